@@ -0,0 +1,161 @@
+#ifndef ZCO_BLOCKING_H_
+#define ZCO_BLOCKING_H_
+
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "zco/internal/noncopyable.h"
+
+namespace zco {
+
+class BlockingPool;
+
+namespace detail {
+
+/**
+ * @brief 交给阻塞线程池执行的一次调用。
+ * @details 对象由发起方在堆上分配：共享栈模型下挂起协程的栈会被换出，
+ *          阻塞线程只能访问堆上的状态。链接字段只由 BlockingPool 读写。
+ */
+class BlockingCallBase : public NonCopyable {
+  public:
+    virtual ~BlockingCallBase() {}
+
+    /**
+     * @brief 在阻塞线程上执行调用，异常由实现捕获保存。
+     * @param 无参数。
+     * @return 无返回值。
+     */
+    virtual void run() noexcept = 0;
+
+  private:
+    friend class zco::BlockingPool;
+
+    BlockingCallBase *next_ = nullptr; // 排队链表
+    uint64_t enqueued_ns_ = 0;         // 入队时刻
+    void *waiter_ = nullptr;           // 等待的 Fiber，持有一份引用
+};
+
+/**
+ * @brief 执行一次阻塞调用。
+ * @details 协程内把调用投给阻塞线程池并挂起当前协程，完成后协程回到原
+ *          调度器继续运行；普通线程上直接在当前线程执行。
+ * @param call 调用对象，返回前不会被释放。
+ * @return 无返回值。
+ */
+void run_blocking(BlockingCallBase *call);
+
+// 保存调用结果，引用与 void 结果单独处理。
+template <typename R> class BlockingResult {
+  public:
+    BlockingResult() : has_value_(false) {}
+
+    ~BlockingResult() {
+        if (has_value_) {
+            value_ptr()->~R();
+        }
+    }
+
+    template <typename F> void emplace(F &fn) {
+        new (&storage_) R(fn());
+        has_value_ = true;
+    }
+
+    R take() { return std::move(*value_ptr()); }
+
+  private:
+    R *value_ptr() { return reinterpret_cast<R *>(&storage_); }
+
+    typename std::aligned_storage<sizeof(R), alignof(R)>::type storage_;
+    bool has_value_;
+};
+
+template <typename R> class BlockingResult<R &> {
+  public:
+    template <typename F> void emplace(F &fn) { value_ = &fn(); }
+
+    R &take() { return *value_; }
+
+  private:
+    R *value_ = nullptr;
+};
+
+template <> class BlockingResult<void> {
+  public:
+    template <typename F> void emplace(F &fn) { fn(); }
+
+    void take() {}
+};
+
+template <typename F, typename R>
+class BlockingCall final : public BlockingCallBase {
+  public:
+    template <typename U>
+    explicit BlockingCall(U &&fn) : fn_(std::forward<U>(fn)) {}
+
+    void run() noexcept override {
+        try {
+            result_.emplace(fn_);
+        } catch (...) {
+            error_ = std::current_exception();
+        }
+    }
+
+    R get() {
+        if (error_) {
+            std::rethrow_exception(error_);
+        }
+        return result_.take();
+    }
+
+  private:
+    F fn_;
+    BlockingResult<R> result_;
+    std::exception_ptr error_;
+};
+
+} // namespace detail
+
+/**
+ * @brief 在阻塞线程池中执行不能改成非阻塞的操作。
+ * @details
+ * - 用于 fsync、大块压缩、getaddrinfo 这类会占住线程的调用。协程内调用时
+ *   fn 在独立的阻塞线程池中执行，只挂起当前协程，调度器继续运行其他协程；
+ *   fn 结束后协程回到原调度器继续运行。
+ * - 普通线程上调用时 fn 直接在当前线程执行。
+ * - fn 抛出的异常在调用方重新抛出。
+ * - 挂起不响应 TaskGroup 取消，fn 执行期间不能被打断。
+ * - fn 运行在普通线程上，不能在其中使用协程 API。
+ * - 共享栈模型下协程挂起后栈内容可能被换出，fn 不能按引用访问协程栈上
+ *   的变量，参数与缓冲区应按值捕获或放在堆上。
+ * @param fn 无参可调用对象，会被移动或复制到堆上。
+ * @return fn 的返回值。
+ */
+template <typename F>
+auto blocking(F &&fn)
+    -> decltype(std::declval<typename std::decay<F>::type &>()()) {
+    using Fn = typename std::decay<F>::type;
+    using Result = decltype(std::declval<Fn &>()());
+    std::unique_ptr<detail::BlockingCall<Fn, Result>> call(
+        new detail::BlockingCall<Fn, Result>(std::forward<F>(fn)));
+    detail::run_blocking(call.get());
+    return call->get();
+}
+
+/**
+ * @brief 设置阻塞线程池的并发上限。
+ * @details 线程按需创建，空闲一段时间后退出，同时执行的调用不超过该值，
+ *          其余调用排队。可以随时调整，调小后多出的线程在手头调用结束后
+ *          退出。与调度器数量无关，运行时 shutdown 不会重置该值。
+ * @param max_threads 最大线程数，需大于 0。
+ * @return 无返回值。
+ */
+void co_blocking_threads(uint32_t max_threads);
+
+} // namespace zco
+
+#endif // ZCO_BLOCKING_H_
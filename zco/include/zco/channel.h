@@ -4,18 +4,27 @@
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
-#include <mutex>
+#include <memory>
+#include <new>
 #include <type_traits>
 #include <utility>
-#include <vector>
 
-#include "zco/event.h"
+#include "zco/internal/channel_wait_queue.h"
+#include "zco/sched.h"
 #include "zco/zco_log.h"
 
 namespace zco {
 
+class SelectCase;
+
 /**
  * @brief 协程与线程可共享的有界通道。
+ * @details
+ * - 缓冲区是无锁的有界 MPMC 环形队列（每个槽位带序号），缓冲区非空/非满时
+ *   读写都不加锁。
+ * - 读端缓冲为空才挂起；写端发现有挂起的读端时把值直接交给它，
+ *   不经过缓冲区。
+ * - 写满挂起的写端在读端腾出槽位后被唤醒重试。
  * @tparam T 元素类型。
  */
 template <typename T> class Channel {
@@ -28,15 +37,32 @@ template <typename T> class Channel {
     explicit Channel(uint32_t capacity = 1,
                      uint32_t timeout_ms = kInfiniteTimeoutMs)
         : capacity_(capacity == 0 ? 1 : capacity), timeout_ms_(timeout_ms),
-          storage_(capacity_, StorageSlot{}), head_(0), tail_(0), size_(0),
-          not_empty_(true, false), not_full_(true, true), closed_(false),
-          done_(true) {}
+          cells_(new Cell[capacity_]), enqueue_pos_(0), dequeue_pos_(0),
+          waiters_(), closed_(false), done_(true) {
+        for (size_t i = 0; i < capacity_; ++i) {
+            cells_[i].sequence.store(2 * i, std::memory_order_relaxed);
+        }
+    }
 
     ~Channel() {
-        std::lock_guard<std::mutex> lock(mutex_);
-        clear_locked();
+        // 析构时不再有并发读写，直接原地析构剩余元素。
+        const size_t tail = enqueue_pos_.load(std::memory_order_acquire);
+        for (size_t pos = dequeue_pos_.load(std::memory_order_acquire);
+             pos != tail; ++pos) {
+            cells_[pos % capacity_].slot()->~T();
+        }
+
+        ChannelWaiter *node = waiters_.take_free_nodes();
+        while (node) {
+            ChannelWaiter *next = node->next;
+            delete static_cast<WaitNode *>(node);
+            node = next;
+        }
     }
 
+    Channel(const Channel &) = delete;
+    Channel &operator=(const Channel &) = delete;
+
     /**
      * @brief 从通道读取一个元素。
      * @param out 输出对象。
@@ -52,28 +78,31 @@ template <typename T> class Channel {
      */
     bool read(T &out, uint32_t timeout_ms) const {
         while (true) {
-            {
-                std::lock_guard<std::mutex> lock(mutex_);
-                if (size_ > 0) {
-                    pop_front_locked(&out);
-                    done_.store(true, std::memory_order_release);
-                    update_events_locked();
-                    ZCO_LOG_DEBUG("channel read success, size={}, capacity={}",
-                                  size_, capacity_);
-                    return true;
-                }
+            bool ok = false;
+            if (poll_read(out, &ok)) {
+                return ok;
+            }
 
-                const bool closed = closed_.load(std::memory_order_acquire);
-                if (closed) {
-                    done_.store(false, std::memory_order_release);
-                    update_events_locked();
-                    ZCO_LOG_DEBUG(
-                        "channel read failed, channel closed and empty");
-                    return false;
-                }
+            if (timeout_ms == 0) {
+                done_.store(false, std::memory_order_release);
+                return false;
             }
 
-            if (!not_empty_.wait(timeout_ms)) {
+            WaitNode *node = acquire_node();
+            const ChannelWaiter::Result result =
+                waiters_.wait(node, ChannelWaitQueue::kReader, timeout_ms,
+                              &Channel::readable_or_closed, this);
+            if (result == ChannelWaiter::Result::kHanded) {
+                T *handed = node->value();
+                out = std::move(*handed);
+                handed->~T();
+                waiters_.release_node(node);
+                done_.store(true, std::memory_order_release);
+                return true;
+            }
+
+            waiters_.release_node(node);
+            if (result == ChannelWaiter::Result::kTimeout) {
                 done_.store(false, std::memory_order_release);
                 ZCO_LOG_DEBUG("channel read timeout, timeout_ms={}",
                               timeout_ms);
@@ -82,6 +111,40 @@ template <typename T> class Channel {
         }
     }
 
+    /**
+     * @brief 批量读取。
+     * @details 缓冲为空时按 timeout 等待第一个元素，之后只取已就绪的元素。
+     * @param out 输出数组，至少 max_count 个元素。
+     * @param max_count 最多读取数量。
+     * @return 实际读取数量，0 表示超时或通道关闭且为空。
+     */
+    size_t read_n(T *out, size_t max_count) const {
+        return read_n(out, max_count, timeout_ms_);
+    }
+
+    /**
+     * @brief 批量读取（按调用覆盖超时）。
+     * @param out 输出数组。
+     * @param max_count 最多读取数量。
+     * @param timeout_ms 等待第一个元素的超时。
+     * @return 实际读取数量。
+     */
+    size_t read_n(T *out, size_t max_count, uint32_t timeout_ms) const {
+        if (!out || max_count == 0) {
+            return 0;
+        }
+
+        size_t count = pop_ready(out, max_count);
+        if (count == 0) {
+            if (!read(out[0], timeout_ms)) {
+                return 0;
+            }
+            count = 1 + pop_ready(out + 1, max_count - 1);
+        }
+        done_.store(true, std::memory_order_release);
+        return count;
+    }
+
     /**
      * @brief 向通道写入一个元素（拷贝）。
      * @param value 输入元素。
@@ -122,6 +185,54 @@ template <typename T> class Channel {
         return write_impl(std::move(value), timeout_ms);
     }
 
+    /**
+     * @brief 批量写入，元素按顺序从 values 移走。
+     * @details 先交给已挂起的读端，其余放进缓冲区，整批只唤醒一次；
+     *          缓冲区满时按 timeout 等待，每次等待单独计时。
+     * @param values 输入数组。
+     * @param count 元素数量。
+     * @return 实际写入数量，小于 count 表示超时或通道已关闭。
+     */
+    size_t write_n(T *values, size_t count) const {
+        return write_n(values, count, timeout_ms_);
+    }
+
+    /**
+     * @brief 批量写入（按调用覆盖超时）。
+     * @param values 输入数组。
+     * @param count 元素数量。
+     * @param timeout_ms 每次等待的超时。
+     * @return 实际写入数量。
+     */
+    size_t write_n(T *values, size_t count, uint32_t timeout_ms) const {
+        size_t written = 0;
+        while (values && written < count) {
+            if (closed_.load(std::memory_order_acquire)) {
+                ZCO_LOG_WARN("channel write_n stopped, channel already closed");
+                break;
+            }
+
+            while (written < count && hand_off(values[written])) {
+                ++written;
+            }
+
+            size_t pushed = 0;
+            while (written < count && try_push(values[written])) {
+                ++written;
+                ++pushed;
+            }
+            if (pushed > 0) {
+                waiters_.notify(ChannelWaitQueue::kReader, pushed);
+            }
+
+            if (written == count || !wait_writable(timeout_ms)) {
+                break;
+            }
+        }
+        done_.store(written == count, std::memory_order_release);
+        return written;
+    }
+
     /**
      * @brief 尝试立即读取（不等待）。
      * @param out 输出对象。
@@ -184,15 +295,9 @@ template <typename T> class Channel {
      * @return 无返回值。
      */
     void close() const {
-        {
-            std::lock_guard<std::mutex> lock(mutex_);
-            closed_.store(true, std::memory_order_release);
-            update_events_locked();
-            ZCO_LOG_INFO("channel closed, remaining_size={}, capacity={}",
-                         size_, capacity_);
-        }
-        not_empty_.notify_all();
-        not_full_.notify_all();
+        closed_.store(true, std::memory_order_seq_cst);
+        waiters_.notify_all(ChannelWaiter::Result::kClosed);
+        ZCO_LOG_INFO("channel closed, capacity={}", capacity_);
     }
 
     /**
@@ -204,6 +309,34 @@ template <typename T> class Channel {
     }
 
   private:
+    friend class SelectCase;
+
+    using StorageSlot =
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type;
+
+    /**
+     * @brief 环形队列槽位。
+     * @details sequence 为 2 * pos 表示位置 pos 可写，2 * pos + 1 表示可读；
+     *          乘 2 后容量为 1 时“已满”与“下一轮可写”也不会混淆。
+     */
+    struct Cell {
+        std::atomic<size_t> sequence;
+        StorageSlot storage;
+
+        T *slot() { return reinterpret_cast<T *>(&storage); }
+    };
+
+    /**
+     * @brief 带交接存储的等待节点。
+     */
+    struct WaitNode : ChannelWaiter {
+        WaitNode() : ChannelWaiter(), storage() { slot = &storage; }
+
+        T *value() { return reinterpret_cast<T *>(&storage); }
+
+        StorageSlot storage;
+    };
+
     /**
      * @brief 写入实现。
      * @param value 输入元素。
@@ -211,99 +344,267 @@ template <typename T> class Channel {
      */
     bool write_impl(T &&value, uint32_t timeout_ms) const {
         while (true) {
-            {
-                std::lock_guard<std::mutex> lock(mutex_);
-                const bool closed = closed_.load(std::memory_order_acquire);
-                if (closed) {
-                    done_.store(false, std::memory_order_release);
-                    update_events_locked();
-                    ZCO_LOG_WARN(
-                        "channel write failed, channel already closed");
-                    return false;
-                }
-
-                if (size_ < capacity_) {
-                    push_back_locked(std::move(value));
-                    done_.store(true, std::memory_order_release);
-                    update_events_locked();
-                    ZCO_LOG_DEBUG("channel write success, size={}, capacity={}",
-                                  size_, capacity_);
-                    return true;
-                }
+            bool ok = false;
+            if (poll_write(value, &ok)) {
+                return ok;
             }
 
-            if (!not_full_.wait(timeout_ms)) {
+            if (!wait_writable(timeout_ms)) {
                 done_.store(false, std::memory_order_release);
-                ZCO_LOG_DEBUG("channel write timeout, timeout_ms={}",
-                              timeout_ms);
                 return false;
             }
         }
     }
 
     /**
-     * @brief 在持锁状态下更新内部事件状态。
-     * @return 无返回值。
+     * @brief 不等待地读取一次。
+     * @param out 输出对象。
+     * @param ok 输出读取结果，通道关闭且为空时为 false。
+     * @return true 表示已有结果，false 表示需要等待。
      */
-    void update_events_locked() const {
-        // not_empty_ 和 not_full_ 分别用于读侧和写侧阻塞唤醒。
-        if (size_ > 0) {
-            not_empty_.signal();
-        } else {
-            not_empty_.reset();
+    bool poll_read(T &out, bool *ok) const {
+        if (try_pop(&out)) {
+            waiters_.notify(ChannelWaitQueue::kWriter, 1);
+            done_.store(true, std::memory_order_release);
+            *ok = true;
+            return true;
         }
 
-        const bool closed = closed_.load(std::memory_order_acquire);
-        const bool can_write = !closed && size_ < capacity_;
-        if (can_write) {
-            not_full_.signal();
-        } else {
-            not_full_.reset();
+        // 关闭前写入的元素仍可读完，因此关闭后再取一次。
+        if (closed_.load(std::memory_order_acquire)) {
+            *ok = try_pop(&out);
+            done_.store(*ok, std::memory_order_release);
+            if (!*ok) {
+                ZCO_LOG_DEBUG("channel read failed, channel closed and empty");
+            }
+            return true;
         }
+        return false;
     }
 
-    using StorageSlot =
-        typename std::aligned_storage<sizeof(T), alignof(T)>::type;
+    /**
+     * @brief 不等待地写入一次。
+     * @param value 输入元素，写入成功时被移走。
+     * @param ok 输出写入结果，通道已关闭时为 false。
+     * @return true 表示已有结果，false 表示需要等待。
+     */
+    bool poll_write(T &value, bool *ok) const {
+        if (closed_.load(std::memory_order_acquire)) {
+            done_.store(false, std::memory_order_release);
+            ZCO_LOG_WARN("channel write failed, channel already closed");
+            *ok = false;
+            return true;
+        }
+
+        if (hand_off(value)) {
+            done_.store(true, std::memory_order_release);
+            *ok = true;
+            return true;
+        }
+
+        if (try_push(value)) {
+            waiters_.notify(ChannelWaitQueue::kReader, 1);
+            done_.store(true, std::memory_order_release);
+            *ok = true;
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief 把值直接交给一个挂起的读端。
+     * @param value 输入元素，成功时被移走。
+     * @return true 表示已交接。
+     */
+    bool hand_off(T &value) const {
+        if (!waiters_.has_waiters(ChannelWaitQueue::kReader)) {
+            return false;
+        }
+
+        ChannelWaiter *reader = waiters_.claim(ChannelWaitQueue::kReader);
+        if (!reader) {
+            return false;
+        }
+        new (reader->slot) T(std::move(value));
+        waiters_.complete(reader, ChannelWaiter::Result::kHanded);
+        return true;
+    }
 
-    T *slot_ptr(size_t index) const {
-        return reinterpret_cast<T *>(
-            const_cast<StorageSlot *>(&storage_[index]));
+    /**
+     * @brief 缓冲区满时挂起写端。
+     * @param timeout_ms 超时时间。
+     * @return true 表示可以重试，false 表示超时。
+     */
+    bool wait_writable(uint32_t timeout_ms) const {
+        if (timeout_ms == 0) {
+            return false;
+        }
+
+        WaitNode *node = acquire_node();
+        const ChannelWaiter::Result result =
+            waiters_.wait(node, ChannelWaitQueue::kWriter, timeout_ms,
+                          &Channel::writable_or_closed, this);
+        waiters_.release_node(node);
+        if (result == ChannelWaiter::Result::kTimeout) {
+            ZCO_LOG_DEBUG("channel write timeout, timeout_ms={}", timeout_ms);
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief 读取已就绪的元素，不等待。
+     * @param out 输出数组。
+     * @param max_count 最多读取数量。
+     * @return 实际读取数量。
+     */
+    size_t pop_ready(T *out, size_t max_count) const {
+        size_t count = 0;
+        while (count < max_count && try_pop(&out[count])) {
+            ++count;
+        }
+        if (count > 0) {
+            waiters_.notify(ChannelWaitQueue::kWriter, count);
+        }
+        return count;
     }
 
-    void push_back_locked(T &&value) const {
-        new (slot_ptr(tail_)) T(std::move(value));
-        tail_ = (tail_ + 1U) % capacity_;
-        ++size_;
+    bool try_push(T &value) const {
+        size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        Cell *cell = nullptr;
+        while (true) {
+            cell = &cells_[pos % capacity_];
+            const size_t sequence =
+                cell->sequence.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(sequence) -
+                                  static_cast<intptr_t>(2 * pos);
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(
+                        pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        new (cell->slot()) T(std::move(value));
+        cell->sequence.store(2 * pos + 1, std::memory_order_release);
+        return true;
     }
 
-    void pop_front_locked(T *out) const {
-        T *element = slot_ptr(head_);
+    bool try_pop(T *out) const {
+        size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        Cell *cell = nullptr;
+        while (true) {
+            cell = &cells_[pos % capacity_];
+            const size_t sequence =
+                cell->sequence.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(sequence) -
+                                  static_cast<intptr_t>(2 * pos + 1);
+            if (diff == 0) {
+                if (dequeue_pos_.compare_exchange_weak(
+                        pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = dequeue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        T *element = cell->slot();
         *out = std::move(*element);
         element->~T();
-        head_ = (head_ + 1U) % capacity_;
-        --size_;
+        cell->sequence.store(2 * (pos + capacity_), std::memory_order_release);
+        return true;
+    }
+
+    static bool readable_or_closed(const void *context) {
+        const Channel *self = static_cast<const Channel *>(context);
+        if (self->closed_.load(std::memory_order_acquire)) {
+            return true;
+        }
+        const size_t pos = self->dequeue_pos_.load(std::memory_order_acquire);
+        const size_t sequence = self->cells_[pos % self->capacity_]
+                                    .sequence.load(std::memory_order_acquire);
+        return static_cast<intptr_t>(sequence) -
+                   static_cast<intptr_t>(2 * pos + 1) >=
+               0;
     }
 
-    void clear_locked() const {
-        while (size_ > 0) {
-            T *element = slot_ptr(head_);
-            element->~T();
-            head_ = (head_ + 1U) % capacity_;
-            --size_;
+    static bool writable_or_closed(const void *context) {
+        const Channel *self = static_cast<const Channel *>(context);
+        if (self->closed_.load(std::memory_order_acquire)) {
+            return true;
         }
-        head_ = 0;
-        tail_ = 0;
+        const size_t pos = self->enqueue_pos_.load(std::memory_order_acquire);
+        const size_t sequence = self->cells_[pos % self->capacity_]
+                                    .sequence.load(std::memory_order_acquire);
+        return static_cast<intptr_t>(sequence) -
+                   static_cast<intptr_t>(2 * pos) >=
+               0;
+    }
+
+    // 以下为 select 使用的类型擦除入口，见 zco/select.h。
+
+    static bool select_poll_read(const void *channel, void *value,
+                                 bool *ok) {
+        return static_cast<const Channel *>(channel)->poll_read(
+            *static_cast<T *>(value), ok);
+    }
+
+    static bool select_poll_write(const void *channel, void *value,
+                                  bool *ok) {
+        return static_cast<const Channel *>(channel)->poll_write(
+            *static_cast<T *>(value), ok);
+    }
+
+    static ChannelWaiter *select_arm(const void *channel,
+                                     ChannelWaitQueue::Side side) {
+        const Channel *self = static_cast<const Channel *>(channel);
+        WaitNode *node = self->acquire_node();
+        const ChannelWaitQueue::ReadyFn ready =
+            side == ChannelWaitQueue::kReader ? &Channel::readable_or_closed
+                                              : &Channel::writable_or_closed;
+        if (!self->waiters_.enqueue(node, side, ready, self)) {
+            self->waiters_.release_node(node);
+            return nullptr;
+        }
+        return node;
+    }
+
+    static ChannelWaiter::Result select_disarm(const void *channel,
+                                               ChannelWaitQueue::Side side,
+                                               ChannelWaiter *waiter,
+                                               void *value) {
+        const Channel *self = static_cast<const Channel *>(channel);
+        WaitNode *node = static_cast<WaitNode *>(waiter);
+        const ChannelWaiter::Result result = self->waiters_.cancel(node, side);
+        if (result == ChannelWaiter::Result::kHanded) {
+            T *handed = node->value();
+            *static_cast<T *>(value) = std::move(*handed);
+            handed->~T();
+            self->done_.store(true, std::memory_order_release);
+        }
+        self->waiters_.release_node(node);
+        return result;
+    }
+
+    WaitNode *acquire_node() const {
+        ChannelWaiter *node = waiters_.acquire_node();
+        return node ? static_cast<WaitNode *>(node) : new WaitNode();
     }
 
     const size_t capacity_;
     const uint32_t timeout_ms_;
-    mutable std::mutex mutex_;
-    mutable std::vector<StorageSlot> storage_; // 固定容量的环形缓冲区
-    mutable size_t head_;
-    mutable size_t tail_;
-    mutable size_t size_;
-    mutable Event not_empty_;
-    mutable Event not_full_;
+    const std::unique_ptr<Cell[]> cells_; // 固定容量的环形缓冲区
+    alignas(64) mutable std::atomic<size_t> enqueue_pos_;
+    alignas(64) mutable std::atomic<size_t> dequeue_pos_;
+    alignas(64) mutable ChannelWaitQueue waiters_;
     mutable std::atomic<bool> closed_;
     mutable std::atomic<bool> done_;
 };
@@ -0,0 +1,87 @@
+#ifndef ZCO_FIBER_LOCAL_H_
+#define ZCO_FIBER_LOCAL_H_
+
+#include <cstdint>
+#include <utility>
+
+#include "zco/internal/fiber_local_slots.h"
+#include "zco/internal/noncopyable.h"
+
+namespace zco {
+
+/**
+ * @brief 协程局部变量。
+ * @details
+ * - 每个协程各有一份独立的值，首次访问时默认构造，协程结束时在协程内
+ *   析构；协程被窃取到其他调度器后值仍然跟随协程。
+ * - 普通线程上访问时每个线程各有一份，线程退出时析构。
+ * - 访问按下标直接取槽位，不哈希、不加锁；前几个 FiberLocal 的槽位内联
+ *   在协程对象里。
+ * - 通常定义为全局或静态对象。FiberLocal 销毁后，各协程里残留的值在下次
+ *   复用该下标或协程结束时析构。
+ */
+template <typename T> class FiberLocal : public NonCopyable {
+  public:
+    FiberLocal() : index_(acquire_fiber_local_index(&key_)) {}
+
+    ~FiberLocal() { release_fiber_local_index(index_); }
+
+    /**
+     * @brief 获取当前协程的值，尚未构造时默认构造。
+     * @param 无参数。
+     * @return 值引用，在当前协程结束或 reset 之前有效。
+     */
+    T &get() {
+        FiberLocalSlots *slots = current_fiber_local_slots();
+        void *value = slots->get(index_, key_);
+        if (!value) {
+            value = new T();
+            slots->emplace(index_, key_, value, &destroy);
+        }
+        return *static_cast<T *>(value);
+    }
+
+    T &operator*() { return get(); }
+
+    T *operator->() { return &get(); }
+
+    /**
+     * @brief 替换当前协程的值。
+     * @param value 新值。
+     * @return 无返回值。
+     */
+    void set(T value) {
+        FiberLocalSlots *slots = current_fiber_local_slots();
+        if (void *current = slots->get(index_, key_)) {
+            *static_cast<T *>(current) = std::move(value);
+            return;
+        }
+        slots->emplace(index_, key_, new T(std::move(value)), &destroy);
+    }
+
+    /**
+     * @brief 判断当前协程是否已构造过值。
+     * @param 无参数。
+     * @return true 表示已有值。
+     */
+    bool has_value() const {
+        return current_fiber_local_slots()->get(index_, key_) != nullptr;
+    }
+
+    /**
+     * @brief 立即析构当前协程的值，下次访问时重新构造。
+     * @param 无参数。
+     * @return 无返回值。
+     */
+    void reset() { current_fiber_local_slots()->erase(index_, key_); }
+
+  private:
+    static void destroy(void *value) { delete static_cast<T *>(value); }
+
+    uint64_t key_;
+    const uint32_t index_;
+};
+
+} // namespace zco
+
+#endif // ZCO_FIBER_LOCAL_H_
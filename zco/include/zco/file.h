@@ -0,0 +1,67 @@
+#ifndef ZCO_FILE_H_
+#define ZCO_FILE_H_
+
+#include <sys/types.h>
+
+namespace zco {
+
+/**
+ * @brief 协程友好的文件 IO。
+ * @details
+ * - 普通文件对 epoll 总是就绪，hook 层的 co_read/co_write 对它无效，读写
+ *   仍会占住调度线程。这里的函数在协程内只挂起当前协程：处理器使用
+ *   io_uring 时直接提交给内核异步执行，否则交给 zco::blocking 的阻塞
+ *   线程池；完成后协程回到原调度器。
+ * - 普通线程上调用时直接执行对应的系统调用。
+ * - 返回值与 errno 约定同名 libc 函数；挂起不响应 TaskGroup 取消。
+ * - 共享栈模型下缓冲区位于协程栈上时自动经堆上的中转缓冲区拷贝。
+ */
+namespace file {
+
+/**
+ * @brief 打开文件。
+ * @param path 路径。
+ * @param flags open 标志。
+ * @param mode 创建文件时的权限。
+ * @return 文件描述符，失败返回 -1 并设置 errno。
+ */
+int open(const char *path, int flags, mode_t mode = 0);
+
+/**
+ * @brief 从指定偏移读取。
+ * @param fd 文件描述符。
+ * @param buf 缓冲区。
+ * @param count 最多读取的字节数。
+ * @param offset 文件偏移，需非负。
+ * @return 读取的字节数，0 表示文件结束，失败返回 -1 并设置 errno。
+ */
+ssize_t pread(int fd, void *buf, size_t count, off_t offset);
+
+/**
+ * @brief 写入指定偏移。
+ * @param fd 文件描述符。
+ * @param buf 数据。
+ * @param count 字节数。
+ * @param offset 文件偏移，需非负。
+ * @return 写入的字节数，可能小于 count，失败返回 -1 并设置 errno。
+ */
+ssize_t pwrite(int fd, const void *buf, size_t count, off_t offset);
+
+/**
+ * @brief 把文件数据与元数据刷到存储设备。
+ * @param fd 文件描述符。
+ * @return 0 表示成功，失败返回 -1 并设置 errno。
+ */
+int fsync(int fd);
+
+/**
+ * @brief 把文件数据刷到存储设备，不必要的元数据不刷。
+ * @param fd 文件描述符。
+ * @return 0 表示成功，失败返回 -1 并设置 errno。
+ */
+int fdatasync(int fd);
+
+} // namespace file
+} // namespace zco
+
+#endif // ZCO_FILE_H_
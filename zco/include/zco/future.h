@@ -0,0 +1,277 @@
+#ifndef ZCO_FUTURE_H_
+#define ZCO_FUTURE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <future>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "zco/event.h"
+#include "zco/internal/noncopyable.h"
+#include "zco/sched.h"
+
+namespace zco {
+
+template <typename T> class Future;
+template <typename T> class Promise;
+class TaskGroup;
+
+namespace detail {
+
+/**
+ * @brief Future/Promise 共享状态中与结果类型无关的部分。
+ * @details 结果只写一次：写入方先 CAS 抢到写入权，写完结果再发布并唤醒
+ * 全部等待者；等待复用手动复位的 Event，线程与协程上下文都可以等。
+ */
+class FutureStateBase : public NonCopyable {
+  public:
+    FutureStateBase() : stage_(kPending), ready_event_(true, false) {}
+
+    /**
+     * @brief 判断结果是否已发布。
+     * @param 无参数。
+     * @return true 表示值或异常已就绪。
+     */
+    bool ready() const {
+        return stage_.load(std::memory_order_acquire) == kReady;
+    }
+
+    /**
+     * @brief 等待结果发布。
+     * @param milliseconds 超时时间。
+     * @return true 表示已就绪，false 表示超时。
+     */
+    bool wait(uint32_t milliseconds) const {
+        return ready() || ready_event_.wait(milliseconds);
+    }
+
+    /**
+     * @brief 以异常结束。
+     * @param error 异常对象。
+     * @return false 表示结果已被设置过。
+     */
+    bool set_exception(std::exception_ptr error) {
+        if (!try_claim()) {
+            return false;
+        }
+        publish(std::move(error));
+        return true;
+    }
+
+  protected:
+    bool try_claim() {
+        uint8_t expected = kPending;
+        return stage_.compare_exchange_strong(expected, kSetting,
+                                              std::memory_order_acq_rel);
+    }
+
+    void publish(std::exception_ptr error) {
+        error_ = std::move(error);
+        stage_.store(kReady, std::memory_order_release);
+        ready_event_.signal();
+    }
+
+    // 等到就绪，结果是异常时重新抛出。
+    void wait_and_check() const {
+        while (!wait(kInfiniteTimeoutMs)) {
+        }
+        if (error_) {
+            std::rethrow_exception(error_);
+        }
+    }
+
+  private:
+    static constexpr uint8_t kPending = 0;
+    static constexpr uint8_t kSetting = 1; // 已抢到写入权，结果尚未发布
+    static constexpr uint8_t kReady = 2;
+
+    std::atomic<uint8_t> stage_;
+    Event ready_event_;
+    std::exception_ptr error_;
+};
+
+/**
+ * @brief 带值的共享状态，值就地构造在状态对象内，不再单独分配。
+ */
+template <typename T> class FutureState : public FutureStateBase {
+  public:
+    FutureState() : has_value_(false) {}
+
+    ~FutureState() {
+        if (has_value_) {
+            value_ptr()->~T();
+        }
+    }
+
+    template <typename U> bool set_value(U &&value) {
+        if (!try_claim()) {
+            return false;
+        }
+        try {
+            new (&storage_) T(std::forward<U>(value));
+            has_value_ = true;
+        } catch (...) {
+            // 构造失败也要发布，否则等待者永远等不到结果。
+            publish(std::current_exception());
+            return true;
+        }
+        publish(nullptr);
+        return true;
+    }
+
+    T &get() {
+        wait_and_check();
+        return *value_ptr();
+    }
+
+  private:
+    T *value_ptr() { return reinterpret_cast<T *>(&storage_); }
+
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type storage_;
+    bool has_value_;
+};
+
+template <> class FutureState<void> : public FutureStateBase {
+  public:
+    bool set_value() {
+        if (!try_claim()) {
+            return false;
+        }
+        publish(nullptr);
+        return true;
+    }
+
+    void get() { wait_and_check(); }
+};
+
+} // namespace detail
+
+/**
+ * @brief 异步结果的只读句柄。
+ * @details
+ * - 语义接近 std::shared_future：可复制，副本共享同一个结果，
+ *   get() 可重复调用。
+ * - 线程与协程上下文都可以等待；协程里等待只挂起当前协程。
+ * @tparam T 结果类型，可以是 void。
+ */
+template <typename T> class Future {
+  public:
+    Future() = default;
+
+    /**
+     * @brief 判断是否关联了共享状态。
+     * @param 无参数。
+     * @return true 表示有效。
+     */
+    bool valid() const { return state_ != nullptr; }
+
+    /**
+     * @brief 判断结果是否已就绪，不等待。
+     * @param 无参数。
+     * @return true 表示值或异常已就绪。
+     */
+    bool ready() const { return state_ && state_->ready(); }
+
+    /**
+     * @brief 等待结果就绪。
+     * @param milliseconds 超时时间。
+     * @return true 表示已就绪；超时或无效句柄返回 false。
+     */
+    bool wait(uint32_t milliseconds = kInfiniteTimeoutMs) const {
+        return state_ && state_->wait(milliseconds);
+    }
+
+    /**
+     * @brief 等待并获取结果。
+     * @details 任务以异常结束时在这里重新抛出；无效句柄抛出
+     * std::future_error(no_state)。
+     * @param 无参数。
+     * @return 结果引用，T 为 void 时无返回值。
+     */
+    decltype(auto) get() const {
+        if (!state_) {
+            throw std::future_error(std::future_errc::no_state);
+        }
+        return state_->get();
+    }
+
+  private:
+    friend class Promise<T>;
+    friend class TaskGroup;
+
+    explicit Future(std::shared_ptr<detail::FutureState<T>> state)
+        : state_(std::move(state)) {}
+
+    std::shared_ptr<detail::FutureState<T>> state_;
+};
+
+/**
+ * @brief 异步结果的写入端。
+ * @details
+ * - 只可移动；结果只能设置一次，重复设置返回 false。
+ * - 析构时仍未设置结果，Future 以 std::future_error(broken_promise) 结束。
+ * - set_value/set_exception 可在任意线程或协程调用。
+ * @tparam T 结果类型，可以是 void。
+ */
+template <typename T> class Promise {
+  public:
+    Promise() : state_(std::make_shared<detail::FutureState<T>>()) {}
+
+    ~Promise() { abandon(); }
+
+    Promise(const Promise &) = delete;
+    Promise &operator=(const Promise &) = delete;
+
+    Promise(Promise &&other) noexcept = default;
+
+    Promise &operator=(Promise &&other) noexcept {
+        if (this != &other) {
+            abandon();
+            state_ = std::move(other.state_);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief 获取关联的 Future，可多次调用。
+     * @param 无参数。
+     * @return Future 句柄；已被移走时返回无效句柄。
+     */
+    Future<T> get_future() const { return Future<T>(state_); }
+
+    /**
+     * @brief 设置结果并唤醒全部等待者。
+     * @param args 结果值，T 为 void 时不传。
+     * @return false 表示结果已被设置过或 Promise 已被移走。
+     */
+    template <typename... Args> bool set_value(Args &&...args) {
+        return state_ && state_->set_value(std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief 以异常结束。
+     * @param error 异常对象。
+     * @return false 表示结果已被设置过或 Promise 已被移走。
+     */
+    bool set_exception(std::exception_ptr error) {
+        return state_ && state_->set_exception(std::move(error));
+    }
+
+  private:
+    void abandon() {
+        if (state_ && !state_->ready()) {
+            (void)state_->set_exception(std::make_exception_ptr(
+                std::future_error(std::future_errc::broken_promise)));
+        }
+    }
+
+    std::shared_ptr<detail::FutureState<T>> state_;
+};
+
+} // namespace zco
+
+#endif // ZCO_FUTURE_H_
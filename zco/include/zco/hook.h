@@ -1,6 +1,9 @@
 #ifndef ZCO_HOOK_H_
 #define ZCO_HOOK_H_
 
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/select.h>
 #include <sys/socket.h>
 #include <sys/types.h>
 #include <sys/uio.h>
@@ -26,6 +29,28 @@ namespace zco {
  */
 void co_sleep_for(uint32_t milliseconds);
 
+/**
+ * @brief 开关 libc 阻塞调用接管。
+ * @details
+ * - 接管层随 ZCO_ENABLE_SYSCALL_HOOK 编译（默认关闭），运行时默认关闭，
+ *   也可以用环境变量 ZCO_SYSCALL_HOOK=1 在启动时打开。
+ * - 开启后协程里经 socket/socketpair/accept 创建的 fd 在内核侧转为非阻塞，
+ *   调用方通过 fcntl/ioctl 看到的仍是自己设置的阻塞标志；第三方库对这些
+ *   fd 的 read/write/recv/send/connect/accept 等阻塞调用只挂起当前协程，
+ *   协程里的 poll/select/epoll_wait/sleep/usleep/nanosleep 同样如此。
+ * - 关闭只影响之后创建的 fd 与 poll/select/epoll_wait/sleep，已转换的 fd
+ *   保持接管直到关闭。
+ * @param enable 是否开启。
+ * @return true 表示设置生效，false 表示编译时未包含接管层。
+ */
+bool co_hook_enable(bool enable);
+
+/**
+ * @brief 查询 libc 阻塞调用接管是否开启。
+ * @return true 表示已开启。
+ */
+bool co_hook_enabled();
+
 /**
  * @brief 获取当前线程错误码。
  * @return 当前 errno。
@@ -307,6 +332,28 @@ ssize_t co_sendto(int fd, const void *buffer, size_t count, int flags,
                   const struct sockaddr *address, socklen_t address_len,
                   uint32_t timeout_ms = kInfiniteTimeoutMs);
 
+/**
+ * @brief 协程友好的 recvmsg 包装。必须在协程中调用。
+ * @param fd 文件描述符。
+ * @param message 消息结构。
+ * @param flags recvmsg flags。
+ * @param timeout_ms 超时毫秒。
+ * @return 接收结果，与系统调用 recvmsg 语义一致。
+ */
+ssize_t co_recvmsg(int fd, struct msghdr *message, int flags,
+                   uint32_t timeout_ms = kInfiniteTimeoutMs);
+
+/**
+ * @brief 协程友好的 sendmsg 包装。必须在协程中调用。
+ * @param fd 文件描述符。
+ * @param message 消息结构。
+ * @param flags sendmsg flags。
+ * @param timeout_ms 超时毫秒。
+ * @return 发送结果，与系统调用 sendmsg 语义一致。
+ */
+ssize_t co_sendmsg(int fd, const struct msghdr *message, int flags,
+                   uint32_t timeout_ms = kInfiniteTimeoutMs);
+
 /**
  * @brief 协程友好的 connect 包装。必须在协程中调用。
  * @param fd 文件描述符。
@@ -341,6 +388,47 @@ int co_accept(int fd, struct sockaddr *address, socklen_t *address_len,
 int co_accept4(int fd, struct sockaddr *address, socklen_t *address_len,
                int flags, uint32_t timeout_ms = kInfiniteTimeoutMs);
 
+/**
+ * @brief 协程友好的 poll 包装。
+ * @details
+ * - 先不等待地调用一次 poll，已有就绪或 timeout_ms 为 0 时直接返回，不挂起，
+ *   因此零超时调用在任何线程都可用。
+ * - 否则把所有 fd 的读写兴趣登记到当前处理器的 poller，只挂起一次；任一 fd
+ *   就绪或超时后撤销全部登记，再用真实 poll 计算 revents。
+ * - 需要挂起时必须在协程中调用；被 TaskGroup 取消时失败并设置 ECANCELED。
+ * @param fds pollfd 数组。
+ * @param nfds 数组长度。
+ * @param timeout_ms 超时毫秒，负数表示无限等待。
+ * @return 就绪 fd 数，超时返回 0，与系统调用 poll 语义一致。
+ */
+int co_poll(struct pollfd *fds, nfds_t nfds, int timeout_ms);
+
+/**
+ * @brief 协程友好的 select 包装，基于 co_poll 实现。
+ * @details 零超时不挂起；timeout 不回写剩余时间。
+ * @param nfds 最大 fd 加一，不超过 FD_SETSIZE。
+ * @param readfds 读集合，可为 nullptr。
+ * @param writefds 写集合，可为 nullptr。
+ * @param exceptfds 异常集合，可为 nullptr。
+ * @param timeout 超时，nullptr 表示无限等待。
+ * @return 就绪位总数，与系统调用 select 语义一致。
+ */
+int co_select(int nfds, fd_set *readfds, fd_set *writefds, fd_set *exceptfds,
+              struct timeval *timeout);
+
+/**
+ * @brief 协程友好的 epoll_wait 包装。
+ * @details 先不等待地取一次事件；没有事件时用 co_poll 等 epoll fd 可读，
+ *          再不等待地取出事件。零超时不挂起。
+ * @param epfd epoll fd。
+ * @param events 输出事件数组。
+ * @param maxevents 数组长度。
+ * @param timeout_ms 超时毫秒，负数表示无限等待。
+ * @return 事件数，超时返回 0，与系统调用 epoll_wait 语义一致。
+ */
+int co_epoll_wait(int epfd, struct epoll_event *events, int maxevents,
+                  int timeout_ms);
+
 } // namespace zco
 
 #endif // ZCO_HOOK_H_
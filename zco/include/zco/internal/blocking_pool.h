@@ -0,0 +1,109 @@
+#ifndef ZCO_INTERNAL_BLOCKING_POOL_H_
+#define ZCO_INTERNAL_BLOCKING_POOL_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+#include "zco/blocking.h"
+#include "zco/internal/noncopyable.h"
+#include "zco/stats.h"
+
+namespace zco {
+
+// 默认并发上限；阻塞调用多为磁盘 IO 与 DNS，线程大部分时间在内核里等待。
+constexpr uint32_t kDefaultBlockingThreads = 64;
+
+// 线程空闲超过该时间后退出。
+constexpr uint32_t kBlockingThreadIdleMs = 10000;
+
+/**
+ * @brief zco::blocking 使用的阻塞线程池。
+ * @details
+ * - 与调度器分开计数和调整，线程按需创建，数量不超过并发上限，空闲超时后
+ *   退出；超过上限的调用按提交顺序排队，队列以调用对象侵入式串联，入队
+ *   不分配内存。
+ * - 调用结束后把等待的协程投回其所属调度器的就绪队列。
+ * - 单例不析构，分离的线程在进程退出前都可以安全访问。
+ */
+class BlockingPool : public NonCopyable {
+  public:
+    /**
+     * @brief 获取线程池单例。
+     * @param 无参数。
+     * @return 线程池引用。
+     */
+    static BlockingPool &instance();
+
+    /**
+     * @brief 设置并发上限。
+     * @param max_threads 最大线程数，需大于 0。
+     * @return true 表示设置成功。
+     */
+    bool set_max_threads(uint32_t max_threads);
+
+    /**
+     * @brief 提交协程发起的调用。
+     * @details 调用方已把当前协程标记为等待并在 call 中持有引用，提交后
+     *          挂起；调用结束后线程池恢复该协程。无法创建线程且没有现存
+     *          线程时在当前线程执行。
+     * @param call 调用对象。
+     * @param fiber 等待的协程，引用所有权转交给线程池。
+     * @return 无返回值。
+     */
+    void submit(detail::BlockingCallBase *call, void *fiber);
+
+    /**
+     * @brief 等待排队和执行中的调用全部结束。
+     * @details 运行时 shutdown 在销毁处理器前调用，避免调用结束后把协程
+     *          投给已销毁的处理器。
+     * @param 无参数。
+     * @return 无返回值。
+     */
+    void wait_idle();
+
+    /**
+     * @brief 采集统计快照。
+     * @param 无参数。
+     * @return 统计快照。
+     */
+    BlockingPoolStats stats() const;
+
+  private:
+    BlockingPool();
+
+    /**
+     * @brief 工作线程主循环。
+     * @param 无参数。
+     * @return 无返回值。
+     */
+    void worker_loop();
+
+    /**
+     * @brief 执行一次调用并恢复等待的协程。
+     * @details 恢复之后调用对象可能已被协程释放，不得再访问。
+     * @param call 调用对象。
+     * @return 执行耗时。
+     */
+    static uint64_t run_and_resume(detail::BlockingCallBase *call);
+
+    mutable std::mutex mutex_;
+    std::condition_variable work_cv_; // 有新调用或上限调小
+    std::condition_variable idle_cv_; // 排队和执行中的调用全部结束
+    detail::BlockingCallBase *head_;
+    detail::BlockingCallBase *tail_;
+    uint32_t max_threads_;
+    uint32_t threads_;
+    uint32_t idle_threads_; // 阻塞在 work_cv_ 上的线程数
+    uint32_t busy_threads_;
+    uint32_t queued_;
+    uint32_t peak_queued_;
+    uint64_t submitted_;
+    uint64_t completed_;
+    uint64_t queue_wait_ns_;
+    uint64_t run_ns_;
+};
+
+} // namespace zco
+
+#endif // ZCO_INTERNAL_BLOCKING_POOL_H_
@@ -0,0 +1,182 @@
+#ifndef ZCO_INTERNAL_CHANNEL_WAIT_QUEUE_H_
+#define ZCO_INTERNAL_CHANNEL_WAIT_QUEUE_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+#include "zco/internal/noncopyable.h"
+
+namespace zco {
+
+class Fiber;
+
+/**
+ * @brief 通道等待节点。
+ * @details
+ * - 节点由通道在堆上分配并复用。共享栈模型下挂起协程的栈会被换出，
+ *   唤醒方不能直接写协程栈，交接的值只能写进节点。
+ * - 除 result 外的字段都只在持有 ChannelWaitQueue 锁时访问；
+ *   result 由唤醒方在唤醒前写入，被唤醒方恢复后读取。
+ */
+struct ChannelWaiter {
+    enum class Result : uint8_t {
+        kNone,    // 尚未被唤醒
+        kHanded,  // 写端已把值放进 slot
+        kRetry,   // 条件可能已满足，重新尝试
+        kClosed,  // 通道已关闭
+        kTimeout, // 等待超时
+    };
+
+    ChannelWaiter()
+        : prev(nullptr), next(nullptr), fiber(nullptr), cv(),
+          result(Result::kNone), linked(false), claimed(false),
+          slot(nullptr) {}
+
+    ChannelWaiter *prev;
+    ChannelWaiter *next;
+    Fiber *fiber; // 协程等待者持有一份引用，线程等待者为空
+    std::condition_variable cv; // 线程等待者阻塞在这里
+    Result result;
+    bool linked;
+    bool claimed;
+    void *slot; // 读端交接目标，指向节点自身的存储
+};
+
+/**
+ * @brief 通道的两侧等待队列。
+ * @details
+ * - 只在慢路径使用：读端发现缓冲为空、写端发现缓冲已满时才登记挂起。
+ * - 快路径与挂起之间用计数 + seq_cst 栅栏配对：等待方先递增计数再复查条件，
+ *   生产/消费方先发布缓冲再检查计数，两者至少有一方能看到对方。
+ * - 唤醒分两步：claim() 持锁摘下等待者并占住它（协程用 try_wake），
+ *   complete() 在锁外写入结果并让它重新就绪，中间可以安全地写交接值。
+ */
+class ChannelWaitQueue : public NonCopyable {
+  public:
+    enum Side { kReader = 0, kWriter = 1 };
+
+    /**
+     * @brief 复查条件的回调。
+     * @param context 调用方上下文。
+     * @return true 表示条件已满足，不需要挂起。
+     */
+    using ReadyFn = bool (*)(const void *context);
+
+    ChannelWaitQueue();
+    ~ChannelWaitQueue();
+
+    /**
+     * @brief 判断某一侧是否可能有等待者。
+     * @details 调用方需先执行 seq_cst 栅栏（见 notify()），或者先以 seq_cst
+     *          修改 ready() 读取的状态，两者都能与登记方的计数配对。
+     * @param side 读端或写端。
+     * @return true 表示有已登记的等待者。
+     */
+    bool has_waiters(Side side) const {
+        return counts_[side].load(std::memory_order_seq_cst) != 0;
+    }
+
+    /**
+     * @brief 登记并挂起当前协程或线程。
+     * @param waiter 等待节点。
+     * @param side 读端或写端。
+     * @param timeout_ms 超时时间。
+     * @param ready 登记后持锁复查的条件。
+     * @param context ready 的参数。
+     * @return 唤醒原因；复查成功时返回 kRetry。
+     */
+    ChannelWaiter::Result wait(ChannelWaiter *waiter, Side side,
+                               uint32_t timeout_ms, ReadyFn ready,
+                               const void *context);
+
+    /**
+     * @brief 登记当前协程但不挂起，供 select 同时等待多个通道。
+     * @details 调用方需先 prepare_current_wait()，这样登记一旦可见，
+     *          claim() 的 try_wake 就能成功；协程恢复后必须 cancel()。
+     * @param waiter 等待节点。
+     * @param side 读端或写端。
+     * @param ready 登记后持锁复查的条件。
+     * @param context ready 的参数。
+     * @return false 表示复查成功，节点未登记。
+     */
+    bool enqueue(ChannelWaiter *waiter, Side side, ReadyFn ready,
+                 const void *context);
+
+    /**
+     * @brief 撤销 enqueue() 的登记。
+     * @param waiter 等待节点。
+     * @param side 读端或写端。
+     * @return 本通道写入的唤醒原因，未被本通道唤醒时为 kNone。
+     */
+    ChannelWaiter::Result cancel(ChannelWaiter *waiter, Side side);
+
+    /**
+     * @brief 摘下一个仍在等待的节点，之后必须调用 complete()。
+     * @param side 读端或写端。
+     * @return 等待节点，没有可唤醒的等待者时返回 nullptr。
+     */
+    ChannelWaiter *claim(Side side);
+
+    /**
+     * @brief 唤醒 claim() 摘下的节点。
+     * @param waiter 等待节点。
+     * @param result 唤醒原因。
+     * @return 无返回值。
+     */
+    void complete(ChannelWaiter *waiter, ChannelWaiter::Result result);
+
+    /**
+     * @brief 发布缓冲变化后唤醒对侧等待者。
+     * @details 内含 seq_cst 栅栏，没有等待者时不加锁。
+     * @param side 要唤醒的一侧。
+     * @param max_count 最多唤醒数量。
+     * @return 无返回值。
+     */
+    void notify(Side side, size_t max_count);
+
+    /**
+     * @brief 唤醒两侧全部等待者。
+     * @param result 唤醒原因。
+     * @return 无返回值。
+     */
+    void notify_all(ChannelWaiter::Result result);
+
+    /**
+     * @brief 从空闲链表取一个节点。
+     * @param 无参数。
+     * @return 节点，空闲链表为空时返回 nullptr。
+     */
+    ChannelWaiter *acquire_node();
+
+    /**
+     * @brief 把节点放回空闲链表。
+     * @param waiter 节点。
+     * @return 无返回值。
+     */
+    void release_node(ChannelWaiter *waiter);
+
+    /**
+     * @brief 取走全部空闲节点，供析构时按实际类型释放。
+     * @param 无参数。
+     * @return 以 next 串起的链表。
+     */
+    ChannelWaiter *take_free_nodes();
+
+  private:
+    void link_locked(Side side, ChannelWaiter *waiter);
+    void unlink_locked(Side side, ChannelWaiter *waiter);
+    ChannelWaiter *claim_locked(Side side);
+
+    std::mutex mutex_;
+    ChannelWaiter *heads_[2];
+    ChannelWaiter *tails_[2];
+    std::atomic<size_t> counts_[2];
+    ChannelWaiter *free_nodes_;
+};
+
+} // namespace zco
+
+#endif // ZCO_INTERNAL_CHANNEL_WAIT_QUEUE_H_
@@ -1,37 +1,39 @@
 #ifndef ZCO_INTERNAL_CONTEXT_H_
 #define ZCO_INTERNAL_CONTEXT_H_
 
-#include <ucontext.h>
-
 #include <cstddef>
 
+// 上下文切换后端在构建期选择：
+// - 默认在 x86-64/AArch64 上使用手写汇编，仅保存 callee-saved 寄存器与栈指针，
+//   切换过程不进入内核。
+// - 定义 ZCO_USE_UCONTEXT（CMake 选项同名）或在其他架构上回退到 ucontext，
+//   swapcontext 每次切换都会额外触发一次 rt_sigprocmask 系统调用。
+#if defined(ZCO_USE_UCONTEXT) || !(defined(__x86_64__) || defined(__aarch64__))
+#define ZCO_CONTEXT_BACKEND_UCONTEXT 1
+#include <ucontext.h>
+#endif
+
 namespace zco {
 
 /**
  * @brief 协程上下文类
- * @details 封装 ucontext_t，提供创建上下文、切换上下文等功能。
+ * @details 封装一次上下文切换所需的最小状态：汇编后端只保存栈指针，
+ * 寄存器在切换时压入各自的栈；ucontext 后端保存完整 ucontext_t。
  */
 class Context {
   public:
     Context() = default;
     ~Context() = default;
 
-    /**
-     * @brief 获取上下文
-     * @return 上下文指针
-     */
-    ucontext_t *get() { return &ctx_; }
-    const ucontext_t *get() const { return &ctx_; }
-
     /**
      * @brief 创建上下文
      * @param stack_ptr 协程栈指针
      * @param stack_size 协程栈大小
      * @param func 协程入口函数
-     * @param link 可选的链接上下文，默认为 nullptr
+     * @param link 入口函数返回后切换到的上下文，默认为 nullptr
      */
     void make_context(void *stack_ptr, size_t stack_size, void (*func)(),
-                      ucontext_t *link = nullptr);
+                      Context *link = nullptr);
 
     /**
      * @brief 切换上下文
@@ -43,7 +45,8 @@ class Context {
 
     /**
      * @brief 获取上下文
-     * @return 上下文指针
+     * @details 汇编后端的上下文只在切出时生成，这里仅保留接口兼容。
+     * @return 成功返回 0
      */
     int get_context();
 
@@ -53,10 +56,20 @@ class Context {
      */
     void *get_stack_pointer() const;
 
+    /**
+     * @brief 获取构建期选定的切换后端名称
+     * @return "asm" 或 "ucontext"
+     */
+    static const char *backend_name();
+
   private:
+#if defined(ZCO_CONTEXT_BACKEND_UCONTEXT)
     ucontext_t ctx_{};
+#else
+    void *stack_pointer_ = nullptr; // 切出时保存的栈顶，寄存器保存在其上方
+#endif
 };
 
 } // namespace zco
 
-#endif // ZCO_INTERNAL_CONTEXT_H_
\ No newline at end of file
+#endif // ZCO_INTERNAL_CONTEXT_H_
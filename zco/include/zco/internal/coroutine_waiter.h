@@ -5,6 +5,7 @@
 #include <atomic>
 #include <deque>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "zco/internal/fiber.h"
@@ -13,10 +14,11 @@ namespace zco {
 
 /**
  * @brief 协程等待器条目
- * @details 封装协程和其活跃状态
+ * @details 封装协程和其活跃状态。条目持有协程引用，claim 成功后
+ *          以移动方式交给唤醒方，整个挂起/唤醒只增减一次计数。
  */
 struct CoroutineWaiterEntry {
-    std::weak_ptr<Fiber> coroutine;
+    Fiber::ptr coroutine;
     std::shared_ptr<std::atomic<bool>> active;
 };
 
@@ -32,7 +34,7 @@ inline bool is_waiter_entry_valid(const CoroutineWaiterEntry &waiter) {
     if (!waiter.active->load(std::memory_order_acquire)) {
         return false;
     }
-    return !waiter.coroutine.expired();
+    return static_cast<bool>(waiter.coroutine);
 }
 
 /**
@@ -83,9 +85,9 @@ inline Fiber::ptr claim_waiter(CoroutineWaiterEntry *waiter) {
         return nullptr;
     }
 
-    return waiter->coroutine.lock();
+    return std::move(waiter->coroutine);
 }
 
 } // namespace zco
 
-#endif // ZCO_INTERNAL_COROUTINE_WAITER_H_
\ No newline at end of file
+#endif // ZCO_INTERNAL_COROUTINE_WAITER_H_
\ No newline at end of file
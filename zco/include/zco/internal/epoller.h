@@ -6,39 +6,53 @@
 #include <functional>
 #include <memory>
 #include <mutex>
-#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "zco/internal/poller.h"
 
+struct epoll_event;
+
 namespace zco {
 
 /**
  * @brief 单个 fd 的等待状态。
- * @details 同时维护读/写两个等待槽位，避免互相覆盖。
+ * @details
+ * - 同时维护读/写两个等待槽位，避免互相覆盖。
+ * - persistent 表示 fd 以 EPOLLET 常驻注册，此时不再随 waiter 增删调用
+ *   epoll_ctl，边沿事件到达而没有 waiter 时记录在 read_ready/write_ready。
  */
 struct FdWaitState {
     std::shared_ptr<IoWaiter> read_waiter;
     std::shared_ptr<IoWaiter> write_waiter;
     uint32_t registered_events;
     bool registered;
+    bool persistent;
+    bool read_ready;
+    bool write_ready;
 
     FdWaitState()
         : read_waiter(), write_waiter(), registered_events(0),
-          registered(false) {}
+          registered(false), persistent(false), read_ready(false),
+          write_ready(false) {}
 };
 
 /**
  * @brief epoll 封装器。
- * @details 统一管理 epoll 生命周期、eventfd 唤醒和 waiter 列表。
+ * @details
+ * - 统一管理 epoll 生命周期、eventfd 唤醒和 waiter 列表。
+ * - 普通 fd 按需水平触发注册；通过 attach_fd 接入的 fd 以边沿触发常驻
+ *   注册，直到 cancel_fd（co_close）才移除。
+ * - fd 状态存放在按 fd 下标索引的平坦数组中。
  */
 class Epoller : public Poller {
   public:
     /**
      * @brief 构造 epoller。
-     * @param 无参数。
+     * @param persistent_fds 是否允许 attach_fd 建立常驻边沿触发注册。
      * @return 无返回值。
      */
-    Epoller();
+    explicit Epoller(bool persistent_fds = true);
 
     /**
      * @brief 析构 epoller。
@@ -82,29 +96,66 @@ class Epoller : public Poller {
      */
     void unregister_waiter(const std::shared_ptr<IoWaiter> &waiter) override;
 
-    /**
-     * @brief 取消指定 fd 的所有 waiter。
-     * @param fd 文件描述符。
-     * @param error 写入 waiter 的错误码。
-     * @return 被取消的 waiter 列表。
-     */
-    std::vector<std::shared_ptr<IoWaiter>> cancel_fd(int fd,
-                                                     int error) override;
-
-    /**
-     * @brief 等待 IO 事件并回调处理。
-     * @param timeout_ms 等待超时毫秒。
-     * @param on_ready 事件就绪回调。
-     * @return 无返回值。
-     */
+    /**
+     * @brief 取消指定 fd 的所有 waiter。
+     * @param fd 文件描述符。
+     * @param error 写入 waiter 的错误码。
+     * @return 被取消的 waiter 列表。
+     */
+    std::vector<std::shared_ptr<IoWaiter>> cancel_fd(int fd,
+                                                     int error) override;
+
+    /**
+     * @brief 等待 IO 事件并回调处理。
+     * @param timeout_ms 等待超时毫秒。
+     * @param on_ready 事件就绪回调。
+     * @return 无返回值。
+     */
     void wait_events(
         int timeout_ms,
         const std::function<void(const std::shared_ptr<IoWaiter> &waiter,
                                  uint32_t ready_events)> &on_ready) override;
 
+    /**
+     * @brief 以 EPOLLIN|EPOLLOUT|EPOLLET 常驻注册 fd。
+     * @param fd 文件描述符。
+     * @return true 表示注册成功，之后等待该 fd 不再调用 epoll_ctl。
+     */
+    bool attach_fd(int fd) override;
+
+    /**
+     * @brief 获取后端名称。
+     * @param 无参数。
+     * @return 固定返回 "epoll"。
+     */
+    const char *name() const override;
+
+    /**
+     * @brief 获取累计系统调用次数。
+     * @param 无参数。
+     * @return epoll_ctl/epoll_wait/eventfd 读写的累计次数。
+     */
+    uint64_t syscall_count() const override;
+
   private:
     bool update_interest_locked(int fd, FdWaitState *state);
 
+    /**
+     * @brief 获取 fd 对应的状态槽位，数组不足时扩容。
+     * @param fd 文件描述符，调用方保证非负。
+     * @return 状态槽位引用。
+     */
+    FdWaitState &state_locked(int fd);
+
+    /**
+     * @brief 调用 epoll_ctl 并计入系统调用次数。
+     * @param op EPOLL_CTL_* 操作。
+     * @param fd 目标文件描述符。
+     * @param ev 事件描述，删除时可为 nullptr。
+     * @return epoll_ctl 的返回值。
+     */
+    int control(int op, int fd, epoll_event *ev);
+
     /**
      * @brief 清空 wake fd 中的唤醒计数。
      * @param 无参数。
@@ -116,8 +167,17 @@ class Epoller : public Poller {
     int wake_fd_;
     std::atomic<bool> wake_pending_;
 
+    const bool persistent_fds_;
+    // epoll_wait 期间为 true；其他线程投递立即就绪的 waiter 时据此决定
+    // 是否需要唤醒。
+    std::atomic<bool> polling_;
+
     std::mutex waiter_mutex_;
-    std::unordered_map<int, FdWaitState> fd_wait_states_;
+    std::vector<FdWaitState> fd_wait_states_; // 以 fd 为下标
+    // 注册时即已就绪（边沿已记录）的 waiter，下一次 wait_events 直接分发。
+    std::vector<std::pair<std::shared_ptr<IoWaiter>, uint32_t>> pending_ready_;
+
+    std::atomic<uint64_t> syscall_count_;
 };
 
 } // namespace zco
@@ -4,23 +4,28 @@
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
-#include <memory>
 
 #include "zco/internal/context.h"
+#include "zco/internal/fiber_local_slots.h"
+#include "zco/internal/intrusive_ptr.h"
 #include "zco/internal/noncopyable.h"
 #include "zco/sched.h"
 
 namespace zco {
 
 class Processor;
+class RunQueue;
+struct SpawnSite;
 
 /**
  * @brief 协程执行单元。
  * @details 负责维护协程上下文、状态机与共享栈快照。
+ * 生命周期由内嵌引用计数管理：处理器运行期间只借用裸指针，
+ * 就绪队列、等待器之间以移动方式交接引用。
  */
-class Fiber : public std::enable_shared_from_this<Fiber>, public NonCopyable {
+class Fiber : public NonCopyable {
   public:
-    using ptr = std::shared_ptr<Fiber>;
+    using ptr = IntrusivePtr<Fiber>;
 
     /**
      * @brief 协程状态。
@@ -66,6 +71,15 @@ class Fiber : public std::enable_shared_from_this<Fiber>, public NonCopyable {
      */
     void reset(int id, Task task, size_t stack_slot);
 
+    /**
+     * @brief 取走尚未运行的任务。
+     * @details 供缩容时把未切入过的协程还原成任务转交给其他调度器，
+     *          取走后协程应直接回收。
+     * @param 无参数。
+     * @return 任务函数。
+     */
+    Task take_task();
+
     /**
      * @brief 获取所属处理器。
      * @param 无参数。
@@ -173,6 +187,37 @@ class Fiber : public std::enable_shared_from_this<Fiber>, public NonCopyable {
      */
     void clear_timed_out();
 
+    /**
+     * @brief 请求取消协程。
+     * @details 设置取消标记；协程正处于可中断等待时按超时把它从等待态
+     * 改为就绪，调用方负责把它投递回所属处理器。
+     * @param 无参数。
+     * @return true 表示本次调用完成了唤醒，需要调用方入队。
+     */
+    bool request_cancel();
+
+    /**
+     * @brief 查询协程是否已被请求取消。
+     * @param 无参数。
+     * @return true 表示已请求取消。
+     */
+    bool cancel_requested() const;
+
+    /**
+     * @brief 进入可中断等待，需在 mark_waiting 之后调用。
+     * @param 无参数。
+     * @return false 表示进入前已被请求取消，调用方不应挂起。
+     */
+    bool begin_interruptible_wait();
+
+    /**
+     * @brief 离开可中断等待。
+     * @details 取消方正在唤醒时等它结束，保证其唤醒不会落到下一次等待上。
+     * @param 无参数。
+     * @return 无返回值。
+     */
+    void end_interruptible_wait();
+
     /**
      * @brief 执行协程入口函数。
      * @param 无参数。
@@ -230,7 +275,58 @@ class Fiber : public std::enable_shared_from_this<Fiber>, public NonCopyable {
      */
     void clear_saved_stack();
 
+    /**
+     * @brief 获取当前引用计数（仅用于诊断与测试）。
+     * @param 无参数。
+     * @return 引用数量。
+     */
+    uint32_t ref_count() const;
+
+    /**
+     * @brief 记录进入就绪队列的时刻。
+     * @details 只在开启调度追踪时写入，可由唤醒方线程调用。
+     * @param ready_ns 单调时钟纳秒值，0 表示未记录。
+     * @return 无返回值。
+     */
+    void set_ready_since_ns(uint64_t ready_ns);
+
+    /**
+     * @brief 取出并清除进入就绪队列的时刻。
+     * @param 无参数。
+     * @return 单调时钟纳秒值，未记录时为 0。
+     */
+    uint64_t take_ready_since_ns();
+
+    /**
+     * @brief 设置创建位置调用栈。
+     * @details 由携带调用栈的任务在运行期间设置，只在调度线程读写。
+     * @param site 调用栈，生命周期由任务持有；nullptr 表示清除。
+     * @return 无返回值。
+     */
+    void set_spawn_site(const SpawnSite *site);
+
+    /**
+     * @brief 获取创建位置调用栈。
+     * @param 无参数。
+     * @return 调用栈，未记录时返回 nullptr。
+     */
+    const SpawnSite *spawn_site() const;
+
+    /**
+     * @brief 获取协程局部变量槽位表。
+     * @details 值在任务返回后于协程内析构，复用前 reset 再清一次。
+     * @param 无参数。
+     * @return 槽位表。
+     */
+    FiberLocalSlots *local_slots();
+
   private:
+    friend class RunQueue;
+    friend void intrusive_ptr_add_ref(Fiber *fiber);
+    friend void intrusive_ptr_release(Fiber *fiber);
+
+    std::atomic<uint32_t> ref_count_;
+
     int id_;
     Processor *owner_;
     Task task_;
@@ -250,9 +346,30 @@ class Fiber : public std::enable_shared_from_this<Fiber>, public NonCopyable {
     bool context_initialized_;
     std::atomic<State> state_;
     std::atomic<bool> timed_out_;
+    std::atomic<bool> cancel_requested_;
+    std::atomic<uint8_t> interrupt_state_; // 见 fiber.cc 中的 kInterrupt*
     std::atomic<uint64_t> external_handle_id_; // 外部句柄 id，0 表示未注册
+    std::atomic<uint64_t> ready_since_ns_;     // 进入就绪队列的时刻
+    const SpawnSite *spawn_site_;              // 创建位置，仅追踪时设置
+    FiberLocalSlots local_slots_;              // FiberLocal 的值
+
+    // 就绪队列侵入式链接，只由 RunQueue 读写；入队期间链表节点即持有一份引用。
+    Fiber *run_queue_next_;
+    std::atomic<bool> run_queued_;
 };
 
+inline void intrusive_ptr_add_ref(Fiber *fiber) {
+    // 新引用总是由已有引用复制而来，不需要与其他内存操作建立顺序。
+    fiber->ref_count_.fetch_add(1, std::memory_order_relaxed);
+}
+
+inline void intrusive_ptr_release(Fiber *fiber) {
+    if (fiber->ref_count_.fetch_sub(1, std::memory_order_release) == 1) {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        delete fiber;
+    }
+}
+
 } // namespace zco
 
 #endif // ZCO_INTERNAL_FIBER_H_
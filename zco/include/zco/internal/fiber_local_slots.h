@@ -0,0 +1,127 @@
+#ifndef ZCO_INTERNAL_FIBER_LOCAL_SLOTS_H_
+#define ZCO_INTERNAL_FIBER_LOCAL_SLOTS_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "zco/internal/noncopyable.h"
+
+namespace zco {
+
+// 内联在 Fiber 里的槽位数，超过后按需分配溢出数组。
+constexpr uint32_t kInlineFiberLocalSlots = 4;
+
+/**
+ * @brief 协程局部变量的槽位表。
+ * @details
+ * - 每个 FiberLocal 在构造时分到一个下标，访问按下标直接取槽位，不查表、
+ *   不加锁；前 kInlineFiberLocalSlots 个槽位内联在对象里。
+ * - 槽位记录所属 FiberLocal 的 key，下标被回收复用后旧值按 key 识别并销毁。
+ * - 只由所属协程（或所属线程）访问，不做同步。
+ */
+class FiberLocalSlots : public NonCopyable {
+  public:
+    FiberLocalSlots();
+
+    ~FiberLocalSlots();
+
+    /**
+     * @brief 读取槽位中的值。
+     * @param index FiberLocal 下标。
+     * @param key FiberLocal 的唯一 key。
+     * @return 值指针，尚未构造或属于已销毁的 FiberLocal 时为 nullptr。
+     */
+    void *get(uint32_t index, uint64_t key) const {
+        const Slot *slot = find(index);
+        return slot && slot->key == key ? slot->value : nullptr;
+    }
+
+    /**
+     * @brief 写入槽位，原有的值先被销毁。
+     * @param index FiberLocal 下标。
+     * @param key FiberLocal 的唯一 key。
+     * @param value 新值，所有权转交给槽位表。
+     * @param destroy 销毁函数。
+     * @return 无返回值。
+     */
+    void emplace(uint32_t index, uint64_t key, void *value,
+                 void (*destroy)(void *));
+
+    /**
+     * @brief 销毁单个槽位中的值。
+     * @param index FiberLocal 下标。
+     * @param key FiberLocal 的唯一 key，不匹配时什么也不做。
+     * @return 无返回值。
+     */
+    void erase(uint32_t index, uint64_t key);
+
+    /**
+     * @brief 销毁全部值。
+     * @details 析构函数里再次写入的值会在下一轮一并销毁，最多重复
+     *          kClearRounds 轮，与 pthread 线程局部变量的处理一致。
+     * @param 无参数。
+     * @return 无返回值。
+     */
+    void clear();
+
+  private:
+    struct Slot {
+        uint64_t key = 0;
+        void *value = nullptr;
+        void (*destroy)(void *) = nullptr;
+    };
+
+    static constexpr int kClearRounds = 4;
+
+    const Slot *find(uint32_t index) const {
+        if (index < kInlineFiberLocalSlots) {
+            return &inline_slots_[index];
+        }
+        index -= kInlineFiberLocalSlots;
+        return index < overflow_size_ ? &overflow_[index] : nullptr;
+    }
+
+    Slot *find(uint32_t index) {
+        return const_cast<Slot *>(
+            static_cast<const FiberLocalSlots *>(this)->find(index));
+    }
+
+    Slot *slot_for_write(uint32_t index);
+
+    static void destroy_slot(Slot *slot);
+
+    Slot inline_slots_[kInlineFiberLocalSlots];
+    std::unique_ptr<Slot[]> overflow_;
+    uint32_t overflow_size_;
+    uint32_t used_; // 写过的最大下标加一，为 0 时 clear 直接返回
+};
+
+/**
+ * @brief 为新的 FiberLocal 分配下标与 key。
+ * @details 下标优先复用已销毁的 FiberLocal 留下的空位；key 全局递增，
+ *          永不复用。
+ * @param key 输出 key。
+ * @return 下标。
+ */
+uint32_t acquire_fiber_local_index(uint64_t *key);
+
+/**
+ * @brief 归还 FiberLocal 的下标。
+ * @param index 下标。
+ * @return 无返回值。
+ */
+void release_fiber_local_index(uint32_t index);
+
+/**
+ * @brief 获取当前上下文的槽位表。
+ * @details 协程内返回当前 Fiber 的槽位表，普通线程上返回线程私有的一份，
+ *          线程退出时销毁。
+ * @param 无参数。
+ * @return 槽位表。
+ */
+FiberLocalSlots *current_fiber_local_slots();
+
+} // namespace zco
+
+#endif // ZCO_INTERNAL_FIBER_LOCAL_SLOTS_H_
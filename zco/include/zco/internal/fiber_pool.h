@@ -23,9 +23,9 @@ class FiberPool : public NonCopyable {
 
     /**
      * @brief 回收 Fiber 对象
-     * @param fiber 待回收的 Fiber 对象
+     * @param fiber 待回收的 Fiber 对象，引用直接移入池中
      */
-    void recycle(const Fiber::ptr &fiber);
+    void recycle(Fiber::ptr fiber);
 
     /**
      * @brief 清空 Fiber 池，销毁所有 Fiber 对象
@@ -42,4 +42,4 @@ class FiberPool : public NonCopyable {
 
 } // namespace zco
 
-#endif // ZCO_INTERNAL_FIBER_POOL_H_
\ No newline at end of file
+#endif // ZCO_INTERNAL_FIBER_POOL_H_
\ No newline at end of file
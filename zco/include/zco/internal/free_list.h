@@ -0,0 +1,103 @@
+#ifndef ZCO_INTERNAL_FREE_LIST_H_
+#define ZCO_INTERNAL_FREE_LIST_H_
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+
+#include "zco/internal/noncopyable.h"
+
+namespace zco {
+
+/**
+ * @brief 单弹出方的无锁空闲链表。
+ * @details
+ * - 空闲内存块自身的一段充当链表节点，链表本身不分配内存。
+ * - pop() 只允许单线程调用（所属处理器线程），push() 可在任意线程调用；
+ *   只有一个弹出方，因此弹出时不存在 ABA 问题。
+ * - 长度是近似值，仅用于限流：归还方先 reserve() 占一个名额再 push()。
+ */
+class FreeList : public NonCopyable {
+  public:
+    FreeList() : head_(nullptr), size_(0) {}
+
+    /**
+     * @brief 为一次 push() 预占名额。
+     * @param limit 链表最多缓存的块数。
+     * @return true 表示占到名额，调用方随后必须 push()。
+     */
+    bool reserve(size_t limit) {
+        if (size_.fetch_add(1, std::memory_order_relaxed) >= limit) {
+            size_.fetch_sub(1, std::memory_order_relaxed);
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief 把空闲块挂到链表头。
+     * @param storage 节点所在的位置，至少容纳一个指针。
+     * @return 无返回值。
+     */
+    void push(void *storage) {
+        Node *node = new (storage) Node();
+        node->next = head_.load(std::memory_order_relaxed);
+        while (!head_.compare_exchange_weak(node->next, node,
+                                            std::memory_order_release,
+                                            std::memory_order_relaxed)) {
+        }
+    }
+
+    /**
+     * @brief 取出一个空闲块。
+     * @param 无参数。
+     * @return 节点所在的位置，链表为空时返回 nullptr。
+     */
+    void *pop() {
+        // 弹出方唯一，node 在 CAS 成功前不会被释放，读取 node->next 是安全的。
+        Node *node = head_.load(std::memory_order_acquire);
+        while (node &&
+               !head_.compare_exchange_weak(node, node->next,
+                                            std::memory_order_acquire,
+                                            std::memory_order_acquire)) {
+        }
+        if (node) {
+            size_.fetch_sub(1, std::memory_order_relaxed);
+        }
+        return node;
+    }
+
+    /**
+     * @brief 摘下全部空闲块并逐个交给 release，供析构时释放。
+     * @param release 接收节点位置的回调。
+     * @return 无返回值。
+     */
+    template <typename Release> void clear(Release release) {
+        Node *node = head_.exchange(nullptr, std::memory_order_acquire);
+        while (node) {
+            Node *next = node->next;
+            size_.fetch_sub(1, std::memory_order_relaxed);
+            release(static_cast<void *>(node));
+            node = next;
+        }
+    }
+
+    /**
+     * @brief 获取链表中的块数。
+     * @param 无参数。
+     * @return 近似值，并发归还时可能短暂偏差。
+     */
+    size_t size() const { return size_.load(std::memory_order_relaxed); }
+
+  private:
+    struct Node {
+        Node *next;
+    };
+
+    std::atomic<Node *> head_;
+    std::atomic<size_t> size_;
+};
+
+} // namespace zco
+
+#endif // ZCO_INTERNAL_FREE_LIST_H_
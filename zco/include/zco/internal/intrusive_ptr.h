@@ -0,0 +1,141 @@
+#ifndef ZCO_INTERNAL_INTRUSIVE_PTR_H_
+#define ZCO_INTERNAL_INTRUSIVE_PTR_H_
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+
+namespace zco {
+
+/**
+ * @brief 侵入式引用计数智能指针。
+ * @details
+ * - 计数存放在对象内部，T 需提供 ADL 可见的
+ *   intrusive_ptr_add_ref(T*) / intrusive_ptr_release(T*)。
+ * - 没有独立控制块，也没有弱引用计数；移动不触碰计数。
+ * - 可以从裸指针重新取得所有权，因此调度线程上可以只借用裸指针，
+ *   需要跨线程交出时再补一次计数。
+ */
+template <typename T> class IntrusivePtr {
+  public:
+    IntrusivePtr() noexcept : ptr_(nullptr) {}
+
+    IntrusivePtr(std::nullptr_t) noexcept : ptr_(nullptr) {}
+
+    /**
+     * @brief 从裸指针取得引用。
+     * @param ptr 目标对象。
+     * @param add_ref false 表示接管调用方已持有的一份计数。
+     */
+    explicit IntrusivePtr(T *ptr, bool add_ref = true) noexcept : ptr_(ptr) {
+        if (ptr_ && add_ref) {
+            intrusive_ptr_add_ref(ptr_);
+        }
+    }
+
+    IntrusivePtr(const IntrusivePtr &other) noexcept : ptr_(other.ptr_) {
+        if (ptr_) {
+            intrusive_ptr_add_ref(ptr_);
+        }
+    }
+
+    IntrusivePtr(IntrusivePtr &&other) noexcept : ptr_(other.ptr_) {
+        other.ptr_ = nullptr;
+    }
+
+    ~IntrusivePtr() {
+        if (ptr_) {
+            intrusive_ptr_release(ptr_);
+        }
+    }
+
+    IntrusivePtr &operator=(const IntrusivePtr &other) noexcept {
+        IntrusivePtr(other).swap(*this);
+        return *this;
+    }
+
+    IntrusivePtr &operator=(IntrusivePtr &&other) noexcept {
+        IntrusivePtr(std::move(other)).swap(*this);
+        return *this;
+    }
+
+    IntrusivePtr &operator=(std::nullptr_t) noexcept {
+        reset();
+        return *this;
+    }
+
+    void reset() noexcept { IntrusivePtr().swap(*this); }
+
+    /**
+     * @brief 放弃所有权但不减少计数。
+     * @return 原裸指针，调用方负责之后以 add_ref=false 接回。
+     */
+    T *detach() noexcept {
+        T *ptr = ptr_;
+        ptr_ = nullptr;
+        return ptr;
+    }
+
+    void swap(IntrusivePtr &other) noexcept { std::swap(ptr_, other.ptr_); }
+
+    T *get() const noexcept { return ptr_; }
+    T &operator*() const noexcept { return *ptr_; }
+    T *operator->() const noexcept { return ptr_; }
+    explicit operator bool() const noexcept { return ptr_ != nullptr; }
+
+  private:
+    T *ptr_;
+};
+
+template <typename T>
+inline bool operator==(const IntrusivePtr<T> &lhs, const IntrusivePtr<T> &rhs) {
+    return lhs.get() == rhs.get();
+}
+
+template <typename T>
+inline bool operator!=(const IntrusivePtr<T> &lhs, const IntrusivePtr<T> &rhs) {
+    return lhs.get() != rhs.get();
+}
+
+template <typename T>
+inline bool operator==(const IntrusivePtr<T> &lhs, std::nullptr_t) {
+    return !lhs;
+}
+
+template <typename T>
+inline bool operator==(std::nullptr_t, const IntrusivePtr<T> &rhs) {
+    return !rhs;
+}
+
+template <typename T>
+inline bool operator!=(const IntrusivePtr<T> &lhs, std::nullptr_t) {
+    return static_cast<bool>(lhs);
+}
+
+template <typename T>
+inline bool operator!=(std::nullptr_t, const IntrusivePtr<T> &rhs) {
+    return static_cast<bool>(rhs);
+}
+
+/**
+ * @brief 构造对象并返回持有唯一引用的 IntrusivePtr。
+ * @details 对象内部计数从 0 开始，由返回值补上第一份引用。
+ */
+template <typename T, typename... Args>
+inline IntrusivePtr<T> make_intrusive(Args &&...args) {
+    return IntrusivePtr<T>(new T(std::forward<Args>(args)...));
+}
+
+} // namespace zco
+
+namespace std {
+
+template <typename T> struct hash<zco::IntrusivePtr<T>> {
+    size_t operator()(const zco::IntrusivePtr<T> &ptr) const noexcept {
+        return hash<T *>()(ptr.get());
+    }
+};
+
+} // namespace std
+
+#endif // ZCO_INTERNAL_INTRUSIVE_PTR_H_
@@ -0,0 +1,205 @@
+#ifndef ZCO_INTERNAL_IO_URING_POLLER_H_
+#define ZCO_INTERNAL_IO_URING_POLLER_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "zco/internal/poller.h"
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+namespace zco {
+
+/**
+ * @brief 单个 fd 在 io_uring 上的轮询状态。
+ * @details 读/写方向各自维护 waiter、是否已有在途 poll 以及在途 poll 的
+ * 代际号，代际号用于丢弃已被替换或撤销的 poll 完成事件。
+ */
+struct FdPollState {
+    std::shared_ptr<IoWaiter> read_waiter;
+    std::shared_ptr<IoWaiter> write_waiter;
+    uint32_t read_generation;
+    uint32_t write_generation;
+    bool read_armed;
+    bool write_armed;
+
+    FdPollState()
+        : read_waiter(), write_waiter(), read_generation(0),
+          write_generation(0), read_armed(false), write_armed(false) {}
+};
+
+/**
+ * @brief io_uring 封装器。
+ * @details
+ * - 注册 waiter 时只把 POLL_ADD 写入提交队列，不触发系统调用。
+ * - wait_events 用一次 io_uring_enter 同时提交积攒的 SQE 并等待完成事件。
+ * - 唤醒 eventfd 通过 IORING_OP_READ 直接读取，完成即代表唤醒已消费。
+ * - 文件请求以 READ/WRITE/FSYNC/OPENAT 提交，与 poll 一起在下一次
+ *   wait_events 时进入内核。
+ */
+class IoUringPoller : public Poller {
+  public:
+    /**
+     * @brief 构造 io_uring poller。
+     * @param 无参数。
+     * @return 无返回值。
+     */
+    IoUringPoller();
+
+    /**
+     * @brief 析构 io_uring poller。
+     * @param 无参数。
+     * @return 无返回值。
+     */
+    ~IoUringPoller();
+
+    /**
+     * @brief 探测当前内核是否支持本实现依赖的 io_uring 能力。
+     * @param 无参数。
+     * @return true 表示可以使用 io_uring。
+     */
+    static bool supported();
+
+    /**
+     * @brief 初始化 io_uring 实例与 wake fd。
+     * @param 无参数。
+     * @return true 表示初始化成功。
+     */
+    bool start() override;
+
+    /**
+     * @brief 关闭 io_uring 并释放资源。
+     * @param 无参数。
+     * @return 无返回值。
+     */
+    void stop() override;
+
+    /**
+     * @brief 唤醒正在 io_uring_enter 等待的线程。
+     * @param 无参数。
+     * @return 无返回值。
+     */
+    void wake() override;
+
+    /**
+     * @brief 注册 waiter，并在需要时排队一个 POLL_ADD。
+     * @param waiter 等待请求对象。
+     * @return true 表示注册成功。
+     */
+    bool register_waiter(const std::shared_ptr<IoWaiter> &waiter) override;
+
+    /**
+     * @brief 解除 waiter 注册，仍在途的 poll 会被排队撤销。
+     * @param waiter 等待请求对象。
+     * @return 无返回值。
+     */
+    void unregister_waiter(const std::shared_ptr<IoWaiter> &waiter) override;
+
+    /**
+     * @brief 取消指定 fd 的所有 waiter，并立即提交撤销请求。
+     * @param fd 文件描述符。
+     * @param error 写入 waiter 的错误码。
+     * @return 被取消的 waiter 列表。
+     */
+    std::vector<std::shared_ptr<IoWaiter>> cancel_fd(int fd,
+                                                     int error) override;
+
+    /**
+     * @brief 把文件请求排入提交队列。
+     * @param request 文件请求，完成前由 poller 持有。
+     * @return true 表示已排队。
+     */
+    bool submit_file(const std::shared_ptr<FileRequest> &request) override;
+
+    /**
+     * @brief io_uring 的 poll 本身按需提交，不建立常驻注册。
+     * @param fd 文件描述符。
+     * @return 固定返回 false。
+     */
+    bool attach_fd(int fd) override;
+
+    /**
+     * @brief 批量提交并等待完成事件。
+     * @param timeout_ms 等待超时毫秒。
+     * @param on_ready 事件就绪回调。
+     * @return 无返回值。
+     */
+    void wait_events(
+        int timeout_ms,
+        const std::function<void(const std::shared_ptr<IoWaiter> &waiter,
+                                 uint32_t ready_events)> &on_ready) override;
+
+    const char *name() const override;
+
+    uint64_t syscall_count() const override;
+
+  private:
+    bool setup_ring();
+    void teardown_ring();
+
+    /**
+     * @brief 获取一个空闲 SQE，提交队列写满时先同步提交一次。
+     * @param 无参数。
+     * @return SQE 指针，失败返回 nullptr。
+     */
+    io_uring_sqe *next_sqe_locked();
+
+    /**
+     * @brief 发布 SQE 到提交队列尾部。
+     * @param 无参数。
+     * @return 无返回值。
+     */
+    void publish_sqe_locked();
+
+    bool queue_poll_locked(int fd, bool write, uint32_t generation);
+    void queue_poll_remove_locked(int fd, bool write, uint32_t generation);
+    bool queue_wake_read_locked();
+    void flush_locked();
+    void drop_state_if_idle_locked(int fd);
+
+    int enter(unsigned to_submit, unsigned min_complete, unsigned flags,
+              int timeout_ms);
+
+    int ring_fd_;
+    int wake_fd_;
+    std::atomic<bool> wake_pending_;
+    uint64_t wake_buffer_;
+
+    void *sq_ring_ptr_;
+    size_t sq_ring_size_;
+    void *cq_ring_ptr_;
+    size_t cq_ring_size_;
+    io_uring_sqe *sqes_;
+    size_t sqes_size_;
+
+    unsigned *sq_head_;
+    unsigned *sq_tail_;
+    unsigned *sq_array_;
+    unsigned sq_mask_;
+    unsigned sq_entries_;
+    unsigned sq_local_tail_;
+
+    unsigned *cq_head_;
+    unsigned *cq_tail_;
+    unsigned cq_mask_;
+    io_uring_cqe *cqes_;
+
+    std::mutex waiter_mutex_;
+    unsigned pending_submit_;
+    uint32_t next_generation_; // 全局递增，避免 fd 重用后误匹配旧完成事件
+    std::unordered_map<int, FdPollState> fd_poll_states_;
+    uint64_t next_file_id_;
+    std::unordered_map<uint64_t, std::shared_ptr<FileRequest>> file_requests_;
+
+    std::atomic<uint64_t> syscall_count_;
+};
+
+} // namespace zco
+
+#endif // ZCO_INTERNAL_IO_URING_POLLER_H_
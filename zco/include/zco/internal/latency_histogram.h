@@ -0,0 +1,64 @@
+#ifndef ZCO_INTERNAL_LATENCY_HISTOGRAM_H_
+#define ZCO_INTERNAL_LATENCY_HISTOGRAM_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "zco/internal/noncopyable.h"
+#include "zco/stats.h"
+
+namespace zco {
+
+/**
+ * @brief 单写者对数线性直方图。
+ * @details 每个 2 的幂区间再等分为 8 个子桶，相对误差不超过 12.5%，
+ * 覆盖整个 uint64_t 范围。只由所属调度线程写入，任意线程可以采样。
+ */
+class LatencyHistogram : public NonCopyable {
+  public:
+    static constexpr size_t kSubBucketBits = 3;
+    static constexpr size_t kSubBucketCount = size_t(1) << kSubBucketBits;
+    static constexpr size_t kBucketCount =
+        (64 - kSubBucketBits + 1) * kSubBucketCount;
+
+    LatencyHistogram();
+
+    /**
+     * @brief 记录一个样本，只能由所属线程调用。
+     * @param value 样本值，通常为纳秒。
+     * @return 无返回值。
+     */
+    void record(uint64_t value);
+
+    /**
+     * @brief 采集当前分布。
+     * @param out 输出快照，桶数组被整体覆盖。
+     * @return 无返回值。
+     */
+    void snapshot(LatencyHistogramStats *out) const;
+
+    /**
+     * @brief 计算样本所在桶。
+     * @param value 样本值。
+     * @return 桶下标。
+     */
+    static size_t bucket_index(uint64_t value);
+
+    /**
+     * @brief 获取桶内能容纳的最大值。
+     * @param index 桶下标。
+     * @return 桶上界（含）。
+     */
+    static uint64_t bucket_upper_bound(size_t index);
+
+  private:
+    std::atomic<uint64_t> buckets_[kBucketCount];
+    std::atomic<uint64_t> count_;
+    std::atomic<uint64_t> sum_;
+    std::atomic<uint64_t> max_;
+};
+
+} // namespace zco
+
+#endif // ZCO_INTERNAL_LATENCY_HISTOGRAM_H_
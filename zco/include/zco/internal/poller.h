@@ -5,6 +5,7 @@
 #include <cstdint>
 #include <functional>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "zco/internal/fiber.h"
@@ -20,12 +21,33 @@ namespace zco {
 struct IoWaiter {
     int fd;
     uint32_t events;
-    std::weak_ptr<Fiber> fiber;
+    Fiber::ptr fiber; // 等待期间持有引用，唤醒路径无需 weak_ptr::lock
     std::shared_ptr<TimerToken> timer;
     std::atomic<bool> active;
     std::atomic<int> error;
 };
 
+/**
+ * @brief 单次文件操作请求。
+ * @details 由处理器提交给 poller，完成后 poller 写入 result，再经
+ * wait_events 的 on_ready 交回 waiter。请求在完成前由 poller 持有，
+ * 缓冲区与路径须在此期间保持有效，且不能位于共享栈上。
+ */
+struct FileRequest {
+    enum class Op : uint8_t { kOpen, kRead, kWrite, kFsync, kFdatasync };
+
+    Op op = Op::kRead;
+    int fd = -1;
+    void *buffer = nullptr;
+    size_t length = 0;
+    int64_t offset = 0;
+    std::string path; // kOpen 使用
+    int flags = 0;    // kOpen 使用
+    uint32_t mode = 0;
+    int64_t result = 0; // 成功为非负返回值，失败为 -errno
+    std::shared_ptr<IoWaiter> waiter;
+};
+
 /**
  * @brief IO 多路复用抽象。
  * @details 统一管理等待器注册、唤醒与事件分发。
@@ -44,6 +66,28 @@ class Poller : public NonCopyable {
     virtual std::vector<std::shared_ptr<IoWaiter>> cancel_fd(int fd,
                                                              int error) = 0;
 
+    /**
+     * @brief 为 fd 建立常驻注册
+     * @details 处理器首次等待经 co_socket/co_accept 创建的 fd 时调用，
+     * 之后的等待不再逐次修改内核兴趣集合；常驻注册在 cancel_fd 时移除，
+     * 重复调用应是无开销的。后端不支持时返回 false，fd 仍按普通方式等待。
+     * @param fd 文件描述符
+     * @return true 表示已建立常驻注册
+     */
+    virtual bool attach_fd(int fd) = 0;
+
+    /**
+     * @brief 提交文件操作
+     * @details 普通文件对就绪通知总是可读写，只有能异步执行文件操作的
+     * 后端才接受请求；完成事件随 wait_events 交回。
+     * @param request 文件请求
+     * @return false 表示后端不支持，调用方改用阻塞线程池
+     */
+    virtual bool submit_file(const std::shared_ptr<FileRequest> &request) {
+        (void)request;
+        return false;
+    }
+
     /**
      * @brief 等待 I/O 事件
      * @param timeout_ms 超时时间（毫秒）
@@ -53,8 +97,27 @@ class Poller : public NonCopyable {
         int timeout_ms,
         const std::function<void(const std::shared_ptr<IoWaiter> &waiter,
                                  uint32_t ready_events)> &on_ready) = 0;
+
+    /**
+     * @brief 获取后端名称
+     * @return "epoll" 或 "io_uring"
+     */
+    virtual const char *name() const = 0;
+
+    /**
+     * @brief 获取后端累计发起的系统调用次数
+     * @return 系统调用次数，仅统计 poller 自身发起的调用
+     */
+    virtual uint64_t syscall_count() const = 0;
 };
 
+/**
+ * @brief 创建默认 poller
+ * @details 内核支持时优先使用 io_uring，否则回退到 epoll；
+ * 环境变量 ZCO_POLLER=epoll|io_uring 可以强制指定后端，
+ * ZCO_EPOLL_PERSISTENT=0 关闭 epoll 的常驻边沿触发注册。
+ * @return poller 实例
+ */
 std::unique_ptr<Poller> create_default_poller();
 
 } // namespace zco
@@ -6,19 +6,25 @@
 #include <deque>
 #include <functional>
 #include <memory>
-#include <mutex>
 #include <thread>
+#include <vector>
 
 #include "zco/internal/context.h"
 #include "zco/internal/fiber.h"
 #include "zco/internal/fiber_pool.h"
+#include "zco/internal/latency_histogram.h"
 #include "zco/internal/noncopyable.h"
 #include "zco/internal/poller.h"
+#include "zco/internal/run_queue.h"
 #include "zco/internal/shared_stack_buffer.h"
 #include "zco/internal/snapshot_buffer_pool.h"
+#include "zco/internal/stack_allocator.h"
 #include "zco/internal/steal_queue.h"
 #include "zco/internal/timer.h"
+#include "zco/internal/topology.h"
+#include "zco/internal/watchdog.h"
 #include "zco/sched.h"
+#include "zco/stats.h"
 
 namespace zco {
 
@@ -54,6 +60,58 @@ class Processor : public NonCopyable {
      */
     ~Processor();
 
+    /**
+     * @brief 设置处理器线程的 CPU 与 NUMA 节点。
+     * @details 须在 start() 之前调用；线程启动后绑定 CPU、设置线程内存
+     * 策略并迁移共享栈，之后在该线程上创建的 Fiber、独立栈与 FiberPool
+     * 缓存都落在本节点。
+     * @param placement 放置结果，cpu 为 -1 表示不绑定。
+     * @return 无返回值。
+     */
+    void set_placement(const CpuPlacement &placement);
+
+    /**
+     * @brief 获取绑定的 NUMA 节点。
+     * @param 无参数。
+     * @return 节点编号，未绑定返回 -1。
+     */
+    int numa_node() const;
+
+    /**
+     * @brief 设置调度追踪。
+     * @details 须在 start() 之前调用。
+     * @param options 追踪配置，见 co_sched_trace。
+     * @return 无返回值。
+     */
+    void set_trace(const SchedTraceOptions &options);
+
+    /**
+     * @brief 查询正在运行的片段。
+     * @details 只在开启慢片段检测或延迟直方图时有效，供看门狗线程读取。
+     * @param begin_ns 输出片段起点。
+     * @param fiber_id 输出正在运行的协程编号。
+     * @return true 表示当前有协程在运行。
+     */
+    bool running_slice(uint64_t *begin_ns, int *fiber_id) const;
+
+    /**
+     * @brief 登记正在运行片段的创建位置，供看门狗跨线程读取。
+     * @details 只能在调度线程上调用；没有正在计时的片段时忽略。
+     * @param site 当前协程的创建位置。
+     * @return 无返回值。
+     */
+    void publish_spawn_site(const SpawnSite *site);
+
+    /**
+     * @brief 读取正在运行片段的创建位置。
+     * @details 按 running_slice 返回的片段起点校验，读取期间片段切换时
+     *          返回 false，不会拿到其他片段的调用栈。
+     * @param begin_ns 片段起点。
+     * @param site 输出调用栈副本。
+     * @return true 表示读到了该片段的创建位置。
+     */
+    bool running_spawn_site(uint64_t begin_ns, SpawnSite *site) const;
+
     /**
      * @brief 启动处理器线程。
      * @param 无参数。
@@ -75,6 +133,37 @@ class Processor : public NonCopyable {
      */
     void join();
 
+    /**
+     * @brief 开始缩容。
+     * @details 处理器不再实体化新任务，积压任务和尚未运行过的协程转交给
+     * 其他调度器；已经运行过的协程栈绑定在本处理器上，留在原地运行结束。
+     * 之后没有存活协程和定时器时线程退出，poller 保留到析构。
+     * @param 无参数。
+     * @return 无返回值。
+     */
+    void begin_drain();
+
+    /**
+     * @brief 撤销尚未完成的缩容。
+     * @param 无参数。
+     * @return true 表示已恢复为活跃，false 表示线程已经退役。
+     */
+    bool cancel_drain();
+
+    /**
+     * @brief 重新启动已退役的处理器。
+     * @param 无参数。
+     * @return 无返回值。
+     */
+    void restart();
+
+    /**
+     * @brief 判断是否处于缩容中或已退役。
+     * @param 无参数。
+     * @return true 表示不再接收新任务。
+     */
+    bool draining() const;
+
     /**
      * @brief 提交待创建任务。
      * @param task 任务函数。
@@ -82,6 +171,14 @@ class Processor : public NonCopyable {
      */
     void enqueue_task(Task task);
 
+    /**
+     * @brief 批量提交待创建任务，整批最多唤醒一次事件循环。
+     * @param tasks 任务数组，提交后元素被移走，不能包含空任务。
+     * @param count 任务数量。
+     * @return 无返回值。
+     */
+    void enqueue_task_batch(Task *tasks, size_t count);
+
     /**
      * @brief 将 Fiber 放入就绪队列。
      * @param fiber 协程对象。
@@ -96,7 +193,7 @@ class Processor : public NonCopyable {
      * @param min_reserve 给受害者保留的最小任务数。
      * @return 实际窃取数量。
      */
-    size_t steal_tasks(std::deque<Task> *tasks, size_t max_steal,
+    size_t steal_tasks(std::vector<Task> *tasks, size_t max_steal,
                        size_t min_reserve);
 
     /**
@@ -106,6 +203,22 @@ class Processor : public NonCopyable {
      */
     uint32_t pending_task_count() const;
 
+    /**
+     * @brief 把全部待创建任务转交给活跃调度器。
+     * @details 可在任意线程调用，供缩容与退役后的投递方兜底使用。
+     * @param 无参数。
+     * @return 转交的任务数。
+     */
+    size_t hand_off_pending_tasks();
+
+    /**
+     * @brief 若处理器正阻塞在 poller 上则唤醒它。
+     * @details 同一次空闲最多被唤醒一次，供其他处理器积压时拉起窃取方。
+     * @param 无参数。
+     * @return true 表示本次调用完成了唤醒。
+     */
+    bool wake_if_idle();
+
     /**
      * @brief 获取处理器编号。
      * @param 无参数。
@@ -116,16 +229,23 @@ class Processor : public NonCopyable {
     /**
      * @brief 获取当前运行 Fiber。
      * @param 无参数。
-     * @return 当前 Fiber 指针。
+     * @return 当前 Fiber 裸指针（借用，运行循环持有引用）。
      */
-    Fiber::ptr current_fiber() const;
+    Fiber *current_fiber() const;
 
     /**
      * @brief 获取调度器上下文。
      * @param 无参数。
      * @return 上下文指针。
      */
-    ucontext_t *scheduler_context();
+    Context *scheduler_context();
+
+    /**
+     * @brief 获取处理器使用的 IO 多路复用后端。
+     * @param 无参数。
+     * @return poller 指针，处理器未启动时可能为空。
+     */
+    const Poller *poller() const;
 
     /**
      * @brief 当前 Fiber 主动让出执行权。
@@ -150,7 +270,8 @@ class Processor : public NonCopyable {
 
     /**
      * @brief 挂起当前 Fiber 并设置超时。
-     * @param milliseconds 超时毫秒。
+     * @details 可被 Fiber::request_cancel 中断，中断按超时返回。
+     * @param milliseconds 超时毫秒，kInfiniteTimeoutMs 表示只等唤醒或取消。
      * @return true 表示非超时恢复。
      */
     bool park_current_for(uint32_t milliseconds);
@@ -166,6 +287,7 @@ class Processor : public NonCopyable {
 
     /**
      * @brief 等待 fd 事件。
+     * @details 可被 Fiber::request_cancel 中断，中断时 errno 为 ECANCELED。
      * @param fd 文件描述符。
      * @param events 事件掩码。
      * @param milliseconds 超时毫秒。
@@ -173,6 +295,32 @@ class Processor : public NonCopyable {
      */
     bool wait_fd(int fd, uint32_t events, uint32_t milliseconds);
 
+    /**
+     * @brief 为当前 Fiber 登记 fd 等待但不挂起。
+     * @details 供 select 与其他等待源一起挂起：调用方需先
+     *          prepare_wait_current()，恢复后调用 unregister_fd_wait()。
+     *          IO 路径消费 waiter 时把 active 置为 false。
+     * @param fd 文件描述符。
+     * @param events 事件掩码。
+     * @return 等待对象，失败返回 nullptr 并设置 errno。
+     */
+    std::shared_ptr<IoWaiter> register_fd_wait(int fd, uint32_t events);
+
+    /**
+     * @brief 撤销 register_fd_wait() 的登记。
+     * @param waiter 等待对象。
+     * @return true 表示 IO 路径已消费该等待（事件到达或被取消）。
+     */
+    bool unregister_fd_wait(const std::shared_ptr<IoWaiter> &waiter);
+
+    /**
+     * @brief 把文件操作交给 poller 异步执行，挂起当前 Fiber 直到完成。
+     * @details 不响应取消；完成后结果在 request->result 中。
+     * @param request 文件请求。
+     * @return false 表示 poller 不支持文件操作，请求未提交。
+     */
+    bool run_file_request(const std::shared_ptr<FileRequest> &request);
+
     /**
      * @brief 取消指定 fd 上挂起的 IO 等待。
      * @param fd
@@ -234,6 +382,21 @@ class Processor : public NonCopyable {
      */
     uint64_t load_score() const;
 
+    /**
+     * @brief 获取共享栈快照拷贝统计。
+     * @param 无参数。
+     * @return 自处理器创建以来的累计值。
+     */
+    StackCopyStats stack_copy_stats() const;
+
+    /**
+     * @brief 采集运行统计快照。
+     * @details 只读取原子计数，可在任意线程调用。
+     * @param 无参数。
+     * @return 统计快照。
+     */
+    ProcessorStats stats() const;
+
     /**
      * @brief 申请分档快照缓冲。
      * @param required_size 需要容量。
@@ -254,7 +417,31 @@ class Processor : public NonCopyable {
     void release_snapshot_buffer(char *buffer, uint8_t bucket_index,
                                  size_t capacity);
 
+    /**
+     * @brief 申请带 guard 页的独立栈。
+     * @param stack_size 需要的可用大小。
+     * @return 栈的最低可用地址，可用大小为 StackAllocator::round_size()。
+     */
+    char *acquire_independent_stack(size_t stack_size);
+
+    /**
+     * @brief 归还独立栈，可在任意线程调用。
+     * @param stack 栈地址。
+     * @param stack_size 申请时传入的大小。
+     * @return 无返回值。
+     */
+    void release_independent_stack(char *stack, size_t stack_size);
+
   private:
+    /**
+     * @brief 以可中断方式挂起当前 Fiber。
+     * @details 调用前需已 prepare_wait_current()；进入前已被取消时不切换，
+     *          直接按超时返回。
+     * @param 无参数。
+     * @return true 表示非超时、非取消恢复。
+     */
+    bool park_interruptible();
+
     /**
      * @brief 处理器主循环。
      * @param 无参数。
@@ -269,6 +456,40 @@ class Processor : public NonCopyable {
      */
     void wake_loop();
 
+    /**
+     * @brief 其他线程投递之后按需唤醒调度循环。
+     * @details 先用栅栏与 enter_idle 配对，再只在处理器已标记空闲时写
+     *          唤醒 fd；未空闲的处理器在阻塞前会重新检查队列。
+     * @param 无参数。
+     * @return 无返回值。
+     */
+    void notify_remote();
+
+    /**
+     * @brief 积压时请求其他处理器来窃取。
+     * @details 已有处理器在自旋找活时不再唤醒空闲处理器。
+     * @param 无参数。
+     * @return 无返回值。
+     */
+    void request_thief();
+
+    /**
+     * @brief 阻塞前先自旋等待新任务。
+     * @details 自旋期间间歇窃取，超过 kIdleSpinNs 或运行时已有足够多的
+     *          处理器在自旋时放弃。
+     * @param 无参数。
+     * @return true 表示自旋期间等到了任务。
+     */
+    bool spin_when_idle();
+
+    /**
+     * @brief 标记进入/离开空闲等待，并同步运行时的空闲计数。
+     * @param 无参数。
+     * @return 无返回值。
+     */
+    void enter_idle();
+    void leave_idle();
+
     /**
      * @brief 拉取待创建任务并实例化 Fiber。
      * @param 无参数。
@@ -291,6 +512,22 @@ class Processor : public NonCopyable {
      */
     size_t drain_ready_fibers(std::deque<Fiber::ptr> *fibers, size_t max_count);
 
+    /**
+     * @brief 执行单个就绪 Fiber 并按切回后的状态分发。
+     * @param fiber 待执行的 Fiber。
+     * @return 无返回值。
+     */
+    void run_fiber(Fiber::ptr fiber);
+
+    /**
+     * @brief 连续执行 next 槽位中被刚运行的 Fiber 唤醒的 Fiber。
+     * @details 连续次数有上限，超过后把槽位移回队尾，避免互相唤醒的
+     * 一对 Fiber 饿死队列中的其他 Fiber。
+     * @param 无参数。
+     * @return 无返回值。
+     */
+    void run_next_fibers();
+
     /**
      * @brief 执行单个 Fiber。
      * @param fiber 待执行的 Fiber。
@@ -305,6 +542,28 @@ class Processor : public NonCopyable {
      */
     Fiber::ptr switch_to_fiber(Fiber::ptr fiber);
 
+    /**
+     * @brief 登记运行片段起点并记录就绪等待时间。
+     * @param fiber 即将切入的 Fiber。
+     * @return 片段起点。
+     */
+    uint64_t begin_slice(Fiber *fiber);
+
+    /**
+     * @brief 结束运行片段，记录片段时长并检查是否过长。
+     * @param fiber 刚切回的 Fiber。
+     * @param begin_ns 片段起点。
+     * @return 无返回值。
+     */
+    void end_slice(Fiber *fiber, uint64_t begin_ns);
+
+    /**
+     * @brief 在协程进入就绪队列时打点。
+     * @param fiber 进入就绪队列的 Fiber。
+     * @return 无返回值。
+     */
+    void stamp_ready(Fiber *fiber) const;
+
     /**
      * @brief 切换后最终化处理。
      * @param fiber Fiber 对象。
@@ -320,6 +579,27 @@ class Processor : public NonCopyable {
      */
     void dispatch_resumed_fiber(Fiber::ptr fiber, Fiber::State state);
 
+    /**
+     * @brief 缩容中转交任务，条件满足时退役。
+     * @param 无参数。
+     * @return true 表示已退役，调度循环应退出。
+     */
+    bool hand_off_when_draining();
+
+    /**
+     * @brief 把尚未运行过的就绪协程还原成任务转交出去。
+     * @param 无参数。
+     * @return 无返回值。
+     */
+    void hand_off_unstarted_fibers();
+
+    /**
+     * @brief 判断缩容是否可以收尾。
+     * @param 无参数。
+     * @return true 表示没有存活协程与定时器。
+     */
+    bool drain_complete() const;
+
     /**
      * @brief 检查是否有就绪或待创建任务。
      * @param 无参数。
@@ -336,9 +616,22 @@ class Processor : public NonCopyable {
 
     /**
      * @brief 在空闲时窃取其他处理器的任务。
+     * @details 绑定了 NUMA 节点时先在同节点内窃取，失败后再跨节点。
      */
     void steal_tasks_when_idle();
 
+    /**
+     * @brief 从两个探测到的受害者中窃取一批任务。
+     * @param all 全部处理器。
+     * @param count 已发布的处理器数量。
+     * @param same_node_only 是否只考虑同节点处理器。
+     * @param stolen_batch 输出任务队列。
+     * @return 无返回值。
+     */
+    void steal_from_victims(const std::vector<std::unique_ptr<Processor>> &all,
+                            size_t count, bool same_node_only,
+                            std::vector<Task> *stolen_batch);
+
     /**
      * @brief 更新负载评估指标。
      * @param loop_ns 本次调度循环耗时（纳秒）。
@@ -398,14 +691,14 @@ class Processor : public NonCopyable {
      * @brief 回收 Fiber 对象
      * @param fiber 待回收的 Fiber 对象
      */
-    void recycle_fiber(const Fiber::ptr &fiber);
+    void recycle_fiber(Fiber::ptr fiber);
 
     /**
      * @brief 将窃取的任务加入待创建队列。
      * @param tasks 待加入的任务队列。
      * @return 无返回值。
      */
-    void enqueue_stolen_tasks(std::deque<Task> *tasks);
+    void enqueue_stolen_tasks(std::vector<Task> *tasks);
 
     /**
      * @brief 将就绪的 Fiber 批量加入就绪队列。
@@ -417,25 +710,76 @@ class Processor : public NonCopyable {
     int id_;
     const size_t stack_size_;
     const StackModel stack_model_;
+    CpuPlacement placement_; // start() 之前写入，之后只读
     std::atomic<bool> running_;
+    std::atomic<bool> idle_; // 阻塞在 poller 上且尚未被唤醒
     std::thread worker_;
 
-    std::atomic<uint32_t>
-        ready_size_; // 就绪队列长度，近似值仅供负载评估，不强求精确
+    // 缩容状态：活跃 -> 缩容中 -> 退役，缩容中可以撤销回活跃。
+    enum DrainState { kActive = 0, kDraining = 1, kRetired = 2 };
+    std::atomic<int> drain_state_;
+    std::atomic<uint64_t> live_fibers_; // 已实体化且尚未回收的协程数
+    bool poller_started_;               // 只由调度线程读写，退役后重启时沿用
+
     std::atomic<uint64_t> cpu_time_ns_; // 累计运行时间，纳秒级，供负载评估使用
     std::atomic<uint64_t>
         ema_loop_ns_; // 调度循环平均耗时，纳秒级，供负载评估使用
 
-    mutable std::mutex run_queue_mutex_;
-    std::deque<Fiber::ptr> run_queue_;
+    RunQueue run_queue_;
 
     StealQueue steal_queue_;
+    std::vector<Task> task_batch_; // 实体化新任务的暂存区，只由调度线程复用
 
     FiberPool fiber_pool_;
     std::atomic<size_t> next_stack_slot_; // 下一个共享栈槽位，循环使用，配合
                                           // steal_probe_cursor_ 实现负载均衡
 
     SnapshotBufferPool snapshot_pool_;
+    StackAllocator stack_allocator_;
+
+    // 共享栈拷贝计数，只由调度线程写入，其他线程可随时读取。
+    std::atomic<uint64_t> stack_save_count_;
+    std::atomic<uint64_t> stack_saved_bytes_;
+    std::atomic<uint64_t> stack_restore_count_;
+    std::atomic<uint64_t> stack_restored_bytes_;
+
+    // 运行统计，同样只由调度线程写入。
+    std::atomic<uint64_t> context_switches_;
+    std::atomic<uint64_t> yields_;
+    std::atomic<uint64_t> parks_;
+    std::atomic<uint64_t> local_wakeups_;
+    std::atomic<uint64_t> steals_in_;
+    std::atomic<uint64_t> io_waits_;
+    std::atomic<uint64_t> io_wakeups_;
+    std::atomic<uint64_t> idle_waits_;
+    std::atomic<uint64_t> idle_wait_ns_;
+    std::atomic<uint64_t> idle_spins_;
+    std::atomic<uint64_t> idle_spin_hits_;
+    std::atomic<uint64_t> timer_fires_;
+    std::atomic<uint64_t> fiber_pool_hits_;
+    std::atomic<uint64_t> fiber_pool_misses_;
+
+    // 由其他线程累加的统计，单独占一条缓存行，不与调度线程的计数争用。
+    alignas(64) std::atomic<uint64_t> remote_wakeups_;
+    std::atomic<uint64_t> steals_out_;
+    std::atomic<uint64_t> wakes_avoided_;
+    // 两次 poller 等待之间是否已省掉过唤醒：poller 的 wake_pending_ 本来就
+    // 把这期间的重复唤醒合并成一次写入，只有第一次算真正省掉的系统调用。
+    std::atomic<bool> wake_skipped_;
+
+    // 调度追踪，配置在 start() 之前写入，之后只读。
+    bool trace_latency_;
+    bool slice_timing_; // 开启直方图或慢片段检测时在切换前后读时钟
+    uint64_t long_slice_ns_;
+    LatencyHistogram ready_latency_;
+    LatencyHistogram run_slice_;
+    std::atomic<uint64_t> long_slices_;
+    std::atomic<uint64_t> slice_begin_ns_; // 正在运行片段的起点，0 表示空闲
+    std::atomic<int> slice_fiber_id_;
+    // 正在运行片段的创建位置副本，按片段起点做 seqlock 校验。
+    std::atomic<uint64_t> slice_site_begin_ns_;
+    std::atomic<int> slice_site_depth_;
+    std::atomic<void *> slice_site_frames_[SpawnSite::kMaxFrames];
 
     size_t
         steal_probe_cursor_; // 窃取探测游标，轮询选择窃取对象，避免总是从同一处理器窃取导致负载不均
@@ -446,7 +790,8 @@ class Processor : public NonCopyable {
     SharedStackPool shared_stacks_;
 
     Context scheduler_context_;
-    Fiber::ptr current_fiber_;
+    // 运行循环栈上的 Fiber::ptr 在切换期间保持引用，这里只借用裸指针。
+    Fiber *current_fiber_;
 };
 
 /**
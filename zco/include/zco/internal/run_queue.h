@@ -0,0 +1,96 @@
+#ifndef ZCO_INTERNAL_RUN_QUEUE_H_
+#define ZCO_INTERNAL_RUN_QUEUE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <deque>
+
+#include "zco/internal/fiber.h"
+#include "zco/internal/noncopyable.h"
+
+namespace zco {
+
+/**
+ * @brief 处理器就绪队列
+ * @details
+ * - 侵入式 MPSC 队列：链接指针嵌在 Fiber 内，入队不分配内存。
+ * - 其他线程唤醒的 Fiber 只做一次无锁注入栈 CAS；owner 消费时整批
+ *   取走并翻转成 FIFO 接到本地链表尾部。
+ * - owner 线程入队直接写本地链表，不触碰原子变量以外的共享状态。
+ * - next 槽位保存“下一个运行”的 Fiber（LIFO），新放入的会把旧的挤到
+ *   本地链表尾部。
+ * - 同一个 Fiber 已在队列中时重复入队会被忽略。
+ */
+class RunQueue : public NonCopyable {
+  public:
+    RunQueue();
+    ~RunQueue();
+
+    /**
+     * @brief 从任意线程投递就绪 Fiber
+     * @param fiber 就绪 Fiber
+     * @return true 表示入队，false 表示为空或已在队列中
+     */
+    bool push(Fiber::ptr fiber);
+
+    /**
+     * @brief 由 owner 线程投递就绪 Fiber 到本地链表尾部
+     * @param fiber 就绪 Fiber
+     * @return true 表示入队，false 表示为空或已在队列中
+     */
+    bool push_local(Fiber::ptr fiber);
+
+    /**
+     * @brief 由 owner 线程放入 next 槽位
+     * @details 槽位原有的 Fiber 会被移到本地链表尾部。
+     * @param fiber 就绪 Fiber
+     * @return true 表示入队，false 表示为空或已在队列中
+     */
+    bool push_next(Fiber::ptr fiber);
+
+    /**
+     * @brief 取出 next 槽位中的 Fiber，仅限 owner 线程调用
+     * @return 槽位为空时返回 nullptr
+     */
+    Fiber::ptr take_next();
+
+    /**
+     * @brief 按 FIFO 取出一个 Fiber，不含 next 槽位，仅限 owner 线程调用
+     * @return 队列为空时返回 nullptr
+     */
+    Fiber::ptr pop();
+
+    /**
+     * @brief 批量取出 Fiber，先取 next 槽位再按 FIFO，仅限 owner 线程调用
+     * @param fibers 输出队列
+     * @param max_count 最大取出数量
+     * @return 实际取出数量
+     */
+    size_t drain(std::deque<Fiber::ptr> *fibers, size_t max_count);
+
+    /**
+     * @brief 获取近似长度，可在任意线程调用
+     * @return 队列长度
+     */
+    size_t size() const;
+
+    bool empty() const;
+
+  private:
+    bool acquire_node(Fiber *node, Fiber::ptr *fiber);
+    Fiber::ptr release_node(Fiber *node);
+    void append_local(Fiber *node);
+    void transfer_injected();
+
+    alignas(64) std::atomic<Fiber *> inject_head_;
+    alignas(64) std::atomic<size_t> size_;
+
+    // 以下成员只由 owner 线程访问。
+    Fiber *local_head_;
+    Fiber *local_tail_;
+    Fiber *next_;
+};
+
+} // namespace zco
+
+#endif // ZCO_INTERNAL_RUN_QUEUE_H_
@@ -14,7 +14,9 @@
 #include "zco/internal/noncopyable.h"
 #include "zco/internal/processor.h"
 #include "zco/internal/timer.h"
+#include "zco/internal/watchdog.h"
 #include "zco/sched.h"
+#include "zco/stats.h"
 
 namespace zco {
 
@@ -64,6 +66,43 @@ class Runtime : public NonCopyable {
      */
     bool set_stack_model(StackModel stack_model);
 
+    /**
+     * @brief 设置是否启用 NUMA 拓扑感知。
+     * @details 仅在运行时未启动时生效。
+     * @param enable true 表示绑定 CPU 并按节点分组处理器。
+     * @return true 表示设置成功。
+     */
+    bool set_numa_aware(bool enable);
+
+    /**
+     * @brief 获取是否启用 NUMA 拓扑感知。
+     * @param 无参数。
+     * @return true 表示启用。
+     */
+    bool numa_aware() const;
+
+    /**
+     * @brief 设置调度追踪。
+     * @details 仅在运行时未启动时生效。
+     * @param options 追踪配置。
+     * @return true 表示设置成功。
+     */
+    bool set_sched_trace(const SchedTraceOptions &options);
+
+    /**
+     * @brief 汇总全部处理器的共享栈拷贝统计。
+     * @param 无参数。
+     * @return 累计值，运行时未启动时全零。
+     */
+    StackCopyStats stack_copy_stats() const;
+
+    /**
+     * @brief 采集每个调度器的运行统计。
+     * @param 无参数。
+     * @return 统计快照，运行时未启动时为空。
+     */
+    RuntimeStats stats() const;
+
     /**
      * @brief 获取当前配置的共享栈数量。
      * @param 无参数。
@@ -107,6 +146,43 @@ class Runtime : public NonCopyable {
      */
     void submit_to(size_t scheduler_index, Task task);
 
+    /**
+     * @brief 批量投递任务。
+     * @details 任务按提交顺序切成连续的几段，每个处理器整段入队一次，
+     * 最多被唤醒一次；空任务被跳过。
+     * @param tasks 任务数组，投递后元素被移走。
+     * @param count 任务数量。
+     * @return 无返回值。
+     */
+    void submit_batch(Task *tasks, size_t count);
+
+    /**
+     * @brief 向指定调度器批量投递任务。
+     * @param scheduler_index 调度器索引。
+     * @param tasks 任务数组，投递后元素被移走。
+     * @param count 任务数量。
+     * @return 无返回值。
+     */
+    void submit_batch_to(size_t scheduler_index, Task *tasks, size_t count);
+
+    /**
+     * @brief 把一批任务分给活跃处理器，不再附加创建位置。
+     * @details 供缩容中的处理器转交积压任务。
+     * @param tasks 任务数组，投递后元素被移走，不能包含空任务。
+     * @param count 任务数量。
+     * @return 无返回值。
+     */
+    void redistribute_tasks(Task *tasks, size_t count);
+
+    /**
+     * @brief 调整活跃调度器数量。
+     * @details 扩容优先重新启用缩容过的处理器，不足时新建；缩容从编号
+     * 最大的处理器开始，转交过程在后台完成。编号 0 始终保持活跃。
+     * @param count 目标数量。
+     * @return 调整后的活跃调度器数量。
+     */
+    size_t resize_schedulers(uint32_t count);
+
     /**
      * @brief 获取主调度器句柄。
      * @param 无参数。
@@ -129,19 +205,66 @@ class Runtime : public NonCopyable {
     void resume_external(void *handle);
 
     /**
-     * @brief 获取调度器数量。
+     * @brief 获取活跃调度器数量。
+     * @details 活跃处理器总是编号最小的那一段，投递只在这一段内选择。
      * @param 无参数。
      * @return 调度器数量。
      */
     size_t scheduler_count() const;
 
+    /**
+     * @brief 获取已创建的处理器数量，含缩容中与已退役的。
+     * @param 无参数。
+     * @return 处理器数量。
+     */
+    size_t processor_count() const;
+
     /**
      * @brief 获取处理器列表。
+     * @details 容量在 init 时一次预留，扩容不会搬移元素；其他线程只应
+     *          访问 processor_count() 以内的下标。
      * @param 无参数。
      * @return 处理器数组引用。
      */
     const std::vector<std::unique_ptr<Processor>> &processors() const;
 
+    /**
+     * @brief 调整空闲处理器计数。
+     * @param delta 增量，进入空闲为 1，离开为 -1。
+     * @return 无返回值。
+     */
+    void adjust_idle_processors(int delta);
+
+    /**
+     * @brief 唤醒一个空闲处理器来窃取积压任务。
+     * @param busy 积压任务所在的处理器，不会被选中。
+     * @return 无返回值。
+     */
+    void wake_idle_processor(const Processor *busy);
+
+    /**
+     * @brief 登记一个处理器开始自旋找活。
+     * @details 与 Go 调度器相同，自旋数不超过忙碌处理器数的一半，避免
+     *          大量处理器同时空转。
+     * @param 无参数。
+     * @return true 表示允许自旋，结束时需调用 end_spinning。
+     */
+    bool begin_spinning();
+
+    /**
+     * @brief 注销自旋中的处理器。
+     * @param 无参数。
+     * @return 无返回值。
+     */
+    void end_spinning();
+
+    /**
+     * @brief 获取正在自旋找活的处理器数。
+     * @param 无参数。
+     * @return 自旋中的处理器数。
+     */
+    uint32_t spinning_processors() const;
+
     /**
      * @brief 生成新 Fiber 编号。
      * @param 无参数。
@@ -163,14 +286,31 @@ class Runtime : public NonCopyable {
      */
     void unregister_fiber(Fiber *fiber);
 
-    /**
-     * @brief 取消所有处理器上指定 fd 的 IO 等待。
-     * @param fd 文件描述符。
-     * @param error 唤醒等待协程后暴露的错误码。
-     * @return 无返回值。
+    /**
+     * @brief 取消所有处理器上指定 fd 的 IO 等待。
+     * @param fd 文件描述符。
+     * @param error 唤醒等待协程后暴露的错误码。
+     * @return 无返回值。
      */
     void cancel_fd_waiters(int fd, int error);
 
+    /**
+     * @brief 标记 fd 允许常驻注册。
+     * @details 由 co_socket/co_accept 调用；会先清理该 fd 号残留的注册，
+     * 各处理器在首次等待该 fd 时建立常驻注册，co_close 经
+     * cancel_fd_waiters 清除标记。
+     * @param fd 文件描述符。
+     * @return 无返回值。
+     */
+    void attach_fd(int fd);
+
+    /**
+     * @brief 查询 fd 是否允许常驻注册。
+     * @param fd 文件描述符。
+     * @return true 表示 fd 经 attach_fd 标记且尚未关闭。
+     */
+    bool fd_attached(int fd) const;
+
     /**
      * @brief 导出 Fiber 的外部句柄。
      * @param fiber 协程对象。
@@ -185,11 +325,11 @@ class Runtime : public NonCopyable {
      */
     Scheduler *ensure_scheduler_handle(size_t scheduler_index);
 
-    /**
-     * @brief 确保运行时已启动。
-     * @param 无参数。
-     * @return 无返回值。
-     */
+    /**
+     * @brief 确保运行时已启动。
+     * @param 无参数。
+     * @return 无返回值。
+     */
     void ensure_started();
 
     /**
@@ -199,6 +339,21 @@ class Runtime : public NonCopyable {
      */
     size_t pick_processor_index();
 
+    /**
+     * @brief 在当前处理器所在节点内选择投递目标。
+     * @param ticket 序号。
+     * @param index 输出处理器索引。
+     * @return true 表示当前线程属于某个多处理器节点并已选出目标。
+     */
+    bool pick_same_node_index(uint64_t ticket, size_t *index);
+
+    /**
+     * @brief 获取当前处理器所在节点的处理器索引组。
+     * @param 无参数。
+     * @return 拓扑模式下当前线程属于某个节点时返回该组，否则返回 nullptr。
+     */
+    const std::vector<size_t> *local_node_group() const;
+
     /**
      * @brief 计算二选一候选索引。
      * @param first 首个候选。
@@ -215,6 +370,30 @@ class Runtime : public NonCopyable {
      */
     Runtime();
 
+    /**
+     * @brief 按追踪配置给一批任务附上创建位置。
+     * @param tasks 任务数组。
+     * @param count 任务数量。
+     * @return 无返回值。
+     */
+    void attach_spawn_sites(Task *tasks, size_t count);
+
+    /**
+     * @brief 把一批任务按轮询切段投给目标处理器。
+     * @param tasks 任务数组。
+     * @param count 任务数量。
+     * @return 无返回值。
+     */
+    void distribute_batch(Task *tasks, size_t count);
+
+    /**
+     * @brief 启用下标处的处理器，必要时新建。
+     * @details 调用方持有 scale_mutex_。
+     * @param index 处理器下标。
+     * @return 无返回值。
+     */
+    void activate_processor(size_t index);
+
     std::atomic<bool> started_;
     std::atomic<uint32_t> rr_index_; // 轮询索引，用于简单的轮询负载均衡
     std::atomic<uint64_t>
@@ -223,32 +402,51 @@ class Runtime : public NonCopyable {
     std::atomic<uint64_t>
         fiber_handle_id_gen_; // Fiber 句柄 id 生成器，递增分配唯一 id
     std::vector<std::unique_ptr<Processor>> processors_;
+    std::atomic<size_t> processor_count_;       // 已发布的处理器数
+    std::atomic<size_t> active_count_;          // 活跃处理器数，占据下标前缀
+    std::mutex scale_mutex_;                    // 串行化扩缩容与 init/shutdown
+    std::atomic<uint32_t> idle_processors_;     // 阻塞在 poller 上的处理器数
+    std::atomic<uint32_t> spinning_processors_; // 阻塞前自旋找活的处理器数
 
     mutable std::mutex stack_config_mutex_;
     size_t stack_num_;
     size_t stack_size_;
     StackModel stack_model_;
+    bool numa_aware_;
+    SchedTraceOptions sched_trace_;
+
+    std::atomic<bool> capture_spawn_site_; // init 时按追踪配置设置
+    Watchdog watchdog_;
+
+    // 拓扑模式下按节点分组的处理器索引，下标为节点编号，init 后只读。
+    std::vector<std::vector<size_t>> node_processors_;
 
     mutable std::mutex scheduler_handle_mutex_;
     std::vector<std::unique_ptr<Scheduler>> scheduler_handles_;
 
     FiberHandleRegistry fiber_handle_registry_;
+
+    // 以 fd 为下标的常驻注册标记，容量按 RLIMIT_NOFILE 一次性分配。
+    std::unique_ptr<std::atomic<bool>[]> attached_fds_;
+    size_t attached_fd_capacity_;
 };
 
 /**
  * @brief 获取当前 Fiber。
+ * @details 返回值额外持有一份引用，只读查询应直接借用
+ *          Processor::current_fiber()。
  * @param 无参数。
- * @return 当前 Fiber，共享指针；不在处理器线程返回 nullptr。
+ * @return 当前 Fiber 引用；不在处理器线程返回 nullptr。
  */
 Fiber::ptr current_fiber_shared();
 
 /**
  * @brief 恢复等待中的 Fiber。
- * @param fiber 协程对象。
+ * @param fiber 协程对象，唤醒成功时引用直接移入就绪队列。
  * @param timed_out 是否因超时恢复。
  * @return 无返回值。
  */
-void resume_fiber(const Fiber::ptr &fiber, bool timed_out);
+void resume_fiber(Fiber::ptr fiber, bool timed_out);
 
 /**
  * @brief 将当前 Fiber 标记为等待。
@@ -290,8 +488,26 @@ std::shared_ptr<TimerToken> add_timer(uint32_t milliseconds,
  */
 bool wait_fd(int fd, uint32_t events, uint32_t milliseconds);
 
+/**
+ * @brief 在当前处理器为当前 Fiber 登记 fd 等待但不挂起。
+ * @details 仅允许在协程上下文调用，见 Processor::register_fd_wait()。
+ * @param fd 文件描述符。
+ * @param events 事件掩码。
+ * @return 等待对象，失败返回 nullptr 并设置 errno。
+ */
+std::shared_ptr<IoWaiter> register_fd_wait(int fd, uint32_t events);
+
+/**
+ * @brief 撤销 register_fd_wait() 的登记。
+ * @param waiter 等待对象。
+ * @return true 表示 IO 路径已消费该等待。
+ */
+bool unregister_fd_wait(const std::shared_ptr<IoWaiter> &waiter);
+
 void cancel_fd_waiters(int fd, int error);
 
+void attach_fd(int fd);
+
 } // namespace zco
 
 #endif // ZCO_INTERNAL_RUNTIME_MANAGER_H_
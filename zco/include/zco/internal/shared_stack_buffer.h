@@ -90,8 +90,39 @@ class SharedStackPool : private NonCopyable {
 
     void set_occupy_fiber(size_t stack_slot, Fiber *fiber, int fiber_id);
 
+    /**
+     * @brief 为新协程选择并登记栈槽
+     * @details 从 hint 开始找绑定协程最少的槽位，遇到空闲槽位立即返回；
+     * 协程的栈帧含绝对地址，一经运行只能回到同一槽位，因此选空闲槽位
+     * 可以直接省掉后续的快照拷贝。
+     * @param hint 起始探测槽位
+     * @return 选中的槽位
+     */
+    size_t bind_slot(size_t hint);
+
+    /**
+     * @brief 协程结束后注销槽位登记
+     * @param stack_slot 栈槽索引
+     */
+    void unbind_slot(size_t stack_slot);
+
+    /**
+     * @brief 获取绑定在槽位上的存活协程数量
+     * @param stack_slot 栈槽索引
+     * @return 协程数量
+     */
+    size_t bound_count(size_t stack_slot) const;
+
+    /**
+     * @brief 把全部共享栈优先放到指定 NUMA 节点
+     * @param numa_node 节点编号
+     * @return 成功设置的栈数量
+     */
+    size_t bind_to_node(int numa_node);
+
   private:
     std::vector<SharedStackBuffer> stacks_;
+    std::vector<size_t> bound_counts_; // 仅所属处理器线程访问
 };
 
 } // namespace zco
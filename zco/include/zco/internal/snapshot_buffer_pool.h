@@ -4,13 +4,19 @@
 #include <array>
 #include <cstddef>
 #include <cstdint>
-#include <deque>
-#include <mutex>
 
+#include "zco/internal/free_list.h"
 #include "zco/internal/noncopyable.h"
 
 namespace zco {
 
+/**
+ * @brief 共享栈快照缓冲池
+ * @details
+ * - 每个桶是一条 FreeList，空闲缓冲区自身的首部充当链表节点。
+ * - acquire() 只允许单线程调用（所属处理器线程），release() 可在任意线程调用，
+ *   约束来自 FreeList。
+ */
 class SnapshotBufferPool : public NonCopyable {
   public:
     SnapshotBufferPool();
@@ -56,10 +62,9 @@ class SnapshotBufferPool : public NonCopyable {
      */
     static size_t bucket_size(uint8_t bucket_index);
 
-    std::mutex mutex_;
-    std::array<std::deque<char *>, kBucketCount> pools_;
+    std::array<FreeList, kBucketCount> buckets_;
 };
 
 } // namespace zco
 
-#endif // ZCO_INTERNAL_SNAPSHOT_BUFFER_POOL_H_
\ No newline at end of file
+#endif // ZCO_INTERNAL_SNAPSHOT_BUFFER_POOL_H_
\ No newline at end of file
@@ -0,0 +1,92 @@
+#ifndef ZCO_INTERNAL_STACK_ALLOCATOR_H_
+#define ZCO_INTERNAL_STACK_ALLOCATOR_H_
+
+#include <cstddef>
+
+#include "zco/internal/free_list.h"
+#include "zco/internal/noncopyable.h"
+
+namespace zco {
+
+/**
+ * @brief 独立栈分配器
+ * @details
+ * - 每个栈用 mmap 预留 guard + size 的地址空间，最低一页设为 PROT_NONE，
+ *   栈溢出直接触发 SIGSEGV，不会写坏相邻内存。
+ * - 映射带 MAP_NORESERVE，页在首次触碰时才提交，空闲协程只占用实际用到的页。
+ * - 归还的栈挂到 FreeList 上复用，入链前对除顶页以外的部分做
+ *   MADV_FREE（内核不支持时退回 MADV_DONTNEED），空闲节点放在顶页里。
+ * - allocate() 只允许单线程调用（所属处理器线程），deallocate() 可在任意
+ *   线程调用，约束来自 FreeList。
+ */
+class StackAllocator : public NonCopyable {
+  public:
+    /**
+     * @brief 构造分配器，不预先映射任何栈。
+     * @param stack_size 缓存栈的可用大小，向上取整到页。
+     * @param cache_limit 空闲链表最多缓存的栈数量。
+     */
+    StackAllocator(size_t stack_size, size_t cache_limit);
+    ~StackAllocator();
+
+    /**
+     * @brief 获取一个栈。
+     * @param stack_size 需要的可用大小，与缓存大小不一致时单独映射。
+     * @return 栈的最低可用地址，可用大小为 round_size(stack_size)。
+     * @throws std::bad_alloc 映射失败时抛出。
+     */
+    char *allocate(size_t stack_size);
+
+    /**
+     * @brief 归还栈。
+     * @param stack allocate() 返回的地址。
+     * @param stack_size 传给 allocate() 的大小。
+     * @return 无返回值。
+     */
+    void deallocate(char *stack, size_t stack_size);
+
+    /**
+     * @brief 获取空闲链表中的栈数量。
+     * @param 无参数。
+     * @return 近似值，并发归还时可能短暂偏差。
+     */
+    size_t cached_count() const;
+
+    /**
+     * @brief 把栈大小向上取整到页。
+     * @param stack_size 原始大小。
+     * @return 取整后的大小。
+     */
+    static size_t round_size(size_t stack_size);
+
+    /**
+     * @brief 获取页大小，同时也是 guard 区大小。
+     * @param 无参数。
+     * @return 页大小。
+     */
+    static size_t page_size();
+
+  private:
+    static char *map_stack(size_t stack_size);
+    static void unmap_stack(char *stack, size_t stack_size);
+
+    /**
+     * @brief 释放除顶页以外已提交的页。
+     * @param stack 栈的最低可用地址。
+     * @param stack_size 取整后的大小。
+     * @return 无返回值。
+     */
+    static void trim_stack(char *stack, size_t stack_size);
+
+    // 空闲节点放在栈顶页的末尾。
+    char *node_of(char *stack) const;
+    char *stack_of(void *node) const;
+
+    const size_t stack_size_;
+    const size_t cache_limit_;
+    FreeList free_stacks_;
+};
+
+} // namespace zco
+
+#endif // ZCO_INTERNAL_STACK_ALLOCATOR_H_
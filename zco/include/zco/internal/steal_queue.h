@@ -3,8 +3,11 @@
 
 #include <atomic>
 #include <cstddef>
+#include <cstdint>
 #include <deque>
+#include <memory>
 #include <mutex>
+#include <vector>
 
 #include "zco/internal/noncopyable.h"
 #include "zco/sched.h"
@@ -14,14 +17,51 @@ namespace zco {
 /**
  * @brief 任务窃取队列
  * @details
- * - StealQueue 是一个线程安全的双端队列，支持一个生产者线程和多个消费者线程。
- * - 生产者线程通过 push() 向队列尾部添加任务。
+ * - 主体是一个有界的 Chase-Lev 环形缓冲：只有所属调度线程（owner）在
+ *   bottom 端写入，owner 与窃取者都通过 CAS 推进 top 端批量取出。
+ * - 其他线程投递的任务先进入无锁注入栈，owner 消费时再搬进环形缓冲；
+ *   窃取者在环形缓冲为空时也可以直接从注入栈取走任务。
+ * - 环形缓冲写满时任务落入互斥锁保护的溢出队列，只在突发积压时才会触碰锁。
+ * - 任务节点取自每线程的空闲节点缓存，协程内 go() 的节点在同一调度线程上
+ *   循环使用，稳态下投递不经过分配器。
  */
 class StealQueue : public NonCopyable {
   public:
-    StealQueue();
+    static constexpr size_t kDefaultCapacity = 1024;
+
+    /**
+     * @brief 构造窃取队列
+     * @param capacity 环形缓冲容量，会向上取整到 2 的幂
+     */
+    explicit StealQueue(size_t capacity = kDefaultCapacity);
+    ~StealQueue();
+
+    /**
+     * @brief 从任意线程投递任务
+     * @param task 待投递任务
+     */
     void push(Task task);
 
+    /**
+     * @brief 由 owner 线程投递任务，直接写入环形缓冲
+     * @param task 待投递任务
+     */
+    void push_local(Task task);
+
+    /**
+     * @brief 从任意线程批量投递任务，整批只做一次注入栈 CAS
+     * @param tasks 任务数组，投递后元素被移走
+     * @param count 任务数量
+     */
+    void push_batch(Task *tasks, size_t count);
+
+    /**
+     * @brief 由 owner 线程批量投递任务，直接写入环形缓冲
+     * @param tasks 任务数组，投递后元素被移走
+     * @param count 任务数量
+     */
+    void push_local_batch(Task *tasks, size_t count);
+
     /**
      * @brief 窃取任务
      * @param tasks 任务队列
@@ -29,33 +69,67 @@ class StealQueue : public NonCopyable {
      * @param min_reserve 最小保留数量
      * @return 窃取的任务数量
      */
-    size_t steal(std::deque<Task> *tasks, size_t max_steal, size_t min_reserve);
+    size_t steal(std::vector<Task> *tasks, size_t max_steal,
+                 size_t min_reserve);
 
     /**
-     * @brief 清空所有任务
+     * @brief 清空所有任务，仅限 owner 线程调用
      * @param tasks 任务队列
      */
-    void drain_all(std::deque<Task> *tasks);
+    void drain_all(std::vector<Task> *tasks);
 
     /**
-     * @brief 清空部分任务
+     * @brief 清空部分任务，仅限 owner 线程调用
      * @param tasks 任务队列
      * @param max_count 最大清空数量
      */
-    void drain_some(std::deque<Task> *tasks, size_t max_count);
+    void drain_some(std::vector<Task> *tasks, size_t max_count);
 
     /**
-     * @brief 将队列中的任务追加到另一个队列
-     * @param tasks 目标任务队列
+     * @brief 将另一个队列中的任务追加进来，仅限 owner 线程调用
+     * @param tasks 源任务队列
      */
-    void append(std::deque<Task> *tasks);
+    void append(std::vector<Task> *tasks);
 
     size_t size() const;
 
+    /**
+     * @brief 获取环形缓冲容量
+     * @return 容量
+     */
+    size_t capacity() const;
+
   private:
-    mutable std::mutex mutex_;
+    struct TaskNode {
+        Task task;
+        TaskNode *next;
+    };
+
+    struct NodeCache;
+
+    static TaskNode *acquire_node(Task task);
+    static void release_node(TaskNode *node);
+
+    void push_node_local(TaskNode *node);
+    void transfer_injected();
+    size_t grab_ring(std::vector<Task> *tasks, size_t max_count);
+    size_t grab_overflow(std::vector<Task> *tasks, size_t max_count);
+    size_t grab_injected(std::vector<Task> *tasks, size_t max_count);
+
+    const size_t capacity_;
+    const size_t mask_;
+    std::unique_ptr<std::atomic<TaskNode *>[]> buffer_;
+
+    // top_ 被 owner 与窃取者共同 CAS，bottom_ 只由 owner 写入，
+    // 分开放置避免两端互相伪共享。
+    alignas(64) std::atomic<uint64_t> top_;
+    alignas(64) std::atomic<uint64_t> bottom_;
+    alignas(64) std::atomic<TaskNode *> inject_head_;
+
+    std::mutex overflow_mutex_;
+    std::deque<TaskNode *> overflow_;
+    std::atomic<size_t> overflow_size_;
     std::atomic<size_t> size_;
-    std::deque<Task> tasks_;
 };
 
 } // namespace zco
@@ -0,0 +1,89 @@
+#ifndef ZCO_INTERNAL_SYSCALL_HOOK_H_
+#define ZCO_INTERNAL_SYSCALL_HOOK_H_
+
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+#include <time.h>
+
+#include <cstddef>
+
+namespace zco {
+
+/**
+ * @brief libc 原始系统调用入口。
+ * @details
+ * - 开启 ZCO_ENABLE_SYSCALL_HOOK 编译时，zco 导出 read/connect/poll 等同名
+ *   符号接管第三方库的阻塞调用，原始入口经 dlsym(RTLD_NEXT) 解析。
+ * - 运行时自身需要真实系统调用的地方都经由这里，避免重新进入接管函数。
+ * - 未开启时各字段直接指向 libc 函数。
+ */
+struct SysCalls {
+    int (*socket)(int, int, int);
+    int (*socketpair)(int, int, int, int *);
+    int (*connect)(int, const struct sockaddr *, socklen_t);
+    int (*accept)(int, struct sockaddr *, socklen_t *);
+    int (*accept4)(int, struct sockaddr *, socklen_t *, int);
+    ssize_t (*read)(int, void *, size_t);
+    ssize_t (*readv)(int, const struct iovec *, int);
+    ssize_t (*recv)(int, void *, size_t, int);
+    ssize_t (*recvfrom)(int, void *, size_t, int, struct sockaddr *,
+                        socklen_t *);
+    ssize_t (*recvmsg)(int, struct msghdr *, int);
+    ssize_t (*write)(int, const void *, size_t);
+    ssize_t (*writev)(int, const struct iovec *, int);
+    ssize_t (*send)(int, const void *, size_t, int);
+    ssize_t (*sendto)(int, const void *, size_t, int, const struct sockaddr *,
+                      socklen_t);
+    ssize_t (*sendmsg)(int, const struct msghdr *, int);
+    int (*poll)(struct pollfd *, nfds_t, int);
+    int (*select)(int, fd_set *, fd_set *, fd_set *, struct timeval *);
+    int (*epoll_wait)(int, struct epoll_event *, int, int);
+    int (*close)(int);
+    int (*fcntl)(int, int, ...);
+    int (*ioctl)(int, unsigned long, ...);
+    int (*setsockopt)(int, int, int, const void *, socklen_t);
+    int (*dup)(int);
+    int (*dup2)(int, int);
+    int (*dup3)(int, int, int);
+    unsigned int (*sleep)(unsigned int);
+    int (*usleep)(useconds_t);
+    int (*nanosleep)(const struct timespec *, struct timespec *);
+};
+
+/**
+ * @brief 获取原始系统调用表。
+ * @details 首次调用时解析，之后只读。
+ * @param 无参数。
+ * @return 原始系统调用表。
+ */
+const SysCalls &sys_calls();
+
+/**
+ * @brief 查询 fd 是否由接管层转换成了非阻塞。
+ * @param fd 文件描述符。
+ * @return true 表示 fd 在接管模式下创建，调用方看到的仍是阻塞语义。
+ */
+bool is_hooked_fd(int fd);
+
+/**
+ * @brief dup 后同步接管标记。
+ * @param from_fd 源 fd。
+ * @param to_fd 新 fd。
+ * @return 无返回值。
+ */
+void sync_hooked_fd_on_dup(int from_fd, int to_fd);
+
+/**
+ * @brief close 前清除接管标记。
+ * @param fd 文件描述符。
+ * @return 无返回值。
+ */
+void clear_hooked_fd(int fd);
+
+} // namespace zco
+
+#endif // ZCO_INTERNAL_SYSCALL_HOOK_H_
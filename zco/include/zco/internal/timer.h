@@ -2,28 +2,53 @@
 #define ZCO_INTERNAL_TIMER_H_
 
 #include <atomic>
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <memory>
 #include <mutex>
-#include <queue>
-#include <vector>
 
 #include "zco/internal/noncopyable.h"
 
 namespace zco {
 
+class TimerQueue;
+
 /**
  * @brief 定时器取消令牌。
- * @details 当 cancelled 为 true 时，定时器回调将被跳过。
+ * @details
+ * - 令牌本身就是时间轮中的侵入式节点，插入与取消都不再额外分配。
+ * - cancel() 会把节点从所在槽位摘除；直接设置 cancelled 也能让回调被跳过。
  */
 struct TimerToken {
     std::atomic<bool> cancelled{false};
+
+    /**
+     * @brief 取消定时器并从时间轮中摘除。
+     * @param 无参数。
+     * @return 无返回值。
+     */
+    void cancel();
+
+  private:
+    friend class TimerQueue;
+
+    TimerToken *prev = nullptr;
+    TimerToken *next = nullptr;
+    uint64_t deadline_ms = 0;
+    uint32_t slot = 0; // 所在槽位的全局下标
+    // 挂在时间轮期间指向所属队列，触发或取消后置空。
+    std::atomic<TimerQueue *> queue{nullptr};
+    std::function<void()> callback;
+    std::shared_ptr<TimerToken> self; // 挂在时间轮期间由时间轮持有
 };
 
 /**
- * @brief 定时器优先队列。
- * @details 按 deadline 与 sequence 顺序触发到期回调。
+ * @brief 分层时间轮定时器队列。
+ * @details
+ * - 第 0 层 256 个 1ms 槽位，之后每层 64 个槽位，跨度逐层放大 64 倍。
+ * - 插入与取消都是 O(1) 链表操作；推进时间时高层槽位逐级下沉。
+ * - 同一 deadline 的定时器按插入顺序触发。
  */
 class TimerQueue : public NonCopyable {
   public:
@@ -34,6 +59,13 @@ class TimerQueue : public NonCopyable {
      */
     TimerQueue();
 
+    /**
+     * @brief 析构定时器队列，释放所有未触发的定时器。
+     * @param 无参数。
+     * @return 无返回值。
+     */
+    ~TimerQueue();
+
     /**
      * @brief 添加定时器回调。
      * @param milliseconds 延时毫秒。
@@ -46,9 +78,9 @@ class TimerQueue : public NonCopyable {
     /**
      * @brief 执行所有已到期定时器。
      * @param 无参数。
-     * @return 无返回值。
+     * @return 实际执行的回调数，已取消的定时器不计入。
      */
-    void process_due();
+    size_t process_due();
 
     /**
      * @brief 获取下一次等待超时时间。
@@ -57,41 +89,52 @@ class TimerQueue : public NonCopyable {
      */
     int next_timeout_ms() const;
 
-  private:
     /**
-     * @brief 定时器条目。
-     * @details 包含触发时间、序号、取消令牌与回调。
+     * @brief 获取尚未触发的定时器数量。
+     * @param 无参数。
+     * @return 定时器数量。
      */
-    struct TimerEntry {
-        uint64_t deadline_ms;
-        uint64_t sequence;
-        std::shared_ptr<TimerToken> token;
-        std::function<void()> callback;
-    };
+    size_t size() const;
+
+  private:
+    friend struct TimerToken;
+
+    static constexpr uint32_t kLevelCount = 6;
+    static constexpr uint32_t kFirstLevelBits = 8;
+    static constexpr uint32_t kLevelBits = 6;
+    static constexpr uint32_t kSlotCount =
+        (1u << kFirstLevelBits) + (kLevelCount - 1) * (1u << kLevelBits);
+    // 到期槽位 kReadySlot 存放已经到期、等待下一次 process_due 的定时器；
+    // kFarSlot 存放超出全部层级跨度的定时器。
+    static constexpr uint32_t kReadySlot = kSlotCount;
+    static constexpr uint32_t kFarSlot = kSlotCount + 1;
+    static constexpr uint32_t kListCount = kSlotCount + 2;
 
     /**
-     * @brief 定时器比较器。
-     * @details 使优先队列按最近 deadline 优先出队。
+     * @brief 槽位链表头。
+     * @details min_deadline 只在挂入时更新、链表清空时复位，
+     * 因此是链表内最早 deadline 的下界。
      */
-    struct TimerCompare {
-        /**
-         * @brief 比较两个定时器条目优先级。
-         * @param lhs 左侧条目。
-         * @param rhs 右侧条目。
-         * @return true 表示 lhs 优先级低于 rhs。
-         */
-        bool operator()(const TimerEntry &lhs, const TimerEntry &rhs) const {
-            if (lhs.deadline_ms != rhs.deadline_ms) {
-                return lhs.deadline_ms > rhs.deadline_ms;
-            }
-            return lhs.sequence > rhs.sequence;
-        }
+    struct TimerList {
+        TimerToken *head = nullptr;
+        TimerToken *tail = nullptr;
+        uint64_t min_deadline = UINT64_MAX;
     };
 
+    void cancel(TimerToken *token);
+    void link(TimerToken *token);
+    void link_to(TimerToken *token, uint32_t slot);
+    void unlink(TimerToken *token);
+    void cascade(uint32_t slot);
+    void advance_to(uint64_t now, TimerList *due);
+    void move_all(uint32_t slot, TimerList *due);
+    int find_next_slot(uint32_t level, uint32_t from) const;
+
     mutable std::mutex mutex_;
-    std::priority_queue<TimerEntry, std::vector<TimerEntry>, TimerCompare>
-        timers_;
-    std::atomic<uint64_t> sequence_;
+    TimerList lists_[kListCount];
+    uint64_t occupied_[(kSlotCount + 63) / 64];
+    uint64_t current_ms_;
+    size_t size_;
 };
 
 /**
@@ -101,6 +144,13 @@ class TimerQueue : public NonCopyable {
  */
 uint64_t now_ms();
 
+/**
+ * @brief 获取当前单调时钟纳秒值。
+ * @param 无参数。
+ * @return 当前纳秒时间戳。
+ */
+uint64_t now_ns();
+
 } // namespace zco
 
 #endif // ZCO_INTERNAL_TIMER_H_
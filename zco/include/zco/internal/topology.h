@@ -0,0 +1,107 @@
+#ifndef ZCO_INTERNAL_TOPOLOGY_H_
+#define ZCO_INTERNAL_TOPOLOGY_H_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace zco {
+
+/**
+ * @brief 单个处理器的放置结果。
+ * @details cpu/numa_node 为 -1 表示不绑定。
+ */
+struct CpuPlacement {
+    int cpu;
+    int numa_node;
+
+    CpuPlacement() : cpu(-1), numa_node(-1) {}
+    CpuPlacement(int placement_cpu, int placement_node)
+        : cpu(placement_cpu), numa_node(placement_node) {}
+};
+
+/**
+ * @brief CPU 与 NUMA 节点拓扑。
+ * @details
+ * - detect() 读取当前线程允许运行的 CPU 与 sysfs 中各节点的 cpulist，
+ *   没有 NUMA 信息时全部归入节点 0。
+ * - plan() 按节点的 CPU 数量比例分配处理器，同一节点的处理器编号连续。
+ */
+class CpuTopology {
+  public:
+    /**
+     * @brief 由 CPU 列表构造拓扑。
+     * @param cpus 可用 CPU 编号。
+     * @param cpu_nodes 与 cpus 一一对应的节点编号。
+     */
+    CpuTopology(std::vector<int> cpus, std::vector<int> cpu_nodes);
+
+    /**
+     * @brief 探测当前进程可用的拓扑。
+     * @param 无参数。
+     * @return 拓扑对象；探测失败时为空拓扑。
+     */
+    static CpuTopology detect();
+
+    /**
+     * @brief 获取可用 CPU 数量。
+     * @param 无参数。
+     * @return CPU 数量。
+     */
+    size_t cpu_count() const;
+
+    /**
+     * @brief 获取涉及的 NUMA 节点数量。
+     * @param 无参数。
+     * @return 节点数量。
+     */
+    size_t node_count() const;
+
+    /**
+     * @brief 查询 CPU 所在节点。
+     * @param cpu CPU 编号。
+     * @return 节点编号，未知 CPU 返回 -1。
+     */
+    int node_of(int cpu) const;
+
+    /**
+     * @brief 为处理器规划 CPU 与节点。
+     * @param processor_count 处理器数量。
+     * @return 每个处理器的放置结果；拓扑为空时全部不绑定。
+     */
+    std::vector<CpuPlacement> plan(size_t processor_count) const;
+
+  private:
+    std::vector<int> cpus_;
+    std::vector<int> cpu_nodes_;
+    std::vector<int> nodes_; // 升序去重后的节点编号
+};
+
+/**
+ * @brief 解析内核 cpulist 格式，例如 "0-3,8,10-11"。
+ * @param text 待解析文本。
+ * @param cpus 输出 CPU 编号，按出现顺序追加。
+ * @return true 表示解析成功。
+ */
+bool parse_cpu_list(const std::string &text, std::vector<int> *cpus);
+
+/**
+ * @brief 把当前线程绑定到指定 CPU，并把线程内存策略设为优先该节点。
+ * @param placement 放置结果。
+ * @return true 表示 CPU 绑定成功；内存策略失败只记录日志。
+ */
+bool bind_current_thread(const CpuPlacement &placement);
+
+/**
+ * @brief 把一段内存优先放到指定节点，已分配的页会尝试迁移。
+ * @details 只处理区间内完整的页，不足一页的首尾部分保持原样。
+ * @param addr 起始地址。
+ * @param length 字节数。
+ * @param numa_node 目标节点。
+ * @return true 表示设置成功或区间不足一页。
+ */
+bool bind_memory_to_node(void *addr, size_t length, int numa_node);
+
+} // namespace zco
+
+#endif // ZCO_INTERNAL_TOPOLOGY_H_
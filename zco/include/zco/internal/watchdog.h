@@ -0,0 +1,104 @@
+#ifndef ZCO_INTERNAL_WATCHDOG_H_
+#define ZCO_INTERNAL_WATCHDOG_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "zco/internal/noncopyable.h"
+#include "zco/sched.h"
+
+namespace zco {
+
+class Processor;
+
+/**
+ * @brief go() 调用处的调用栈。
+ */
+struct SpawnSite {
+    static constexpr int kMaxFrames = 16;
+
+    void *frames[kMaxFrames];
+    int depth = 0;
+};
+
+/**
+ * @brief 记录当前线程的调用栈。
+ * @param 无参数。
+ * @return 调用栈，跳过运行时自身的帧。
+ */
+std::unique_ptr<SpawnSite> capture_spawn_site();
+
+/**
+ * @brief 把调用栈格式化为多行文本，每帧一行。
+ * @param site 调用栈。
+ * @return 符号化后的文本，无法解析符号时输出地址。
+ */
+std::string format_spawn_site(const SpawnSite &site);
+
+/**
+ * @brief 包装任务，让任务运行期间所在协程能查到创建位置。
+ * @param task 原任务。
+ * @return 携带调用栈的新任务。
+ */
+Task attach_spawn_site(Task task);
+
+/**
+ * @brief 慢运行片段看门狗。
+ * @details 独立线程按阈值的四分之一为周期扫描各调度器正在运行的片段，
+ * 同一片段只告警一次；开启迁移时每个周期都把卡住调度器上尚未开始的
+ * 任务转交给负载最低的其他调度器。
+ */
+class Watchdog : public NonCopyable {
+  public:
+    Watchdog();
+
+    ~Watchdog();
+
+    /**
+     * @brief 启动看门狗线程。
+     * @param processors 被检查的处理器，运行期间不得增删。
+     * @param threshold_ns 告警阈值。
+     * @param migrate 是否迁移卡住调度器的积压任务。
+     * @return 无返回值。
+     */
+    void start(const std::vector<std::unique_ptr<Processor>> *processors,
+               uint64_t threshold_ns, bool migrate);
+
+    /**
+     * @brief 停止并等待看门狗线程退出。
+     * @param 无参数。
+     * @return 无返回值。
+     */
+    void stop();
+
+    /**
+     * @brief 检查一轮所有处理器。
+     * @param now_ns 当前单调时钟纳秒值。
+     * @return 本轮检出的卡住调度器数。
+     */
+    size_t check(uint64_t now_ns);
+
+  private:
+    void run();
+
+    size_t migrate_pending_tasks(Processor *stalled);
+
+    const std::vector<std::unique_ptr<Processor>> *processors_;
+    uint64_t threshold_ns_;
+    bool migrate_;
+    std::vector<uint64_t> reported_; // 各处理器最近一次告警的片段起点
+
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool stopping_;
+    std::thread thread_;
+};
+
+} // namespace zco
+
+#endif // ZCO_INTERNAL_WATCHDOG_H_
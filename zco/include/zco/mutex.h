@@ -9,7 +9,13 @@ namespace zco {
 
 /**
  * @brief 协程友好的互斥锁。
- * @details 在线程上下文使用条件变量阻塞，在协程上下文使用 runtime park/resume。
+ * @details
+ * - 状态字 0/1/2 分别表示空闲、已加锁、已加锁且可能有等待者；无竞争时
+ *   加锁、解锁各只有一次 CAS，不碰内部互斥量。
+ * - 竞争时先做有上限的自适应自旋（单核不自旋），仍拿不到再挂起：
+ *   线程阻塞在等待节点的条件变量上，协程走 runtime park/resume。
+ * - 解锁时若有等待者，锁不释放而直接转交：先交给协程等待者，没有时再交给
+ *   线程等待者，同类等待者按到达顺序获得锁。
  */
 class Mutex : private NonCopyable {
   public:
@@ -46,6 +52,73 @@ class Mutex : private NonCopyable {
     std::shared_ptr<Impl> impl_;
 };
 
+/**
+ * @brief 协程友好的读写锁。
+ * @details
+ * - 状态字最低位表示写锁，其余位为读者计数；读锁无竞争时只有一次 CAS。
+ * - 写优先：有写者排队时新读者也排队，避免写者被源源不断的读者饿死。
+ * - 写锁释放时把锁整批转交给排队的读者，最后一个读者释放时再转交给
+ *   排队的写者，读写两侧交替推进。
+ * - 满足标准库 SharedMutex 要求，可配合 std::shared_lock 使用。
+ */
+class SharedMutex : private NonCopyable {
+  public:
+    /**
+     * @brief 构造读写锁。
+     */
+    SharedMutex();
+
+    /**
+     * @brief 析构读写锁。
+     */
+    ~SharedMutex();
+
+    /**
+     * @brief 加写锁。
+     * @return 无返回值。
+     */
+    void lock() const;
+
+    /**
+     * @brief 释放写锁。
+     * @return 无返回值。
+     */
+    void unlock() const;
+
+    /**
+     * @brief 尝试加写锁。
+     * @return true 表示成功获得写锁。
+     */
+    bool try_lock() const;
+
+    /**
+     * @brief 加读锁。
+     * @return 无返回值。
+     */
+    void lock_shared() const;
+
+    /**
+     * @brief 释放读锁。
+     * @return 无返回值。
+     */
+    void unlock_shared() const;
+
+    /**
+     * @brief 尝试加读锁。
+     * @return true 表示成功获得读锁。
+     */
+    bool try_lock_shared() const;
+
+  private:
+    struct Impl;
+    std::shared_ptr<Impl> impl_;
+};
+
+/**
+ * @brief 读写锁别名，与 SharedMutex 为同一实现。
+ */
+using RWMutex = SharedMutex;
+
 /**
  * @brief Mutex 的 RAII 守卫。
  */
@@ -72,6 +145,46 @@ class MutexGuard : public NonCopyable {
     const Mutex *mutex_;
 };
 
+/**
+ * @brief SharedMutex 读锁的 RAII 守卫。
+ */
+class ReadGuard : public NonCopyable {
+  public:
+    /**
+     * @brief 构造守卫并加读锁。
+     * @param mutex 读写锁。
+     */
+    explicit ReadGuard(const SharedMutex &mutex);
+
+    /**
+     * @brief 析构时释放读锁。
+     */
+    ~ReadGuard();
+
+  private:
+    const SharedMutex *mutex_;
+};
+
+/**
+ * @brief SharedMutex 写锁的 RAII 守卫。
+ */
+class WriteGuard : public NonCopyable {
+  public:
+    /**
+     * @brief 构造守卫并加写锁。
+     * @param mutex 读写锁。
+     */
+    explicit WriteGuard(const SharedMutex &mutex);
+
+    /**
+     * @brief 析构时释放写锁。
+     */
+    ~WriteGuard();
+
+  private:
+    const SharedMutex *mutex_;
+};
+
 } // namespace zco
 
 #endif // ZCO_MUTEX_H_
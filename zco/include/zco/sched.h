@@ -7,6 +7,8 @@
 #include <type_traits>
 #include <utility>
 
+#include "zco/task.h"
+
 namespace zco {
 
 /**
@@ -20,11 +22,6 @@ class Runtime;
  */
 class Scheduler;
 
-/**
- * @brief 协程任务函数类型。
- */
-using Task = std::function<void()>;
-
 /**
  * @brief 可复用的协程回调基类。
  * @details 通过 go(Closure*) 启动后，回调对象会在执行后自动释放。
@@ -91,6 +88,18 @@ enum class StackModel : uint8_t {
     kIndependent = 1,
 };
 
+/**
+ * @brief 共享栈快照拷贝统计。
+ * @details 累计值，两次采样相减后除以间隔即可得到每秒拷贝字节数；
+ * 拷贝量高说明共享栈数量不足，可以调大 co_stack_num。
+ */
+struct StackCopyStats {
+    uint64_t save_count = 0;     // 被换出时保存快照的次数
+    uint64_t saved_bytes = 0;    // 保存快照拷贝的字节数
+    uint64_t restore_count = 0;  // 换回时恢复快照的次数
+    uint64_t restored_bytes = 0; // 恢复快照拷贝的字节数
+};
+
 /**
  * @brief 表示无限等待的超时时间常量。
  */
@@ -127,6 +136,24 @@ void co_stack_size(size_t stack_size);
  */
 void co_stack_model(StackModel stack_model);
 
+/**
+ * @brief 设置是否启用 NUMA 拓扑感知调度。
+ * @details 仅在运行时未启动时生效，建议在首次 init/go 之前调用。
+ * 启用后每个调度线程绑定到一个 CPU，调度器按 NUMA 节点分组：空闲窃取
+ * 优先同节点，共享栈与协程栈内存优先分配在本节点。
+ * @param enable true 表示启用，默认关闭。
+ * @return 无返回值。
+ */
+void co_numa_aware(bool enable);
+
+/**
+ * @brief 获取全部调度器的共享栈拷贝统计。
+ * @details 运行时未启动时返回全零；独立栈模型下始终为零。
+ * @param 无参数。
+ * @return 自 init 以来的累计值。
+ */
+StackCopyStats co_stack_copy_stats();
+
 /**
  * @brief 关闭协程调度系统并释放资源。
  * @param 无参数。
@@ -147,6 +174,16 @@ void go(Closure *cb);
  */
 void go(Task task);
 
+/**
+ * @brief 批量提交任务到运行时。
+ * @details 任务按提交顺序切成连续的几段分给各调度器，每个调度器整段入队，
+ * 整批最多唤醒它一次；大量派生时比逐个 go() 少很多次唤醒。空任务被跳过。
+ * @param tasks 任务数组，提交后元素被移走。
+ * @param count 任务数量。
+ * @return 无返回值。
+ */
+void go_batch(Task *tasks, size_t count);
+
 /**
  * @brief 提交无参可调用对象到运行时。
  */
@@ -192,6 +229,14 @@ class Scheduler {
      */
     void go(Task task);
 
+    /**
+     * @brief 向当前句柄对应的调度器批量提交任务，整批最多唤醒一次。
+     * @param tasks 任务数组，提交后元素被移走。
+     * @param count 任务数量。
+     * @return 无返回值。
+     */
+    void go_batch(Task *tasks, size_t count);
+
     /**
      * @brief 向当前句柄对应的调度器提交 Closure 任务。
      * @details 调度执行后会自动释放 cb。
@@ -267,6 +312,18 @@ Scheduler *next_sched();
  */
 void stop_scheds();
 
+/**
+ * @brief 在运行期间调整活跃调度器数量。
+ * @details 运行时未启动时先按默认配置启动。扩容优先重新启用缩容过的
+ * 调度器，不足时新建，栈配置沿用 init 时的设置；缩容从编号最大的调度器
+ * 开始，调用立即返回，被缩容的调度器在后台把积压任务和尚未运行过的协程
+ * 转交给其余调度器，已经运行过的协程留在原处运行结束，之后线程退出。
+ * 调度器 0 始终保持活跃；NUMA 拓扑模式下不支持调整。
+ * @param count 目标数量，需大于 0。
+ * @return 调整后的活跃调度器数量。
+ */
+size_t resize_scheds(uint32_t count);
+
 /**
  * @brief 当前协程主动让出执行权。
  * @param 无参数。
@@ -316,6 +373,16 @@ int coroutine_id();
  */
 bool timeout();
 
+/**
+ * @brief 判断当前协程是否已被取消。
+ * @details 协程所属 TaskGroup 被取消或到达截止时间后返回 true。此后
+ * sleep_for、带超时的 Event/Channel 等待按超时提前返回，IoEvent 与 hook
+ * 的 IO 等待失败并置 errno 为 ECANCELED；无超时的锁与通道等待不受影响。
+ * @param 无参数。
+ * @return true 表示已请求取消，不在协程上下文时返回 false。
+ */
+bool cancelled();
+
 /**
  * @brief 判断当前是否处于协程上下文。
  * @param 无参数。
@@ -325,6 +392,7 @@ bool in_coroutine();
 
 /**
  * @brief 获取当前运行时调度器总数。
+ * @details 只计活跃的调度器，不含缩容中与已退役的。
  * @param 无参数。
  * @return 调度器数量。
  */
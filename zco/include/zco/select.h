@@ -0,0 +1,136 @@
+#ifndef ZCO_SELECT_H_
+#define ZCO_SELECT_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+
+#include "zco/channel.h"
+#include "zco/io_event.h"
+#include "zco/internal/channel_wait_queue.h"
+#include "zco/sched.h"
+
+namespace zco {
+
+/**
+ * @brief select 的一个分支。
+ * @details
+ * - 分支只保存通道、输入输出对象的地址，构造不分配内存；被引用的对象需在
+ *   select 返回前保持有效。
+ * - 读分支在读到元素或通道关闭且为空时触发；写分支在写入成功或通道已关闭时
+ *   触发，只有触发时才移走输入元素。
+ * - fd 分支在 fd 可读/可写时触发，语义同 IoEvent：就绪可能是虚假的，
+ *   调用方仍需以非阻塞方式重试 IO。
+ */
+class SelectCase {
+  public:
+    /**
+     * @brief 构造通道读分支。
+     * @param channel 通道。
+     * @param out 触发时写入读到的元素。
+     * @param ok 可选，触发时写入读取结果，通道关闭且为空时为 false。
+     * @return 分支对象。
+     */
+    template <typename T>
+    static SelectCase recv(const Channel<T> &channel, T &out,
+                           bool *ok = nullptr) {
+        SelectCase c;
+        c.channel_ = &channel;
+        c.value_ = &out;
+        c.ok_ = ok;
+        c.side_ = ChannelWaitQueue::kReader;
+        c.poll_ = &Channel<T>::select_poll_read;
+        c.arm_ = &Channel<T>::select_arm;
+        c.disarm_ = &Channel<T>::select_disarm;
+        return c;
+    }
+
+    /**
+     * @brief 构造通道写分支。
+     * @param channel 通道。
+     * @param value 待写入的元素，分支触发且写入成功时被移走。
+     * @param ok 可选，触发时写入写入结果，通道已关闭时为 false。
+     * @return 分支对象。
+     */
+    template <typename T>
+    static SelectCase send(const Channel<T> &channel, T &value,
+                           bool *ok = nullptr) {
+        SelectCase c;
+        c.channel_ = &channel;
+        c.value_ = &value;
+        c.ok_ = ok;
+        c.side_ = ChannelWaitQueue::kWriter;
+        c.poll_ = &Channel<T>::select_poll_write;
+        c.arm_ = &Channel<T>::select_arm;
+        c.disarm_ = &Channel<T>::select_disarm;
+        return c;
+    }
+
+    /**
+     * @brief 构造 fd 就绪分支。
+     * @param fd 文件描述符。
+     * @param event_type 等待的事件。
+     * @param ok 可选，触发时写入结果，fd 被关闭取消等待时为 false。
+     * @return 分支对象。
+     */
+    static SelectCase fd(int fd, IoEventType event_type, bool *ok = nullptr);
+
+  private:
+    friend int select(const SelectCase *cases, size_t count,
+                      uint32_t timeout_ms);
+
+    using PollFn = bool (*)(const void *channel, void *value, bool *ok);
+    using ArmFn = ChannelWaiter *(*)(const void *channel,
+                                     ChannelWaitQueue::Side side);
+    using DisarmFn = ChannelWaiter::Result (*)(const void *channel,
+                                               ChannelWaitQueue::Side side,
+                                               ChannelWaiter *waiter,
+                                               void *value);
+
+    SelectCase()
+        : channel_(nullptr), value_(nullptr), ok_(nullptr),
+          side_(ChannelWaitQueue::kReader), poll_(nullptr), arm_(nullptr),
+          disarm_(nullptr), fd_(-1), events_(0) {}
+
+    const void *channel_; // 为空表示 fd 分支
+    void *value_;
+    bool *ok_;
+    ChannelWaitQueue::Side side_;
+    PollFn poll_;
+    ArmFn arm_;
+    DisarmFn disarm_;
+    int fd_;
+    uint32_t events_;
+};
+
+/**
+ * @brief 同时等待多个分支，恰好触发其中一个。
+ * @details
+ * - 先按声明顺序不等待地尝试每个分支，都未就绪时把当前协程登记到全部通道
+ *   和 fd 上后只挂起一次；协程自身的等待态是唯一的唤醒令牌，第一个
+ *   try_wake 成功的通道、fd 或超时定时器胜出，其余登记在恢复后撤销。
+ * - 读分支可以直接收下写端交接的元素，不会出现元素被取走但分支未触发。
+ * - 仅允许在协程上下文调用。
+ * @param cases 分支数组。
+ * @param count 分支数量。
+ * @param timeout_ms 超时时间，0 表示只尝试一次。
+ * @return 触发分支的下标；超时或出错返回 -1 并设置 errno
+ *         （ETIMEDOUT、EPERM、EINVAL、EBADF 或 fd 登记失败的错误码）。
+ */
+int select(const SelectCase *cases, size_t count,
+           uint32_t timeout_ms = kInfiniteTimeoutMs);
+
+/**
+ * @brief 同时等待多个分支。
+ * @param cases 分支列表。
+ * @param timeout_ms 超时时间。
+ * @return 触发分支的下标，超时或出错返回 -1。
+ */
+inline int select(std::initializer_list<SelectCase> cases,
+                  uint32_t timeout_ms = kInfiniteTimeoutMs) {
+    return select(cases.begin(), cases.size(), timeout_ms);
+}
+
+} // namespace zco
+
+#endif // ZCO_SELECT_H_
@@ -0,0 +1,157 @@
+#ifndef ZCO_STATS_H_
+#define ZCO_STATS_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "zco/sched.h"
+
+namespace zco {
+
+/**
+ * @brief 延迟分布快照。
+ * @details 桶按对数线性划分，每个 2 的幂区间分为 8 个子桶；百分位取所在桶
+ *          的上界，相对误差不超过 12.5%。
+ */
+struct LatencyHistogramStats {
+    uint64_t count = 0;            // 样本数
+    uint64_t sum_ns = 0;           // 样本总和
+    uint64_t max_ns = 0;           // 最大样本
+    std::vector<uint64_t> buckets; // 各桶样本数，未开启记录时为空
+
+    /**
+     * @brief 估算百分位。
+     * @param quantile 0 到 1 之间的分位点，如 0.99。
+     * @return 分位值，没有样本时为 0。
+     */
+    uint64_t percentile_ns(double quantile) const;
+
+    /**
+     * @brief 合并另一份分布，用于汇总多个调度器。
+     * @param other 另一份快照。
+     * @return 无返回值。
+     */
+    void merge(const LatencyHistogramStats &other);
+};
+
+/**
+ * @brief 单个调度器的运行统计快照。
+ * @details
+ * - 计数器为自 init 以来的累计值，两次采样相减即得区间速率；队列长度等
+ *   瞬时量只反映采样时刻。
+ * - 延迟分布只在 co_sched_trace 开启 latency_histograms 时记录。
+ * - 计数以 relaxed 原子读写维护，其他线程采样时各字段之间不保证是
+ *   同一时刻的值。
+ */
+struct ProcessorStats {
+    int id = -1;
+    int numa_node = -1;         // 未绑定节点时为 -1
+    bool active = true;         // false 表示已被缩容，正在收尾或已退役
+    bool idle = false;          // 采样时是否阻塞在 poller 上
+    uint32_t ready_fibers = 0;  // 就绪队列长度
+    uint32_t pending_tasks = 0; // 尚未实体化为协程的任务数
+    uint32_t live_fibers = 0;   // 已实体化且尚未结束的协程数
+    size_t pending_timers = 0;  // 未到期的定时器数
+
+    uint64_t cpu_time_ns = 0; // 调度循环累计耗时，含执行协程的时间
+    uint64_t ema_loop_ns = 0; // 单轮调度循环耗时的指数滑动平均
+
+    uint64_t context_switches = 0;  // 切入协程的次数
+    uint64_t yields = 0;            // 协程主动让出的次数
+    uint64_t parks = 0;             // 协程挂起等待的次数
+    uint64_t wakeups = 0;           // 等待中的协程被投回就绪队列的次数
+    uint64_t remote_wakeups = 0;    // 其中由其他线程发起的次数
+    uint64_t steals_in = 0;         // 从其他调度器窃取到的任务数
+    uint64_t steals_out = 0;        // 被窃取或被看门狗迁走的任务数
+    uint64_t io_waits = 0;          // 登记 fd 等待的次数
+    uint64_t io_wakeups = 0;        // 因 fd 就绪恢复的协程数
+    uint64_t idle_waits = 0;        // 空闲时进入 poller 等待的次数
+    uint64_t idle_wait_ns = 0;      // 空闲时阻塞在 poller 上的累计时间
+    uint64_t idle_spins = 0;        // 阻塞前自旋等待新任务的次数
+    uint64_t idle_spin_hits = 0;    // 其中自旋期间等到任务的次数
+    uint64_t wakes_avoided = 0;     // 目标未阻塞而省掉的唤醒 fd 写入次数
+    uint64_t poller_syscalls = 0;   // poller 发起的系统调用次数
+    uint64_t timer_fires = 0;       // 执行的定时器回调数
+    uint64_t fiber_pool_hits = 0;   // 创建协程时复用了池中对象的次数
+    uint64_t fiber_pool_misses = 0; // 创建协程时新分配对象的次数
+    uint64_t long_slices = 0;       // 超过告警阈值的运行片段数
+    StackCopyStats stack_copy;      // 共享栈快照拷贝，独立栈模型下为零
+
+    LatencyHistogramStats ready_latency; // 从进入就绪队列到开始运行
+    LatencyHistogramStats run_slice;     // 每次切入到切回之间的运行时间
+};
+
+/**
+ * @brief 阻塞线程池的统计快照。
+ * @details 计数器为进程启动以来的累计值，不随运行时 shutdown 清零。
+ */
+struct BlockingPoolStats {
+    uint32_t max_threads = 0;   // 并发上限
+    uint32_t threads = 0;       // 当前线程数
+    uint32_t busy_threads = 0;  // 正在执行调用的线程数
+    uint32_t queued = 0;        // 排队等待线程的调用数
+    uint32_t peak_queued = 0;   // 排队长度的最大值
+    uint64_t submitted = 0;     // 提交的调用数
+    uint64_t completed = 0;     // 执行结束的调用数
+    uint64_t queue_wait_ns = 0; // 调用排队等待的累计时间
+    uint64_t run_ns = 0;        // 调用执行的累计时间
+};
+
+/**
+ * @brief 运行时统计快照。
+ */
+struct RuntimeStats {
+    std::vector<ProcessorStats> processors; // 按调度器编号排列，含已缩容的
+    BlockingPoolStats blocking;             // zco::blocking 使用的线程池
+};
+
+/**
+ * @brief 调度追踪配置。
+ * @details 开启延迟直方图或慢片段检测后，每次切换协程多读两次时钟，
+ *          协程进入就绪队列时多读一次；两者都关闭时没有额外开销。
+ */
+struct SchedTraceOptions {
+    bool latency_histograms = false;    // 记录就绪等待与运行片段的延迟分布
+    uint32_t long_slice_ms = 0;         // 运行片段超过该值时告警，0 表示关闭
+    bool capture_spawn_site = false;    // go() 时记录调用栈，告警时一并输出
+    bool migrate_on_long_slice = false; // 检出后把卡住调度器的积压任务迁走
+};
+
+/**
+ * @brief 设置调度追踪。
+ * @details 仅在运行时未启动时生效，建议在首次 init/go 之前调用。
+ * 开启 long_slice_ms 后由一个看门狗线程周期检查各调度器：某个协程连续
+ * 运行超过阈值时记录告警日志，协程切回后再补一条带运行时长的日志；开启
+ * capture_spawn_site 时两条日志都带创建位置调用栈。migrate_on_long_slice 会把该调度器上尚未开始运行的任务
+ * 转交给其他调度器；已经运行过的协程的栈绑定在原调度器上，无法迁移。
+ * @param options 追踪配置。
+ * @return 无返回值。
+ */
+void co_sched_trace(const SchedTraceOptions &options);
+
+/**
+ * @brief 采集全部调度器的运行统计。
+ * @details 只读取各调度器的原子计数，不加锁、不打断调度线程，可以在任意
+ *          线程周期性调用。运行时未启动时返回空快照。
+ * @param 无参数。
+ * @return 统计快照。
+ */
+RuntimeStats stats();
+
+/**
+ * @brief 把统计快照渲染为 Prometheus 文本格式。
+ * @details 每个调度器一组样本，以 sched 标签区分；计数器以 _total 结尾，
+ *          纳秒累计值换算为秒，
+ *          延迟分布输出为 summary。
+ * @param snapshot 统计快照。
+ * @param prefix 指标名前缀。
+ * @return Prometheus exposition 文本。
+ */
+std::string render_prometheus(const RuntimeStats &snapshot,
+                              const std::string &prefix = "zco");
+
+} // namespace zco
+
+#endif // ZCO_STATS_H_
@@ -0,0 +1,197 @@
+#ifndef ZCO_TASK_H_
+#define ZCO_TASK_H_
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace zco {
+
+/**
+ * @brief 协程任务函数类型。
+ * @details
+ * - 只可移动的 void() 可调用对象包装，取代 std::function<void()>。
+ * - 不超过 kInlineSize 字节、对齐不超过 kInlineAlign 且移动构造不抛异常的
+ *   可调用对象直接放在 Task 内部，投递时不分配内存；其余放到堆上。
+ * - 可调用对象只需可移动，可以捕获 std::unique_ptr 之类的只移类型。
+ * - 空函数指针、空 std::function 构造出的 Task 为空，投递时被忽略。
+ */
+class Task {
+  public:
+    static constexpr size_t kInlineSize = 48;
+    static constexpr size_t kInlineAlign = alignof(std::max_align_t);
+
+    Task() noexcept : ops_(nullptr) {}
+
+    Task(std::nullptr_t) noexcept : ops_(nullptr) {}
+
+    template <typename F, typename Fn = typename std::decay<F>::type,
+              typename = typename std::enable_if<
+                  !std::is_same<Fn, Task>::value &&
+                  !std::is_same<Fn, std::nullptr_t>::value>::type,
+              typename = decltype(std::declval<Fn &>()())>
+    Task(F &&fn) : ops_(nullptr) {
+        if (is_null(fn, std::is_pointer<Fn>())) {
+            return;
+        }
+        emplace<Fn>(std::forward<F>(fn), stored_inline<Fn>());
+    }
+
+    Task(Task &&other) noexcept : ops_(nullptr) { take(other); }
+
+    Task &operator=(Task &&other) noexcept {
+        if (this != &other) {
+            clear();
+            take(other);
+        }
+        return *this;
+    }
+
+    Task &operator=(std::nullptr_t) noexcept {
+        clear();
+        return *this;
+    }
+
+    Task(const Task &) = delete;
+    Task &operator=(const Task &) = delete;
+
+    ~Task() { clear(); }
+
+    /**
+     * @brief 判断是否持有可调用对象。
+     * @param 无参数。
+     * @return true 表示非空。
+     */
+    explicit operator bool() const noexcept { return ops_ != nullptr; }
+
+    /**
+     * @brief 调用持有的可调用对象。
+     * @details 空 Task 抛出 std::bad_function_call。
+     * @param 无参数。
+     * @return 无返回值。
+     */
+    void operator()() {
+        if (!ops_) {
+            throw std::bad_function_call();
+        }
+        ops_->invoke(&storage_);
+    }
+
+    /**
+     * @brief 判断可调用对象是否内联存放。
+     * @param 无参数。
+     * @return true 表示存放在 Task 内部，空 Task 返回 false。
+     */
+    bool is_inline() const noexcept { return ops_ && ops_->inline_stored; }
+
+  private:
+    using Storage =
+        typename std::aligned_storage<kInlineSize, kInlineAlign>::type;
+
+    // 按存放方式生成的操作表，每种可调用类型只有一份静态实例。
+    struct Ops {
+        void (*invoke)(void *storage);
+        // 把 src 的对象移进 dst 的未初始化存储，并析构 src 中的原对象。
+        void (*relocate)(void *dst, void *src);
+        void (*destroy)(void *storage);
+        bool inline_stored;
+    };
+
+    template <typename Fn>
+    using stored_inline = std::integral_constant<
+        bool, sizeof(Fn) <= kInlineSize && alignof(Fn) <= kInlineAlign &&
+                  std::is_nothrow_move_constructible<Fn>::value>;
+
+    template <typename Fn> struct InlineOps {
+        static void invoke(void *storage) { (*static_cast<Fn *>(storage))(); }
+
+        static void relocate(void *dst, void *src) {
+            Fn *from = static_cast<Fn *>(src);
+            ::new (dst) Fn(std::move(*from));
+            from->~Fn();
+        }
+
+        static void destroy(void *storage) {
+            static_cast<Fn *>(storage)->~Fn();
+        }
+
+        static const Ops table;
+    };
+
+    template <typename Fn> struct HeapOps {
+        static Fn *&target(void *storage) {
+            return *static_cast<Fn **>(storage);
+        }
+
+        static void invoke(void *storage) { (*target(storage))(); }
+
+        static void relocate(void *dst, void *src) {
+            ::new (dst) Fn *(target(src));
+        }
+
+        static void destroy(void *storage) { delete target(storage); }
+
+        static const Ops table;
+    };
+
+    template <typename Fn> static bool is_null(const Fn &fn, std::true_type) {
+        return fn == nullptr;
+    }
+
+    template <typename Fn> static bool is_null(const Fn &, std::false_type) {
+        return false;
+    }
+
+    template <typename Sig>
+    static bool is_null(const std::function<Sig> &fn, std::false_type) {
+        return !fn;
+    }
+
+    template <typename Fn, typename F> void emplace(F &&fn, std::true_type) {
+        ::new (static_cast<void *>(&storage_)) Fn(std::forward<F>(fn));
+        ops_ = &InlineOps<Fn>::table;
+    }
+
+    template <typename Fn, typename F> void emplace(F &&fn, std::false_type) {
+        Fn *target = new Fn(std::forward<F>(fn));
+        ::new (static_cast<void *>(&storage_)) Fn *(target);
+        ops_ = &HeapOps<Fn>::table;
+    }
+
+    void take(Task &other) noexcept {
+        if (other.ops_) {
+            other.ops_->relocate(&storage_, &other.storage_);
+            ops_ = other.ops_;
+            other.ops_ = nullptr;
+        }
+    }
+
+    void clear() noexcept {
+        if (ops_) {
+            const Ops *ops = ops_;
+            ops_ = nullptr;
+            ops->destroy(&storage_);
+        }
+    }
+
+    Storage storage_;
+    const Ops *ops_;
+};
+
+template <typename Fn>
+const Task::Ops Task::InlineOps<Fn>::table = {
+    &Task::InlineOps<Fn>::invoke, &Task::InlineOps<Fn>::relocate,
+    &Task::InlineOps<Fn>::destroy, true};
+
+template <typename Fn>
+const Task::Ops Task::HeapOps<Fn>::table = {
+    &Task::HeapOps<Fn>::invoke, &Task::HeapOps<Fn>::relocate,
+    &Task::HeapOps<Fn>::destroy, false};
+
+static_assert(sizeof(Task) == 64, "zco::Task should fill one cache line");
+
+} // namespace zco
+
+#endif // ZCO_TASK_H_
@@ -0,0 +1,180 @@
+#ifndef ZCO_TASK_GROUP_H_
+#define ZCO_TASK_GROUP_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "zco/future.h"
+#include "zco/internal/noncopyable.h"
+#include "zco/sched.h"
+
+namespace zco {
+
+/**
+ * @brief 子任务因所属 TaskGroup 已取消而没有执行。
+ */
+class TaskCancelled : public std::runtime_error {
+  public:
+    TaskCancelled() : std::runtime_error("zco task group cancelled") {}
+};
+
+namespace detail {
+
+/**
+ * @brief 子任务的结果类型。
+ */
+template <typename F>
+using task_result_t =
+    decltype(std::declval<typename std::decay<F>::type &>()());
+
+template <typename R, typename Fn> void fulfil(FutureState<R> *state, Fn &fn) {
+    state->set_value(fn());
+}
+
+template <typename Fn> void fulfil(FutureState<void> *state, Fn &fn) {
+    fn();
+    state->set_value();
+}
+
+} // namespace detail
+
+/**
+ * @brief 结构化并发的任务组。
+ * @details
+ * - go() 经 Scheduler::go 启动子协程，返回子任务结果的 Future；子任务
+ *   抛出的异常由 Future::get() 重新抛出。
+ * - 任一子任务抛出异常、显式 cancel() 或到达截止时间都会取消整个组：
+ *   尚未开始的子任务不再执行，其 Future 以 TaskCancelled 结束；运行中的
+ *   子协程被请求取消，sleep_for、带超时的 Event/Channel 等待立即按超时
+ *   返回，IoEvent 与 hook 的 IO 等待以 ECANCELED 失败。
+ * - 取消是协作式的，子任务根据等待结果或 zco::cancelled() 自行退出。
+ * - 析构时等待全部子任务结束，子任务可以安全引用组所在作用域的对象。
+ */
+class TaskGroup : public NonCopyable {
+  public:
+    /**
+     * @brief 构造不带截止时间的任务组。
+     */
+    TaskGroup();
+
+    /**
+     * @brief 构造带截止时间的任务组。
+     * @param deadline_ms 从构造开始计时，到期后自动 cancel()；
+     *        kInfiniteTimeoutMs 表示不设截止时间。
+     */
+    explicit TaskGroup(uint32_t deadline_ms);
+
+    /**
+     * @brief 等待全部子任务结束后析构。
+     */
+    ~TaskGroup();
+
+    /**
+     * @brief 在轮询选出的调度器上启动子任务。
+     * @param fn 无参可调用对象，需可复制。
+     * @return 子任务结果的 Future。
+     */
+    template <typename F> Future<detail::task_result_t<F>> go(F &&fn) {
+        return go(next_sched(), std::forward<F>(fn));
+    }
+
+    /**
+     * @brief 在指定调度器上启动子任务。
+     * @param scheduler 目标调度器，为空时按 zco::go 的策略投递。
+     * @param fn 无参可调用对象，需可复制。
+     * @return 子任务结果的 Future。
+     */
+    template <typename F>
+    Future<detail::task_result_t<F>> go(Scheduler *scheduler, F &&fn) {
+        using Fn = typename std::decay<F>::type;
+        using R = detail::task_result_t<F>;
+
+        auto future = std::make_shared<detail::FutureState<R>>();
+        const size_t index = add_child();
+        Task task([state = state_, index, future,
+                   fn = Fn(std::forward<F>(fn))]() mutable {
+            if (!enter_child(state, index)) {
+                future->set_exception(std::make_exception_ptr(TaskCancelled()));
+                leave_child(state, index, false);
+                return;
+            }
+
+            bool failed = false;
+            try {
+                detail::fulfil(future.get(), fn);
+            } catch (...) {
+                future->set_exception(std::current_exception());
+                failed = true;
+            }
+            leave_child(state, index, failed);
+        });
+
+        if (scheduler) {
+            scheduler->go(std::move(task));
+        } else {
+            ::zco::go(std::move(task));
+        }
+        return Future<R>(std::move(future));
+    }
+
+    /**
+     * @brief 等待全部子任务结束。
+     * @param timeout_ms 超时时间。
+     * @return true 表示全部结束；超时返回 false 并设置 errno 为
+     *         ETIMEDOUT，调用方协程自身被取消时为 ECANCELED。
+     */
+    bool wait_all(uint32_t timeout_ms = kInfiniteTimeoutMs) const;
+
+    /**
+     * @brief 等待任一子任务结束。
+     * @details 返回最先结束的子任务，之后再调用仍返回同一个下标。
+     * @param timeout_ms 超时时间。
+     * @return 子任务按 go() 调用顺序的下标；超时返回 -1 并设置 errno，
+     *         组内还没有子任务时返回 -1 且 errno 为 EINVAL。
+     */
+    int wait_any(uint32_t timeout_ms = kInfiniteTimeoutMs) const;
+
+    /**
+     * @brief 取消整个组，可重复调用。
+     * @param 无参数。
+     * @return 无返回值。
+     */
+    void cancel() const;
+
+    /**
+     * @brief 判断组是否已被取消。
+     * @param 无参数。
+     * @return true 表示已取消（显式取消、子任务失败或到达截止时间）。
+     */
+    bool cancelled() const;
+
+    /**
+     * @brief 获取已启动的子任务数量。
+     * @param 无参数。
+     * @return 子任务数量。
+     */
+    size_t size() const;
+
+  private:
+    struct State;
+
+    size_t add_child() const;
+
+    static bool enter_child(const std::shared_ptr<State> &state, size_t index);
+
+    static void leave_child(const std::shared_ptr<State> &state, size_t index,
+                            bool failed);
+
+    static void cancel_state(State *state);
+
+    std::shared_ptr<State> state_;
+};
+
+} // namespace zco
+
+#endif // ZCO_TASK_GROUP_H_
@@ -1,13 +1,20 @@
 #ifndef ZCO_ZCO_H_
 #define ZCO_ZCO_H_
 
+#include "zco/blocking.h"
 #include "zco/channel.h"
 #include "zco/event.h"
+#include "zco/file.h"
+#include "zco/fiber_local.h"
+#include "zco/future.h"
 #include "zco/hook.h"
 #include "zco/io_event.h"
 #include "zco/mutex.h"
 #include "zco/pool.h"
 #include "zco/sched.h"
+#include "zco/select.h"
+#include "zco/stats.h"
+#include "zco/task_group.h"
 #include "zco/wait_group.h"
 #include "zco/zco_log.h"
 
@@ -24,6 +31,12 @@ using pool = Pool;
 using io_event = IoEvent;
 using mutex = Mutex;
 using mutex_guard = MutexGuard;
+using shared_mutex = SharedMutex;
+using rw_mutex = RWMutex;
+template <typename T> using future = Future<T>;
+template <typename T> using promise = Promise<T>;
+using task_group = TaskGroup;
+template <typename T> using fiber_local = FiberLocal<T>;
 
 } // namespace zco
 #endif // ZCO_ZCO_H_
@@ -0,0 +1,193 @@
+#include "zco/internal/blocking_pool.h"
+
+#include <chrono>
+#include <exception>
+#include <thread>
+
+#include "zco/internal/fiber.h"
+#include "zco/internal/processor.h"
+#include "zco/internal/runtime_manager.h"
+#include "zco/internal/timer.h"
+#include "zco/zco_log.h"
+
+namespace zco {
+
+// blocking_pool.cc 把会占住线程的调用移出调度器：
+// - 协程先标记为等待再提交，调用结束时无论协程是否已经切出，
+//   resume_fiber 都能把它投回原处理器。
+// - 阻塞线程只访问堆上的调用对象，恢复协程后立即放手。
+
+BlockingPool &BlockingPool::instance() {
+    static BlockingPool *pool = new BlockingPool();
+    return *pool;
+}
+
+BlockingPool::BlockingPool()
+    : mutex_(), work_cv_(), idle_cv_(), head_(nullptr), tail_(nullptr),
+      max_threads_(kDefaultBlockingThreads), threads_(0), idle_threads_(0),
+      busy_threads_(0), queued_(0), peak_queued_(0), submitted_(0),
+      completed_(0), queue_wait_ns_(0), run_ns_(0) {}
+
+bool BlockingPool::set_max_threads(uint32_t max_threads) {
+    if (max_threads == 0) {
+        ZCO_LOG_WARN("co_blocking_threads ignored invalid value 0");
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    max_threads_ = max_threads;
+    // 叫醒空闲线程，让多出的线程退出。
+    work_cv_.notify_all();
+    return true;
+}
+
+void BlockingPool::submit(detail::BlockingCallBase *call, void *fiber) {
+    call->next_ = nullptr;
+    call->waiter_ = fiber;
+    call->enqueued_ns_ = now_ns();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (tail_) {
+        tail_->next_ = call;
+    } else {
+        head_ = call;
+    }
+    tail_ = call;
+    ++submitted_;
+    if (++queued_ > peak_queued_) {
+        peak_queued_ = queued_;
+    }
+
+    if (idle_threads_ >= queued_ || threads_ >= max_threads_) {
+        work_cv_.notify_one();
+        return;
+    }
+
+    ++threads_;
+    try {
+        std::thread(&BlockingPool::worker_loop, this).detach();
+        return;
+    } catch (const std::exception &ex) {
+        --threads_;
+        ZCO_LOG_ERROR("blocking pool failed to start thread, threads={}, "
+                      "error={}",
+                      threads_, ex.what());
+    }
+    if (threads_ != 0) {
+        // 现有线程迟早会取走这个调用。
+        return;
+    }
+
+    // 一个线程都没有时只能就地执行。
+    detail::BlockingCallBase *first = head_;
+    head_ = first->next_;
+    if (!head_) {
+        tail_ = nullptr;
+    }
+    --queued_;
+    ++busy_threads_;
+    lock.unlock();
+    const uint64_t run_ns = run_and_resume(first);
+    lock.lock();
+    --busy_threads_;
+    ++completed_;
+    run_ns_ += run_ns;
+    if (!head_ && busy_threads_ == 0) {
+        idle_cv_.notify_all();
+    }
+}
+
+void BlockingPool::wait_idle() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_cv_.wait(lock, [this]() { return !head_ && busy_threads_ == 0; });
+}
+
+BlockingPoolStats BlockingPool::stats() const {
+    BlockingPoolStats snapshot;
+    std::lock_guard<std::mutex> lock(mutex_);
+    snapshot.max_threads = max_threads_;
+    snapshot.threads = threads_;
+    snapshot.busy_threads = busy_threads_;
+    snapshot.queued = queued_;
+    snapshot.peak_queued = peak_queued_;
+    snapshot.submitted = submitted_;
+    snapshot.completed = completed_;
+    snapshot.queue_wait_ns = queue_wait_ns_;
+    snapshot.run_ns = run_ns_;
+    return snapshot;
+}
+
+void BlockingPool::worker_loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        while (!head_ && threads_ <= max_threads_) {
+            ++idle_threads_;
+            const std::cv_status status = work_cv_.wait_for(
+                lock, std::chrono::milliseconds(kBlockingThreadIdleMs));
+            --idle_threads_;
+            if (status == std::cv_status::timeout && !head_) {
+                break;
+            }
+        }
+        if (!head_ || threads_ > max_threads_) {
+            --threads_;
+            return;
+        }
+
+        detail::BlockingCallBase *call = head_;
+        head_ = call->next_;
+        if (!head_) {
+            tail_ = nullptr;
+        }
+        --queued_;
+        ++busy_threads_;
+        const uint64_t started_ns = now_ns();
+        queue_wait_ns_ += started_ns - call->enqueued_ns_;
+
+        lock.unlock();
+        const uint64_t run_ns = run_and_resume(call);
+        lock.lock();
+
+        --busy_threads_;
+        ++completed_;
+        run_ns_ += run_ns;
+        if (!head_ && busy_threads_ == 0) {
+            idle_cv_.notify_all();
+        }
+    }
+}
+
+uint64_t BlockingPool::run_and_resume(detail::BlockingCallBase *call) {
+    const uint64_t started_ns = now_ns();
+    call->run();
+    const uint64_t run_ns = now_ns() - started_ns;
+
+    // 先取出协程引用，恢复之后 call 随时可能被释放。
+    Fiber::ptr waiter(static_cast<Fiber *>(call->waiter_), false);
+    call->waiter_ = nullptr;
+    resume_fiber(std::move(waiter), false);
+    return run_ns;
+}
+
+namespace detail {
+
+void run_blocking(BlockingCallBase *call) {
+    Processor *processor = current_processor();
+    Fiber *fiber = processor ? processor->current_fiber() : nullptr;
+    if (!fiber) {
+        call->run();
+        return;
+    }
+
+    prepare_current_wait();
+    BlockingPool::instance().submit(call, Fiber::ptr(fiber).detach());
+    park_current();
+}
+
+} // namespace detail
+
+void co_blocking_threads(uint32_t max_threads) {
+    BlockingPool::instance().set_max_threads(max_threads);
+}
+
+} // namespace zco
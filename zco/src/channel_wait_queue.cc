@@ -0,0 +1,264 @@
+#include "zco/internal/channel_wait_queue.h"
+
+#include <chrono>
+#include <utility>
+
+#include "zco/internal/fiber.h"
+#include "zco/internal/processor.h"
+#include "zco/internal/runtime_manager.h"
+#include "zco/zco_log.h"
+
+namespace zco {
+
+// channel_wait_queue.cc 只处理通道的慢路径：
+// - 缓冲区本身是无锁环形队列，放在 channel.h 的模板里。
+// - 这里负责登记、挂起、交接唤醒，以及超时后把自己摘下来。
+
+ChannelWaitQueue::ChannelWaitQueue()
+    : mutex_(), heads_{nullptr, nullptr}, tails_{nullptr, nullptr},
+      free_nodes_(nullptr) {
+    counts_[kReader].store(0, std::memory_order_relaxed);
+    counts_[kWriter].store(0, std::memory_order_relaxed);
+}
+
+ChannelWaitQueue::~ChannelWaitQueue() {
+    if (heads_[kReader] || heads_[kWriter]) {
+        ZCO_LOG_ERROR("channel destroyed with waiters still parked");
+    }
+}
+
+ChannelWaiter::Result ChannelWaitQueue::wait(ChannelWaiter *waiter, Side side,
+                                             uint32_t timeout_ms,
+                                             ReadyFn ready,
+                                             const void *context) {
+    const bool coroutine = in_coroutine();
+    Fiber::ptr self = coroutine ? current_fiber_shared() : Fiber::ptr();
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    counts_[side].fetch_add(1, std::memory_order_seq_cst);
+    // 与 notify() 中的栅栏配对：要么这里看到对方刚发布的数据，
+    // 要么对方看到这里的计数并来唤醒。
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (ready(context)) {
+        counts_[side].fetch_sub(1, std::memory_order_relaxed);
+        return ChannelWaiter::Result::kRetry;
+    }
+
+    waiter->result = ChannelWaiter::Result::kNone;
+    waiter->claimed = false;
+    waiter->fiber = self.detach();
+    link_locked(side, waiter);
+
+    if (!coroutine) {
+        auto woken = [waiter]() {
+            return waiter->result != ChannelWaiter::Result::kNone;
+        };
+        if (timeout_ms == kInfiniteTimeoutMs) {
+            waiter->cv.wait(lock, woken);
+            return waiter->result;
+        }
+        if (!waiter->cv.wait_for(lock, std::chrono::milliseconds(timeout_ms),
+                                 woken)) {
+            if (!waiter->claimed) {
+                unlink_locked(side, waiter);
+                return ChannelWaiter::Result::kTimeout;
+            }
+            // 已被摘下，唤醒方马上会写入结果。
+            waiter->cv.wait(lock, woken);
+        }
+        return waiter->result;
+    }
+
+    // 持锁标记等待态，唤醒方只能在登记可见之后 try_wake。
+    prepare_current_wait();
+    lock.unlock();
+
+    const bool ok = timeout_ms == kInfiniteTimeoutMs
+                        ? park_current()
+                        : park_current_for(timeout_ms);
+    if (ok && waiter->result != ChannelWaiter::Result::kNone) {
+        return waiter->result;
+    }
+
+    // 超时或被其他路径唤醒：claim() 的 try_wake 必然失败，节点要么仍挂着，
+    // 要么已被 claim() 当作失效节点摘掉。
+    lock.lock();
+    if (waiter->linked) {
+        unlink_locked(side, waiter);
+    }
+    return ok ? ChannelWaiter::Result::kRetry
+              : ChannelWaiter::Result::kTimeout;
+}
+
+bool ChannelWaitQueue::enqueue(ChannelWaiter *waiter, Side side,
+                               ReadyFn ready, const void *context) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    counts_[side].fetch_add(1, std::memory_order_seq_cst);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (ready(context)) {
+        counts_[side].fetch_sub(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    waiter->result = ChannelWaiter::Result::kNone;
+    waiter->claimed = false;
+    waiter->fiber = current_fiber_shared().detach();
+    link_locked(side, waiter);
+    return true;
+}
+
+ChannelWaiter::Result ChannelWaitQueue::cancel(ChannelWaiter *waiter,
+                                               Side side) {
+    // 协程已恢复：唤醒它的 claim() 早已 complete()，其余通道上的节点
+    // 要么仍挂着，要么已被当作失效节点摘掉。
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (waiter->linked) {
+        unlink_locked(side, waiter);
+    }
+    return waiter->result;
+}
+
+ChannelWaiter *ChannelWaitQueue::claim(Side side) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return claim_locked(side);
+}
+
+void ChannelWaitQueue::complete(ChannelWaiter *waiter,
+                                ChannelWaiter::Result result) {
+    if (!waiter->fiber) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        waiter->result = result;
+        waiter->cv.notify_one();
+        return;
+    }
+
+    // claim() 已经 try_wake 成功，协程在重新入队前不会读取节点。
+    Fiber::ptr fiber(waiter->fiber, false);
+    waiter->fiber = nullptr;
+    waiter->result = result;
+    Processor *owner = fiber->owner();
+    owner->enqueue_ready(std::move(fiber));
+}
+
+void ChannelWaitQueue::notify(Side side, size_t max_count) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!has_waiters(side)) {
+        return;
+    }
+
+    ChannelWaiter *claimed = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (size_t i = 0; i < max_count; ++i) {
+            ChannelWaiter *waiter = claim_locked(side);
+            if (!waiter) {
+                break;
+            }
+            waiter->next = claimed;
+            claimed = waiter;
+        }
+    }
+
+    while (claimed) {
+        ChannelWaiter *next = claimed->next;
+        complete(claimed, ChannelWaiter::Result::kRetry);
+        claimed = next;
+    }
+}
+
+void ChannelWaitQueue::notify_all(ChannelWaiter::Result result) {
+    ChannelWaiter *claimed = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (int side = kReader; side <= kWriter; ++side) {
+            while (ChannelWaiter *waiter =
+                       claim_locked(static_cast<Side>(side))) {
+                waiter->next = claimed;
+                claimed = waiter;
+            }
+        }
+    }
+
+    size_t woken = 0;
+    while (claimed) {
+        ChannelWaiter *next = claimed->next;
+        complete(claimed, result);
+        claimed = next;
+        ++woken;
+    }
+    ZCO_LOG_DEBUG("channel wait queue notify_all, woken={}", woken);
+}
+
+ChannelWaiter *ChannelWaitQueue::acquire_node() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ChannelWaiter *waiter = free_nodes_;
+    if (waiter) {
+        free_nodes_ = waiter->next;
+        waiter->next = nullptr;
+    }
+    return waiter;
+}
+
+void ChannelWaitQueue::release_node(ChannelWaiter *waiter) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    waiter->next = free_nodes_;
+    free_nodes_ = waiter;
+}
+
+ChannelWaiter *ChannelWaitQueue::take_free_nodes() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ChannelWaiter *nodes = free_nodes_;
+    free_nodes_ = nullptr;
+    return nodes;
+}
+
+void ChannelWaitQueue::link_locked(Side side, ChannelWaiter *waiter) {
+    waiter->prev = tails_[side];
+    waiter->next = nullptr;
+    if (tails_[side]) {
+        tails_[side]->next = waiter;
+    } else {
+        heads_[side] = waiter;
+    }
+    tails_[side] = waiter;
+    waiter->linked = true;
+}
+
+void ChannelWaitQueue::unlink_locked(Side side, ChannelWaiter *waiter) {
+    if (waiter->prev) {
+        waiter->prev->next = waiter->next;
+    } else {
+        heads_[side] = waiter->next;
+    }
+    if (waiter->next) {
+        waiter->next->prev = waiter->prev;
+    } else {
+        tails_[side] = waiter->prev;
+    }
+    waiter->prev = nullptr;
+    waiter->next = nullptr;
+    waiter->linked = false;
+    counts_[side].fetch_sub(1, std::memory_order_relaxed);
+
+    if (waiter->fiber && !waiter->claimed) {
+        // 失效或超时的协程节点，归还登记时取得的引用。
+        Fiber::ptr stale(waiter->fiber, false);
+        waiter->fiber = nullptr;
+    }
+}
+
+ChannelWaiter *ChannelWaitQueue::claim_locked(Side side) {
+    while (ChannelWaiter *waiter = heads_[side]) {
+        // 协程可能已被超时回调唤醒，try_wake 失败说明节点已失效。
+        const bool claimed = waiter->fiber ? waiter->fiber->try_wake(false)
+                                           : true;
+        waiter->claimed = claimed;
+        unlink_locked(side, waiter);
+        if (claimed) {
+            return waiter;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace zco
@@ -1,13 +1,18 @@
 #include "zco/internal/context.h"
 
+#include <cstdint>
+#include <cstdlib>
+
 namespace zco {
 
+#if defined(ZCO_CONTEXT_BACKEND_UCONTEXT)
+
 void Context::make_context(void *stack_ptr, size_t stack_size, void (*func)(),
-                           ucontext_t *link) {
+                           Context *link) {
     getcontext(&ctx_);
     ctx_.uc_stack.ss_sp = stack_ptr;
     ctx_.uc_stack.ss_size = stack_size;
-    ctx_.uc_link = link;
+    ctx_.uc_link = link ? &link->ctx_ : nullptr;
     makecontext(&ctx_, func, 0);
 }
 
@@ -16,7 +21,7 @@ int Context::swap_context(Context *from_ctx, Context *to_ctx) {
         return -1;
     }
 
-    return swapcontext(from_ctx->get(), to_ctx->get());
+    return swapcontext(&from_ctx->ctx_, &to_ctx->ctx_);
 }
 
 int Context::get_context() { return getcontext(&ctx_); }
@@ -31,4 +36,187 @@ void *Context::get_stack_pointer() const {
 #endif
 }
 
-} // namespace zco
\ No newline at end of file
+const char *Context::backend_name() { return "ucontext"; }
+
+#else // 汇编后端
+
+// 汇编后端只做三件事：
+// - 把 callee-saved 寄存器压到当前栈，并把栈指针写回 from。
+// - 切换到 to 保存的栈指针，弹出对端寄存器后 ret/br 回对端。
+// - 新上下文首次切入时经由 trampoline 调用 context_start(func, link)。
+// 整个过程不触碰信号掩码，也就没有 swapcontext 的 rt_sigprocmask 系统调用。
+
+extern "C" {
+__attribute__((visibility("hidden"))) void
+zco_context_switch(void **from_stack_pointer, void *to_stack_pointer);
+__attribute__((visibility("hidden"))) void zco_context_trampoline();
+}
+
+#if defined(__x86_64__)
+
+// 栈帧布局（低地址 -> 高地址）：
+// [mxcsr|x87 cw] r15 r14 r13 r12 rbx rbp <ret>
+asm(R"(
+    .text
+    .globl zco_context_switch
+    .hidden zco_context_switch
+    .type zco_context_switch, @function
+    .p2align 4
+zco_context_switch:
+    pushq %rbp
+    pushq %rbx
+    pushq %r12
+    pushq %r13
+    pushq %r14
+    pushq %r15
+    subq $8, %rsp
+    stmxcsr (%rsp)
+    fnstcw 4(%rsp)
+    movq %rsp, (%rdi)
+    movq %rsi, %rsp
+    ldmxcsr (%rsp)
+    fldcw 4(%rsp)
+    addq $8, %rsp
+    popq %r15
+    popq %r14
+    popq %r13
+    popq %r12
+    popq %rbx
+    popq %rbp
+    ret
+    .size zco_context_switch, .-zco_context_switch
+
+    .globl zco_context_trampoline
+    .hidden zco_context_trampoline
+    .type zco_context_trampoline, @function
+    .p2align 4
+zco_context_trampoline:
+    movq %r13, %rdi
+    movq %r14, %rsi
+    callq *%r12
+    ud2
+    .size zco_context_trampoline, .-zco_context_trampoline
+)");
+
+#elif defined(__aarch64__)
+
+// 栈帧布局（相对 sp 偏移）：
+// 0x00 d8-d15 | 0x40 x19-x28 | 0x90 x29 x30
+asm(R"(
+    .text
+    .globl zco_context_switch
+    .hidden zco_context_switch
+    .type zco_context_switch, %function
+    .p2align 4
+zco_context_switch:
+    sub sp, sp, #0xa0
+    stp d8, d9, [sp, #0x00]
+    stp d10, d11, [sp, #0x10]
+    stp d12, d13, [sp, #0x20]
+    stp d14, d15, [sp, #0x30]
+    stp x19, x20, [sp, #0x40]
+    stp x21, x22, [sp, #0x50]
+    stp x23, x24, [sp, #0x60]
+    stp x25, x26, [sp, #0x70]
+    stp x27, x28, [sp, #0x80]
+    stp x29, x30, [sp, #0x90]
+    mov x9, sp
+    str x9, [x0]
+    mov sp, x1
+    ldp d8, d9, [sp, #0x00]
+    ldp d10, d11, [sp, #0x10]
+    ldp d12, d13, [sp, #0x20]
+    ldp d14, d15, [sp, #0x30]
+    ldp x19, x20, [sp, #0x40]
+    ldp x21, x22, [sp, #0x50]
+    ldp x23, x24, [sp, #0x60]
+    ldp x25, x26, [sp, #0x70]
+    ldp x27, x28, [sp, #0x80]
+    ldp x29, x30, [sp, #0x90]
+    add sp, sp, #0xa0
+    ret
+    .size zco_context_switch, .-zco_context_switch
+
+    .globl zco_context_trampoline
+    .hidden zco_context_trampoline
+    .type zco_context_trampoline, %function
+    .p2align 4
+zco_context_trampoline:
+    mov x0, x20
+    mov x1, x21
+    blr x19
+    brk #0
+    .size zco_context_trampoline, .-zco_context_trampoline
+)");
+
+#endif
+
+namespace {
+
+void context_start(void (*func)(), Context *link) {
+    // func 自然返回后切回 link，等价于 ucontext 的 uc_link 语义；
+    // 当前栈帧随后被丢弃，不会再被恢复。
+    func();
+
+    Context finished;
+    if (!link) {
+        std::abort();
+    }
+    Context::swap_context(&finished, link);
+    std::abort();
+}
+
+} // namespace
+
+void Context::make_context(void *stack_ptr, size_t stack_size, void (*func)(),
+                           Context *link) {
+    const uintptr_t stack_top =
+        (reinterpret_cast<uintptr_t>(stack_ptr) + stack_size) &
+        ~static_cast<uintptr_t>(15);
+    void (*entry)(void (*)(), Context *) = &context_start;
+
+#if defined(__x86_64__)
+    // 预留 16 字节后放置 8 个槽位，保证 ret 进入 trampoline 时 rsp 16
+    // 字节对齐；trampoline 从 r12/r13/r14 取出 entry/func/link。
+    uint64_t *frame = reinterpret_cast<uint64_t *>(stack_top - 16 - 8 * 8);
+    frame[0] = 0x0000037F00001F80ULL; // 默认 mxcsr 与 x87 控制字
+    frame[1] = 0;                     // r15
+    frame[2] = reinterpret_cast<uint64_t>(link);
+    frame[3] = reinterpret_cast<uint64_t>(func);
+    frame[4] = reinterpret_cast<uint64_t>(entry);
+    frame[5] = 0; // rbx
+    frame[6] = 0; // rbp
+    frame[7] = reinterpret_cast<uint64_t>(&zco_context_trampoline);
+#elif defined(__aarch64__)
+    // x19/x20/x21 依次放 entry/func/link，x30 指向 trampoline。
+    uint64_t *frame = reinterpret_cast<uint64_t *>(stack_top - 0xa0);
+    for (size_t i = 0; i < 0xa0 / sizeof(uint64_t); ++i) {
+        frame[i] = 0;
+    }
+    frame[8] = reinterpret_cast<uint64_t>(entry);
+    frame[9] = reinterpret_cast<uint64_t>(func);
+    frame[10] = reinterpret_cast<uint64_t>(link);
+    frame[19] = reinterpret_cast<uint64_t>(&zco_context_trampoline);
+#endif
+
+    stack_pointer_ = frame;
+}
+
+int Context::swap_context(Context *from_ctx, Context *to_ctx) {
+    if (!from_ctx || !to_ctx) {
+        return -1;
+    }
+
+    zco_context_switch(&from_ctx->stack_pointer_, to_ctx->stack_pointer_);
+    return 0;
+}
+
+int Context::get_context() { return 0; }
+
+void *Context::get_stack_pointer() const { return stack_pointer_; }
+
+const char *Context::backend_name() { return "asm"; }
+
+#endif
+
+} // namespace zco
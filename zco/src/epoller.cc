@@ -6,9 +6,11 @@
 #include <sys/eventfd.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <utility>
 #include <vector>
 
+#include "zco/internal/syscall_hook.h"
 #include "zco/zco_log.h"
 
 namespace zco {
@@ -17,6 +19,8 @@ namespace zco {
 // - 一个 epoll 实例管理所有 fd 等待。
 // - 一个 eventfd 用于跨线程唤醒 epoll_wait。
 // - 每个 fd 维护读/写两个等待槽位，避免相互覆盖。
+// - attach_fd 接入的 fd 以 EPOLLET 常驻注册，就绪位在用户态记录，
+//   waiter 增删不再触发 epoll_ctl。
 
 namespace {
 
@@ -39,9 +43,10 @@ void collect_waiter_unique(std::vector<std::shared_ptr<IoWaiter>> *waiters,
 
 } // namespace
 
-Epoller::Epoller()
-    : epoll_fd_(-1), wake_fd_(-1), wake_pending_(false), waiter_mutex_(),
-      fd_wait_states_() {}
+Epoller::Epoller(bool persistent_fds)
+    : epoll_fd_(-1), wake_fd_(-1), wake_pending_(false),
+      persistent_fds_(persistent_fds), polling_(false), waiter_mutex_(),
+      fd_wait_states_(), pending_ready_(), syscall_count_(0) {}
 
 Epoller::~Epoller() { stop(); }
 
@@ -60,7 +65,7 @@ bool Epoller::start() {
     ::memset(&wake_ev, 0, sizeof(wake_ev));
     wake_ev.events = EPOLLIN;
     wake_ev.data.fd = wake_fd_;
-    if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &wake_ev) != 0) {
+    if (control(EPOLL_CTL_ADD, wake_fd_, &wake_ev) != 0) {
         ZCO_LOG_FATAL("epoller register wake fd failed, wake_fd={}, errno={}",
                       wake_fd_, errno);
         stop();
@@ -76,6 +81,7 @@ void Epoller::stop() {
     {
         std::lock_guard<std::mutex> lock(waiter_mutex_);
         fd_wait_states_.clear();
+        pending_ready_.clear();
     }
 
     if (wake_fd_ >= 0) {
@@ -104,6 +110,7 @@ void Epoller::wake() {
     }
 
     const uint64_t value = 1;
+    syscall_count_.fetch_add(1, std::memory_order_relaxed);
     const ssize_t rc = write(wake_fd_, &value, sizeof(value));
     if (rc < 0 && errno != EAGAIN) {
         wake_pending_.store(false, std::memory_order_release);
@@ -125,9 +132,9 @@ bool Epoller::register_waiter(const std::shared_ptr<IoWaiter> &waiter) {
         return false;
     }
 
-    std::lock_guard<std::mutex> lock(waiter_mutex_);
+    std::unique_lock<std::mutex> lock(waiter_mutex_);
 
-    FdWaitState &state = fd_wait_states_[waiter->fd];
+    FdWaitState &state = state_locked(waiter->fd);
     FdWaitState old_state = state;
 
     if (state.read_waiter &&
@@ -155,14 +162,42 @@ bool Epoller::register_waiter(const std::shared_ptr<IoWaiter> &waiter) {
         state.write_waiter = waiter;
     }
 
+    if (state.persistent) {
+        // 常驻注册下只需检查用户态就绪位：边沿已经到达过的方向直接投递，
+        // 由调用方重试 I/O；未到达的方向等待下一个边沿。
+        uint32_t ready_events = 0;
+        if (want_read && state.read_ready) {
+            ready_events |= EPOLLIN;
+            state.read_ready = false;
+        }
+        if (want_write && state.write_ready) {
+            ready_events |= EPOLLOUT;
+            state.write_ready = false;
+        }
+        if (ready_events == 0) {
+            return true;
+        }
+
+        if (state.read_waiter.get() == waiter.get()) {
+            state.read_waiter.reset();
+        }
+        if (state.write_waiter.get() == waiter.get()) {
+            state.write_waiter.reset();
+        }
+        pending_ready_.push_back(std::make_pair(waiter, ready_events));
+        lock.unlock();
+
+        if (polling_.load(std::memory_order_acquire)) {
+            wake();
+        }
+        return true;
+    }
+
     if (update_interest_locked(waiter->fd, &state)) {
         return true;
     }
 
     state = old_state;
-    if (!state.registered && !state.read_waiter && !state.write_waiter) {
-        fd_wait_states_.erase(waiter->fd);
-    }
     return false;
 }
 
@@ -172,12 +207,11 @@ void Epoller::unregister_waiter(const std::shared_ptr<IoWaiter> &waiter) {
     }
 
     std::lock_guard<std::mutex> lock(waiter_mutex_);
-    auto it = fd_wait_states_.find(waiter->fd);
-    if (it == fd_wait_states_.end()) {
+    if (static_cast<size_t>(waiter->fd) >= fd_wait_states_.size()) {
         return;
     }
 
-    FdWaitState &state = it->second;
+    FdWaitState &state = fd_wait_states_[waiter->fd];
     bool changed = false;
 
     if ((waiter->events & EPOLLIN) && state.read_waiter.get() == waiter.get()) {
@@ -191,13 +225,9 @@ void Epoller::unregister_waiter(const std::shared_ptr<IoWaiter> &waiter) {
         changed = true;
     }
 
-    if (changed) {
+    if (changed && !state.persistent) {
         (void)update_interest_locked(waiter->fd, &state);
     }
-
-    if (!state.registered && !state.read_waiter && !state.write_waiter) {
-        fd_wait_states_.erase(it);
-    }
 }
 
 std::vector<std::shared_ptr<IoWaiter>> Epoller::cancel_fd(int fd, int error) {
@@ -207,14 +237,22 @@ std::vector<std::shared_ptr<IoWaiter>> Epoller::cancel_fd(int fd, int error) {
     }
 
     std::lock_guard<std::mutex> lock(waiter_mutex_);
-    auto it = fd_wait_states_.find(fd);
-    if (it == fd_wait_states_.end()) {
+    if (static_cast<size_t>(fd) >= fd_wait_states_.size()) {
         return waiters;
     }
 
-    FdWaitState &state = it->second;
+    FdWaitState &state = fd_wait_states_[fd];
     collect_waiter_unique(&waiters, state.read_waiter);
     collect_waiter_unique(&waiters, state.write_waiter);
+    for (size_t i = 0; i < pending_ready_.size();) {
+        if (pending_ready_[i].first->fd == fd) {
+            collect_waiter_unique(&waiters, pending_ready_[i].first);
+            pending_ready_.erase(pending_ready_.begin() +
+                                 static_cast<std::ptrdiff_t>(i));
+            continue;
+        }
+        ++i;
+    }
 
     for (size_t i = 0; i < waiters.size(); ++i) {
         waiters[i]->error.store(error, std::memory_order_release);
@@ -224,15 +262,49 @@ std::vector<std::shared_ptr<IoWaiter>> Epoller::cancel_fd(int fd, int error) {
     state.write_waiter.reset();
 
     if (state.registered &&
-        epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr) != 0 &&
+        control(EPOLL_CTL_DEL, fd, nullptr) != 0 &&
         errno != ENOENT && errno != EBADF) {
         ZCO_LOG_WARN("epoll cancel fd failed, fd={}, errno={}", fd, errno);
     }
 
-    fd_wait_states_.erase(it);
+    state = FdWaitState();
     return waiters;
 }
 
+bool Epoller::attach_fd(int fd) {
+    if (!persistent_fds_ || epoll_fd_ < 0 || fd < 0) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(waiter_mutex_);
+    FdWaitState &state = state_locked(fd);
+    if (state.persistent) {
+        return true;
+    }
+
+    epoll_event ev;
+    ::memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN | EPOLLOUT | EPOLLET;
+    ev.data.fd = fd;
+
+    // fd 号可能被未经 co_close 关闭的旧 fd 复用，ADD 冲突时改用 MOD 覆盖。
+    int rc = control(EPOLL_CTL_ADD, fd, &ev);
+    if (rc != 0 && errno == EEXIST) {
+        rc = control(EPOLL_CTL_MOD, fd, &ev);
+    }
+    if (rc != 0) {
+        ZCO_LOG_WARN("epoll attach fd failed, fd={}, errno={}", fd, errno);
+        return false;
+    }
+
+    state.registered = true;
+    state.registered_events = ev.events;
+    state.persistent = true;
+    state.read_ready = false;
+    state.write_ready = false;
+    return true;
+}
+
 bool Epoller::update_interest_locked(int fd, FdWaitState *state) {
     if (!state) {
         errno = EINVAL;
@@ -251,7 +323,7 @@ bool Epoller::update_interest_locked(int fd, FdWaitState *state) {
 
     if (desired_events == 0) {
         if (state->registered) {
-            if (epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr) != 0 &&
+            if (control(EPOLL_CTL_DEL, fd, nullptr) != 0 &&
                 errno != ENOENT) {
                 ZCO_LOG_WARN("epoll del waiter failed, fd={}, errno={}", fd,
                              errno);
@@ -274,13 +346,13 @@ bool Epoller::update_interest_locked(int fd, FdWaitState *state) {
     ev.data.fd = fd;
 
     int op = state->registered ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
-    int rc = epoll_ctl(epoll_fd_, op, fd, &ev);
+    int rc = control(op, fd, &ev);
     if (rc != 0 && op == EPOLL_CTL_ADD && errno == EEXIST) {
         op = EPOLL_CTL_MOD;
-        rc = epoll_ctl(epoll_fd_, op, fd, &ev);
+        rc = control(op, fd, &ev);
     } else if (rc != 0 && op == EPOLL_CTL_MOD && errno == ENOENT) {
         op = EPOLL_CTL_ADD;
-        rc = epoll_ctl(epoll_fd_, op, fd, &ev);
+        rc = control(op, fd, &ev);
     }
 
     if (rc != 0) {
@@ -302,18 +374,28 @@ void Epoller::wait_events(
         return;
     }
 
+    std::vector<std::pair<std::shared_ptr<IoWaiter>, uint32_t>> ready_waiters;
+    {
+        std::lock_guard<std::mutex> lock(waiter_mutex_);
+        ready_waiters.swap(pending_ready_);
+    }
+    if (!ready_waiters.empty()) {
+        // 已有就绪 waiter 时只做非阻塞收割，避免推迟它们的恢复。
+        timeout_ms = 0;
+    }
+
     epoll_event events[kMaxEpollEvents];
-    const int event_count =
-        epoll_wait(epoll_fd_, events, kMaxEpollEvents, timeout_ms);
-    if (event_count <= 0) {
-        if (event_count < 0 && errno != EINTR) {
-            ZCO_LOG_WARN("epoll_wait failed, errno={}", errno);
-        }
-        return;
+    polling_.store(true, std::memory_order_release);
+    syscall_count_.fetch_add(1, std::memory_order_relaxed);
+    const int event_count = sys_calls().epoll_wait(epoll_fd_, events,
+                                                   kMaxEpollEvents, timeout_ms);
+    polling_.store(false, std::memory_order_release);
+    if (event_count < 0 && errno != EINTR) {
+        ZCO_LOG_WARN("epoll_wait failed, errno={}", errno);
     }
 
-    std::vector<std::pair<std::shared_ptr<IoWaiter>, uint32_t>> ready_waiters;
-    ready_waiters.reserve(static_cast<size_t>(event_count) * 2);
+    ready_waiters.reserve(ready_waiters.size() +
+                          static_cast<size_t>(std::max(event_count, 0)) * 2);
 
     for (int i = 0; i < event_count; ++i) {
         if (events[i].data.fd == wake_fd_) {
@@ -326,33 +408,40 @@ void Epoller::wait_events(
         const uint32_t ready_events = events[i].events;
 
         std::lock_guard<std::mutex> lock(waiter_mutex_);
-        auto it = fd_wait_states_.find(fd);
-        if (it == fd_wait_states_.end()) {
+        if (static_cast<size_t>(fd) >= fd_wait_states_.size()) {
             continue;
         }
 
-        FdWaitState &state = it->second;
+        FdWaitState &state = fd_wait_states_[fd];
         const bool read_ready =
             (ready_events & (EPOLLIN | EPOLLHUP | EPOLLERR)) != 0;
         const bool write_ready =
             (ready_events & (EPOLLOUT | EPOLLHUP | EPOLLERR)) != 0;
 
-        if (read_ready && state.read_waiter) {
+        const bool read_consumed = read_ready && state.read_waiter;
+        if (read_consumed) {
             ready_waiters.push_back(
                 std::make_pair(state.read_waiter, ready_events));
             state.read_waiter.reset();
         }
 
-        if (write_ready && state.write_waiter) {
+        const bool write_consumed = write_ready && state.write_waiter;
+        if (write_consumed) {
             ready_waiters.push_back(
                 std::make_pair(state.write_waiter, ready_events));
             state.write_waiter.reset();
         }
 
-        (void)update_interest_locked(fd, &state);
-        if (!state.registered && !state.read_waiter && !state.write_waiter) {
-            fd_wait_states_.erase(it);
+        if (state.persistent) {
+            // 边沿只通知一次，没有 waiter 消费的方向记录下来供下次注册使用。
+            state.read_ready =
+                state.read_ready || (read_ready && !read_consumed);
+            state.write_ready =
+                state.write_ready || (write_ready && !write_consumed);
+            continue;
         }
+
+        (void)update_interest_locked(fd, &state);
     }
 
     if (on_ready) {
@@ -374,13 +463,33 @@ void Epoller::consume_wakeup_fd() {
 
     uint64_t value = 0;
     // 一次可能积累多个写入，循环读空避免下一轮 epoll 立即被同一事件触发。
-    while (read(wake_fd_, &value, sizeof(value)) == sizeof(value)) {
-    }
+    do {
+        syscall_count_.fetch_add(1, std::memory_order_relaxed);
+    } while (read(wake_fd_, &value, sizeof(value)) == sizeof(value));
     wake_pending_.store(false, std::memory_order_release);
 }
 
-std::unique_ptr<Poller> create_default_poller() {
-    return std::unique_ptr<Poller>(new Epoller());
+FdWaitState &Epoller::state_locked(int fd) {
+    const size_t index = static_cast<size_t>(fd);
+    if (index >= fd_wait_states_.size()) {
+        size_t capacity = fd_wait_states_.empty() ? 64 : fd_wait_states_.size();
+        while (capacity <= index) {
+            capacity *= 2;
+        }
+        fd_wait_states_.resize(capacity);
+    }
+    return fd_wait_states_[index];
+}
+
+int Epoller::control(int op, int fd, epoll_event *ev) {
+    syscall_count_.fetch_add(1, std::memory_order_relaxed);
+    return epoll_ctl(epoll_fd_, op, fd, ev);
+}
+
+const char *Epoller::name() const { return "epoll"; }
+
+uint64_t Epoller::syscall_count() const {
+    return syscall_count_.load(std::memory_order_relaxed);
 }
 
 } // namespace zco
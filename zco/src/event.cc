@@ -109,7 +109,8 @@ bool Event::wait(uint32_t milliseconds) const {
             return true;
         }
 
-        impl_->waiters.push_back(CoroutineWaiterEntry{coroutine, active});
+        impl_->waiters.push_back(
+            CoroutineWaiterEntry{std::move(coroutine), active});
     }
 
     // active 作为“等待资格令牌”：
@@ -146,7 +147,7 @@ void Event::signal() const {
                 CoroutineWaiterEntry &waiter = impl_->waiters[i];
                 Fiber::ptr coroutine = claim_waiter(&waiter);
                 if (coroutine) {
-                    resume_list.push_back(coroutine);
+                    resume_list.push_back(std::move(coroutine));
                 }
             }
         } else {
@@ -157,7 +158,7 @@ void Event::signal() const {
                 CoroutineWaiterEntry &waiter = impl_->waiters[i];
                 Fiber::ptr coroutine = claim_waiter(&waiter);
                 if (coroutine) {
-                    resume_list.push_back(coroutine);
+                    resume_list.push_back(std::move(coroutine));
                     resumed = true;
                     break;
                 }
@@ -176,7 +177,7 @@ void Event::signal() const {
     ZCO_LOG_DEBUG("event signal wake coroutine count={}", resume_list.size());
     // 协程唤醒放在锁外执行，避免在锁内触发复杂调度链路。
     for (size_t i = 0; i < resume_list.size(); ++i) {
-        resume_fiber(resume_list[i], false);
+        resume_fiber(std::move(resume_list[i]), false);
     }
 }
 
@@ -206,7 +207,7 @@ void Event::notify_all() const {
             CoroutineWaiterEntry &waiter = impl_->waiters[i];
             Fiber::ptr coroutine = claim_waiter(&waiter);
             if (coroutine) {
-                resume_list.push_back(coroutine);
+                resume_list.push_back(std::move(coroutine));
             }
         }
 
@@ -222,7 +223,7 @@ void Event::notify_all() const {
                   resume_list.size());
     // notify_all 强制唤醒协程等待队列中所有活跃节点。
     for (size_t i = 0; i < resume_list.size(); ++i) {
-        resume_fiber(resume_list[i], false);
+        resume_fiber(std::move(resume_list[i]), false);
     }
 }
 
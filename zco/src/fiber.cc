@@ -2,6 +2,7 @@
 
 #include <cstring>
 #include <stdexcept>
+#include <thread>
 #include <utility>
 
 #include "zco/internal/processor.h"
@@ -11,7 +12,7 @@ namespace zco {
 
 // fiber.cc 聚焦“协程执行单元”本身：
 // - 保存任务函数与运行状态。
-// - 管理 ucontext 初始化。
+// - 管理协程上下文初始化。
 // - 在共享栈模式下保存/恢复栈快照。
 
 namespace {
@@ -19,6 +20,12 @@ namespace {
 extern "C" void zco_context_entry();
 constexpr uint8_t kDynamicSnapshotBucketLocal = 0xff;
 
+// interrupt_state_ 取值：协程不在可中断等待 / 正在可中断等待 /
+// 取消方已占住、正在 try_wake。
+constexpr uint8_t kInterruptIdle = 0;
+constexpr uint8_t kInterruptArmed = 1;
+constexpr uint8_t kInterruptBusy = 2;
+
 void zco_context_entry() {
     // 所有 fiber 首次切入都会经过该入口，再桥接到 Fiber::run。
     Processor *processor = current_processor();
@@ -27,7 +34,8 @@ void zco_context_entry() {
         return;
     }
 
-    Fiber::ptr holder = processor->current_fiber();
+    // 运行循环在切入前已持有该 Fiber 的引用，这里借用即可。
+    Fiber *holder = processor->current_fiber();
     if (!holder) {
         ZCO_LOG_ERROR("context entry has no current fiber, sched_id={}",
                       processor->id());
@@ -41,14 +49,17 @@ void zco_context_entry() {
 
 Fiber::Fiber(int id, Processor *owner, Task task, size_t stack_size,
              size_t stack_slot, bool use_shared_stack)
-    : id_(id), owner_(owner), task_(std::move(task)), stack_slot_(stack_slot),
+    : ref_count_(0), id_(id), owner_(owner), task_(std::move(task)),
+      stack_slot_(stack_slot),
       independent_stack_buffer_(nullptr), independent_stack_size_(0),
       context_(), use_shared_stack_(use_shared_stack),
       saved_stack_buffer_(nullptr), saved_stack_size_(0),
       saved_stack_capacity_(0),
       saved_stack_bucket_(kDynamicSnapshotBucketLocal),
       context_initialized_(false), state_(State::kReady), timed_out_(false),
-      external_handle_id_(0) {
+      cancel_requested_(false), interrupt_state_(kInterruptIdle),
+      external_handle_id_(0), ready_since_ns_(0), spawn_site_(nullptr),
+      local_slots_(), run_queue_next_(nullptr), run_queued_(false) {
     if (!owner_) {
         throw std::runtime_error("fiber owner is null");
     }
@@ -73,8 +84,9 @@ Fiber::Fiber(int id, Processor *owner, Task task, size_t stack_size,
         return;
     }
 
-    independent_stack_buffer_ = new char[stack_size];
-    independent_stack_size_ = stack_size;
+    // 栈页按需提交，低端 guard 页拦截溢出；大小按页取整。
+    independent_stack_buffer_ = owner_->acquire_independent_stack(stack_size);
+    independent_stack_size_ = StackAllocator::round_size(stack_size);
     ZCO_LOG_DEBUG(
         "fiber created(independent stack lazy init), fiber_id={}, sched_id={}, "
         "stack_size={}",
@@ -83,7 +95,10 @@ Fiber::Fiber(int id, Processor *owner, Task task, size_t stack_size,
 
 Fiber::~Fiber() {
     clear_saved_stack();
-    delete[] independent_stack_buffer_;
+    if (independent_stack_buffer_) {
+        owner_->release_independent_stack(independent_stack_buffer_,
+                                          independent_stack_size_);
+    }
 }
 
 int Fiber::id() const { return id_; }
@@ -96,10 +111,17 @@ void Fiber::reset(int id, Task task, size_t stack_slot) {
     context_initialized_ = false;
     state_.store(State::kReady, std::memory_order_release);
     timed_out_.store(false, std::memory_order_release);
+    cancel_requested_.store(false, std::memory_order_relaxed);
+    interrupt_state_.store(kInterruptIdle, std::memory_order_relaxed);
     external_handle_id_.store(0, std::memory_order_release);
+    ready_since_ns_.store(0, std::memory_order_relaxed);
+    spawn_site_ = nullptr;
+    local_slots_.clear();
     clear_saved_stack();
 }
 
+Task Fiber::take_task() { return std::move(task_); }
+
 Processor *Fiber::owner() const { return owner_; }
 
 size_t Fiber::stack_slot() const { return stack_slot_; }
@@ -173,16 +195,57 @@ void Fiber::clear_timed_out() {
     timed_out_.store(false, std::memory_order_release);
 }
 
+bool Fiber::request_cancel() {
+    // 与 begin_interruptible_wait 构成 Dekker 配对：要么这里看到可中断态，
+    // 要么协程看到取消标记后自己放弃挂起。
+    cancel_requested_.store(true, std::memory_order_seq_cst);
+    uint8_t expected = kInterruptArmed;
+    if (!interrupt_state_.compare_exchange_strong(expected, kInterruptBusy,
+                                                  std::memory_order_seq_cst)) {
+        return false;
+    }
+
+    const bool woken = try_wake(true);
+    interrupt_state_.store(kInterruptIdle, std::memory_order_release);
+    return woken;
+}
+
+bool Fiber::cancel_requested() const {
+    return cancel_requested_.load(std::memory_order_acquire);
+}
+
+bool Fiber::begin_interruptible_wait() {
+    interrupt_state_.store(kInterruptArmed, std::memory_order_seq_cst);
+    return !cancel_requested_.load(std::memory_order_seq_cst);
+}
+
+void Fiber::end_interruptible_wait() {
+    uint8_t expected = kInterruptArmed;
+    if (interrupt_state_.compare_exchange_strong(expected, kInterruptIdle,
+                                                 std::memory_order_acq_rel)) {
+        return;
+    }
+    // 取消方已占住中断位，try_wake 结束前不能进入下一次等待。
+    while (interrupt_state_.load(std::memory_order_acquire) !=
+           kInterruptIdle) {
+        std::this_thread::yield();
+    }
+}
+
 void Fiber::run() {
     // 任务函数异常不能越过协程边界，否则会破坏调度循环稳定性。
     try {
         if (task_) {
             task_();
+            // 捕获的资源随任务结束立即释放，不必等到 Fiber 被复用。
+            task_ = nullptr;
         }
     } catch (...) {
         ZCO_LOG_ERROR("unhandled exception escaped from fiber, fiber_id={}",
                       id_);
     }
+    // 局部变量在协程内析构，析构函数里仍可使用协程 API。
+    local_slots_.clear();
 
     mark_done();
     ZCO_LOG_DEBUG("fiber finished, fiber_id={}", id_);
@@ -196,7 +259,7 @@ void Fiber::initialize_context() {
     }
 
     if (use_shared_stack_) {
-        // Fiber 使用 Processor 的共享栈，uc_link
+        // Fiber 使用 Processor 的共享栈，link
         // 指向调度上下文保证自然返回可回收。 这意味着 Fiber
         // 执行结束后不需要手动 longjmp，函数 return 即可回到调度器。
         context_.make_context(owner_->shared_stack_data(stack_slot_),
@@ -271,4 +334,25 @@ void Fiber::clear_saved_stack() {
     saved_stack_bucket_ = kDynamicSnapshotBucketLocal;
 }
 
+uint32_t Fiber::ref_count() const {
+    return ref_count_.load(std::memory_order_relaxed);
+}
+
+void Fiber::set_ready_since_ns(uint64_t ready_ns) {
+    ready_since_ns_.store(ready_ns, std::memory_order_relaxed);
+}
+
+uint64_t Fiber::take_ready_since_ns() {
+    // 就绪队列的入队/出队已建立先后关系，这里只需保证读写本身原子。
+    const uint64_t ready_ns = ready_since_ns_.load(std::memory_order_relaxed);
+    ready_since_ns_.store(0, std::memory_order_relaxed);
+    return ready_ns;
+}
+
+void Fiber::set_spawn_site(const SpawnSite *site) { spawn_site_ = site; }
+
+const SpawnSite *Fiber::spawn_site() const { return spawn_site_; }
+
+FiberLocalSlots *Fiber::local_slots() { return &local_slots_; }
+
 } // namespace zco
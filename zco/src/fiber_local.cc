@@ -0,0 +1,129 @@
+#include "zco/internal/fiber_local_slots.h"
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include "zco/internal/fiber.h"
+#include "zco/internal/processor.h"
+
+namespace zco {
+
+namespace {
+
+std::atomic<uint64_t> next_key(1);
+
+// 下标分配只发生在 FiberLocal 构造/析构时，用锁即可。全局 FiberLocal 的
+// 析构顺序不确定，登记表故意不析构。
+struct IndexRegistry {
+    std::mutex mutex;
+    uint32_t next_index = 0;
+    std::vector<uint32_t> free_indexes;
+};
+
+IndexRegistry &index_registry() {
+    static IndexRegistry *registry = new IndexRegistry();
+    return *registry;
+}
+
+thread_local FiberLocalSlots thread_slots;
+
+} // namespace
+
+FiberLocalSlots::FiberLocalSlots()
+    : inline_slots_(), overflow_(), overflow_size_(0), used_(0) {}
+
+FiberLocalSlots::~FiberLocalSlots() { clear(); }
+
+void FiberLocalSlots::emplace(uint32_t index, uint64_t key, void *value,
+                              void (*destroy)(void *)) {
+    Slot *slot = slot_for_write(index);
+    // 先摘下旧值再析构，析构函数里访问其他 FiberLocal 时槽位已是新值。
+    Slot old = *slot;
+    slot->key = key;
+    slot->value = value;
+    slot->destroy = destroy;
+    destroy_slot(&old);
+}
+
+void FiberLocalSlots::erase(uint32_t index, uint64_t key) {
+    Slot *slot = find(index);
+    if (!slot || slot->key != key || !slot->value) {
+        return;
+    }
+    Slot old = *slot;
+    *slot = Slot();
+    destroy_slot(&old);
+}
+
+void FiberLocalSlots::clear() {
+    for (int round = 0; round < kClearRounds && used_ != 0; ++round) {
+        const uint32_t used = used_;
+        used_ = 0;
+        for (uint32_t index = 0; index < used; ++index) {
+            Slot *slot = find(index);
+            if (!slot || !slot->value) {
+                continue;
+            }
+            Slot old = *slot;
+            *slot = Slot();
+            destroy_slot(&old);
+        }
+    }
+}
+
+FiberLocalSlots::Slot *FiberLocalSlots::slot_for_write(uint32_t index) {
+    if (index >= used_) {
+        used_ = index + 1;
+    }
+    if (index < kInlineFiberLocalSlots) {
+        return &inline_slots_[index];
+    }
+
+    const uint32_t offset = index - kInlineFiberLocalSlots;
+    if (offset >= overflow_size_) {
+        uint32_t capacity = overflow_size_ == 0 ? 4 : overflow_size_ * 2;
+        while (capacity <= offset) {
+            capacity *= 2;
+        }
+        std::unique_ptr<Slot[]> grown(new Slot[capacity]);
+        for (uint32_t i = 0; i < overflow_size_; ++i) {
+            grown[i] = overflow_[i];
+        }
+        overflow_ = std::move(grown);
+        overflow_size_ = capacity;
+    }
+    return &overflow_[offset];
+}
+
+void FiberLocalSlots::destroy_slot(Slot *slot) {
+    if (slot->value && slot->destroy) {
+        slot->destroy(slot->value);
+    }
+}
+
+uint32_t acquire_fiber_local_index(uint64_t *key) {
+    *key = next_key.fetch_add(1, std::memory_order_relaxed);
+    IndexRegistry &registry = index_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    if (!registry.free_indexes.empty()) {
+        const uint32_t index = registry.free_indexes.back();
+        registry.free_indexes.pop_back();
+        return index;
+    }
+    return registry.next_index++;
+}
+
+void release_fiber_local_index(uint32_t index) {
+    IndexRegistry &registry = index_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.free_indexes.push_back(index);
+}
+
+FiberLocalSlots *current_fiber_local_slots() {
+    Processor *processor = current_processor();
+    Fiber *fiber = processor ? processor->current_fiber() : nullptr;
+    return fiber ? fiber->local_slots() : &thread_slots;
+}
+
+} // namespace zco
@@ -1,5 +1,7 @@
 #include "zco/internal/fiber_pool.h"
 
+#include <utility>
+
 namespace zco {
 
 // FiberPool 保存已完成或可复用的 Fiber，目标是减少热路径上的堆分配：
@@ -16,22 +18,22 @@ Fiber::ptr FiberPool::acquire() {
         return nullptr;
     }
 
-    Fiber::ptr fiber = fibers_.front();
+    Fiber::ptr fiber = std::move(fibers_.front());
     fibers_.pop_front();
     return fiber;
 }
 
-void FiberPool::recycle(const Fiber::ptr &fiber) {
+void FiberPool::recycle(Fiber::ptr fiber) {
     if (!fiber) {
         return;
     }
 
     std::lock_guard<std::mutex> lock(mutex_);
     if (fibers_.size() >= max_size_) {
-        // 池满时直接丢弃，依赖 shared_ptr 自然析构回收底层资源。
+        // 池满时直接丢弃，最后一份引用释放时回收底层资源。
         return;
     }
-    fibers_.push_back(fiber);
+    fibers_.push_back(std::move(fiber));
 }
 
 void FiberPool::clear() {
@@ -44,4 +46,4 @@ size_t FiberPool::size() const {
     return fibers_.size();
 }
 
-} // namespace zco
\ No newline at end of file
+} // namespace zco
\ No newline at end of file
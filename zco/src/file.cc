@@ -0,0 +1,171 @@
+#include "zco/file.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <memory>
+
+#include "zco/blocking.h"
+#include "zco/internal/fiber.h"
+#include "zco/internal/poller.h"
+#include "zco/internal/processor.h"
+#include "zco/sched.h"
+
+namespace zco {
+namespace file {
+
+// file.cc 把文件操作包装成 FileRequest：
+// - 处理器的 poller 接受时由 io_uring 异步执行，完成事件随 poller 等待取回；
+// - 否则在阻塞线程池里同步执行，lambda 只捕获堆上的请求。
+// 两条路径里执行方都可能在协程换出后访问缓冲区，共享栈上的缓冲区先中转。
+
+namespace {
+
+// 同步执行请求，结果按 FileRequest::result 的约定写回。
+void execute(FileRequest *request) {
+    ssize_t rc = -1;
+    switch (request->op) {
+    case FileRequest::Op::kOpen:
+        rc = ::open(request->path.c_str(), request->flags,
+                    static_cast<mode_t>(request->mode));
+        break;
+    case FileRequest::Op::kRead:
+        rc = ::pread(request->fd, request->buffer, request->length,
+                     static_cast<off_t>(request->offset));
+        break;
+    case FileRequest::Op::kWrite:
+        rc = ::pwrite(request->fd, request->buffer, request->length,
+                      static_cast<off_t>(request->offset));
+        break;
+    case FileRequest::Op::kFsync:
+        rc = ::fsync(request->fd);
+        break;
+    case FileRequest::Op::kFdatasync:
+        rc = ::fdatasync(request->fd);
+        break;
+    }
+    request->result = rc < 0 ? -static_cast<int64_t>(errno) : rc;
+}
+
+// 判断缓冲区是否落在当前协程的共享栈上。
+bool on_shared_stack(const void *buffer, size_t length) {
+    Processor *processor = current_processor();
+    Fiber *fiber = processor ? processor->current_fiber() : nullptr;
+    if (!fiber || !fiber->use_shared_stack() || length == 0) {
+        return false;
+    }
+
+    const char *stack = static_cast<const char *>(
+        processor->shared_stack_data(fiber->stack_slot()));
+    const size_t stack_size = processor->shared_stack_size(fiber->stack_slot());
+    const char *data = static_cast<const char *>(buffer);
+    return stack && data < stack + stack_size && data + length > stack;
+}
+
+// 在协程内执行请求并挂起，返回 libc 风格的结果。
+int64_t run(const std::shared_ptr<FileRequest> &request) {
+    Processor *processor = current_processor();
+    if (!processor->run_file_request(request)) {
+        blocking([request]() { execute(request.get()); });
+    }
+    if (request->result < 0) {
+        errno = static_cast<int>(-request->result);
+        return -1;
+    }
+    return request->result;
+}
+
+std::shared_ptr<FileRequest> make_request(FileRequest::Op op, int fd) {
+    std::shared_ptr<FileRequest> request = std::make_shared<FileRequest>();
+    request->op = op;
+    request->fd = fd;
+    return request;
+}
+
+} // namespace
+
+int open(const char *path, int flags, mode_t mode) {
+    if (!in_coroutine()) {
+        return ::open(path, flags, mode);
+    }
+    if (!path) {
+        errno = EFAULT;
+        return -1;
+    }
+
+    // 路径在提交时才被内核读取，复制一份到请求里。
+    std::shared_ptr<FileRequest> request =
+        make_request(FileRequest::Op::kOpen, -1);
+    request->path = path;
+    request->flags = flags;
+    request->mode = static_cast<uint32_t>(mode);
+    return static_cast<int>(run(request));
+}
+
+ssize_t pread(int fd, void *buf, size_t count, off_t offset) {
+    if (!in_coroutine()) {
+        return ::pread(fd, buf, count, offset);
+    }
+    if (offset < 0) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    std::shared_ptr<FileRequest> request =
+        make_request(FileRequest::Op::kRead, fd);
+    std::unique_ptr<char[]> bounce;
+    if (on_shared_stack(buf, count)) {
+        bounce.reset(new char[count]);
+    }
+    request->buffer = bounce ? bounce.get() : buf;
+    request->length = count;
+    request->offset = offset;
+
+    const ssize_t rc = static_cast<ssize_t>(run(request));
+    if (bounce && rc > 0) {
+        std::memcpy(buf, bounce.get(), static_cast<size_t>(rc));
+    }
+    return rc;
+}
+
+ssize_t pwrite(int fd, const void *buf, size_t count, off_t offset) {
+    if (!in_coroutine()) {
+        return ::pwrite(fd, buf, count, offset);
+    }
+    if (offset < 0) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    std::shared_ptr<FileRequest> request =
+        make_request(FileRequest::Op::kWrite, fd);
+    std::unique_ptr<char[]> bounce;
+    if (on_shared_stack(buf, count)) {
+        bounce.reset(new char[count]);
+        std::memcpy(bounce.get(), buf, count);
+    }
+    request->buffer = bounce ? bounce.get() : const_cast<void *>(buf);
+    request->length = count;
+    request->offset = offset;
+    return static_cast<ssize_t>(run(request));
+}
+
+int fsync(int fd) {
+    if (!in_coroutine()) {
+        return ::fsync(fd);
+    }
+    return static_cast<int>(run(make_request(FileRequest::Op::kFsync, fd)));
+}
+
+int fdatasync(int fd) {
+    if (!in_coroutine()) {
+        return ::fdatasync(fd);
+    }
+    return static_cast<int>(
+        run(make_request(FileRequest::Op::kFdatasync, fd)));
+}
+
+} // namespace file
+} // namespace zco
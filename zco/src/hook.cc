@@ -4,6 +4,9 @@
 #include <fcntl.h>
 #include <netinet/in.h>
 #include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/select.h>
 #include <sys/socket.h>
 #include <sys/time.h>
 #include <sys/uio.h>
@@ -11,11 +14,16 @@
 
 #include <array>
 #include <chrono>
+#include <climits>
 #include <cstring>
+#include <memory>
 #include <mutex>
 #include <unordered_map>
+#include <vector>
 
+#include "zco/internal/fiber.h"
 #include "zco/internal/runtime_manager.h"
+#include "zco/internal/syscall_hook.h"
 #include "zco/io_event.h"
 #include "zco/zco_log.h"
 
@@ -100,6 +108,9 @@ class FdMetadataStore {
 
 FdMetadataStore g_fd_metadata_store;
 
+// 开启系统调用接管时 ::read 等符号指向接管函数，这里的真实调用都走原始入口。
+const SysCalls &sys() { return sys_calls(); }
+
 bool is_retryable_errno(int err) { return err == EAGAIN || err == EWOULDBLOCK; }
 
 bool require_coroutine_context(const char *func_name) {
@@ -113,7 +124,7 @@ bool require_coroutine_context(const char *func_name) {
 }
 
 bool force_nonblocking_fd(int fd) {
-    const int flags = fcntl(fd, F_GETFL, 0);
+    const int flags = sys().fcntl(fd, F_GETFL, 0);
     if (flags < 0) {
         return false;
     }
@@ -122,19 +133,19 @@ bool force_nonblocking_fd(int fd) {
         return true;
     }
 
-    return fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+    return sys().fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
 }
 
 void set_cloexec_if_possible(int fd) {
-    const int fd_flags = fcntl(fd, F_GETFD, 0);
+    const int fd_flags = sys().fcntl(fd, F_GETFD, 0);
     if (fd_flags < 0 || (fd_flags & FD_CLOEXEC) != 0) {
         return;
     }
-    (void)fcntl(fd, F_SETFD, fd_flags | FD_CLOEXEC);
+    (void)sys().fcntl(fd, F_SETFD, fd_flags | FD_CLOEXEC);
 }
 
 bool require_nonblocking_fd(const char *func_name, int fd) {
-    const int flags = fcntl(fd, F_GETFL, 0);
+    const int flags = sys().fcntl(fd, F_GETFL, 0);
     if (flags < 0) {
         return false;
     }
@@ -334,6 +345,96 @@ ssize_t run_io_loop(const char *func_name, int fd, IoEventType event_type,
     }
 }
 
+constexpr size_t kInlinePollFds = 8;
+// 同一 fd 同一方向已有别的等待方时无法再登记，退化为按此间隔重查。
+constexpr uint32_t kContendedPollIntervalMs = 10;
+
+// poll 兴趣到 poller 事件的映射；POLLERR/POLLHUP 总会随读写事件一起上报。
+uint32_t poll_events_to_epoll(short events) {
+    uint32_t mask = 0;
+    if (events & (POLLIN | POLLPRI | POLLRDHUP)) {
+        mask |= EPOLLIN;
+    }
+    if (events & POLLOUT) {
+        mask |= EPOLLOUT;
+    }
+    return mask;
+}
+
+uint32_t poll_timeout_to_ms(int timeout_ms) {
+    return timeout_ms < 0 ? kInfiniteTimeoutMs
+                          : static_cast<uint32_t>(timeout_ms);
+}
+
+// 把 fds 中的每个兴趣登记到当前处理器的 poller，整体只挂起一次。
+// 返回 1 表示被事件唤醒，0 表示超时，-1 表示取消或登记失败并设置 errno。
+int park_on_pollfds(const struct pollfd *fds, nfds_t nfds,
+                     uint32_t timeout_ms) {
+    std::array<std::shared_ptr<IoWaiter>, kInlinePollFds> inline_waiters;
+    std::unique_ptr<std::shared_ptr<IoWaiter>[]> heap_waiters;
+    std::shared_ptr<IoWaiter> *waiters = inline_waiters.data();
+    if (nfds > kInlinePollFds) {
+        heap_waiters.reset(new std::shared_ptr<IoWaiter>[nfds]);
+        waiters = heap_waiters.get();
+    }
+
+    Fiber::ptr self = current_fiber_shared();
+    prepare_current_wait();
+    size_t armed = 0;
+    int error = 0;
+    bool contended = false;
+    for (nfds_t i = 0; i < nfds; ++i) {
+        const uint32_t events = poll_events_to_epoll(fds[i].events);
+        if (fds[i].fd < 0 || events == 0) {
+            continue;
+        }
+        waiters[armed] = register_fd_wait(fds[i].fd, events);
+        if (!waiters[armed]) {
+            if (errno == EBUSY) {
+                contended = true;
+                continue;
+            }
+            error = errno;
+            break;
+        }
+        ++armed;
+    }
+    if (contended && timeout_ms > kContendedPollIntervalMs) {
+        timeout_ms = kContendedPollIntervalMs;
+    }
+
+    bool woke = false;
+    if (error != 0) {
+        // 登记途中失败：先收回自己的令牌；收不回说明已登记的 fd 先就绪，
+        // 挂起把这次唤醒消费掉。
+        if (self->try_wake(false)) {
+            self->mark_running();
+        } else {
+            (void)park_current();
+        }
+    } else {
+        woke = park_current_for(timeout_ms);
+    }
+
+    bool fired = false;
+    for (size_t i = 0; i < armed; ++i) {
+        if (unregister_fd_wait(waiters[i])) {
+            fired = true;
+        }
+        waiters[i].reset();
+    }
+
+    if (error != 0) {
+        errno = error;
+        return -1;
+    }
+    if (!woke && self->cancel_requested()) {
+        errno = ECANCELED;
+        return -1;
+    }
+    return woke && fired ? 1 : 0;
+}
+
 } // namespace
 
 void co_sleep_for(uint32_t milliseconds) { sleep_for(milliseconds); }
@@ -352,16 +453,18 @@ void sync_fd_metadata_on_close(int fd) {
     }
 
     g_fd_metadata_store.erase(fd);
+    clear_hooked_fd(fd);
 }
 
 int co_socket(int domain, int type, int protocol) {
 #if defined(SOCK_NONBLOCK) && defined(SOCK_CLOEXEC)
     const int fd = static_cast<int>(retry_on_eintr([&]() -> ssize_t {
-        return ::socket(domain, type | SOCK_NONBLOCK | SOCK_CLOEXEC, protocol);
+        return sys().socket(domain, type | SOCK_NONBLOCK | SOCK_CLOEXEC,
+                            protocol);
     }));
 #else
     const int fd = static_cast<int>(retry_on_eintr(
-        [&]() -> ssize_t { return ::socket(domain, type, protocol); }));
+        [&]() -> ssize_t { return sys().socket(domain, type, protocol); }));
 #endif
 
     if (fd < 0) {
@@ -370,13 +473,14 @@ int co_socket(int domain, int type, int protocol) {
 
     if (!force_nonblocking_fd(fd)) {
         const int err = errno;
-        (void)::close(fd);
+        (void)sys().close(fd);
         errno = err;
         return -1;
     }
 
     set_cloexec_if_possible(fd);
     ensure_timeout_cached(fd);
+    attach_fd(fd);
     return fd;
 }
 
@@ -390,18 +494,20 @@ int co_udp_socket(int domain) {
 
 int co_dup(int oldfd) {
     const int newfd = static_cast<int>(
-        retry_on_eintr([&]() -> ssize_t { return ::dup(oldfd); }));
+        retry_on_eintr([&]() -> ssize_t { return sys().dup(oldfd); }));
     if (newfd >= 0) {
         sync_fd_metadata_on_dup(oldfd, newfd);
+        sync_hooked_fd_on_dup(oldfd, newfd);
     }
     return newfd;
 }
 
 int co_dup2(int oldfd, int newfd) {
     const int rc = static_cast<int>(
-        retry_on_eintr([&]() -> ssize_t { return ::dup2(oldfd, newfd); }));
+        retry_on_eintr([&]() -> ssize_t { return sys().dup2(oldfd, newfd); }));
     if (rc >= 0) {
         sync_fd_metadata_on_dup(oldfd, rc);
+        sync_hooked_fd_on_dup(oldfd, rc);
     }
     return rc;
 }
@@ -409,9 +515,10 @@ int co_dup2(int oldfd, int newfd) {
 int co_dup3(int oldfd, int newfd, int flags) {
 #if defined(__linux__)
     const int rc = static_cast<int>(retry_on_eintr(
-        [&]() -> ssize_t { return ::dup3(oldfd, newfd, flags); }));
+        [&]() -> ssize_t { return sys().dup3(oldfd, newfd, flags); }));
     if (rc >= 0) {
         sync_fd_metadata_on_dup(oldfd, rc);
+        sync_hooked_fd_on_dup(oldfd, rc);
     }
     return rc;
 #else
@@ -431,7 +538,7 @@ int co_close(int fd, uint32_t delay_ms) {
     cancel_fd_waiters(fd, EBADF);
     sync_fd_metadata_on_close(fd);
     return static_cast<int>(
-        retry_on_eintr([&]() -> ssize_t { return ::close(fd); }));
+        retry_on_eintr([&]() -> ssize_t { return sys().close(fd); }));
 }
 
 int co_reset_tcp_socket(int fd, uint32_t delay_ms) {
@@ -476,7 +583,7 @@ int co_getsockopt(int fd, int level, int option, void *option_value,
 int co_setsockopt(int fd, int level, int option, const void *option_value,
                   socklen_t option_len) {
     const int rc = static_cast<int>(retry_on_eintr([&]() -> ssize_t {
-        return ::setsockopt(fd, level, option, option_value, option_len);
+        return sys().setsockopt(fd, level, option, option_value, option_len);
     }));
     if (rc == 0) {
         refresh_timeout_cache_after_setsockopt(fd, level, option, option_value,
@@ -520,33 +627,37 @@ void co_set_tcp_nodelay(int fd) {
 }
 
 ssize_t co_read(int fd, void *buffer, size_t count, uint32_t timeout_ms) {
-    return run_io_loop("co_read", fd, IoEventType::kRead, timeout_ms, true,
-                       [&]() -> ssize_t { return ::read(fd, buffer, count); });
+    return run_io_loop(
+        "co_read", fd, IoEventType::kRead, timeout_ms, true,
+        [&]() -> ssize_t { return sys().read(fd, buffer, count); });
 }
 
 ssize_t co_write(int fd, const void *buffer, size_t count,
                  uint32_t timeout_ms) {
-    return run_io_loop("co_write", fd, IoEventType::kWrite, timeout_ms, false,
-                       [&]() -> ssize_t { return ::write(fd, buffer, count); });
+    return run_io_loop(
+        "co_write", fd, IoEventType::kWrite, timeout_ms, false,
+        [&]() -> ssize_t { return sys().write(fd, buffer, count); });
 }
 
 ssize_t co_readv(int fd, const struct iovec *iov, int iovcnt,
                  uint32_t timeout_ms) {
-    return run_io_loop("co_readv", fd, IoEventType::kRead, timeout_ms, true,
-                       [&]() -> ssize_t { return ::readv(fd, iov, iovcnt); });
+    return run_io_loop(
+        "co_readv", fd, IoEventType::kRead, timeout_ms, true,
+        [&]() -> ssize_t { return sys().readv(fd, iov, iovcnt); });
 }
 
 ssize_t co_writev(int fd, const struct iovec *iov, int iovcnt,
                   uint32_t timeout_ms) {
-    return run_io_loop("co_writev", fd, IoEventType::kWrite, timeout_ms, false,
-                       [&]() -> ssize_t { return ::writev(fd, iov, iovcnt); });
+    return run_io_loop(
+        "co_writev", fd, IoEventType::kWrite, timeout_ms, false,
+        [&]() -> ssize_t { return sys().writev(fd, iov, iovcnt); });
 }
 
 ssize_t co_recv(int fd, void *buffer, size_t count, int flags,
                 uint32_t timeout_ms) {
     return run_io_loop(
         "co_recv", fd, IoEventType::kRead, timeout_ms, true,
-        [&]() -> ssize_t { return ::recv(fd, buffer, count, flags); });
+        [&]() -> ssize_t { return sys().recv(fd, buffer, count, flags); });
 }
 
 ssize_t co_recvn(int fd, void *buffer, size_t count, int flags,
@@ -568,7 +679,7 @@ ssize_t co_recvn(int fd, void *buffer, size_t count, int flags,
     char *current = static_cast<char *>(buffer);
     while (received < count) {
         const ssize_t rc = retry_on_eintr([&]() -> ssize_t {
-            return ::recv(fd, current, count - received, flags);
+            return sys().recv(fd, current, count - received, flags);
         });
         if (rc > 0) {
             received += static_cast<size_t>(rc);
@@ -618,7 +729,7 @@ ssize_t co_send(int fd, const void *buffer, size_t count, int flags,
     const char *current = static_cast<const char *>(buffer);
     while (sent < count) {
         const ssize_t rc = retry_on_eintr([&]() -> ssize_t {
-            return ::send(fd, current, count - sent, flags);
+            return sys().send(fd, current, count - sent, flags);
         });
         if (rc > 0) {
             sent += static_cast<size_t>(rc);
@@ -650,8 +761,8 @@ ssize_t co_recvfrom(int fd, void *buffer, size_t count, int flags,
                     uint32_t timeout_ms) {
     return run_io_loop("co_recvfrom", fd, IoEventType::kRead, timeout_ms, true,
                        [&]() -> ssize_t {
-                           return ::recvfrom(fd, buffer, count, flags, address,
-                                             address_len);
+                           return sys().recvfrom(fd, buffer, count, flags,
+                                                 address, address_len);
                        });
 }
 
@@ -679,8 +790,8 @@ ssize_t co_sendto(int fd, const void *buffer, size_t count, int flags,
     const char *current = static_cast<const char *>(buffer);
     while (sent < count) {
         const ssize_t rc = retry_on_eintr([&]() -> ssize_t {
-            return ::sendto(fd, current, count - sent, flags, address,
-                            address_len);
+            return sys().sendto(fd, current, count - sent, flags, address,
+                                address_len);
         });
         if (rc > 0) {
             sent += static_cast<size_t>(rc);
@@ -707,6 +818,20 @@ ssize_t co_sendto(int fd, const void *buffer, size_t count, int flags,
     return static_cast<ssize_t>(count);
 }
 
+ssize_t co_recvmsg(int fd, struct msghdr *message, int flags,
+                   uint32_t timeout_ms) {
+    return run_io_loop(
+        "co_recvmsg", fd, IoEventType::kRead, timeout_ms, true,
+        [&]() -> ssize_t { return sys().recvmsg(fd, message, flags); });
+}
+
+ssize_t co_sendmsg(int fd, const struct msghdr *message, int flags,
+                   uint32_t timeout_ms) {
+    return run_io_loop(
+        "co_sendmsg", fd, IoEventType::kWrite, timeout_ms, false,
+        [&]() -> ssize_t { return sys().sendmsg(fd, message, flags); });
+}
+
 int co_connect(int fd, const struct sockaddr *address, socklen_t address_len,
                uint32_t timeout_ms) {
     if (!require_coroutine_context("co_connect") ||
@@ -719,8 +844,9 @@ int co_connect(int fd, const struct sockaddr *address, socklen_t address_len,
     const auto started_at = std::chrono::steady_clock::now();
 
     while (true) {
-        const int rc = static_cast<int>(retry_on_eintr(
-            [&]() -> ssize_t { return ::connect(fd, address, address_len); }));
+        const int rc = static_cast<int>(retry_on_eintr([&]() -> ssize_t {
+            return sys().connect(fd, address, address_len);
+        }));
         if (rc == 0 || errno == EISCONN) {
             return 0;
         }
@@ -752,10 +878,16 @@ int co_connect(int fd, const struct sockaddr *address, socklen_t address_len,
             return -1;
         }
 
-        if (socket_error == 0 || socket_error == EISCONN) {
+        if (socket_error == EISCONN) {
             return 0;
         }
 
+        if (socket_error == 0) {
+            // 常驻注册下写就绪可能来自连接发起前记录的边沿，
+            // 重新 connect 由内核给出 EISCONN/EALREADY 确认真实状态。
+            continue;
+        }
+
         errno = socket_error;
         if (errno != EINPROGRESS && errno != EALREADY &&
             !is_retryable_errno(errno)) {
@@ -776,17 +908,20 @@ int co_accept(int fd, struct sockaddr *address, socklen_t *address_len,
     const auto started_at = std::chrono::steady_clock::now();
 
     while (true) {
-        const int accepted_fd = static_cast<int>(retry_on_eintr(
-            [&]() -> ssize_t { return ::accept(fd, address, address_len); }));
+        const int accepted_fd =
+            static_cast<int>(retry_on_eintr([&]() -> ssize_t {
+                return sys().accept(fd, address, address_len);
+            }));
         if (accepted_fd >= 0) {
             if (!force_nonblocking_fd(accepted_fd)) {
                 const int err = errno;
-                (void)::close(accepted_fd);
+                (void)sys().close(accepted_fd);
                 errno = err;
                 return -1;
             }
             set_cloexec_if_possible(accepted_fd);
             sync_fd_metadata_on_dup(fd, accepted_fd);
+            attach_fd(accepted_fd);
             return accepted_fd;
         }
 
@@ -830,10 +965,11 @@ int co_accept4(int fd, struct sockaddr *address, socklen_t *address_len,
     while (true) {
         const int accepted_fd =
             static_cast<int>(retry_on_eintr([&]() -> ssize_t {
-                return ::accept4(fd, address, address_len, syscall_flags);
+                return sys().accept4(fd, address, address_len, syscall_flags);
             }));
         if (accepted_fd >= 0) {
             sync_fd_metadata_on_dup(fd, accepted_fd);
+            attach_fd(accepted_fd);
             return accepted_fd;
         }
 
@@ -861,4 +997,170 @@ int co_accept4(int fd, struct sockaddr *address, socklen_t *address_len,
     return co_accept(fd, address, address_len, timeout_ms);
 }
 
+int co_poll(struct pollfd *fds, nfds_t nfds, int timeout_ms) {
+    // 快路径：先按电平查一次，已有就绪或调用方不等待时直接返回，不挂起。
+    int rc = static_cast<int>(
+        retry_on_eintr([&]() -> ssize_t { return sys().poll(fds, nfds, 0); }));
+    if (rc != 0 || timeout_ms == 0) {
+        return rc;
+    }
+
+    if (!require_coroutine_context("co_poll")) {
+        return -1;
+    }
+
+    const uint32_t total_timeout_ms = poll_timeout_to_ms(timeout_ms);
+    const auto started_at = std::chrono::steady_clock::now();
+    const int saved_errno = errno;
+    while (true) {
+        const uint32_t wait_timeout_ms =
+            remaining_timeout_ms(total_timeout_ms, started_at);
+        if (wait_timeout_ms == 0) {
+            errno = saved_errno;
+            return 0;
+        }
+
+        if (park_on_pollfds(fds, nfds, wait_timeout_ms) < 0) {
+            return -1;
+        }
+
+        // 常驻注册是边沿触发，唤醒只说明某个 fd 可能就绪，结果以真实 poll 为准。
+        rc = static_cast<int>(retry_on_eintr(
+            [&]() -> ssize_t { return sys().poll(fds, nfds, 0); }));
+        if (rc != 0) {
+            return rc;
+        }
+        errno = saved_errno;
+    }
+}
+
+int co_select(int nfds, fd_set *readfds, fd_set *writefds, fd_set *exceptfds,
+              struct timeval *timeout) {
+    if (nfds < 0 || nfds > FD_SETSIZE) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    int timeout_ms = -1;
+    if (timeout) {
+        if (timeout->tv_sec < 0 || timeout->tv_usec < 0) {
+            errno = EINVAL;
+            return -1;
+        }
+        const uint64_t total_ms =
+            static_cast<uint64_t>(timeout->tv_sec) * 1000ULL +
+            (static_cast<uint64_t>(timeout->tv_usec) + 999ULL) / 1000ULL;
+        timeout_ms = total_ms > static_cast<uint64_t>(INT_MAX)
+                         ? INT_MAX
+                         : static_cast<int>(total_ms);
+    }
+
+    std::vector<pollfd> fds;
+    for (int fd = 0; fd < nfds; ++fd) {
+        short events = 0;
+        if (readfds && FD_ISSET(fd, readfds)) {
+            events |= POLLIN;
+        }
+        if (writefds && FD_ISSET(fd, writefds)) {
+            events |= POLLOUT;
+        }
+        if (exceptfds && FD_ISSET(fd, exceptfds)) {
+            events |= POLLPRI;
+        }
+        if (events != 0) {
+            pollfd pfd;
+            pfd.fd = fd;
+            pfd.events = events;
+            pfd.revents = 0;
+            fds.push_back(pfd);
+        }
+    }
+
+    const int rc = co_poll(fds.data(), fds.size(), timeout_ms);
+    if (rc < 0) {
+        return -1;
+    }
+
+    int ready = 0;
+    for (size_t i = 0; i < fds.size(); ++i) {
+        const pollfd &pfd = fds[i];
+        if (pfd.revents & POLLNVAL) {
+            errno = EBADF;
+            return -1;
+        }
+        // 与内核 select 相同：挂断和错误同时算可读，错误也算可写。
+        if (readfds) {
+            FD_CLR(pfd.fd, readfds);
+            if ((pfd.events & POLLIN) &&
+                (pfd.revents & (POLLIN | POLLHUP | POLLERR))) {
+                FD_SET(pfd.fd, readfds);
+                ++ready;
+            }
+        }
+        if (writefds) {
+            FD_CLR(pfd.fd, writefds);
+            if ((pfd.events & POLLOUT) &&
+                (pfd.revents & (POLLOUT | POLLERR))) {
+                FD_SET(pfd.fd, writefds);
+                ++ready;
+            }
+        }
+        if (exceptfds) {
+            FD_CLR(pfd.fd, exceptfds);
+            if ((pfd.events & POLLPRI) && (pfd.revents & POLLPRI)) {
+                FD_SET(pfd.fd, exceptfds);
+                ++ready;
+            }
+        }
+    }
+    return ready;
+}
+
+int co_epoll_wait(int epfd, struct epoll_event *events, int maxevents,
+                  int timeout_ms) {
+    int rc = static_cast<int>(retry_on_eintr([&]() -> ssize_t {
+        return sys().epoll_wait(epfd, events, maxevents, 0);
+    }));
+    if (rc != 0 || timeout_ms == 0) {
+        return rc;
+    }
+
+    if (!require_coroutine_context("co_epoll_wait")) {
+        return -1;
+    }
+
+    const uint32_t total_timeout_ms = poll_timeout_to_ms(timeout_ms);
+    const auto started_at = std::chrono::steady_clock::now();
+    const int saved_errno = errno;
+    while (true) {
+        const uint32_t wait_timeout_ms =
+            remaining_timeout_ms(total_timeout_ms, started_at);
+        if (wait_timeout_ms == 0) {
+            errno = saved_errno;
+            return 0;
+        }
+
+        // epoll fd 有就绪事件时本身可读，等它可读后再不等待地取事件；
+        // 事件被别的等待方先取走时继续等。
+        pollfd pfd;
+        pfd.fd = epfd;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        rc = co_poll(&pfd, 1,
+                     wait_timeout_ms == kInfiniteTimeoutMs
+                         ? -1
+                         : static_cast<int>(wait_timeout_ms));
+        if (rc <= 0) {
+            return rc;
+        }
+
+        rc = static_cast<int>(retry_on_eintr([&]() -> ssize_t {
+            return sys().epoll_wait(epfd, events, maxevents, 0);
+        }));
+        if (rc != 0) {
+            return rc;
+        }
+    }
+}
+
 } // namespace zco
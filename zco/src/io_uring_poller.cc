@@ -0,0 +1,698 @@
+#include "zco/internal/io_uring_poller.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "zco/zco_log.h"
+
+namespace zco {
+
+// IoUringPoller 与 Epoller 提供相同的 waiter 语义，但把系统调用集中到
+// wait_events 里：
+// - register/unregister 只往提交队列里写 POLL_ADD/POLL_REMOVE，不进内核。
+// - wait_events 一次 io_uring_enter 同时完成“提交 + 等待”，完成队列通过
+//   mmap 直接读取；timeout 为 0 且没有待提交 SQE 时完全不产生系统调用。
+// - 每次提交 poll 都分配全局递增的代际号，fd 关闭重用或 waiter 被撤销后，
+//   迟到的完成事件因代际号不匹配而直接丢弃。
+// - 文件请求按编号登记，完成后把结果写回请求，经 on_ready 恢复协程。
+
+namespace {
+
+constexpr unsigned kRingEntries = 256;
+constexpr uint64_t kWakeUserData = ~0ULL;
+constexpr uint64_t kIgnoreUserData = ~0ULL - 1;
+constexpr uint32_t kGenerationMask = 0x3fffffffu;
+constexpr uint64_t kFileUserDataTag = 1ULL << 63;
+// 单次读写不超过 Linux read/write 的上限，cqe.res 为 32 位。
+constexpr size_t kMaxFileIoLength = 0x7ffff000;
+
+int sys_io_uring_setup(unsigned entries, io_uring_params *params) {
+    return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+}
+
+int sys_io_uring_enter(int ring_fd, unsigned to_submit, unsigned min_complete,
+                       unsigned flags, const void *arg, size_t arg_size) {
+    return static_cast<int>(::syscall(__NR_io_uring_enter, ring_fd, to_submit,
+                                      min_complete, flags, arg, arg_size));
+}
+
+unsigned load_acquire(const unsigned *value) {
+    return __atomic_load_n(value, __ATOMIC_ACQUIRE);
+}
+
+void store_release(unsigned *target, unsigned value) {
+    __atomic_store_n(target, value, __ATOMIC_RELEASE);
+}
+
+// user_data 布局：最高位 0 | 30 位代际号 | 1 位方向 | 低 32 位 fd。
+// fd 非负，因此低 32 位永远不会与两个保留值冲突；最高位为 1 且不是
+// 保留值的是文件请求，低位为请求编号。
+uint64_t encode_user_data(int fd, bool write, uint32_t generation) {
+    return (static_cast<uint64_t>(generation & kGenerationMask) << 33) |
+           (static_cast<uint64_t>(write ? 1 : 0) << 32) |
+           static_cast<uint32_t>(fd);
+}
+
+void decode_user_data(uint64_t user_data, int *fd, bool *write,
+                      uint32_t *generation) {
+    *fd = static_cast<int>(static_cast<uint32_t>(user_data));
+    *write = ((user_data >> 32) & 1) != 0;
+    *generation = static_cast<uint32_t>(user_data >> 33) & kGenerationMask;
+}
+
+} // namespace
+
+IoUringPoller::IoUringPoller()
+    : ring_fd_(-1), wake_fd_(-1), wake_pending_(false), wake_buffer_(0),
+      sq_ring_ptr_(nullptr), sq_ring_size_(0), cq_ring_ptr_(nullptr),
+      cq_ring_size_(0), sqes_(nullptr), sqes_size_(0), sq_head_(nullptr),
+      sq_tail_(nullptr), sq_array_(nullptr), sq_mask_(0), sq_entries_(0),
+      sq_local_tail_(0), cq_head_(nullptr), cq_tail_(nullptr), cq_mask_(0),
+      cqes_(nullptr), waiter_mutex_(), pending_submit_(0), next_generation_(1),
+      fd_poll_states_(), next_file_id_(1), file_requests_(),
+      syscall_count_(0) {}
+
+IoUringPoller::~IoUringPoller() { stop(); }
+
+bool IoUringPoller::supported() {
+    // 依赖 EXT_ARG（带超时的 io_uring_enter，5.11+）与单次 mmap；
+    // 容器 seccomp 禁用 io_uring 时 setup 直接失败，同样回退到 epoll。
+    static const bool kSupported = []() {
+        io_uring_params params;
+        ::memset(&params, 0, sizeof(params));
+        const int ring_fd = sys_io_uring_setup(2, &params);
+        if (ring_fd < 0) {
+            return false;
+        }
+        ::close(ring_fd);
+        return (params.features & IORING_FEAT_EXT_ARG) != 0 &&
+               (params.features & IORING_FEAT_SINGLE_MMAP) != 0 &&
+               (params.features & IORING_FEAT_NODROP) != 0;
+    }();
+    return kSupported;
+}
+
+bool IoUringPoller::start() {
+    if (!setup_ring()) {
+        ZCO_LOG_FATAL("io_uring poller init failed, errno={}", errno);
+        stop();
+        return false;
+    }
+
+    // eventfd 保持阻塞模式：非阻塞 fd 上的 IORING_OP_READ 会立即返回 EAGAIN，
+    // 阻塞模式下内核会把读请求挂起，直到 wake() 写入。
+    wake_fd_ = eventfd(0, EFD_CLOEXEC);
+    if (wake_fd_ < 0) {
+        ZCO_LOG_FATAL("io_uring poller wake fd init failed, errno={}", errno);
+        stop();
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(waiter_mutex_);
+        if (!queue_wake_read_locked()) {
+            ZCO_LOG_FATAL("io_uring poller arm wake fd failed, wake_fd={}",
+                          wake_fd_);
+            stop();
+            return false;
+        }
+    }
+
+    ZCO_LOG_INFO("io_uring poller started, ring_fd={}, wake_fd={}", ring_fd_,
+                 wake_fd_);
+    return true;
+}
+
+void IoUringPoller::stop() {
+    {
+        std::lock_guard<std::mutex> lock(waiter_mutex_);
+        fd_poll_states_.clear();
+        pending_submit_ = 0;
+    }
+
+    // 先关闭 ring，内核会撤销所有在途请求，之后再关闭 wake fd。
+    teardown_ring();
+    {
+        std::lock_guard<std::mutex> lock(waiter_mutex_);
+        file_requests_.clear();
+    }
+
+    if (wake_fd_ >= 0) {
+        ::close(wake_fd_);
+        wake_fd_ = -1;
+    }
+
+    ZCO_LOG_INFO("io_uring poller stopped");
+}
+
+void IoUringPoller::wake() {
+    if (wake_fd_ < 0) {
+        return;
+    }
+
+    bool expected = false;
+    if (!wake_pending_.compare_exchange_strong(expected, true,
+                                               std::memory_order_acq_rel,
+                                               std::memory_order_acquire)) {
+        return;
+    }
+
+    const uint64_t value = 1;
+    syscall_count_.fetch_add(1, std::memory_order_relaxed);
+    const ssize_t rc = ::write(wake_fd_, &value, sizeof(value));
+    if (rc < 0) {
+        wake_pending_.store(false, std::memory_order_release);
+        ZCO_LOG_WARN("io_uring poller wake failed, wake_fd={}, errno={}",
+                     wake_fd_, errno);
+    }
+}
+
+bool IoUringPoller::register_waiter(const std::shared_ptr<IoWaiter> &waiter) {
+    if (ring_fd_ < 0 || !waiter || waiter->fd < 0) {
+        errno = EINVAL;
+        return false;
+    }
+
+    const bool want_read = (waiter->events & EPOLLIN) != 0;
+    const bool want_write = (waiter->events & EPOLLOUT) != 0;
+    // 与 epoll 拒绝监听自身一致：ring fd 与 wake fd 不允许作为等待目标。
+    if ((!want_read && !want_write) || waiter->fd == ring_fd_ ||
+        waiter->fd == wake_fd_) {
+        errno = EINVAL;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(waiter_mutex_);
+
+    FdPollState &state = fd_poll_states_[waiter->fd];
+    FdPollState old_state = state;
+
+    if (state.read_waiter &&
+        !state.read_waiter->active.load(std::memory_order_acquire)) {
+        state.read_waiter.reset();
+    }
+    if (state.write_waiter &&
+        !state.write_waiter->active.load(std::memory_order_acquire)) {
+        state.write_waiter.reset();
+    }
+
+    if ((want_read && state.read_waiter &&
+         state.read_waiter.get() != waiter.get()) ||
+        (want_write && state.write_waiter &&
+         state.write_waiter.get() != waiter.get())) {
+        state = old_state;
+        errno = EBUSY;
+        return false;
+    }
+
+    // 方向上已有在途 poll 时直接复用，不再重复提交。
+    bool ok = true;
+    if (want_read) {
+        state.read_waiter = waiter;
+        if (!state.read_armed) {
+            state.read_generation = next_generation_++;
+            ok = queue_poll_locked(waiter->fd, false, state.read_generation);
+            state.read_armed = ok;
+        }
+    }
+    if (ok && want_write) {
+        state.write_waiter = waiter;
+        if (!state.write_armed) {
+            state.write_generation = next_generation_++;
+            ok = queue_poll_locked(waiter->fd, true, state.write_generation);
+            state.write_armed = ok;
+        }
+    }
+
+    if (ok) {
+        return true;
+    }
+
+    ZCO_LOG_WARN("io_uring queue poll failed, fd={}, events={}, errno={}",
+                 waiter->fd, waiter->events, errno);
+    if (state.read_waiter.get() == waiter.get()) {
+        state.read_waiter = old_state.read_waiter;
+    }
+    if (state.write_waiter.get() == waiter.get()) {
+        state.write_waiter = old_state.write_waiter;
+    }
+    drop_state_if_idle_locked(waiter->fd);
+    return false;
+}
+
+void IoUringPoller::unregister_waiter(const std::shared_ptr<IoWaiter> &waiter) {
+    if (ring_fd_ < 0 || !waiter || waiter->fd < 0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(waiter_mutex_);
+    auto it = fd_poll_states_.find(waiter->fd);
+    if (it == fd_poll_states_.end()) {
+        return;
+    }
+
+    FdPollState &state = it->second;
+    if ((waiter->events & EPOLLIN) && state.read_waiter.get() == waiter.get()) {
+        state.read_waiter.reset();
+        if (state.read_armed) {
+            // 超时等路径留下的在途 poll 会持有 file 引用，随下一次 enter
+            // 一并撤销。
+            queue_poll_remove_locked(waiter->fd, false, state.read_generation);
+            state.read_armed = false;
+        }
+    }
+
+    if ((waiter->events & EPOLLOUT) &&
+        state.write_waiter.get() == waiter.get()) {
+        state.write_waiter.reset();
+        if (state.write_armed) {
+            queue_poll_remove_locked(waiter->fd, true, state.write_generation);
+            state.write_armed = false;
+        }
+    }
+
+    drop_state_if_idle_locked(waiter->fd);
+}
+
+std::vector<std::shared_ptr<IoWaiter>> IoUringPoller::cancel_fd(int fd,
+                                                               int error) {
+    std::vector<std::shared_ptr<IoWaiter>> waiters;
+    if (ring_fd_ < 0 || fd < 0) {
+        return waiters;
+    }
+
+    std::lock_guard<std::mutex> lock(waiter_mutex_);
+    auto it = fd_poll_states_.find(fd);
+    if (it == fd_poll_states_.end()) {
+        return waiters;
+    }
+
+    FdPollState &state = it->second;
+    if (state.read_waiter) {
+        waiters.push_back(state.read_waiter);
+    }
+    if (state.write_waiter && state.write_waiter != state.read_waiter) {
+        waiters.push_back(state.write_waiter);
+    }
+    for (size_t i = 0; i < waiters.size(); ++i) {
+        waiters[i]->error.store(error, std::memory_order_release);
+    }
+
+    const bool had_armed = state.read_armed || state.write_armed;
+    if (state.read_armed) {
+        queue_poll_remove_locked(fd, false, state.read_generation);
+    }
+    if (state.write_armed) {
+        queue_poll_remove_locked(fd, true, state.write_generation);
+    }
+    fd_poll_states_.erase(it);
+
+    // 调用方紧接着会 close(fd)，必须立刻撤销 poll 释放 file 引用，
+    // 否则对端要等到下一次 wait_events 才能看到连接关闭。
+    if (had_armed) {
+        flush_locked();
+    }
+    return waiters;
+}
+
+bool IoUringPoller::submit_file(const std::shared_ptr<FileRequest> &request) {
+    if (ring_fd_ < 0 || !request || !request->waiter) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(waiter_mutex_);
+    io_uring_sqe *sqe = next_sqe_locked();
+    if (!sqe) {
+        return false;
+    }
+
+    const size_t length = std::min(request->length, kMaxFileIoLength);
+    switch (request->op) {
+    case FileRequest::Op::kOpen:
+        sqe->opcode = IORING_OP_OPENAT;
+        sqe->fd = AT_FDCWD;
+        sqe->addr = reinterpret_cast<uint64_t>(request->path.c_str());
+        sqe->len = request->mode;
+        sqe->open_flags = static_cast<uint32_t>(request->flags);
+        break;
+    case FileRequest::Op::kRead:
+    case FileRequest::Op::kWrite:
+        sqe->opcode = request->op == FileRequest::Op::kRead ? IORING_OP_READ
+                                                             : IORING_OP_WRITE;
+        sqe->fd = request->fd;
+        sqe->addr = reinterpret_cast<uint64_t>(request->buffer);
+        sqe->len = static_cast<uint32_t>(length);
+        sqe->off = static_cast<uint64_t>(request->offset);
+        break;
+    case FileRequest::Op::kFsync:
+    case FileRequest::Op::kFdatasync:
+        sqe->opcode = IORING_OP_FSYNC;
+        sqe->fd = request->fd;
+        sqe->fsync_flags = request->op == FileRequest::Op::kFdatasync
+                               ? IORING_FSYNC_DATASYNC
+                               : 0;
+        break;
+    }
+
+    const uint64_t id = next_file_id_++;
+    sqe->user_data = kFileUserDataTag | id;
+    file_requests_[id] = request;
+    publish_sqe_locked();
+    return true;
+}
+
+bool IoUringPoller::attach_fd(int fd) {
+    (void)fd;
+    return false;
+}
+
+void IoUringPoller::wait_events(
+    int timeout_ms,
+    const std::function<void(const std::shared_ptr<IoWaiter> &waiter,
+                             uint32_t ready_events)> &on_ready) {
+    if (ring_fd_ < 0) {
+        return;
+    }
+
+    unsigned to_submit = 0;
+    {
+        std::lock_guard<std::mutex> lock(waiter_mutex_);
+        to_submit = pending_submit_;
+        pending_submit_ = 0;
+    }
+
+    const bool has_completions = load_acquire(cq_tail_) != *cq_head_;
+    const bool should_wait = !has_completions && timeout_ms != 0;
+    if (to_submit > 0 || should_wait) {
+        const int rc = enter(to_submit, should_wait ? 1 : 0,
+                             should_wait ? IORING_ENTER_GETEVENTS : 0,
+                             timeout_ms);
+        unsigned unsubmitted = 0;
+        if (rc >= 0) {
+            unsubmitted = to_submit - std::min<unsigned>(
+                                          to_submit, static_cast<unsigned>(rc));
+        } else if (errno != ETIME && errno != EINTR) {
+            unsubmitted = to_submit;
+            ZCO_LOG_WARN("io_uring_enter failed, to_submit={}, errno={}",
+                         to_submit, errno);
+        }
+        if (unsubmitted > 0) {
+            std::lock_guard<std::mutex> lock(waiter_mutex_);
+            pending_submit_ += unsubmitted;
+        }
+    }
+
+    std::vector<std::pair<std::shared_ptr<IoWaiter>, uint32_t>> ready_waiters;
+    size_t completion_count = 0;
+    {
+        std::lock_guard<std::mutex> lock(waiter_mutex_);
+        unsigned head = *cq_head_;
+        const unsigned tail = load_acquire(cq_tail_);
+        bool rearm_wake = false;
+
+        for (; head != tail; ++head) {
+            const io_uring_cqe &cqe = cqes_[head & cq_mask_];
+            ++completion_count;
+
+            if (cqe.user_data == kWakeUserData) {
+                // wake fd 的读请求完成即代表唤醒计数已被消费。
+                wake_pending_.store(false, std::memory_order_release);
+                rearm_wake = true;
+                continue;
+            }
+            if (cqe.user_data == kIgnoreUserData) {
+                continue;
+            }
+            if ((cqe.user_data & kFileUserDataTag) != 0) {
+                auto file_it =
+                    file_requests_.find(cqe.user_data & ~kFileUserDataTag);
+                if (file_it != file_requests_.end()) {
+                    file_it->second->result = cqe.res;
+                    ready_waiters.push_back(
+                        std::make_pair(file_it->second->waiter, 0u));
+                    file_requests_.erase(file_it);
+                }
+                continue;
+            }
+
+            int fd = -1;
+            bool write = false;
+            uint32_t generation = 0;
+            decode_user_data(cqe.user_data, &fd, &write, &generation);
+
+            auto it = fd_poll_states_.find(fd);
+            if (it == fd_poll_states_.end()) {
+                continue;
+            }
+
+            FdPollState &state = it->second;
+            bool &armed = write ? state.write_armed : state.read_armed;
+            const uint32_t current_generation =
+                write ? state.write_generation : state.read_generation;
+            if (!armed ||
+                (current_generation & kGenerationMask) != generation) {
+                continue;
+            }
+            armed = false;
+
+            if (cqe.res != -ECANCELED) {
+                const uint32_t ready_events =
+                    cqe.res < 0 ? static_cast<uint32_t>(EPOLLERR)
+                                : static_cast<uint32_t>(cqe.res);
+                std::shared_ptr<IoWaiter> &slot =
+                    write ? state.write_waiter : state.read_waiter;
+                if (slot) {
+                    if (cqe.res < 0) {
+                        // 无效 fd 等错误在提交时才暴露，这里转交给等待方，
+                        // 与 epoll_ctl 同步失败时的 errno 保持一致。
+                        slot->error.store(-cqe.res, std::memory_order_release);
+                    }
+                    ready_waiters.push_back(std::make_pair(slot, ready_events));
+                    slot.reset();
+                }
+            }
+            drop_state_if_idle_locked(fd);
+        }
+
+        store_release(cq_head_, head);
+        if (rearm_wake && !queue_wake_read_locked()) {
+            ZCO_LOG_WARN("io_uring poller rearm wake fd failed, wake_fd={}",
+                         wake_fd_);
+        }
+    }
+
+    if (on_ready) {
+        for (size_t i = 0; i < ready_waiters.size(); ++i) {
+            on_ready(ready_waiters[i].first, ready_waiters[i].second);
+        }
+    }
+
+    if (completion_count > 0) {
+        ZCO_LOG_DEBUG("io_uring wait returned completions, count={}, "
+                      "submitted={}, timeout_ms={}",
+                      completion_count, to_submit, timeout_ms);
+    }
+}
+
+const char *IoUringPoller::name() const { return "io_uring"; }
+
+uint64_t IoUringPoller::syscall_count() const {
+    return syscall_count_.load(std::memory_order_relaxed);
+}
+
+bool IoUringPoller::setup_ring() {
+    io_uring_params params;
+    ::memset(&params, 0, sizeof(params));
+    ring_fd_ = sys_io_uring_setup(kRingEntries, &params);
+    if (ring_fd_ < 0) {
+        return false;
+    }
+
+    sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cq_ring_size_ =
+        params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    // SINGLE_MMAP 下 SQ/CQ 共用一段映射，取两者较大值。
+    sq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+    cq_ring_size_ = sq_ring_size_;
+
+    sq_ring_ptr_ = ::mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE,
+                          MAP_SHARED | MAP_POPULATE, ring_fd_,
+                          IORING_OFF_SQ_RING);
+    if (sq_ring_ptr_ == MAP_FAILED) {
+        sq_ring_ptr_ = nullptr;
+        return false;
+    }
+    cq_ring_ptr_ = sq_ring_ptr_;
+
+    sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+    void *sqes = ::mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+        return false;
+    }
+    sqes_ = static_cast<io_uring_sqe *>(sqes);
+
+    char *sq = static_cast<char *>(sq_ring_ptr_);
+    sq_head_ = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+    sq_tail_ = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+    sq_array_ = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+    sq_mask_ = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+    sq_entries_ =
+        *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_entries);
+    sq_local_tail_ = *sq_tail_;
+
+    char *cq = static_cast<char *>(cq_ring_ptr_);
+    cq_head_ = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+    cq_tail_ = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+    cq_mask_ = *reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+    return true;
+}
+
+void IoUringPoller::teardown_ring() {
+    if (sqes_) {
+        ::munmap(sqes_, sqes_size_);
+        sqes_ = nullptr;
+    }
+    if (sq_ring_ptr_) {
+        ::munmap(sq_ring_ptr_, sq_ring_size_);
+        sq_ring_ptr_ = nullptr;
+        cq_ring_ptr_ = nullptr;
+    }
+    if (ring_fd_ >= 0) {
+        ::close(ring_fd_);
+        ring_fd_ = -1;
+    }
+}
+
+io_uring_sqe *IoUringPoller::next_sqe_locked() {
+    if (sq_local_tail_ - load_acquire(sq_head_) >= sq_entries_) {
+        // 提交队列写满时同步提交一次，给后续 SQE 腾出位置。
+        flush_locked();
+        if (sq_local_tail_ - load_acquire(sq_head_) >= sq_entries_) {
+            errno = EBUSY;
+            return nullptr;
+        }
+    }
+
+    io_uring_sqe *sqe = &sqes_[sq_local_tail_ & sq_mask_];
+    ::memset(sqe, 0, sizeof(*sqe));
+    return sqe;
+}
+
+void IoUringPoller::publish_sqe_locked() {
+    const unsigned index = sq_local_tail_ & sq_mask_;
+    sq_array_[index] = index;
+    ++sq_local_tail_;
+    store_release(sq_tail_, sq_local_tail_);
+    ++pending_submit_;
+}
+
+bool IoUringPoller::queue_poll_locked(int fd, bool write,
+                                      uint32_t generation) {
+    io_uring_sqe *sqe = next_sqe_locked();
+    if (!sqe) {
+        return false;
+    }
+
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = fd;
+    sqe->poll32_events = write ? POLLOUT : POLLIN;
+    sqe->user_data = encode_user_data(fd, write, generation);
+    publish_sqe_locked();
+    return true;
+}
+
+void IoUringPoller::queue_poll_remove_locked(int fd, bool write,
+                                             uint32_t generation) {
+    io_uring_sqe *sqe = next_sqe_locked();
+    if (!sqe) {
+        ZCO_LOG_WARN("io_uring queue poll remove failed, fd={}", fd);
+        return;
+    }
+
+    sqe->opcode = IORING_OP_POLL_REMOVE;
+    sqe->fd = -1;
+    sqe->addr = encode_user_data(fd, write, generation);
+    sqe->user_data = kIgnoreUserData;
+    publish_sqe_locked();
+}
+
+bool IoUringPoller::queue_wake_read_locked() {
+    io_uring_sqe *sqe = next_sqe_locked();
+    if (!sqe) {
+        return false;
+    }
+
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = wake_fd_;
+    sqe->addr = reinterpret_cast<uint64_t>(&wake_buffer_);
+    sqe->len = sizeof(wake_buffer_);
+    sqe->off = static_cast<uint64_t>(-1);
+    sqe->user_data = kWakeUserData;
+    publish_sqe_locked();
+    return true;
+}
+
+void IoUringPoller::flush_locked() {
+    if (pending_submit_ == 0) {
+        return;
+    }
+
+    const unsigned to_submit = pending_submit_;
+    const int rc = enter(to_submit, 0, 0, 0);
+    if (rc < 0) {
+        ZCO_LOG_WARN("io_uring flush failed, to_submit={}, errno={}",
+                     to_submit, errno);
+        return;
+    }
+    pending_submit_ = to_submit - std::min<unsigned>(
+                                      to_submit, static_cast<unsigned>(rc));
+}
+
+void IoUringPoller::drop_state_if_idle_locked(int fd) {
+    auto it = fd_poll_states_.find(fd);
+    if (it == fd_poll_states_.end()) {
+        return;
+    }
+
+    const FdPollState &state = it->second;
+    if (!state.read_waiter && !state.write_waiter && !state.read_armed &&
+        !state.write_armed) {
+        fd_poll_states_.erase(it);
+    }
+}
+
+int IoUringPoller::enter(unsigned to_submit, unsigned min_complete,
+                         unsigned flags, int timeout_ms) {
+    syscall_count_.fetch_add(1, std::memory_order_relaxed);
+    if ((flags & IORING_ENTER_GETEVENTS) != 0 && timeout_ms >= 0) {
+        __kernel_timespec ts;
+        ts.tv_sec = timeout_ms / 1000;
+        ts.tv_nsec = static_cast<long long>(timeout_ms % 1000) * 1000000LL;
+
+        io_uring_getevents_arg arg;
+        ::memset(&arg, 0, sizeof(arg));
+        arg.ts = reinterpret_cast<uint64_t>(&ts);
+        return sys_io_uring_enter(ring_fd_, to_submit, min_complete,
+                                  flags | IORING_ENTER_EXT_ARG, &arg,
+                                  sizeof(arg));
+    }
+
+    return sys_io_uring_enter(ring_fd_, to_submit, min_complete, flags,
+                              nullptr, 0);
+}
+
+} // namespace zco
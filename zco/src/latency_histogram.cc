@@ -0,0 +1,76 @@
+#include "zco/internal/latency_histogram.h"
+
+namespace zco {
+
+// 桶布局：小于 8 的值各占一个线性桶；其余值按最高位 e 分组，取最高位
+// 之后的 3 位作为组内子桶。下标 = (e - 2) * 8 + 子桶，与线性桶首尾相接。
+
+namespace {
+
+void add_owner_counter(std::atomic<uint64_t> *counter, uint64_t value) {
+    counter->store(counter->load(std::memory_order_relaxed) + value,
+                   std::memory_order_relaxed);
+}
+
+} // namespace
+
+constexpr size_t LatencyHistogram::kSubBucketBits;
+constexpr size_t LatencyHistogram::kSubBucketCount;
+constexpr size_t LatencyHistogram::kBucketCount;
+
+LatencyHistogram::LatencyHistogram() : count_(0), sum_(0), max_(0) {
+    for (size_t i = 0; i < kBucketCount; ++i) {
+        buckets_[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+void LatencyHistogram::record(uint64_t value) {
+    add_owner_counter(&buckets_[bucket_index(value)], 1);
+    add_owner_counter(&count_, 1);
+    add_owner_counter(&sum_, value);
+    if (value > max_.load(std::memory_order_relaxed)) {
+        max_.store(value, std::memory_order_relaxed);
+    }
+}
+
+void LatencyHistogram::snapshot(LatencyHistogramStats *out) const {
+    if (!out) {
+        return;
+    }
+
+    out->count = count_.load(std::memory_order_relaxed);
+    out->sum_ns = sum_.load(std::memory_order_relaxed);
+    out->max_ns = max_.load(std::memory_order_relaxed);
+    out->buckets.assign(kBucketCount, 0);
+    for (size_t i = 0; i < kBucketCount; ++i) {
+        out->buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+    }
+}
+
+size_t LatencyHistogram::bucket_index(uint64_t value) {
+    if (value < kSubBucketCount) {
+        return static_cast<size_t>(value);
+    }
+
+    const size_t exponent = 63 - static_cast<size_t>(__builtin_clzll(value));
+    const size_t sub = static_cast<size_t>(
+        (value >> (exponent - kSubBucketBits)) & (kSubBucketCount - 1));
+    return (exponent - kSubBucketBits + 1) * kSubBucketCount + sub;
+}
+
+uint64_t LatencyHistogram::bucket_upper_bound(size_t index) {
+    if (index < kSubBucketCount) {
+        return index;
+    }
+    if (index >= kBucketCount) {
+        return UINT64_MAX;
+    }
+
+    const size_t exponent = index / kSubBucketCount + kSubBucketBits - 1;
+    const uint64_t sub = index % kSubBucketCount;
+    const size_t shift = exponent - kSubBucketBits;
+    const uint64_t lower = (kSubBucketCount + sub) << shift;
+    return lower + ((uint64_t(1) << shift) - 1);
+}
+
+} // namespace zco
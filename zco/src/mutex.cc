@@ -1,31 +1,118 @@
 #include "zco/mutex.h"
 
+#include <algorithm>
 #include <atomic>
-#include <condition_variable>
-#include <deque>
+#include <cstdint>
 #include <memory>
-#include <mutex>
+#include <thread>
 
-#include "zco/internal/coroutine_waiter.h"
-#include "zco/internal/fiber.h"
-#include "zco/internal/processor.h"
-#include "zco/internal/runtime_manager.h"
+#include "zco/internal/channel_wait_queue.h"
+#include "zco/sched.h"
 #include "zco/zco_log.h"
 
 namespace zco {
 
-// Mutex 同时支持线程与协程上下文：
-// - 线程等待：condition_variable。
-// - 协程等待：等待队列 + park/resume。
-// 解锁时优先交给协程等待者，避免协程场景被线程竞争长期饿死。
+// Mutex / SharedMutex 同时支持线程与协程上下文：
+// - 快路径只操作一个原子状态字。
+// - 慢路径复用通道的等待队列：节点池化，线程等在节点的条件变量上，
+//   协程 park/resume，唤醒方可以在 claim 与 complete 之间转交所有权。
+// - 解锁时有等待者就直接转交，锁在交接期间保持占用，不会被插队。
+// - Mutex 的协程与线程等待者分两侧排队，解锁时优先交给协程等待者，
+//   避免协程场景被线程竞争长期饿死；同一侧内按 FIFO 转交。
+
+namespace {
+
+constexpr uint32_t kMinSpins = 8;
+constexpr uint32_t kMaxSpins = 256;
+
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
+bool spin_allowed() {
+    // 单核上自旋只会占住持锁方需要的时间片。
+    static const bool allowed = std::thread::hardware_concurrency() > 1;
+    return allowed;
+}
+
+/**
+ * @brief 有上限的自适应自旋。
+ * @details 与 glibc adaptive mutex 类似，按最近的成功位置调整上限：
+ *          自旋能等到锁就多转一会，总是等不到就退回最小值。
+ */
+template <typename TryAcquire>
+bool spin_acquire(std::atomic<uint32_t> *estimate, TryAcquire try_acquire) {
+    if (!spin_allowed()) {
+        return false;
+    }
+
+    const uint32_t average = estimate->load(std::memory_order_relaxed);
+    const uint32_t limit = std::min(kMaxSpins, average * 2 + kMinSpins);
+    for (uint32_t i = 0; i < limit; ++i) {
+        cpu_relax();
+        if (try_acquire()) {
+            estimate->store(average + (static_cast<int32_t>(i) -
+                                       static_cast<int32_t>(average)) /
+                                          8,
+                            std::memory_order_relaxed);
+            return true;
+        }
+    }
+    estimate->store(average - average / 8, std::memory_order_relaxed);
+    return false;
+}
+
+void release_waiter_nodes(ChannelWaitQueue *waiters) {
+    ChannelWaiter *node = waiters->take_free_nodes();
+    while (node) {
+        ChannelWaiter *next = node->next;
+        delete node;
+        node = next;
+    }
+}
+
+ChannelWaiter *acquire_waiter_node(ChannelWaitQueue *waiters) {
+    ChannelWaiter *node = waiters->acquire_node();
+    return node ? node : new ChannelWaiter();
+}
+
+} // namespace
 
 struct Mutex::Impl {
-    void cleanup_waiters_locked() { cleanup_waiters_front(&coroutine_waiters); }
+    static constexpr uint32_t kUnlocked = 0;
+    static constexpr uint32_t kLocked = 1;
+    static constexpr uint32_t kContended = 2; // 已加锁且可能有等待者
+
+    Impl() : state(kUnlocked), spin_estimate(0), waiters() {}
+
+    ~Impl() { release_waiter_nodes(&waiters); }
+
+    bool try_acquire() {
+        uint32_t expected = kUnlocked;
+        return state.compare_exchange_strong(expected, kLocked,
+                                             std::memory_order_acquire,
+                                             std::memory_order_relaxed);
+    }
+
+    // 登记后持锁复查：状态已不是 kContended 说明解锁方可能看不到本节点。
+    static bool not_contended(const void *context) {
+        const Impl *self = static_cast<const Impl *>(context);
+        return self->state.load(std::memory_order_seq_cst) != kContended;
+    }
 
-    bool locked = false;
-    std::mutex mutex;
-    std::condition_variable cv;
-    std::deque<CoroutineWaiterEntry> coroutine_waiters;
+    // 协程等待者排在 kWriter 一侧，线程等待者排在 kReader 一侧。
+    static constexpr ChannelWaitQueue::Side kFiberSide =
+        ChannelWaitQueue::kWriter;
+    static constexpr ChannelWaitQueue::Side kThreadSide =
+        ChannelWaitQueue::kReader;
+
+    std::atomic<uint32_t> state;
+    std::atomic<uint32_t> spin_estimate;
+    ChannelWaitQueue waiters;
 };
 
 Mutex::Mutex() : impl_(std::make_shared<Impl>()) {}
@@ -38,38 +125,35 @@ void Mutex::lock() const {
         return;
     }
 
-    if (!in_coroutine()) {
-        // 线程路径：若已有协程在排队，也要让线程继续等待，避免插队。
-        std::unique_lock<std::mutex> lock(impl_->mutex);
-        for (;;) {
-            impl_->cleanup_waiters_locked();
-            if (!impl_->locked && impl_->coroutine_waiters.empty()) {
-                impl_->locked = true;
-                return;
-            }
-            impl_->cv.wait(lock);
-        }
+    Impl *impl = impl_.get();
+    if (impl->try_acquire() ||
+        spin_acquire(&impl->spin_estimate,
+                     [impl]() { return impl->try_acquire(); })) {
+        return;
     }
 
-    Fiber::ptr coroutine = current_fiber_shared();
-    std::shared_ptr<std::atomic<bool>> active =
-        std::make_shared<std::atomic<bool>>(true);
-    {
-        std::lock_guard<std::mutex> lock(impl_->mutex);
-        impl_->cleanup_waiters_locked();
-        if (!impl_->locked) {
-            impl_->locked = true;
+    ChannelWaitQueue::Side side = Impl::kThreadSide;
+    if (in_coroutine()) {
+        side = Impl::kFiberSide;
+    }
+    for (;;) {
+        // 置为 kContended 后再登记，解锁方看到它就会走转交路径。
+        if (impl->state.exchange(Impl::kContended,
+                                 std::memory_order_seq_cst) ==
+            Impl::kUnlocked) {
             return;
         }
 
-        impl_->coroutine_waiters.push_back(
-            CoroutineWaiterEntry{coroutine, active});
-        // 标记当前协程即将进入等待态，后续由 unlock 或超时路径恢复。
-        prepare_current_wait();
+        ChannelWaiter *node = acquire_waiter_node(&impl->waiters);
+        const ChannelWaiter::Result result =
+            impl->waiters.wait(node, side, kInfiniteTimeoutMs,
+                               &Impl::not_contended, impl);
+        impl->waiters.release_node(node);
+        if (result == ChannelWaiter::Result::kHanded) {
+            // 解锁方保持 kContended 直接转交，这里已经持有锁。
+            return;
+        }
     }
-
-    (void)park_current();
-    active->store(false, std::memory_order_release);
 }
 
 void Mutex::unlock() const {
@@ -78,65 +162,270 @@ void Mutex::unlock() const {
         return;
     }
 
-    Fiber::ptr resume_target;
-    {
-        std::lock_guard<std::mutex> lock(impl_->mutex);
-        if (!impl_->locked) {
-            ZCO_LOG_WARN("mutex unlock ignored, mutex is not locked");
+    Impl *impl = impl_.get();
+    uint32_t expected = Impl::kLocked;
+    if (impl->state.compare_exchange_strong(expected, Impl::kUnlocked,
+                                            std::memory_order_release,
+                                            std::memory_order_relaxed)) {
+        return;
+    }
+    if (expected == Impl::kUnlocked) {
+        ZCO_LOG_WARN("mutex unlock ignored, mutex is not locked");
+        return;
+    }
+
+    // kContended：先协程后线程转交给队首，state 保持不变。拿到锁的一方
+    // 可能立刻销毁 Mutex，慢路径先持有 Impl 的引用。
+    std::shared_ptr<Impl> keep_alive = impl_;
+    ChannelWaiter *waiter = impl->waiters.claim(Impl::kFiberSide);
+    if (!waiter) {
+        waiter = impl->waiters.claim(Impl::kThreadSide);
+    }
+    if (waiter) {
+        impl->waiters.complete(waiter, ChannelWaiter::Result::kHanded);
+        return;
+    }
+
+    // 登记中的等待者还没挂上队列：释放后由 notify 的栅栏与其复查配对。
+    // 两侧各唤醒一个重试，多出的一个会重新登记。
+    impl->state.store(Impl::kUnlocked, std::memory_order_seq_cst);
+    impl->waiters.notify(Impl::kFiberSide, 1);
+    impl->waiters.notify(Impl::kThreadSide, 1);
+}
+
+bool Mutex::try_lock() const {
+    if (!impl_) {
+        ZCO_LOG_WARN("mutex try_lock failed, impl is null");
+        return false;
+    }
+
+    return impl_->try_acquire();
+}
+
+struct SharedMutex::Impl {
+    static constexpr uint32_t kWriter = 1;
+    static constexpr uint32_t kReaderUnit = 2;
+
+    Impl() : state(0), spin_estimate(0), waiters() {}
+
+    ~Impl() { release_waiter_nodes(&waiters); }
+
+    bool try_acquire_writer() {
+        uint32_t expected = 0;
+        return state.compare_exchange_strong(expected, kWriter,
+                                             std::memory_order_acquire,
+                                             std::memory_order_relaxed);
+    }
+
+    // 写优先：有写者持锁或排队时读者不进入。
+    bool try_acquire_reader() {
+        uint32_t current = state.load(std::memory_order_relaxed);
+        while (!(current & kWriter) &&
+               !waiters.has_waiters(ChannelWaitQueue::kWriter)) {
+            if (state.compare_exchange_weak(current, current + kReaderUnit,
+                                            std::memory_order_acquire,
+                                            std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static bool writer_ready(const void *context) {
+        const Impl *self = static_cast<const Impl *>(context);
+        return self->state.load(std::memory_order_seq_cst) == 0;
+    }
+
+    static bool reader_ready(const void *context) {
+        const Impl *self = static_cast<const Impl *>(context);
+        return !(self->state.load(std::memory_order_seq_cst) & kWriter) &&
+               !self->waiters.has_waiters(ChannelWaitQueue::kWriter);
+    }
+
+    /**
+     * @brief 释放写锁，有等待者时直接转交。
+     * @param readers_first 写者释放时先整批转交给读者，最后一个读者代为
+     *        释放时先转交给写者，两侧交替推进。
+     */
+    void release_writer(bool readers_first) {
+        if (!readers_first && hand_to_writer()) {
+            return;
+        }
+        if (hand_to_readers()) {
+            return;
+        }
+        if (readers_first && hand_to_writer()) {
             return;
         }
 
-        impl_->cleanup_waiters_locked();
-        while (!impl_->coroutine_waiters.empty()) {
-            CoroutineWaiterEntry waiter = impl_->coroutine_waiters.front();
-            impl_->coroutine_waiters.pop_front();
-            Fiber::ptr candidate = claim_waiter(&waiter);
-            if (!candidate) {
-                continue;
-            }
+        state.store(0, std::memory_order_seq_cst);
+        notify_all_sides();
+    }
 
-            // 防止把锁交接给“已不在等待态”的协程，避免 locked 永久保持 true。
-            if (!candidate->try_wake(false)) {
-                ZCO_LOG_DEBUG("mutex unlock skip stale waiter, fiber_id={}",
-                              candidate->id());
-                continue;
-            }
+    bool has_any_waiters() const {
+        return waiters.has_waiters(ChannelWaitQueue::kReader) ||
+               waiters.has_waiters(ChannelWaitQueue::kWriter);
+    }
 
-            resume_target = std::move(candidate);
-            if (resume_target) {
-                break;
-            }
+    void notify_all_sides() {
+        waiters.notify(ChannelWaitQueue::kReader, SIZE_MAX);
+        waiters.notify(ChannelWaitQueue::kWriter, 1);
+    }
+
+    bool hand_to_writer() {
+        if (!waiters.has_waiters(ChannelWaitQueue::kWriter)) {
+            return false;
+        }
+        ChannelWaiter *writer = waiters.claim(ChannelWaitQueue::kWriter);
+        if (!writer) {
+            return false;
+        }
+        waiters.complete(writer, ChannelWaiter::Result::kHanded);
+        return true;
+    }
+
+    bool hand_to_readers() {
+        if (!waiters.has_waiters(ChannelWaitQueue::kReader)) {
+            return false;
         }
 
-        if (!resume_target) {
-            // 没有可交接的协程等待者时才真正释放锁。
-            impl_->locked = false;
+        ChannelWaiter *readers = nullptr;
+        uint32_t granted = 0;
+        while (ChannelWaiter *reader =
+                   waiters.claim(ChannelWaitQueue::kReader)) {
+            reader->next = readers;
+            readers = reader;
+            ++granted;
+        }
+        if (granted == 0) {
+            return false;
         }
+
+        state.store(granted * kReaderUnit, std::memory_order_seq_cst);
+        while (readers) {
+            ChannelWaiter *next = readers->next;
+            waiters.complete(readers, ChannelWaiter::Result::kHanded);
+            readers = next;
+        }
+        // 转交之后才登记的读者看到的仍是写锁，唤醒它们重新尝试。
+        waiters.notify(ChannelWaitQueue::kReader, SIZE_MAX);
+        return true;
     }
 
-    if (resume_target) {
-        // 直接交接给协程等待者，保持互斥语义连续。
-        resume_target->owner()->enqueue_ready(std::move(resume_target));
+    std::atomic<uint32_t> state;
+    std::atomic<uint32_t> spin_estimate;
+    ChannelWaitQueue waiters;
+};
+
+SharedMutex::SharedMutex() : impl_(std::make_shared<Impl>()) {}
+
+SharedMutex::~SharedMutex() = default;
+
+void SharedMutex::lock() const {
+    Impl *impl = impl_.get();
+    if (impl->try_acquire_writer() ||
+        spin_acquire(&impl->spin_estimate,
+                     [impl]() { return impl->try_acquire_writer(); })) {
         return;
     }
 
-    impl_->cv.notify_one();
+    for (;;) {
+        ChannelWaiter *node = acquire_waiter_node(&impl->waiters);
+        const ChannelWaiter::Result result = impl->waiters.wait(
+            node, ChannelWaitQueue::kWriter, kInfiniteTimeoutMs,
+            &Impl::writer_ready, impl);
+        impl->waiters.release_node(node);
+        if (result == ChannelWaiter::Result::kHanded ||
+            impl->try_acquire_writer()) {
+            return;
+        }
+    }
 }
 
-bool Mutex::try_lock() const {
-    if (!impl_) {
-        ZCO_LOG_WARN("mutex try_lock failed, impl is null");
-        return false;
+void SharedMutex::unlock() const {
+    Impl *impl = impl_.get();
+    if (!(impl->state.load(std::memory_order_relaxed) & Impl::kWriter)) {
+        ZCO_LOG_WARN("shared mutex unlock ignored, not locked for writing");
+        return;
     }
 
-    std::lock_guard<std::mutex> lock(impl_->mutex);
-    impl_->cleanup_waiters_locked();
-    if (impl_->locked || !impl_->coroutine_waiters.empty()) {
-        return false;
+    if (!impl->has_any_waiters()) {
+        // 持有写锁时其他人改不了状态字，直接清零。
+        impl->state.store(0, std::memory_order_seq_cst);
+        if (!impl->has_any_waiters()) {
+            return;
+        }
+        // 清零前刚登记的等待者看到的仍是写锁，唤醒它们重试。
+        impl->notify_all_sides();
+        return;
+    }
+
+    std::shared_ptr<Impl> keep_alive = impl_;
+    impl->release_writer(true);
+}
+
+bool SharedMutex::try_lock() const { return impl_->try_acquire_writer(); }
+
+void SharedMutex::lock_shared() const {
+    Impl *impl = impl_.get();
+    if (impl->try_acquire_reader() ||
+        spin_acquire(&impl->spin_estimate,
+                     [impl]() { return impl->try_acquire_reader(); })) {
+        return;
+    }
+
+    for (;;) {
+        ChannelWaiter *node = acquire_waiter_node(&impl->waiters);
+        const ChannelWaiter::Result result = impl->waiters.wait(
+            node, ChannelWaitQueue::kReader, kInfiniteTimeoutMs,
+            &Impl::reader_ready, impl);
+        impl->waiters.release_node(node);
+        if (result == ChannelWaiter::Result::kHanded ||
+            impl->try_acquire_reader()) {
+            return;
+        }
+    }
+}
+
+void SharedMutex::unlock_shared() const {
+    Impl *impl = impl_.get();
+    uint32_t current = impl->state.load(std::memory_order_relaxed);
+    for (;;) {
+        if (current < Impl::kReaderUnit || (current & Impl::kWriter)) {
+            ZCO_LOG_WARN("shared mutex unlock_shared ignored, not locked for "
+                         "reading");
+            return;
+        }
+
+        if (current == Impl::kReaderUnit &&
+            impl->waiters.has_waiters(ChannelWaitQueue::kWriter)) {
+            // 最后一个读者且有写者排队：不放开锁，直接改成写锁再转交。
+            if (impl->state.compare_exchange_weak(current, Impl::kWriter,
+                                                  std::memory_order_seq_cst,
+                                                  std::memory_order_relaxed)) {
+                std::shared_ptr<Impl> keep_alive = impl_;
+                impl->release_writer(false);
+                return;
+            }
+            continue;
+        }
+
+        if (impl->state.compare_exchange_weak(
+                current, current - Impl::kReaderUnit,
+                std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            break;
+        }
+    }
+
+    // 放开最后一个读锁时恰有写者登记：它看到的还是读锁，唤醒它重试。
+    if (current == Impl::kReaderUnit &&
+        impl->waiters.has_waiters(ChannelWaitQueue::kWriter)) {
+        impl->waiters.notify(ChannelWaitQueue::kWriter, 1);
     }
+}
 
-    impl_->locked = true;
-    return true;
+bool SharedMutex::try_lock_shared() const {
+    return impl_->try_acquire_reader();
 }
 
 MutexGuard::MutexGuard(const Mutex &mutex) : mutex_(&mutex) { mutex_->lock(); }
@@ -153,4 +442,16 @@ MutexGuard::~MutexGuard() {
     }
 }
 
+ReadGuard::ReadGuard(const SharedMutex &mutex) : mutex_(&mutex) {
+    mutex_->lock_shared();
+}
+
+ReadGuard::~ReadGuard() { mutex_->unlock_shared(); }
+
+WriteGuard::WriteGuard(const SharedMutex &mutex) : mutex_(&mutex) {
+    mutex_->lock();
+}
+
+WriteGuard::~WriteGuard() { mutex_->unlock(); }
+
 } // namespace zco
@@ -0,0 +1,39 @@
+#include "zco/internal/poller.h"
+
+#include <cstdlib>
+#include <cstring>
+
+#include "zco/internal/epoller.h"
+#include "zco/internal/io_uring_poller.h"
+#include "zco/zco_log.h"
+
+namespace zco {
+
+namespace {
+
+bool epoll_persistent_enabled() {
+    // ZCO_EPOLL_PERSISTENT=0 关闭边沿触发常驻注册，回退为按需注册。
+    const char *value = std::getenv("ZCO_EPOLL_PERSISTENT");
+    return !(value && std::strcmp(value, "0") == 0);
+}
+
+} // namespace
+
+std::unique_ptr<Poller> create_default_poller() {
+    // ZCO_POLLER 用于强制指定后端，便于对比测试与规避内核问题。
+    const char *preferred = std::getenv("ZCO_POLLER");
+    if (preferred && std::strcmp(preferred, "epoll") == 0) {
+        return std::unique_ptr<Poller>(new Epoller(epoll_persistent_enabled()));
+    }
+
+    if (IoUringPoller::supported()) {
+        return std::unique_ptr<Poller>(new IoUringPoller());
+    }
+
+    if (preferred && std::strcmp(preferred, "io_uring") == 0) {
+        ZCO_LOG_WARN("io_uring poller unsupported, fallback to epoll");
+    }
+    return std::unique_ptr<Poller>(new Epoller(epoll_persistent_enabled()));
+}
+
+} // namespace zco
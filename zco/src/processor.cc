@@ -3,12 +3,14 @@
 #include <errno.h>
 #include <sys/epoll.h>
 
+#include <algorithm>
 #include <chrono>
 #include <cstring>
-#include <iterator>
+#include <thread>
 #include <utility>
 
 #include "zco/internal/runtime_manager.h"
+#include "zco/internal/watchdog.h"
 #include "zco/zco_log.h"
 
 namespace zco {
@@ -22,12 +24,41 @@ namespace {
 
 thread_local Processor *tls_processor = nullptr;
 
+// 空闲处理器单次窃取的任务上限。
+constexpr size_t kStealBatchSize = 64;
+constexpr size_t kHandOffBatchSize = 256; // 缩容时单次转交的任务上限
+constexpr size_t kStackCacheLimit = 256; // 每处理器缓存的独立栈上限
+
+// 阻塞前的自旋时长，与一次 eventfd 唤醒加 epoll_wait 返回的代价相当。
+constexpr uint64_t kIdleSpinNs = 20 * 1000;
+constexpr uint32_t kIdleSpinStealRounds = 16; // 每隔多少轮自旋窃取一次
+
 #if defined(__x86_64__)
 constexpr size_t kStackRedZoneBytes = 128;
 #else
 constexpr size_t kStackRedZoneBytes = 0;
 #endif
 
+// 单写者计数器：用 load + store 代替 fetch_add，避免热路径上的 RMW 指令。
+void add_owner_counter(std::atomic<uint64_t> *counter, uint64_t value) {
+    counter->store(counter->load(std::memory_order_relaxed) + value,
+                   std::memory_order_relaxed);
+}
+
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
+bool spin_allowed() {
+    // 单核上自旋只会占住投递方需要的时间片。
+    static const bool allowed = std::thread::hardware_concurrency() > 1;
+    return allowed;
+}
+
 } // namespace
 
 Processor::Processor(int id, size_t stack_size)
@@ -36,24 +67,112 @@ Processor::Processor(int id, size_t stack_size)
 Processor::Processor(int id, size_t stack_size, size_t shared_stack_num,
                      StackModel stack_model)
     : id_(id), stack_size_(stack_size), stack_model_(stack_model),
-      running_(false), worker_(), ready_size_(0), cpu_time_ns_(0),
-      ema_loop_ns_(0), run_queue_mutex_(), run_queue_(), steal_queue_(),
+      placement_(), running_(false), idle_(false), worker_(),
+      drain_state_(kActive), live_fibers_(0), poller_started_(false),
+      cpu_time_ns_(0),
+      ema_loop_ns_(0), run_queue_(), steal_queue_(), task_batch_(),
       fiber_pool_(4096), next_stack_slot_(0), snapshot_pool_(),
+      stack_allocator_(stack_size, kStackCacheLimit),
+      stack_save_count_(0), stack_saved_bytes_(0), stack_restore_count_(0),
+      stack_restored_bytes_(0), context_switches_(0), yields_(0), parks_(0),
+      local_wakeups_(0), steals_in_(0), io_waits_(0), io_wakeups_(0),
+      idle_waits_(0), idle_wait_ns_(0), idle_spins_(0), idle_spin_hits_(0),
+      timer_fires_(0), fiber_pool_hits_(0), fiber_pool_misses_(0),
+      remote_wakeups_(0), steals_out_(0), wakes_avoided_(0),
+      wake_skipped_(false),
+      trace_latency_(false), slice_timing_(false), long_slice_ns_(0),
+      ready_latency_(), run_slice_(), long_slices_(0), slice_begin_ns_(0),
+      slice_fiber_id_(0), slice_site_begin_ns_(0), slice_site_depth_(0),
       steal_probe_cursor_(0), timer_queue_(), poller_(create_default_poller()),
       shared_stacks_(stack_model == StackModel::kShared
                          ? (shared_stack_num == 0 ? 1 : shared_stack_num)
                          : 0,
                      stack_size),
-      scheduler_context_(), current_fiber_() {}
+      scheduler_context_(), current_fiber_(nullptr) {}
 
 Processor::~Processor() {
     stop();
     join();
 
-    current_fiber_.reset();
+    current_fiber_ = nullptr;
+    // 停止后仍可能有协程被投回（例如阻塞调用在 shutdown 期间结束）。队列
+    // 声明在栈分配器之前、析构在它之后，须先释放这些协程，栈才能还给
+    // 仍然存活的分配器并随之解除映射。
+    std::deque<Fiber::ptr> pending;
+    while (run_queue_.drain(&pending, kHandOffBatchSize) > 0) {
+        pending.clear();
+    }
+    std::vector<Task> tasks;
+    steal_queue_.drain_all(&tasks);
+    tasks.clear();
+    task_batch_.clear();
     fiber_pool_.clear();
 }
 
+void Processor::set_placement(const CpuPlacement &placement) {
+    placement_ = placement;
+}
+
+int Processor::numa_node() const { return placement_.numa_node; }
+
+void Processor::set_trace(const SchedTraceOptions &options) {
+    trace_latency_ = options.latency_histograms;
+    long_slice_ns_ = static_cast<uint64_t>(options.long_slice_ms) * 1000000;
+    slice_timing_ = trace_latency_ || long_slice_ns_ != 0;
+}
+
+bool Processor::running_slice(uint64_t *begin_ns, int *fiber_id) const {
+    const uint64_t begin = slice_begin_ns_.load(std::memory_order_acquire);
+    if (begin == 0) {
+        return false;
+    }
+    if (begin_ns) {
+        *begin_ns = begin;
+    }
+    if (fiber_id) {
+        *fiber_id = slice_fiber_id_.load(std::memory_order_relaxed);
+    }
+    return true;
+}
+
+void Processor::publish_spawn_site(const SpawnSite *site) {
+    const uint64_t begin = slice_begin_ns_.load(std::memory_order_relaxed);
+    if (begin == 0 || !site) {
+        return;
+    }
+
+    // 先作废旧的起点再改写栈帧，读方按前后两次起点是否一致判断副本完整。
+    slice_site_begin_ns_.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    const int depth = std::min(site->depth, SpawnSite::kMaxFrames);
+    for (int i = 0; i < depth; ++i) {
+        slice_site_frames_[i].store(site->frames[i], std::memory_order_relaxed);
+    }
+    slice_site_depth_.store(depth, std::memory_order_relaxed);
+    slice_site_begin_ns_.store(begin, std::memory_order_release);
+}
+
+bool Processor::running_spawn_site(uint64_t begin_ns, SpawnSite *site) const {
+    if (begin_ns == 0 || !site ||
+        slice_site_begin_ns_.load(std::memory_order_acquire) != begin_ns) {
+        return false;
+    }
+
+    const int depth =
+        std::min(slice_site_depth_.load(std::memory_order_relaxed),
+                 SpawnSite::kMaxFrames);
+    for (int i = 0; i < depth; ++i) {
+        site->frames[i] = slice_site_frames_[i].load(std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slice_site_begin_ns_.load(std::memory_order_relaxed) != begin_ns ||
+        slice_begin_ns_.load(std::memory_order_relaxed) != begin_ns) {
+        return false;
+    }
+    site->depth = depth;
+    return depth > 0;
+}
+
 void Processor::start() {
     running_.store(true, std::memory_order_release);
     worker_ = std::thread(&Processor::run_loop, this);
@@ -73,11 +192,81 @@ void Processor::join() {
     }
 }
 
+void Processor::begin_drain() {
+    int expected = kActive;
+    if (drain_state_.compare_exchange_strong(expected, kDraining,
+                                             std::memory_order_acq_rel)) {
+        wake_loop();
+        ZCO_LOG_INFO("processor drain requested, sched_id={}", id_);
+    }
+}
+
+bool Processor::cancel_drain() {
+    int expected = kDraining;
+    return drain_state_.compare_exchange_strong(expected, kActive,
+                                                std::memory_order_acq_rel);
+}
+
+void Processor::restart() {
+    join();
+    drain_state_.store(kActive, std::memory_order_release);
+    start();
+}
+
+bool Processor::draining() const {
+    return drain_state_.load(std::memory_order_acquire) != kActive;
+}
+
 void Processor::enqueue_task(Task task) {
-    steal_queue_.push(std::move(task));
+    // 调度线程自身投递直接写入环形缓冲，循环回到顶部就会看到，不必唤醒；
+    // 其他线程走无锁注入栈。
+    if (current_processor() == this) {
+        steal_queue_.push_local(std::move(task));
+    } else {
+        steal_queue_.push(std::move(task));
+        notify_remote();
+        // notify_remote 的栅栏同时与退役方配对：两边至少有一方看到对方的
+        // 写入，退役之后才入队的任务由投递方自己转交出去。
+        if (drain_state_.load(std::memory_order_relaxed) == kRetired) {
+            hand_off_pending_tasks();
+            return;
+        }
+    }
+    const size_t pending = steal_queue_.size();
     ZCO_LOG_DEBUG("task enqueued, sched_id={}, pending_tasks={}", id_,
-                  steal_queue_.size());
-    wake_loop();
+                  pending);
+
+    // 积压超过一次窃取的批量时拉起一个空闲处理器：本处理器可能正被
+    // 长任务占住，空闲方阻塞在 poller 上也不会自己醒来窃取。
+    if (pending > kStealBatchSize) {
+        request_thief();
+    }
+}
+
+void Processor::enqueue_task_batch(Task *tasks, size_t count) {
+    if (count == 0) {
+        return;
+    }
+
+    const bool local = current_processor() == this;
+    if (local) {
+        steal_queue_.push_local_batch(tasks, count);
+    } else {
+        steal_queue_.push_batch(tasks, count);
+        notify_remote();
+        if (drain_state_.load(std::memory_order_relaxed) == kRetired) {
+            hand_off_pending_tasks();
+            return;
+        }
+    }
+    const size_t pending = steal_queue_.size();
+    ZCO_LOG_DEBUG("task batch enqueued, sched_id={}, count={}, "
+                  "pending_tasks={}",
+                  id_, count, pending);
+
+    if (pending > kStealBatchSize) {
+        request_thief();
+    }
 }
 
 void Processor::enqueue_ready(Fiber::ptr fiber) {
@@ -85,15 +274,26 @@ void Processor::enqueue_ready(Fiber::ptr fiber) {
         return;
     }
 
-    {
-        std::lock_guard<std::mutex> lock(run_queue_mutex_);
-        run_queue_.push_back(std::move(fiber));
-        ready_size_.fetch_add(1, std::memory_order_relaxed);
-        ZCO_LOG_DEBUG("fiber ready enqueued, sched_id={}, ready_size={}", id_,
-                      run_queue_.size());
+    stamp_ready(fiber.get());
+    if (current_processor() != this) {
+        // 跨线程唤醒只做一次注入栈 CAS，再打断可能阻塞的 poller。
+        remote_wakeups_.fetch_add(1, std::memory_order_relaxed);
+        if (run_queue_.push(std::move(fiber))) {
+            notify_remote();
+        }
+        return;
     }
 
-    wake_loop();
+    // 调度线程自身无需唤醒 poller：循环在阻塞前会先检查就绪队列。
+    // 正在运行的 Fiber 唤醒的对象放进 next 槽位，紧接着在本核运行。
+    add_owner_counter(&local_wakeups_, 1);
+    if (current_fiber_) {
+        run_queue_.push_next(std::move(fiber));
+    } else {
+        run_queue_.push_local(std::move(fiber));
+    }
+    ZCO_LOG_DEBUG("fiber ready enqueued, sched_id={}, ready_size={}", id_,
+                  run_queue_.size());
 }
 
 void Processor::enqueue_ready_batch(std::deque<Fiber::ptr> *fibers) {
@@ -101,23 +301,29 @@ void Processor::enqueue_ready_batch(std::deque<Fiber::ptr> *fibers) {
         return;
     }
 
-    {
-        std::lock_guard<std::mutex> lock(run_queue_mutex_);
-        const uint32_t added = static_cast<uint32_t>(fibers->size());
-        run_queue_.insert(run_queue_.end(),
-                          std::make_move_iterator(fibers->begin()),
-                          std::make_move_iterator(fibers->end()));
-        fibers->clear();
-        ready_size_.fetch_add(added, std::memory_order_relaxed);
-        ZCO_LOG_DEBUG(
-            "fiber ready batch enqueued, sched_id={}, added={}, ready_size={}",
-            id_, added, run_queue_.size());
+    const size_t added = fibers->size();
+    for (size_t i = 0; i < added; ++i) {
+        stamp_ready((*fibers)[i].get());
+        run_queue_.push_local(std::move((*fibers)[i]));
     }
+    fibers->clear();
+    ZCO_LOG_DEBUG(
+        "fiber ready batch enqueued, sched_id={}, added={}, ready_size={}",
+        id_, added, run_queue_.size());
 }
 
-size_t Processor::steal_tasks(std::deque<Task> *tasks, size_t max_steal,
+size_t Processor::steal_tasks(std::vector<Task> *tasks, size_t max_steal,
                               size_t min_reserve) {
     const size_t count = steal_queue_.steal(tasks, max_steal, min_reserve);
+    if (count > 0) {
+        steals_out_.fetch_add(count, std::memory_order_relaxed);
+        // 窃取期间暂时摘下的剩余任务可能在退役收尾之后才挂回，这时由
+        // 窃取方把它们转交出去。
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (drain_state_.load(std::memory_order_relaxed) == kRetired) {
+            hand_off_pending_tasks();
+        }
+    }
     ZCO_LOG_DEBUG(
         "tasks stolen from sched_id={}, stolen={}, remaining_tasks={}", id_,
         count, steal_queue_.size());
@@ -128,11 +334,29 @@ uint32_t Processor::pending_task_count() const {
     return static_cast<uint32_t>(steal_queue_.size());
 }
 
+size_t Processor::hand_off_pending_tasks() {
+    std::vector<Task> tasks;
+    size_t moved = 0;
+    while (steal_queue_.steal(&tasks, kHandOffBatchSize, 0) > 0) {
+        moved += tasks.size();
+        Runtime::instance().redistribute_tasks(tasks.data(), tasks.size());
+        tasks.clear();
+    }
+    if (moved > 0) {
+        steals_out_.fetch_add(moved, std::memory_order_relaxed);
+        ZCO_LOG_DEBUG("pending tasks handed off, sched_id={}, moved={}", id_,
+                      moved);
+    }
+    return moved;
+}
+
 int Processor::id() const { return id_; }
 
-Fiber::ptr Processor::current_fiber() const { return current_fiber_; }
+const Poller *Processor::poller() const { return poller_.get(); }
+
+Fiber *Processor::current_fiber() const { return current_fiber_; }
 
-ucontext_t *Processor::scheduler_context() { return scheduler_context_.get(); }
+Context *Processor::scheduler_context() { return &scheduler_context_; }
 
 void Processor::yield_current() {
     if (!current_fiber_) {
@@ -140,6 +364,7 @@ void Processor::yield_current() {
     }
 
     current_fiber_->mark_ready();
+    add_owner_counter(&yields_, 1);
     Context::swap_context(current_fiber_->context(), &scheduler_context_);
 }
 
@@ -157,6 +382,7 @@ bool Processor::park_current() {
     }
 
     // 切回调度上下文，等待 IO/Timer 或其他路径唤醒后再恢复。
+    add_owner_counter(&parks_, 1);
     Context::swap_context(current_fiber_->context(), &scheduler_context_);
     ZCO_LOG_DEBUG(
         "fiber resumed from park, sched_id={}, fiber_id={}, timed_out={}", id_,
@@ -170,17 +396,36 @@ bool Processor::park_current_for(uint32_t milliseconds) {
     }
 
     if (milliseconds == kInfiniteTimeoutMs) {
-        return park_current();
+        return park_interruptible();
     }
 
     // 为当前等待协程挂一个超时回调，超时后尝试把协程恢复为 ready。
-    Fiber::ptr waiting = current_fiber_;
-    std::shared_ptr<TimerToken> token =
-        add_timer(milliseconds, [waiting]() { resume_fiber(waiting, true); });
+    std::shared_ptr<TimerToken> token = add_timer(
+        milliseconds, [waiting = Fiber::ptr(current_fiber_)]() {
+            resume_fiber(waiting, true);
+        });
+
+    // 协程被正常事件、超时回调或取消唤醒后都会返回这里。
+    const bool ok = park_interruptible();
+    token->cancel();
+    return ok;
+}
+
+bool Processor::park_interruptible() {
+    Fiber *fiber = current_fiber_;
+    if (!fiber->begin_interruptible_wait()) {
+        fiber->end_interruptible_wait();
+        // 已被取消：收回自己的等待态；收不回说明唤醒方已把协程入队，
+        // 照常挂起把这次唤醒消费掉。
+        if (fiber->try_wake(true)) {
+            fiber->mark_running();
+            return false;
+        }
+        return park_current();
+    }
 
-    // 协程被正常事件唤醒或超时回调唤醒后都会返回这里。
     const bool ok = park_current();
-    token->cancelled.store(true, std::memory_order_release);
+    fiber->end_interruptible_wait();
     return ok;
 }
 
@@ -189,7 +434,10 @@ Processor::add_timer(uint32_t milliseconds, std::function<void()> callback) {
     std::shared_ptr<TimerToken> token =
         timer_queue_.add_timer(milliseconds, std::move(callback));
     ZCO_LOG_DEBUG("timer added, sched_id={}, delay_ms={}", id_, milliseconds);
-    wake_loop();
+    // 调度线程自己添加时循环在阻塞前会重新计算超时。
+    if (current_processor() != this) {
+        notify_remote();
+    }
     return token;
 }
 
@@ -204,26 +452,10 @@ bool Processor::wait_fd(int fd, uint32_t events, uint32_t milliseconds) {
                   "events={}, timeout_ms={}",
                   id_, current_fiber_->id(), fd, events, milliseconds);
 
-    std::shared_ptr<IoWaiter> waiter = std::make_shared<IoWaiter>();
-    waiter->fd = fd;
-    waiter->events = events & (EPOLLIN | EPOLLOUT);
-    waiter->fiber = current_fiber_;
-    waiter->timer = nullptr;
-    waiter->active.store(true, std::memory_order_release);
-    waiter->error.store(0, std::memory_order_release);
-
-    if (waiter->events == 0) {
-        errno = EINVAL;
-        return false;
-    }
-
     prepare_wait_current();
 
-    if (!poller_ || !poller_->register_waiter(waiter)) {
-        ZCO_LOG_ERROR(
-            "epoll add/mod failed, sched_id={}, fd={}, events={}, errno={}",
-            id_, fd, events, errno);
-        waiter->active.store(false, std::memory_order_release);
+    std::shared_ptr<IoWaiter> waiter = register_fd_wait(fd, events);
+    if (!waiter) {
         current_fiber_->mark_running();
         return false;
     }
@@ -237,25 +469,23 @@ bool Processor::wait_fd(int fd, uint32_t events, uint32_t milliseconds) {
             if (poller_) {
                 poller_->unregister_waiter(waiter);
             }
-            if (Fiber::ptr fiber = waiter->fiber.lock()) {
+            // active 竞争胜出后只有本路径访问 fiber，直接移走引用。
+            if (Fiber::ptr fiber = std::move(waiter->fiber)) {
                 ZCO_LOG_DEBUG(
                     "wait_fd timeout, sched_id={}, fd={}, fiber_id={}", id_,
                     waiter->fd, fiber->id());
-                resume_fiber(fiber, true);
+                resume_fiber(std::move(fiber), true);
             }
         });
     }
 
-    const bool ok = park_current();
+    const bool ok = park_interruptible();
     const int waiter_error = waiter->error.load(std::memory_order_acquire);
 
-    waiter->active.store(false, std::memory_order_release);
     if (waiter->timer) {
-        waiter->timer->cancelled.store(true, std::memory_order_release);
-    }
-    if (poller_) {
-        poller_->unregister_waiter(waiter);
+        waiter->timer->cancel();
     }
+    (void)unregister_fd_wait(waiter);
 
     if (waiter_error != 0) {
         errno = waiter_error;
@@ -266,11 +496,84 @@ bool Processor::wait_fd(int fd, uint32_t events, uint32_t milliseconds) {
         ZCO_LOG_DEBUG(
             "wait_fd wake failed or timeout, sched_id={}, fd={}, timeout_ms={}",
             id_, fd, milliseconds);
+        // 不依赖 poller 残留的 errno，超时统一暴露 ETIMEDOUT。
+        errno = current_fiber_->cancel_requested() ? ECANCELED : ETIMEDOUT;
     }
 
     return ok;
 }
 
+std::shared_ptr<IoWaiter> Processor::register_fd_wait(int fd,
+                                                      uint32_t events) {
+    std::shared_ptr<IoWaiter> waiter = std::make_shared<IoWaiter>();
+    waiter->fd = fd;
+    waiter->events = events & (EPOLLIN | EPOLLOUT);
+    waiter->fiber = Fiber::ptr(current_fiber_);
+    waiter->timer = nullptr;
+    waiter->active.store(true, std::memory_order_release);
+    waiter->error.store(0, std::memory_order_release);
+
+    if (waiter->events == 0) {
+        errno = EINVAL;
+        return nullptr;
+    }
+
+    if (poller_ && Runtime::instance().fd_attached(fd)) {
+        // 首次在本处理器等待时建立常驻注册，之后的等待不再修改兴趣集合。
+        (void)poller_->attach_fd(fd);
+    }
+
+    if (!poller_ || !poller_->register_waiter(waiter)) {
+        ZCO_LOG_ERROR(
+            "epoll add/mod failed, sched_id={}, fd={}, events={}, errno={}",
+            id_, fd, events, errno);
+        waiter->active.store(false, std::memory_order_release);
+        return nullptr;
+    }
+    add_owner_counter(&io_waits_, 1);
+    return waiter;
+}
+
+bool Processor::unregister_fd_wait(const std::shared_ptr<IoWaiter> &waiter) {
+    const bool consumed =
+        !waiter->active.exchange(false, std::memory_order_acq_rel);
+    if (poller_) {
+        poller_->unregister_waiter(waiter);
+    }
+    if (!consumed) {
+        // 未被 IO 路径消费，等待期间持有的协程引用由这里归还。
+        waiter->fiber.reset();
+    }
+    return consumed;
+}
+
+bool Processor::run_file_request(const std::shared_ptr<FileRequest> &request) {
+    if (!poller_ || !current_fiber_) {
+        return false;
+    }
+
+    std::shared_ptr<IoWaiter> waiter = std::make_shared<IoWaiter>();
+    waiter->fd = request->fd;
+    waiter->events = 0;
+    waiter->fiber = Fiber::ptr(current_fiber_);
+    waiter->timer = nullptr;
+    waiter->active.store(true, std::memory_order_release);
+    waiter->error.store(0, std::memory_order_release);
+    request->waiter = waiter;
+
+    // 完成事件只在本线程的 wait_events 里取出，先标记等待再提交即可。
+    prepare_wait_current();
+    if (!poller_->submit_file(request)) {
+        current_fiber_->mark_running();
+        request->waiter.reset();
+        return false;
+    }
+    add_owner_counter(&io_waits_, 1);
+    park_current();
+    request->waiter.reset();
+    return true;
+}
+
 void Processor::cancel_fd_waiters(int fd, int error) {
     if (!poller_ || fd < 0) {
         return;
@@ -286,14 +589,14 @@ void Processor::cancel_fd_waiters(int fd, int error) {
         }
 
         if (waiter->timer) {
-            waiter->timer->cancelled.store(true, std::memory_order_release);
+            waiter->timer->cancel();
         }
 
-        if (Fiber::ptr fiber = waiter->fiber.lock()) {
+        if (Fiber::ptr fiber = std::move(waiter->fiber)) {
             ZCO_LOG_DEBUG("fd waiter cancelled, sched_id={}, fd={}, "
                           "fiber_id={}, error={}",
                           id_, fd, fiber->id(), error);
-            resume_fiber(fiber, false);
+            resume_fiber(std::move(fiber), false);
         }
     }
 }
@@ -311,7 +614,7 @@ size_t Processor::shared_stack_count() const { return shared_stacks_.count(); }
 StackModel Processor::stack_model() const { return stack_model_; }
 
 uint32_t Processor::queue_load() const {
-    return ready_size_.load(std::memory_order_relaxed) +
+    return static_cast<uint32_t>(run_queue_.size()) +
            static_cast<uint32_t>(steal_queue_.size());
 }
 
@@ -327,7 +630,59 @@ uint64_t Processor::load_score() const {
     return queue_component + cpu_component;
 }
 
-void Processor::enqueue_stolen_tasks(std::deque<Task> *tasks) {
+StackCopyStats Processor::stack_copy_stats() const {
+    StackCopyStats stats;
+    stats.save_count = stack_save_count_.load(std::memory_order_relaxed);
+    stats.saved_bytes = stack_saved_bytes_.load(std::memory_order_relaxed);
+    stats.restore_count = stack_restore_count_.load(std::memory_order_relaxed);
+    stats.restored_bytes =
+        stack_restored_bytes_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+ProcessorStats Processor::stats() const {
+    ProcessorStats stats;
+    stats.id = id_;
+    stats.numa_node = placement_.numa_node;
+    stats.active = drain_state_.load(std::memory_order_relaxed) == kActive;
+    stats.idle = idle_.load(std::memory_order_relaxed);
+    stats.ready_fibers = static_cast<uint32_t>(run_queue_.size());
+    stats.pending_tasks = static_cast<uint32_t>(steal_queue_.size());
+    stats.pending_timers = timer_queue_.size();
+    stats.live_fibers =
+        static_cast<uint32_t>(live_fibers_.load(std::memory_order_relaxed));
+    stats.cpu_time_ns = cpu_time_ns_.load(std::memory_order_relaxed);
+    stats.ema_loop_ns = ema_loop_ns_.load(std::memory_order_relaxed);
+    stats.context_switches = context_switches_.load(std::memory_order_relaxed);
+    stats.yields = yields_.load(std::memory_order_relaxed);
+    stats.parks = parks_.load(std::memory_order_relaxed);
+    stats.remote_wakeups = remote_wakeups_.load(std::memory_order_relaxed);
+    stats.wakeups =
+        local_wakeups_.load(std::memory_order_relaxed) + stats.remote_wakeups;
+    stats.steals_in = steals_in_.load(std::memory_order_relaxed);
+    stats.steals_out = steals_out_.load(std::memory_order_relaxed);
+    stats.io_waits = io_waits_.load(std::memory_order_relaxed);
+    stats.io_wakeups = io_wakeups_.load(std::memory_order_relaxed);
+    stats.idle_waits = idle_waits_.load(std::memory_order_relaxed);
+    stats.idle_wait_ns = idle_wait_ns_.load(std::memory_order_relaxed);
+    stats.idle_spins = idle_spins_.load(std::memory_order_relaxed);
+    stats.idle_spin_hits = idle_spin_hits_.load(std::memory_order_relaxed);
+    stats.wakes_avoided = wakes_avoided_.load(std::memory_order_relaxed);
+    stats.poller_syscalls = poller_ ? poller_->syscall_count() : 0;
+    stats.timer_fires = timer_fires_.load(std::memory_order_relaxed);
+    stats.fiber_pool_hits = fiber_pool_hits_.load(std::memory_order_relaxed);
+    stats.fiber_pool_misses =
+        fiber_pool_misses_.load(std::memory_order_relaxed);
+    stats.long_slices = long_slices_.load(std::memory_order_relaxed);
+    stats.stack_copy = stack_copy_stats();
+    if (trace_latency_) {
+        ready_latency_.snapshot(&stats.ready_latency);
+        run_slice_.snapshot(&stats.run_slice);
+    }
+    return stats;
+}
+
+void Processor::enqueue_stolen_tasks(std::vector<Task> *tasks) {
     steal_queue_.append(tasks);
 }
 
@@ -341,27 +696,60 @@ void Processor::release_snapshot_buffer(char *buffer, uint8_t bucket_index,
     snapshot_pool_.release(buffer, bucket_index, capacity);
 }
 
+char *Processor::acquire_independent_stack(size_t stack_size) {
+    return stack_allocator_.allocate(stack_size);
+}
+
+void Processor::release_independent_stack(char *stack, size_t stack_size) {
+    stack_allocator_.deallocate(stack, stack_size);
+}
+
 void Processor::run_loop() {
     set_current_processor(this);
     ZCO_LOG_INFO("processor loop start, sched_id={}", id_);
 
-    if (!poller_ || !poller_->start()) {
-        running_.store(false, std::memory_order_release);
+    if (placement_.cpu >= 0 && bind_current_thread(placement_)) {
+        // 共享栈在构造线程上分配，绑定后迁到本节点。
+        const size_t bound = placement_.numa_node >= 0
+                                 ? shared_stacks_.bind_to_node(
+                                       placement_.numa_node)
+                                 : 0;
+        ZCO_LOG_INFO("processor bound, sched_id={}, cpu={}, numa_node={}, "
+                     "shared_stacks_bound={}",
+                     id_, placement_.cpu, placement_.numa_node, bound);
+    }
+
+    if (!poller_started_) {
+        poller_started_ = poller_ && poller_->start();
+        if (!poller_started_) {
+            running_.store(false, std::memory_order_release);
+        }
     }
 
     while (running_.load(std::memory_order_acquire)) {
         const auto loop_begin = std::chrono::steady_clock::now();
 
-        // 先消化新任务和就绪队列，尽量降低调度延迟。
-        drain_new_tasks();
+        // 先消化新任务和就绪队列，尽量降低调度延迟。缩容中不再实体化
+        // 新任务，积压全部转交出去。
+        if (drain_state_.load(std::memory_order_acquire) == kActive) {
+            drain_new_tasks();
+        } else if (hand_off_when_draining()) {
+            break;
+        }
         run_ready_tasks();
 
         // 再处理定时器，确保超时路径及时生效。
         process_timers();
         run_ready_tasks();
 
-        if (!has_ready_tasks()) {
-            wait_io_events_when_idle();
+        // 没有活时先自旋一小段时间，等不到再阻塞在 poller 上。标记空闲
+        // 之后重新检查一次队列，与 notify_remote 配对避免丢失唤醒。
+        if (!has_ready_tasks() && !drain_complete() && !spin_when_idle()) {
+            enter_idle();
+            if (!has_ready_tasks()) {
+                wait_io_events_when_idle();
+            }
+            leave_idle();
             steal_tasks_when_idle();
         }
 
@@ -375,17 +763,67 @@ void Processor::run_loop() {
         update_load_metrics(loop_ns);
     }
 
-    if (poller_) {
+    // 退役的处理器保留 poller：投递方此后仍可能写它的唤醒 fd。
+    if (poller_started_ && !running_.load(std::memory_order_acquire)) {
         poller_->stop();
+        poller_started_ = false;
     }
 
     set_current_processor(nullptr);
     ZCO_LOG_INFO("processor loop stop, sched_id={}", id_);
 }
 
+bool Processor::hand_off_when_draining() {
+    hand_off_pending_tasks();
+    hand_off_unstarted_fibers();
+    if (!drain_complete()) {
+        return false;
+    }
+
+    int expected = kDraining;
+    if (!drain_state_.compare_exchange_strong(expected, kRetired,
+                                              std::memory_order_seq_cst)) {
+        return false;
+    }
+    // 与 enqueue_task 的栅栏配对，收走退役前最后入队的任务。
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    hand_off_pending_tasks();
+    ZCO_LOG_INFO("processor retired, sched_id={}", id_);
+    return true;
+}
+
+void Processor::hand_off_unstarted_fibers() {
+    std::deque<Fiber::ptr> ready;
+    if (run_queue_.drain(&ready, run_queue_.size() + 1) == 0) {
+        return;
+    }
+
+    std::vector<Task> tasks;
+    for (Fiber::ptr &fiber : ready) {
+        // 未切入过的协程没有栈上状态，也没有导出过句柄，可以还原成任务。
+        if (fiber->context_initialized() || fiber->external_handle_id() != 0 ||
+            fiber->state() != Fiber::State::kReady) {
+            run_queue_.push_local(std::move(fiber));
+            continue;
+        }
+        tasks.push_back(fiber->take_task());
+        recycle_fiber(std::move(fiber));
+    }
+    if (!tasks.empty()) {
+        steals_out_.fetch_add(tasks.size(), std::memory_order_relaxed);
+        Runtime::instance().redistribute_tasks(tasks.data(), tasks.size());
+    }
+}
+
+bool Processor::drain_complete() const {
+    return drain_state_.load(std::memory_order_relaxed) != kActive &&
+           live_fibers_.load(std::memory_order_relaxed) == 0 &&
+           timer_queue_.size() == 0;
+}
+
 bool Processor::has_ready_tasks() const {
-    std::lock_guard<std::mutex> lock(run_queue_mutex_);
-    return !run_queue_.empty();
+    // 待创建任务每轮只实体化一批，剩余部分同样不能让循环进入阻塞等待。
+    return !run_queue_.empty() || steal_queue_.size() != 0;
 }
 
 void Processor::wait_io_events_when_idle() {
@@ -394,38 +832,83 @@ void Processor::wait_io_events_when_idle() {
     }
 
     const int timeout_ms = next_timeout_ms();
+    const auto wait_begin = std::chrono::steady_clock::now();
     // 没有 ready 任务时进入 epoll_wait，timeout 由最近定时器决定。
     poller_->wait_events(
         timeout_ms,
         [this](const std::shared_ptr<IoWaiter> &waiter, uint32_t ready_events) {
             handle_io_ready(waiter, ready_events);
         });
+    if (wake_skipped_.load(std::memory_order_relaxed)) {
+        wake_skipped_.store(false, std::memory_order_relaxed);
+    }
+    add_owner_counter(&idle_waits_, 1);
+    add_owner_counter(
+        &idle_wait_ns_,
+        static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - wait_begin)
+                .count()));
 }
 
 void Processor::steal_tasks_when_idle() {
     // 空闲时尝试从其他处理器批量窃取待创建任务，提升整体吞吐。
-    const std::vector<std::unique_ptr<Processor>> &all =
-        Runtime::instance().processors();
-    if (all.size() <= 1) {
+    // 缩容中的处理器只往外转交，不再窃取。
+    if (drain_state_.load(std::memory_order_relaxed) != kActive) {
+        return;
+    }
+
+    Runtime &runtime = Runtime::instance();
+    const std::vector<std::unique_ptr<Processor>> &all = runtime.processors();
+    const size_t count = runtime.processor_count();
+    if (count <= 1) {
+        return;
+    }
+
+    std::vector<Task> stolen_batch;
+    // 任务在窃取方实体化，栈也随之分配在窃取方节点；优先同节点可以
+    // 避免连接及其栈跨节点迁移。
+    if (placement_.numa_node >= 0) {
+        steal_from_victims(all, count, true, &stolen_batch);
+    }
+    if (stolen_batch.empty()) {
+        steal_from_victims(all, count, false, &stolen_batch);
+    }
+    steal_probe_cursor_ = (steal_probe_cursor_ + 1) % count;
+
+    if (stolen_batch.empty()) {
         return;
     }
 
+    ZCO_LOG_DEBUG("tasks stolen by scheduler, thief_sched_id={}, stolen={}",
+                  id_, stolen_batch.size());
+    add_owner_counter(&steals_in_, stolen_batch.size());
+    enqueue_stolen_tasks(&stolen_batch);
+}
+
+void Processor::steal_from_victims(
+    const std::vector<std::unique_ptr<Processor>> &all, size_t count,
+    bool same_node_only, std::vector<Task> *stolen_batch) {
     auto probe_victim = [&](size_t start_offset) -> Processor * {
-        const size_t start = (steal_probe_cursor_ + start_offset) % all.size();
-        for (size_t step = 0; step < all.size(); ++step) {
-            const size_t index = (start + step) % all.size();
+        const size_t start = (steal_probe_cursor_ + start_offset) % count;
+        for (size_t step = 0; step < count; ++step) {
+            const size_t index = (start + step) % count;
             Processor *candidate = all[index].get();
-            if (candidate && candidate != this) {
-                return candidate;
+            if (!candidate || candidate == this) {
+                continue;
             }
+            if (same_node_only &&
+                candidate->numa_node() != placement_.numa_node) {
+                continue;
+            }
+            return candidate;
         }
         return nullptr;
     };
 
     Processor *victim_a = probe_victim(0);
     Processor *victim_b =
-        probe_victim(1 + (steal_probe_cursor_ % (all.size() - 1)));
-    steal_probe_cursor_ = (steal_probe_cursor_ + 1) % all.size();
+        probe_victim(1 + (steal_probe_cursor_ % (count - 1)));
 
     Processor *chosen = victim_a;
     if (victim_a && victim_b && victim_a != victim_b) {
@@ -434,19 +917,10 @@ void Processor::steal_tasks_when_idle() {
         chosen = (b_pending > a_pending) ? victim_b : victim_a;
     }
 
-    std::deque<Task> stolen_batch;
-    if (chosen && chosen->steal_tasks(&stolen_batch, 64, 2) > 0) {
+    if (chosen && chosen->steal_tasks(stolen_batch, kStealBatchSize, 2) > 0) {
     } else if (victim_b && victim_b != chosen &&
-               victim_b->steal_tasks(&stolen_batch, 64, 2) > 0) {
-    }
-
-    if (stolen_batch.empty()) {
-        return;
+               victim_b->steal_tasks(stolen_batch, kStealBatchSize, 2) > 0) {
     }
-
-    ZCO_LOG_DEBUG("tasks stolen by scheduler, thief_sched_id={}, stolen={}",
-                  id_, stolen_batch.size());
-    enqueue_stolen_tasks(&stolen_batch);
 }
 
 void Processor::update_load_metrics(uint64_t loop_ns) {
@@ -470,27 +944,112 @@ void Processor::wake_loop() {
     }
 }
 
+bool Processor::wake_if_idle() {
+    if (!idle_.load(std::memory_order_relaxed) ||
+        !idle_.exchange(false, std::memory_order_acq_rel)) {
+        return false;
+    }
+    Runtime::instance().adjust_idle_processors(-1);
+    wake_loop();
+    return true;
+}
+
+void Processor::notify_remote() {
+    // 投递方与空闲方各自先写后读，中间的栅栏保证至少一方看到对方：
+    // 要么这里看到 idle_，要么对方在阻塞前看到新入队的内容。
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!idle_.load(std::memory_order_relaxed)) {
+        // 先读后换，忙碌期间的后续投递只读这条缓存行。
+        if (!wake_skipped_.load(std::memory_order_relaxed) &&
+            !wake_skipped_.exchange(true, std::memory_order_relaxed)) {
+            wakes_avoided_.fetch_add(1, std::memory_order_relaxed);
+        }
+        return;
+    }
+    wake_loop();
+}
+
+void Processor::request_thief() {
+    Runtime &runtime = Runtime::instance();
+    // 自旋中的处理器会自己来窃取，不必再把阻塞的处理器叫醒。
+    if (runtime.spinning_processors() != 0) {
+        wakes_avoided_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    runtime.wake_idle_processor(this);
+}
+
+bool Processor::spin_when_idle() {
+    if (!spin_allowed() ||
+        drain_state_.load(std::memory_order_relaxed) != kActive) {
+        return false;
+    }
+    Runtime &runtime = Runtime::instance();
+    if (!runtime.begin_spinning()) {
+        return false;
+    }
+
+    add_owner_counter(&idle_spins_, 1);
+    const uint64_t deadline = now_ns() + kIdleSpinNs;
+    bool found = false;
+    for (uint32_t round = 1;; ++round) {
+        if (has_ready_tasks()) {
+            found = true;
+            break;
+        }
+        if (round % kIdleSpinStealRounds == 0) {
+            steal_tasks_when_idle();
+            if (has_ready_tasks()) {
+                found = true;
+                break;
+            }
+            if (now_ns() >= deadline) {
+                break;
+            }
+        }
+        cpu_relax();
+    }
+    runtime.end_spinning();
+
+    if (found) {
+        add_owner_counter(&idle_spin_hits_, 1);
+    }
+    return found;
+}
+
+void Processor::enter_idle() {
+    idle_.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    Runtime::instance().adjust_idle_processors(1);
+}
+
+void Processor::leave_idle() {
+    if (idle_.exchange(false, std::memory_order_acq_rel)) {
+        Runtime::instance().adjust_idle_processors(-1);
+    }
+}
+
 void Processor::drain_new_tasks() {
     constexpr size_t kTaskMaterializeBatchLimit = 256;
 
-    std::deque<Task> pending;
-    steal_queue_.drain_some(&pending, kTaskMaterializeBatchLimit);
-    if (pending.empty()) {
+    // 暂存区跨轮次复用，容量稳定后实体化路径不再为容器分配内存。
+    steal_queue_.drain_some(&task_batch_, kTaskMaterializeBatchLimit);
+    if (task_batch_.empty()) {
         return;
     }
 
-    std::deque<Fiber::ptr> ready_batch;
-
-    while (!pending.empty()) {
-        Task task = std::move(pending.front());
-        pending.pop_front();
+    const uint64_t ready_ns = trace_latency_ ? now_ns() : 0;
+    for (Task &task : task_batch_) {
         Fiber::ptr fiber = obtain_fiber(std::move(task));
+        fiber->set_ready_since_ns(ready_ns);
         ZCO_LOG_DEBUG("task materialized to fiber, sched_id={}, fiber_id={}",
                       id_, fiber->id());
-        ready_batch.push_back(std::move(fiber));
+        run_queue_.push_local(std::move(fiber));
     }
-
-    enqueue_ready_batch(&ready_batch);
+    ZCO_LOG_DEBUG("new tasks materialized, sched_id={}, added={}, "
+                  "ready_size={}",
+                  id_, task_batch_.size(), run_queue_.size());
+    task_batch_.clear();
 }
 
 void Processor::run_ready_tasks() {
@@ -501,14 +1060,35 @@ void Processor::run_ready_tasks() {
         while (!ready_batch.empty()) {
             Fiber::ptr fiber = std::move(ready_batch.front());
             ready_batch.pop_front();
-            if (recycle_if_done_before_run(fiber)) {
-                continue;
-            }
+            run_fiber(std::move(fiber));
+            run_next_fibers();
+        }
+    }
+}
+
+void Processor::run_fiber(Fiber::ptr fiber) {
+    if (recycle_if_done_before_run(fiber)) {
+        return;
+    }
+
+    Fiber::ptr resumed = switch_to_fiber(std::move(fiber));
+    const Fiber::State state = finalize_after_switch(resumed);
+    dispatch_resumed_fiber(std::move(resumed), state);
+}
+
+void Processor::run_next_fibers() {
+    constexpr size_t kNextRunStreakLimit = 32;
 
-            Fiber::ptr resumed = switch_to_fiber(std::move(fiber));
-            const Fiber::State state = finalize_after_switch(resumed);
-            dispatch_resumed_fiber(std::move(resumed), state);
+    for (size_t streak = 0; streak < kNextRunStreakLimit; ++streak) {
+        Fiber::ptr fiber = run_queue_.take_next();
+        if (!fiber) {
+            return;
         }
+        run_fiber(std::move(fiber));
+    }
+
+    if (Fiber::ptr fiber = run_queue_.take_next()) {
+        run_queue_.push_local(std::move(fiber));
     }
 }
 
@@ -518,19 +1098,7 @@ size_t Processor::drain_ready_fibers(std::deque<Fiber::ptr> *fibers,
         return 0;
     }
 
-    std::lock_guard<std::mutex> lock(run_queue_mutex_);
-    if (run_queue_.empty()) {
-        return 0;
-    }
-
-    const size_t drained = std::min(max_count, run_queue_.size());
-    for (size_t i = 0; i < drained; ++i) {
-        fibers->push_back(std::move(run_queue_.front()));
-        run_queue_.pop_front();
-    }
-    ready_size_.fetch_sub(static_cast<uint32_t>(drained),
-                          std::memory_order_relaxed);
-    return drained;
+    return run_queue_.drain(fibers, max_count);
 }
 
 bool Processor::recycle_if_done_before_run(const Fiber::ptr &fiber) {
@@ -546,23 +1114,75 @@ bool Processor::recycle_if_done_before_run(const Fiber::ptr &fiber) {
 }
 
 Fiber::ptr Processor::switch_to_fiber(Fiber::ptr fiber) {
-    current_fiber_ = std::move(fiber);
+    // 引用留在调度栈上的 fiber 参数里，切换本身不触碰计数。
+    current_fiber_ = fiber.get();
 
+    // 先让出共享栈槽位再初始化上下文：make_context 会在栈顶写入初始帧，
+    // 必须等上一个占用者的栈快照保存完成之后。
+    prepare_shared_stack_for(fiber);
     if (!current_fiber_->context_initialized()) {
-        // 首次运行需要初始化 ucontext；后续恢复只做栈快照回填。
+        // 首次运行需要初始化上下文；后续恢复只做栈快照回填。
         current_fiber_->initialize_context();
     }
-    prepare_shared_stack_for(current_fiber_);
 
     current_fiber_->mark_running();
+    add_owner_counter(&context_switches_, 1);
     Context *fiber_context = current_fiber_->context();
     ZCO_LOG_DEBUG("switch to fiber, sched_id={}, fiber_id={}", id_,
                   current_fiber_->id());
+    const uint64_t slice_begin = slice_timing_ ? begin_slice(fiber.get()) : 0;
     Context::swap_context(&scheduler_context_, fiber_context);
+    if (slice_begin != 0) {
+        end_slice(fiber.get(), slice_begin);
+    }
 
-    Fiber::ptr resumed = current_fiber_;
-    current_fiber_.reset();
-    return resumed;
+    current_fiber_ = nullptr;
+    return fiber;
+}
+
+uint64_t Processor::begin_slice(Fiber *fiber) {
+    const uint64_t begin = now_ns();
+    const uint64_t ready_ns = fiber->take_ready_since_ns();
+    if (trace_latency_ && ready_ns != 0) {
+        ready_latency_.record(begin > ready_ns ? begin - ready_ns : 0);
+    }
+    slice_fiber_id_.store(fiber->id(), std::memory_order_relaxed);
+    slice_begin_ns_.store(begin, std::memory_order_release);
+    // 首个片段的创建位置由 SpawnSiteTask 在任务开始时登记。
+    publish_spawn_site(fiber->spawn_site());
+    return begin;
+}
+
+void Processor::end_slice(Fiber *fiber, uint64_t begin_ns) {
+    const uint64_t end = now_ns();
+    slice_begin_ns_.store(0, std::memory_order_relaxed);
+    const uint64_t slice_ns = end - begin_ns;
+    if (trace_latency_) {
+        run_slice_.record(slice_ns);
+        // yield 的协程随后直接回到就绪队列，以切回时刻作为就绪起点；
+        // 挂起的协程由唤醒方打点。
+        if (fiber->state() == Fiber::State::kReady) {
+            fiber->set_ready_since_ns(end);
+        }
+    }
+
+    if (long_slice_ns_ == 0 || slice_ns < long_slice_ns_) {
+        return;
+    }
+    add_owner_counter(&long_slices_, 1);
+    const SpawnSite *site = fiber->spawn_site();
+    ZCO_LOG_WARN("long fiber slice, sched_id={}, fiber_id={}, slice_ms={}, "
+                 "pending_tasks={}{}",
+                 id_, fiber->id(), slice_ns / 1000000,
+                 steal_queue_.size(),
+                 site ? "\n spawned at:" + format_spawn_site(*site)
+                      : std::string());
+}
+
+void Processor::stamp_ready(Fiber *fiber) const {
+    if (trace_latency_ && fiber) {
+        fiber->set_ready_since_ns(now_ns());
+    }
 }
 
 Fiber::State Processor::finalize_after_switch(const Fiber::ptr &fiber) {
@@ -584,8 +1204,9 @@ Fiber::State Processor::finalize_after_switch(const Fiber::ptr &fiber) {
 
 void Processor::dispatch_resumed_fiber(Fiber::ptr fiber, Fiber::State state) {
     if (state == Fiber::State::kReady) {
-        // 主动 yield 或被唤醒后进入 ready，重新排队等待下一轮调度。
-        enqueue_ready(std::move(fiber));
+        // 主动 yield 或被唤醒后进入 ready，重新排队等待下一轮调度。这里
+        // 总在调度线程且没有运行中的 Fiber，直接入队，不计入唤醒统计。
+        run_queue_.push_local(std::move(fiber));
         return;
     }
 
@@ -596,10 +1217,15 @@ void Processor::dispatch_resumed_fiber(Fiber::ptr fiber, Fiber::State state) {
     ZCO_LOG_DEBUG("fiber completed and unregistered, sched_id={}, fiber_id={}",
                   id_, fiber->id());
     Runtime::instance().unregister_fiber(fiber.get());
-    recycle_fiber(fiber);
+    recycle_fiber(std::move(fiber));
 }
 
-void Processor::process_timers() { timer_queue_.process_due(); }
+void Processor::process_timers() {
+    const size_t fired = timer_queue_.process_due();
+    if (fired > 0) {
+        add_owner_counter(&timer_fires_, fired);
+    }
+}
 
 int Processor::next_timeout_ms() const {
     return timer_queue_.next_timeout_ms();
@@ -618,14 +1244,15 @@ void Processor::handle_io_ready(const std::shared_ptr<IoWaiter> &waiter,
     }
 
     if (waiter->timer) {
-        waiter->timer->cancelled.store(true, std::memory_order_release);
+        waiter->timer->cancel();
     }
 
-    if (Fiber::ptr fiber = waiter->fiber.lock()) {
+    if (Fiber::ptr fiber = std::move(waiter->fiber)) {
         ZCO_LOG_DEBUG("io ready resume fiber, sched_id={}, fd={}, "
                       "fiber_id={}, ready_events={}",
                       id_, waiter->fd, fiber->id(), ready_events);
-        resume_fiber(fiber, false);
+        add_owner_counter(&io_wakeups_, 1);
+        resume_fiber(std::move(fiber), false);
     }
 }
 
@@ -672,6 +1299,8 @@ void Processor::save_fiber_stack(Fiber *fiber) {
 
     const size_t used = stack_top - save_begin;
     fiber->save_stack_data(reinterpret_cast<const char *>(save_begin), used);
+    add_owner_counter(&stack_save_count_, 1);
+    add_owner_counter(&stack_saved_bytes_, used);
     ZCO_LOG_DEBUG("shared stack saved, sched_id={}, fiber_id={}, used_bytes={}",
                   id_, fiber->id(), used);
 }
@@ -698,6 +1327,8 @@ void Processor::restore_fiber_stack(const Fiber::ptr &fiber) {
 
     char *dst = reinterpret_cast<char *>(stack_data) + (stack_size - used);
     std::memcpy(dst, fiber->saved_stack_data(), used);
+    add_owner_counter(&stack_restore_count_, 1);
+    add_owner_counter(&stack_restored_bytes_, used);
     ZCO_LOG_DEBUG(
         "shared stack restored, sched_id={}, fiber_id={}, used_bytes={}", id_,
         fiber->id(), used);
@@ -726,28 +1357,36 @@ void Processor::prepare_shared_stack_for(const Fiber::ptr &fiber) {
 Fiber::ptr Processor::obtain_fiber(Task task) {
     size_t stack_slot = 0;
     if (stack_model_ == StackModel::kShared) {
-        const size_t stack_count = shared_stacks_.count();
-        stack_slot = next_stack_slot_.fetch_add(1, std::memory_order_relaxed) %
-                     stack_count;
+        // 轮询起点只用于打散，真正选中的是绑定协程最少的槽位。
+        stack_slot = shared_stacks_.bind_slot(
+            next_stack_slot_.fetch_add(1, std::memory_order_relaxed));
     }
 
     const int fiber_id = Runtime::instance().next_fiber_id();
+    add_owner_counter(&live_fibers_, 1);
 
     Fiber::ptr fiber = fiber_pool_.acquire();
 
     if (fiber) {
+        add_owner_counter(&fiber_pool_hits_, 1);
         fiber->reset(fiber_id, std::move(task), stack_slot);
         return fiber;
     }
+    add_owner_counter(&fiber_pool_misses_, 1);
 
     // Task -> Fiber 的“实体化”发生在调度线程，避免跨线程创建上下文。
-    return std::make_shared<Fiber>(fiber_id, this, std::move(task), stack_size_,
-                                   stack_slot,
-                                   stack_model_ == StackModel::kShared);
+    return make_intrusive<Fiber>(fiber_id, this, std::move(task), stack_size_,
+                                 stack_slot,
+                                 stack_model_ == StackModel::kShared);
 }
 
-void Processor::recycle_fiber(const Fiber::ptr &fiber) {
-    fiber_pool_.recycle(fiber);
+void Processor::recycle_fiber(Fiber::ptr fiber) {
+    live_fibers_.store(live_fibers_.load(std::memory_order_relaxed) - 1,
+                       std::memory_order_relaxed);
+    if (fiber->use_shared_stack()) {
+        shared_stacks_.unbind_slot(fiber->stack_slot());
+    }
+    fiber_pool_.recycle(std::move(fiber));
 }
 
 Processor *current_processor() { return tls_processor; }
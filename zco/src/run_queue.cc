@@ -0,0 +1,167 @@
+#include "zco/internal/run_queue.h"
+
+#include <utility>
+
+namespace zco {
+
+// RunQueue 是处理器的就绪 Fiber 队列：
+// - push() 供其他线程唤醒使用，只做一次注入栈 CAS。
+// - push_local()/push_next() 由 owner 线程直接写本地链表与 next 槽位。
+// - 入队时调用方的引用被 detach 成裸指针挂在链表上，出队时原样接回，
+//   整个入队/出队过程不增减引用计数。
+// - run_queued_ 保证同一 Fiber 同时只在队列中出现一次。
+
+RunQueue::RunQueue()
+    : inject_head_(nullptr), size_(0), local_head_(nullptr),
+      local_tail_(nullptr), next_(nullptr) {}
+
+RunQueue::~RunQueue() {
+    std::deque<Fiber::ptr> remaining;
+    while (drain(&remaining, 256) > 0) {
+        remaining.clear();
+    }
+}
+
+bool RunQueue::push(Fiber::ptr fiber) {
+    Fiber *node = fiber.get();
+    if (!acquire_node(node, &fiber)) {
+        return false;
+    }
+
+    Fiber *head = inject_head_.load(std::memory_order_relaxed);
+    do {
+        node->run_queue_next_ = head;
+    } while (!inject_head_.compare_exchange_weak(head, node,
+                                                 std::memory_order_release,
+                                                 std::memory_order_relaxed));
+    return true;
+}
+
+bool RunQueue::push_local(Fiber::ptr fiber) {
+    Fiber *node = fiber.get();
+    if (!acquire_node(node, &fiber)) {
+        return false;
+    }
+
+    append_local(node);
+    return true;
+}
+
+bool RunQueue::push_next(Fiber::ptr fiber) {
+    Fiber *node = fiber.get();
+    if (!acquire_node(node, &fiber)) {
+        return false;
+    }
+
+    if (next_) {
+        append_local(next_);
+    }
+    next_ = node;
+    return true;
+}
+
+Fiber::ptr RunQueue::take_next() {
+    Fiber *node = next_;
+    if (!node) {
+        return nullptr;
+    }
+
+    next_ = nullptr;
+    return release_node(node);
+}
+
+Fiber::ptr RunQueue::pop() {
+    if (!local_head_) {
+        transfer_injected();
+        if (!local_head_) {
+            return nullptr;
+        }
+    }
+
+    Fiber *node = local_head_;
+    local_head_ = node->run_queue_next_;
+    if (!local_head_) {
+        local_tail_ = nullptr;
+    }
+    return release_node(node);
+}
+
+size_t RunQueue::drain(std::deque<Fiber::ptr> *fibers, size_t max_count) {
+    if (!fibers || max_count == 0) {
+        return 0;
+    }
+
+    size_t drained = 0;
+    if (Fiber::ptr fiber = take_next()) {
+        fibers->push_back(std::move(fiber));
+        ++drained;
+    }
+
+    while (drained < max_count) {
+        Fiber::ptr fiber = pop();
+        if (!fiber) {
+            break;
+        }
+        fibers->push_back(std::move(fiber));
+        ++drained;
+    }
+    return drained;
+}
+
+size_t RunQueue::size() const { return size_.load(std::memory_order_relaxed); }
+
+bool RunQueue::empty() const { return size() == 0; }
+
+bool RunQueue::acquire_node(Fiber *node, Fiber::ptr *fiber) {
+    if (!node || node->run_queued_.exchange(true, std::memory_order_acq_rel)) {
+        return false;
+    }
+
+    (void)fiber->detach();
+    node->run_queue_next_ = nullptr;
+    // 先计数再发布，消费者看到节点时计数不会出现下溢。
+    size_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+Fiber::ptr RunQueue::release_node(Fiber *node) {
+    Fiber::ptr fiber(node, false);
+    node->run_queue_next_ = nullptr;
+    size_.fetch_sub(1, std::memory_order_relaxed);
+    node->run_queued_.store(false, std::memory_order_release);
+    return fiber;
+}
+
+void RunQueue::append_local(Fiber *node) {
+    node->run_queue_next_ = nullptr;
+    if (local_tail_) {
+        local_tail_->run_queue_next_ = node;
+    } else {
+        local_head_ = node;
+    }
+    local_tail_ = node;
+}
+
+void RunQueue::transfer_injected() {
+    Fiber *node = inject_head_.exchange(nullptr, std::memory_order_acquire);
+    if (!node) {
+        return;
+    }
+
+    // 注入栈是 LIFO，翻转后按投递顺序接到本地链表尾部。
+    Fiber *reversed = nullptr;
+    while (node) {
+        Fiber *next = node->run_queue_next_;
+        node->run_queue_next_ = reversed;
+        reversed = node;
+        node = next;
+    }
+
+    while (reversed) {
+        Fiber *next = reversed->run_queue_next_;
+        append_local(reversed);
+        reversed = next;
+    }
+}
+
+} // namespace zco
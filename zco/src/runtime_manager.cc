@@ -3,11 +3,15 @@
 #include <errno.h>
 #include <poll.h>
 #include <sys/epoll.h>
+#include <sys/resource.h>
 
+#include <algorithm>
 #include <chrono>
 #include <thread>
 #include <utility>
 
+#include "zco/internal/blocking_pool.h"
+#include "zco/internal/syscall_hook.h"
 #include "zco/sched.h"
 #include "zco/zco_log.h"
 
@@ -23,6 +27,18 @@ namespace {
 constexpr size_t kDefaultStackSize = 128 * 1024;
 constexpr size_t kDefaultSharedStackNum = 64;
 constexpr StackModel kDefaultStackModel = StackModel::kShared;
+constexpr size_t kMaxAttachedFds = 1 << 20;
+// 处理器数组一次预留的容量，扩容不超过它，其他线程读下标时数组不会搬移。
+constexpr size_t kMaxSchedulers = 1024;
+
+size_t attached_fd_capacity() {
+    rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) != 0 ||
+        limit.rlim_cur == RLIM_INFINITY || limit.rlim_cur > kMaxAttachedFds) {
+        return kMaxAttachedFds;
+    }
+    return static_cast<size_t>(limit.rlim_cur);
+}
 
 uint64_t decode_fiber_handle(void *handle) {
     return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(handle));
@@ -32,6 +48,21 @@ void *encode_fiber_handle(uint64_t handle_id) {
     return reinterpret_cast<void *>(static_cast<uintptr_t>(handle_id));
 }
 
+// 把非空任务前移，返回非空任务数量。
+size_t compact_tasks(Task *tasks, size_t count) {
+    size_t valid = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (!tasks[i]) {
+            continue;
+        }
+        if (valid != i) {
+            tasks[valid] = std::move(tasks[i]);
+        }
+        ++valid;
+    }
+    return valid;
+}
+
 } // namespace
 
 Runtime &Runtime::instance() {
@@ -44,10 +75,19 @@ Runtime::Runtime()
       chooser_seed_(static_cast<uint64_t>(
           std::chrono::steady_clock::now().time_since_epoch().count())),
       fiber_id_gen_(1), fiber_handle_id_gen_(1), processors_(),
-      stack_config_mutex_(), stack_num_(kDefaultSharedStackNum),
-      stack_size_(kDefaultStackSize), stack_model_(kDefaultStackModel),
+      processor_count_(0), active_count_(0), scale_mutex_(),
+      idle_processors_(0), spinning_processors_(0), stack_config_mutex_(),
+      stack_num_(kDefaultSharedStackNum), stack_size_(kDefaultStackSize),
+      stack_model_(kDefaultStackModel), numa_aware_(false), sched_trace_(),
+      capture_spawn_site_(false), watchdog_(), node_processors_(),
       scheduler_handle_mutex_(), scheduler_handles_(),
-      fiber_handle_registry_() {}
+      fiber_handle_registry_(), attached_fds_(), attached_fd_capacity_(0) {
+    attached_fd_capacity_ = attached_fd_capacity();
+    attached_fds_.reset(new std::atomic<bool>[attached_fd_capacity_]);
+    for (size_t i = 0; i < attached_fd_capacity_; ++i) {
+        attached_fds_[i].store(false, std::memory_order_relaxed);
+    }
+}
 
 bool Runtime::set_stack_num(size_t stack_num) {
     if (stack_num == 0) {
@@ -89,6 +129,31 @@ bool Runtime::set_stack_model(StackModel stack_model) {
     return true;
 }
 
+bool Runtime::set_numa_aware(bool enable) {
+    std::lock_guard<std::mutex> lock(stack_config_mutex_);
+    if (started_.load(std::memory_order_acquire)) {
+        ZCO_LOG_WARN("co_numa_aware must be called before runtime start");
+        return false;
+    }
+    numa_aware_ = enable;
+    return true;
+}
+
+bool Runtime::set_sched_trace(const SchedTraceOptions &options) {
+    std::lock_guard<std::mutex> lock(stack_config_mutex_);
+    if (started_.load(std::memory_order_acquire)) {
+        ZCO_LOG_WARN("co_sched_trace must be called before runtime start");
+        return false;
+    }
+    sched_trace_ = options;
+    return true;
+}
+
+bool Runtime::numa_aware() const {
+    std::lock_guard<std::mutex> lock(stack_config_mutex_);
+    return numa_aware_;
+}
+
 size_t Runtime::stack_num() const {
     std::lock_guard<std::mutex> lock(stack_config_mutex_);
     return stack_num_;
@@ -128,6 +193,9 @@ void Runtime::init(uint32_t scheduler_count) {
         return;
     }
 
+    // 调度线程启动前解析原始系统调用入口；静态链接时也借此把接管层带进来。
+    (void)sys_calls();
+
     uint32_t final_count = scheduler_count;
     if (final_count == 0) {
         // 用户未指定并发度时，默认使用硬件并发数。
@@ -140,23 +208,55 @@ void Runtime::init(uint32_t scheduler_count) {
     size_t stack_num = 0;
     size_t stack_size = 0;
     StackModel stack_model = StackModel::kShared;
+    bool numa_aware = false;
+    SchedTraceOptions trace;
     {
         std::lock_guard<std::mutex> lock(stack_config_mutex_);
         stack_num = stack_num_;
         stack_size = stack_size_;
         stack_model = stack_model_;
+        numa_aware = numa_aware_;
+        trace = sched_trace_;
     }
 
-    processors_.reserve(final_count);
+    std::lock_guard<std::mutex> scale_lock(scale_mutex_);
+    std::vector<CpuPlacement> placements(final_count);
+    if (numa_aware) {
+        const CpuTopology topology = CpuTopology::detect();
+        placements = topology.plan(final_count);
+        ZCO_LOG_INFO("runtime topology detected, cpus={}, numa_nodes={}",
+                     topology.cpu_count(), topology.node_count());
+    }
+
+    processors_.reserve(std::max<size_t>(final_count, kMaxSchedulers));
     for (uint32_t i = 0; i < final_count; ++i) {
         // 每个 Processor 对应一个独立调度线程。
         processors_.push_back(std::unique_ptr<Processor>(new Processor(
             static_cast<int>(i), stack_size, stack_num, stack_model)));
+        processors_.back()->set_placement(placements[i]);
+        processors_.back()->set_trace(trace);
+
+        const int node = placements[i].numa_node;
+        if (node >= 0) {
+            if (node_processors_.size() <= static_cast<size_t>(node)) {
+                node_processors_.resize(static_cast<size_t>(node) + 1);
+            }
+            node_processors_[node].push_back(i);
+        }
     }
 
     for (size_t i = 0; i < processors_.size(); ++i) {
         processors_[i]->start();
     }
+    processor_count_.store(processors_.size(), std::memory_order_release);
+    active_count_.store(processors_.size(), std::memory_order_release);
+    capture_spawn_site_.store(trace.capture_spawn_site,
+                              std::memory_order_relaxed);
+    if (trace.long_slice_ms != 0) {
+        watchdog_.start(&processors_,
+                        static_cast<uint64_t>(trace.long_slice_ms) * 1000000,
+                        trace.migrate_on_long_slice);
+    }
     ZCO_LOG_INFO("runtime initialized, scheduler_count={}", processors_.size());
 }
 
@@ -168,16 +268,26 @@ void Runtime::shutdown() {
         return;
     }
 
+    std::lock_guard<std::mutex> scale_lock(scale_mutex_);
+    // 看门狗读取处理器列表，须先于处理器销毁停止。
+    watchdog_.stop();
+    capture_spawn_site_.store(false, std::memory_order_relaxed);
+
     for (size_t i = 0; i < processors_.size(); ++i) {
         processors_[i]->stop();
     }
     for (size_t i = 0; i < processors_.size(); ++i) {
         processors_[i]->join();
     }
+    // 阻塞调用结束后会把协程投回处理器，须等它们结束再销毁处理器。
+    BlockingPool::instance().wait_idle();
 
     fiber_handle_registry_.clear();
 
+    active_count_.store(0, std::memory_order_release);
+    processor_count_.store(0, std::memory_order_release);
     processors_.clear();
+    node_processors_.clear();
 
     {
         std::lock_guard<std::mutex> lock(scheduler_handle_mutex_);
@@ -189,6 +299,8 @@ void Runtime::shutdown() {
         stack_num_ = kDefaultSharedStackNum;
         stack_size_ = kDefaultStackSize;
         stack_model_ = kDefaultStackModel;
+        numa_aware_ = false;
+        sched_trace_ = SchedTraceOptions();
     }
 
     ZCO_LOG_INFO("runtime shutdown completed");
@@ -201,6 +313,9 @@ void Runtime::submit(Task task) {
     }
 
     ensure_started();
+    if (capture_spawn_site_.load(std::memory_order_relaxed)) {
+        task = attach_spawn_site(std::move(task));
+    }
 
     const size_t index = pick_processor_index();
     // 轮询基线 + 轻量负载感知，避免单点热点。
@@ -215,14 +330,90 @@ void Runtime::submit_to(size_t scheduler_index, Task task) {
     }
 
     ensure_started();
+    if (capture_spawn_site_.load(std::memory_order_relaxed)) {
+        task = attach_spawn_site(std::move(task));
+    }
 
-    const size_t index = scheduler_index % processors_.size();
-    // 显式投递仍需取模，防止越界访问。
+    const size_t index = scheduler_index % scheduler_count();
+    // 显式投递仍需取模，防止越界访问；缩容后落到仍活跃的调度器上。
     ZCO_LOG_DEBUG("runtime submit_to task, requested_sched_id={}, sched_id={}",
                   scheduler_index, index);
     processors_[index]->enqueue_task(std::move(task));
 }
 
+void Runtime::submit_batch(Task *tasks, size_t count) {
+    const size_t valid = compact_tasks(tasks, count);
+    if (valid < count) {
+        ZCO_LOG_WARN("submit_batch ignored null tasks, count={}",
+                     count - valid);
+    }
+    if (valid == 0) {
+        return;
+    }
+
+    ensure_started();
+    attach_spawn_sites(tasks, valid);
+    distribute_batch(tasks, valid);
+}
+
+void Runtime::redistribute_tasks(Task *tasks, size_t count) {
+    if (count == 0) {
+        return;
+    }
+    distribute_batch(tasks, count);
+}
+
+void Runtime::distribute_batch(Task *tasks, size_t count) {
+    // 与 submit 一样在拓扑模式下留在本节点；整批只推进一次轮询序号，
+    // 按目标数切段，每个处理器只入队、唤醒一次。
+    const std::vector<size_t> *group = local_node_group();
+    const size_t targets = group ? group->size() : scheduler_count();
+    const size_t width = std::min(count, targets);
+    const uint64_t ticket =
+        rr_index_.fetch_add(width, std::memory_order_relaxed);
+
+    size_t begin = 0;
+    for (size_t k = 0; k < width; ++k) {
+        const size_t end = (k + 1) * count / width;
+        const size_t slot = static_cast<size_t>((ticket + k) % targets);
+        const size_t index = group ? (*group)[slot] : slot;
+        ZCO_LOG_DEBUG("runtime submit task batch, sched_id={}, count={}",
+                      index, end - begin);
+        processors_[index]->enqueue_task_batch(tasks + begin, end - begin);
+        begin = end;
+    }
+}
+
+void Runtime::submit_batch_to(size_t scheduler_index, Task *tasks,
+                              size_t count) {
+    const size_t valid = compact_tasks(tasks, count);
+    if (valid < count) {
+        ZCO_LOG_WARN("submit_batch_to ignored null tasks, count={}",
+                     count - valid);
+    }
+    if (valid == 0) {
+        return;
+    }
+
+    ensure_started();
+    attach_spawn_sites(tasks, valid);
+
+    const size_t index = scheduler_index % scheduler_count();
+    ZCO_LOG_DEBUG("runtime submit_batch_to, requested_sched_id={}, "
+                  "sched_id={}, count={}",
+                  scheduler_index, index, valid);
+    processors_[index]->enqueue_task_batch(tasks, valid);
+}
+
+void Runtime::attach_spawn_sites(Task *tasks, size_t count) {
+    if (!capture_spawn_site_.load(std::memory_order_relaxed)) {
+        return;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        tasks[i] = attach_spawn_site(std::move(tasks[i]));
+    }
+}
+
 Scheduler *Runtime::main_scheduler() {
     ensure_started();
     return ensure_scheduler_handle(0);
@@ -236,12 +427,19 @@ Scheduler *Runtime::next_scheduler() {
 }
 
 size_t Runtime::pick_processor_index() {
-    const size_t count = processors_.size();
+    const size_t count = scheduler_count();
     if (count <= 1) {
         return 0;
     }
 
     const uint64_t ticket = rr_index_.fetch_add(1, std::memory_order_relaxed);
+
+    // 拓扑模式下由调度线程投递的任务（如 accept 出的连接）留在本节点。
+    size_t same_node_index = 0;
+    if (pick_same_node_index(ticket, &same_node_index)) {
+        return same_node_index;
+    }
+
     const size_t first = static_cast<size_t>(ticket % count);
 
     // 启动初期先用 RR 快速铺开，避免统计未稳定时偏置。
@@ -255,8 +453,46 @@ size_t Runtime::pick_processor_index() {
     return (first_score <= second_score) ? first : second;
 }
 
+const std::vector<size_t> *Runtime::local_node_group() const {
+    if (node_processors_.size() <= 1) {
+        return nullptr;
+    }
+
+    Processor *processor = current_processor();
+    const int node = processor ? processor->numa_node() : -1;
+    if (node < 0 || static_cast<size_t>(node) >= node_processors_.size()) {
+        return nullptr;
+    }
+
+    const std::vector<size_t> &group = node_processors_[node];
+    return group.empty() ? nullptr : &group;
+}
+
+bool Runtime::pick_same_node_index(uint64_t ticket, size_t *index) {
+    const std::vector<size_t> *local = local_node_group();
+    if (!local) {
+        return false;
+    }
+
+    const std::vector<size_t> &group = *local;
+
+    const size_t first = group[ticket % group.size()];
+    if (group.size() == 1) {
+        *index = first;
+        return true;
+    }
+
+    const size_t second =
+        group[(ticket + 1 + ticket / group.size()) % group.size()];
+    *index = processors_[first]->load_score() <=
+                     processors_[second]->load_score()
+                 ? first
+                 : second;
+    return true;
+}
+
 size_t Runtime::pick_secondary_index(size_t first, uint64_t ticket) {
-    const size_t count = processors_.size();
+    const size_t count = scheduler_count();
     if (count <= 1) {
         return 0;
     }
@@ -292,15 +528,173 @@ void Runtime::resume_external(void *handle) {
         return;
     }
 
-    resume_fiber(holder, false);
+    resume_fiber(std::move(holder), false);
+}
+
+size_t Runtime::scheduler_count() const {
+    return active_count_.load(std::memory_order_acquire);
+}
+
+size_t Runtime::processor_count() const {
+    return processor_count_.load(std::memory_order_acquire);
+}
+
+size_t Runtime::resize_schedulers(uint32_t count) {
+    if (count == 0) {
+        ZCO_LOG_WARN("resize_scheds ignored invalid value 0");
+        return scheduler_count();
+    }
+
+    ensure_started();
+    std::lock_guard<std::mutex> lock(scale_mutex_);
+    if (!started_.load(std::memory_order_acquire)) {
+        return 0;
+    }
+    if (numa_aware()) {
+        // 拓扑模式的节点分组与 CPU 绑定在 init 时一次规划，不支持增减。
+        ZCO_LOG_WARN("resize_scheds is not supported in numa aware mode");
+        return scheduler_count();
+    }
+
+    const size_t target =
+        std::min(static_cast<size_t>(count), processors_.capacity());
+    size_t active = scheduler_count();
+    while (active < target) {
+        // 先让处理器就绪再发布，投递方看到新数量时目标已在运行。
+        activate_processor(active);
+        ++active;
+        active_count_.store(active, std::memory_order_release);
+    }
+    while (active > target) {
+        // 先收缩活跃段，新任务不再投向它，再通知它转交已有的积压。
+        --active;
+        active_count_.store(active, std::memory_order_release);
+        processors_[active]->begin_drain();
+    }
+
+    ZCO_LOG_INFO("runtime schedulers resized, active={}, created={}", active,
+                 processor_count());
+    return active;
+}
+
+void Runtime::activate_processor(size_t index) {
+    if (index < processor_count()) {
+        Processor *processor = processors_[index].get();
+        if (!processor->cancel_drain()) {
+            processor->restart();
+        }
+        return;
+    }
+
+    SchedTraceOptions trace;
+    size_t stack_num = 0;
+    size_t stack_size = 0;
+    StackModel stack_model = StackModel::kShared;
+    {
+        std::lock_guard<std::mutex> lock(stack_config_mutex_);
+        trace = sched_trace_;
+        stack_num = stack_num_;
+        stack_size = stack_size_;
+        stack_model = stack_model_;
+    }
+
+    // 看门狗遍历数组时不能增加元素，先停下，加完再按新的数量启动。
+    watchdog_.stop();
+    processors_.push_back(std::unique_ptr<Processor>(new Processor(
+        static_cast<int>(index), stack_size, stack_num, stack_model)));
+    processors_.back()->set_trace(trace);
+    processors_.back()->start();
+    processor_count_.store(processors_.size(), std::memory_order_release);
+    if (trace.long_slice_ms != 0) {
+        watchdog_.start(&processors_,
+                        static_cast<uint64_t>(trace.long_slice_ms) * 1000000,
+                        trace.migrate_on_long_slice);
+    }
 }
 
-size_t Runtime::scheduler_count() const { return processors_.size(); }
+StackCopyStats Runtime::stack_copy_stats() const {
+    StackCopyStats total;
+    if (!started_.load(std::memory_order_acquire)) {
+        return total;
+    }
+
+    const size_t count = processor_count();
+    for (size_t i = 0; i < count; ++i) {
+        const StackCopyStats stats = processors_[i]->stack_copy_stats();
+        total.save_count += stats.save_count;
+        total.saved_bytes += stats.saved_bytes;
+        total.restore_count += stats.restore_count;
+        total.restored_bytes += stats.restored_bytes;
+    }
+    return total;
+}
+
+RuntimeStats Runtime::stats() const {
+    RuntimeStats snapshot;
+    if (!started_.load(std::memory_order_acquire)) {
+        return snapshot;
+    }
+
+    const size_t count = processor_count();
+    snapshot.processors.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        snapshot.processors.push_back(processors_[i]->stats());
+    }
+    snapshot.blocking = BlockingPool::instance().stats();
+    return snapshot;
+}
 
 const std::vector<std::unique_ptr<Processor>> &Runtime::processors() const {
     return processors_;
 }
 
+void Runtime::adjust_idle_processors(int delta) {
+    idle_processors_.fetch_add(static_cast<uint32_t>(delta),
+                               std::memory_order_relaxed);
+}
+
+void Runtime::wake_idle_processor(const Processor *busy) {
+    // 没有空闲处理器时直接返回，积压期间每次投递不必扫描全部处理器。
+    if (idle_processors_.load(std::memory_order_relaxed) == 0) {
+        return;
+    }
+
+    const size_t count = scheduler_count();
+    const size_t start = static_cast<size_t>(
+        rr_index_.fetch_add(1, std::memory_order_relaxed) % count);
+    for (size_t step = 0; step < count; ++step) {
+        Processor *processor = processors_[(start + step) % count].get();
+        if (processor != busy && processor->wake_if_idle()) {
+            return;
+        }
+    }
+}
+
+bool Runtime::begin_spinning() {
+    // 空闲计数也包含收尾中的处理器，可能超过活跃数；调用方自己总是忙碌的。
+    const uint32_t active =
+        static_cast<uint32_t>(active_count_.load(std::memory_order_relaxed));
+    const uint32_t idle = idle_processors_.load(std::memory_order_relaxed);
+    const uint32_t busy = idle < active ? active - idle : 1;
+    uint32_t spinning = spinning_processors_.load(std::memory_order_relaxed);
+    while (spinning * 2 < busy) {
+        if (spinning_processors_.compare_exchange_weak(
+                spinning, spinning + 1, std::memory_order_relaxed,
+                std::memory_order_relaxed)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void Runtime::end_spinning() {
+    spinning_processors_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+uint32_t Runtime::spinning_processors() const {
+    return spinning_processors_.load(std::memory_order_relaxed);
+}
+
 int Runtime::next_fiber_id() {
     return fiber_id_gen_.fetch_add(1, std::memory_order_relaxed);
 }
@@ -343,13 +737,35 @@ void Runtime::cancel_fd_waiters(int fd, int error) {
         return;
     }
 
-    for (size_t i = 0; i < processors_.size(); ++i) {
+    if (static_cast<size_t>(fd) < attached_fd_capacity_) {
+        attached_fds_[fd].store(false, std::memory_order_release);
+    }
+
+    const size_t count = processor_count();
+    for (size_t i = 0; i < count; ++i) {
         if (processors_[i]) {
             processors_[i]->cancel_fd_waiters(fd, error);
         }
     }
 }
 
+void Runtime::attach_fd(int fd) {
+    if (fd < 0 || static_cast<size_t>(fd) >= attached_fd_capacity_) {
+        return;
+    }
+
+    // fd 号可能来自未经 co_close 关闭的旧 fd，先清掉各处理器残留的注册。
+    cancel_fd_waiters(fd, EBADF);
+    attached_fds_[fd].store(true, std::memory_order_release);
+}
+
+bool Runtime::fd_attached(int fd) const {
+    if (fd < 0 || static_cast<size_t>(fd) >= attached_fd_capacity_) {
+        return false;
+    }
+    return attached_fds_[fd].load(std::memory_order_acquire);
+}
+
 void *Runtime::external_handle(const Fiber::ptr &fiber) {
     if (!fiber) {
         return nullptr;
@@ -369,10 +785,10 @@ Fiber::ptr current_fiber_shared() {
     if (!processor) {
         return nullptr;
     }
-    return processor->current_fiber();
+    return Fiber::ptr(processor->current_fiber());
 }
 
-void resume_fiber(const Fiber::ptr &fiber, bool timed_out) {
+void resume_fiber(Fiber::ptr fiber, bool timed_out) {
     if (!fiber) {
         return;
     }
@@ -385,7 +801,8 @@ void resume_fiber(const Fiber::ptr &fiber, bool timed_out) {
     }
 
     // Fiber 构造时 owner 必填且生命周期由运行时管理，这里直接使用即可。
-    fiber->owner()->enqueue_ready(fiber);
+    Processor *owner = fiber->owner();
+    owner->enqueue_ready(std::move(fiber));
 }
 
 void prepare_current_wait() {
@@ -437,8 +854,27 @@ bool wait_fd(int fd, uint32_t events, uint32_t milliseconds) {
     return processor->wait_fd(fd, events, milliseconds);
 }
 
+std::shared_ptr<IoWaiter> register_fd_wait(int fd, uint32_t events) {
+    Processor *processor = current_processor();
+    if (!processor || !processor->current_fiber()) {
+        errno = EPERM;
+        return nullptr;
+    }
+    return processor->register_fd_wait(fd, events);
+}
+
+bool unregister_fd_wait(const std::shared_ptr<IoWaiter> &waiter) {
+    Processor *processor = current_processor();
+    if (!processor || !waiter) {
+        return false;
+    }
+    return processor->unregister_fd_wait(waiter);
+}
+
 void cancel_fd_waiters(int fd, int error) {
     Runtime::instance().cancel_fd_waiters(fd, error);
 }
 
+void attach_fd(int fd) { Runtime::instance().attach_fd(fd); }
+
 } // namespace zco
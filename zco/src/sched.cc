@@ -22,6 +22,10 @@ void Scheduler::go(Task task) {
     Runtime::instance().submit_to(scheduler_index_, std::move(task));
 }
 
+void Scheduler::go_batch(Task *tasks, size_t count) {
+    Runtime::instance().submit_batch_to(scheduler_index_, tasks, count);
+}
+
 void Scheduler::go(Closure *cb) {
     if (cb == nullptr) {
         return;
@@ -52,6 +56,12 @@ void co_stack_model(StackModel stack_model) {
     Runtime::instance().set_stack_model(stack_model);
 }
 
+void co_numa_aware(bool enable) { Runtime::instance().set_numa_aware(enable); }
+
+StackCopyStats co_stack_copy_stats() {
+    return Runtime::instance().stack_copy_stats();
+}
+
 void shutdown() { Runtime::instance().shutdown(); }
 
 void go(Closure *cb) {
@@ -70,12 +80,20 @@ void go(Task task) {
     Runtime::instance().submit(std::move(task));
 }
 
+void go_batch(Task *tasks, size_t count) {
+    Runtime::instance().submit_batch(tasks, count);
+}
+
 Scheduler *main_sched() { return Runtime::instance().main_scheduler(); }
 
 Scheduler *next_sched() { return Runtime::instance().next_scheduler(); }
 
 void stop_scheds() { Runtime::instance().shutdown(); }
 
+size_t resize_scheds(uint32_t count) {
+    return Runtime::instance().resize_schedulers(count);
+}
+
 void yield() {
     // 线程上下文没有当前 fiber：直接让出 OS 线程时间片。
     Processor *processor = current_processor();
@@ -122,17 +140,28 @@ int sched_id() {
 }
 
 int coroutine_id() {
-    Fiber::ptr fiber = current_fiber_shared();
+    Processor *processor = current_processor();
+    Fiber *fiber = processor ? processor->current_fiber() : nullptr;
     return fiber ? fiber->id() : -1;
 }
 
 bool timeout() {
     // 仅在协程被超时路径唤醒后返回 true。
-    Fiber::ptr fiber = current_fiber_shared();
+    Processor *processor = current_processor();
+    Fiber *fiber = processor ? processor->current_fiber() : nullptr;
     return fiber ? fiber->timed_out() : false;
 }
 
-bool in_coroutine() { return current_fiber_shared() != nullptr; }
+bool cancelled() {
+    Processor *processor = current_processor();
+    Fiber *fiber = processor ? processor->current_fiber() : nullptr;
+    return fiber ? fiber->cancel_requested() : false;
+}
+
+bool in_coroutine() {
+    Processor *processor = current_processor();
+    return processor && processor->current_fiber();
+}
 
 size_t scheduler_count() { return Runtime::instance().scheduler_count(); }
 
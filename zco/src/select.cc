@@ -0,0 +1,223 @@
+#include "zco/select.h"
+
+#include <errno.h>
+#include <poll.h>
+#include <sys/epoll.h>
+
+#include <chrono>
+#include <memory>
+
+#include "zco/internal/fiber.h"
+#include "zco/internal/runtime_manager.h"
+#include "zco/internal/syscall_hook.h"
+#include "zco/zco_log.h"
+
+namespace zco {
+
+// select.cc 把多个等待源合并成一次挂起：
+// - 通道分支登记到各自的 ChannelWaitQueue，fd 分支登记到当前处理器的 poller，
+//   超时交给 park_current_for。
+// - 登记前先 prepare_current_wait()，协程的 kWaiting -> kReady 只能成功一次，
+//   这就是唤醒令牌：通道 claim()、IO 回调和超时定时器谁先 try_wake 谁胜出。
+// - 恢复后逐个撤销登记，胜出的通道节点带着结果，失败的节点已被摘掉或仍挂着。
+
+namespace {
+
+constexpr size_t kInlineCases = 8;
+
+struct ArmedCase {
+    ChannelWaiter *node;
+    std::shared_ptr<IoWaiter> io;
+};
+
+uint32_t remaining_ms(uint32_t timeout_ms,
+                      std::chrono::steady_clock::time_point deadline) {
+    if (timeout_ms == kInfiniteTimeoutMs) {
+        return kInfiniteTimeoutMs;
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    if (now >= deadline) {
+        return 0;
+    }
+    // 向上取整，避免剩余不足 1ms 时提前判定超时。
+    const auto left = std::chrono::duration_cast<std::chrono::microseconds>(
+        deadline - now);
+    return static_cast<uint32_t>((left.count() + 999) / 1000);
+}
+
+} // namespace
+
+SelectCase SelectCase::fd(int fd, IoEventType event_type, bool *ok) {
+    SelectCase c;
+    c.fd_ = fd;
+    c.ok_ = ok;
+    switch (event_type) {
+    case IoEventType::kRead:
+        c.events_ = EPOLLIN;
+        break;
+    case IoEventType::kWrite:
+        c.events_ = EPOLLOUT;
+        break;
+    default:
+        // 留空，登记时按 EINVAL 失败。
+        c.events_ = 0;
+        break;
+    }
+    return c;
+}
+
+int select(const SelectCase *cases, size_t count, uint32_t timeout_ms) {
+    if (!in_coroutine()) {
+        const int saved_errno = EPERM;
+        ZCO_LOG_ERROR("select must be called in coroutine context, count={}",
+                      count);
+        errno = saved_errno;
+        return -1;
+    }
+    if (!cases || count == 0) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() +
+                          std::chrono::milliseconds(timeout_ms);
+    auto fire = [cases](size_t index, bool ok) {
+        if (cases[index].ok_) {
+            *cases[index].ok_ = ok;
+        }
+        return static_cast<int>(index);
+    };
+
+    ArmedCase inline_armed[kInlineCases];
+    std::unique_ptr<ArmedCase[]> heap_armed;
+    ArmedCase *armed = inline_armed;
+    if (count > kInlineCases) {
+        heap_armed.reset(new ArmedCase[count]);
+        armed = heap_armed.get();
+    }
+
+    Fiber::ptr self = current_fiber_shared();
+    while (true) {
+        // 快路径：按声明顺序不等待地尝试，靠前的分支优先。
+        for (size_t i = 0; i < count; ++i) {
+            const SelectCase &c = cases[i];
+            bool ok = false;
+            if (c.channel_) {
+                if (c.poll_(c.channel_, c.value_, &ok)) {
+                    return fire(i, ok);
+                }
+                continue;
+            }
+
+            // 常驻注册是边沿触发，早先的边沿可能已被消费，这里按电平查一次。
+            pollfd pfd;
+            pfd.fd = c.fd_;
+            pfd.events = 0;
+            if (c.events_ & EPOLLIN) {
+                pfd.events |= POLLIN;
+            }
+            if (c.events_ & EPOLLOUT) {
+                pfd.events |= POLLOUT;
+            }
+            pfd.revents = 0;
+            const int rc = sys_calls().poll(&pfd, 1, 0);
+            if (rc < 0 && errno != EINTR) {
+                return -1;
+            }
+            if (rc > 0) {
+                if (pfd.revents & POLLNVAL) {
+                    errno = EBADF;
+                    return -1;
+                }
+                return fire(i, true);
+            }
+        }
+
+        const uint32_t wait_ms = remaining_ms(timeout_ms, deadline);
+        if (wait_ms == 0) {
+            errno = ETIMEDOUT;
+            return -1;
+        }
+
+        prepare_current_wait();
+        size_t armed_count = 0;
+        bool ready = false;
+        int error = 0;
+        for (; armed_count < count; ++armed_count) {
+            const SelectCase &c = cases[armed_count];
+            ArmedCase &a = armed[armed_count];
+            if (c.channel_) {
+                a.node = c.arm_(c.channel_, c.side_);
+                if (!a.node) {
+                    ready = true;
+                    break;
+                }
+            } else {
+                a.io = register_fd_wait(c.fd_, c.events_);
+                if (!a.io) {
+                    error = errno;
+                    break;
+                }
+            }
+        }
+
+        bool timed_out = false;
+        if (ready || error != 0) {
+            // 登记途中条件已满足：先收回自己的令牌；收不回说明已有分支胜出，
+            // 挂起等它把协程投递回来。
+            if (self->try_wake(false)) {
+                self->mark_running();
+            } else {
+                (void)park_current();
+            }
+        } else {
+            timed_out = !park_current_for(wait_ms);
+        }
+
+        int fired = -1;
+        bool channel_woke = false;
+        int fd_fired = -1;
+        int fd_error = 0;
+        for (size_t i = 0; i < armed_count; ++i) {
+            const SelectCase &c = cases[i];
+            ArmedCase &a = armed[i];
+            if (c.channel_) {
+                const ChannelWaiter::Result result =
+                    c.disarm_(c.channel_, c.side_, a.node, c.value_);
+                a.node = nullptr;
+                if (result == ChannelWaiter::Result::kHanded) {
+                    fired = fire(i, true);
+                } else if (result != ChannelWaiter::Result::kNone) {
+                    // 关闭或腾出空间，下一轮快路径会给出结果。
+                    channel_woke = true;
+                }
+                continue;
+            }
+
+            if (unregister_fd_wait(a.io) && fd_fired < 0) {
+                fd_fired = static_cast<int>(i);
+                fd_error = a.io->error.load(std::memory_order_acquire);
+            }
+            a.io.reset();
+        }
+
+        if (fired >= 0) {
+            return fired;
+        }
+        if (fd_fired >= 0 && !channel_woke && !timed_out) {
+            if (fd_error != 0) {
+                errno = fd_error;
+                return fire(static_cast<size_t>(fd_fired), false);
+            }
+            return fire(static_cast<size_t>(fd_fired), true);
+        }
+        if (error != 0) {
+            ZCO_LOG_DEBUG("select register fd failed, errno={}", error);
+            errno = error;
+            return -1;
+        }
+    }
+}
+
+} // namespace zco
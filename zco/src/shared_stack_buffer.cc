@@ -1,5 +1,7 @@
 #include "zco/internal/shared_stack_buffer.h"
 
+#include "zco/internal/topology.h"
+
 namespace zco {
 
 // SharedStackBuffer / SharedStackPool 负责共享栈模式下的“栈实体”管理：
@@ -65,7 +67,7 @@ void SharedStackBuffer::set_occupy_fiber(Fiber *fiber, int fiber_id) {
 }
 
 SharedStackPool::SharedStackPool(size_t stack_count, size_t stack_size)
-    : stacks_() {
+    : stacks_(), bound_counts_(stack_count, 0) {
     // 预分配固定数量的共享栈槽位，避免运行期扩容打断调度热路径。
     stacks_.reserve(stack_count);
     for (size_t i = 0; i < stack_count; ++i) {
@@ -105,4 +107,46 @@ void SharedStackPool::set_occupy_fiber(size_t stack_slot, Fiber *fiber,
     stacks_[stack_slot].set_occupy_fiber(fiber, fiber_id);
 }
 
+size_t SharedStackPool::bind_slot(size_t hint) {
+    const size_t count = stacks_.size();
+    if (count == 0) {
+        return 0;
+    }
+
+    size_t best = hint % count;
+    for (size_t step = 0; step < count && bound_counts_[best] != 0; ++step) {
+        const size_t slot = (hint + step) % count;
+        if (bound_counts_[slot] < bound_counts_[best]) {
+            best = slot;
+        }
+    }
+    ++bound_counts_[best];
+    return best;
+}
+
+void SharedStackPool::unbind_slot(size_t stack_slot) {
+    if (stack_slot < bound_counts_.size() && bound_counts_[stack_slot] > 0) {
+        --bound_counts_[stack_slot];
+    }
+}
+
+size_t SharedStackPool::bound_count(size_t stack_slot) const {
+    if (stack_slot >= bound_counts_.size()) {
+        return 0;
+    }
+    return bound_counts_[stack_slot];
+}
+
+size_t SharedStackPool::bind_to_node(int numa_node) {
+    // 共享栈在构造处理器的线程上分配，这里按节点重设策略并迁移已触碰的页。
+    size_t bound = 0;
+    for (size_t i = 0; i < stacks_.size(); ++i) {
+        if (bind_memory_to_node(stacks_[i].data(), stacks_[i].size(),
+                                numa_node)) {
+            ++bound;
+        }
+    }
+    return bound;
+}
+
 } // namespace zco
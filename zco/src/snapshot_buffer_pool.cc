@@ -12,15 +12,12 @@ constexpr size_t kSnapshotBucketSizes[] = {
 
 } // namespace
 
-SnapshotBufferPool::SnapshotBufferPool() : mutex_(), pools_() {}
+SnapshotBufferPool::SnapshotBufferPool() : buckets_() {}
 
 SnapshotBufferPool::~SnapshotBufferPool() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    for (size_t i = 0; i < pools_.size(); ++i) {
-        while (!pools_[i].empty()) {
-            delete[] pools_[i].back();
-            pools_[i].pop_back();
-        }
+    for (size_t i = 0; i < kBucketCount; ++i) {
+        buckets_[i].clear(
+            [](void *node) { delete[] static_cast<char *>(node); });
     }
 }
 
@@ -50,17 +47,8 @@ char *SnapshotBufferPool::acquire(size_t required_size, size_t *capacity,
     }
 
     const size_t picked_capacity = bucket_size(picked_bucket);
-    char *buffer = nullptr;
-    {
-        std::lock_guard<std::mutex> lock(mutex_);
-        std::deque<char *> &pool = pools_[picked_bucket];
-        if (!pool.empty()) {
-            // 复用已有缓冲区，减少高频保存/恢复栈快照时的分配开销。
-            buffer = pool.back();
-            pool.pop_back();
-        }
-    }
-
+    // 复用已有缓冲区，减少高频保存/恢复栈快照时的分配开销。
+    char *buffer = static_cast<char *>(buckets_[picked_bucket].pop());
     if (!buffer) {
         buffer = new char[picked_capacity];
     }
@@ -93,15 +81,12 @@ void SnapshotBufferPool::release(char *buffer, uint8_t bucket_index,
         return;
     }
 
-    std::lock_guard<std::mutex> lock(mutex_);
-    std::deque<char *> &pool = pools_[bucket_index];
-    if (pool.size() >= kPerBucketLimit) {
+    if (!buckets_[bucket_index].reserve(kPerBucketLimit)) {
         // 每桶设置上限，避免少量超大栈快照长期占住内存。
         delete[] buffer;
         return;
     }
-
-    pool.push_back(buffer);
+    buckets_[bucket_index].push(buffer);
 }
 
 uint8_t SnapshotBufferPool::pick_bucket(size_t required_size) {
@@ -121,4 +106,4 @@ size_t SnapshotBufferPool::bucket_size(uint8_t bucket_index) {
     return kSnapshotBucketSizes[bucket_index];
 }
 
-} // namespace zco
\ No newline at end of file
+} // namespace zco
\ No newline at end of file
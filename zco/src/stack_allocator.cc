@@ -0,0 +1,134 @@
+#include "zco/internal/stack_allocator.h"
+
+#include <errno.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "zco/zco_log.h"
+
+namespace zco {
+namespace {
+
+// 内核 4.5 之前没有 MADV_FREE，第一次收到 EINVAL 后全局退回 MADV_DONTNEED。
+std::atomic<bool> g_madv_free_supported(true);
+
+size_t detect_page_size() {
+    const long page_size = sysconf(_SC_PAGESIZE);
+    return page_size > 0 ? static_cast<size_t>(page_size) : 4096;
+}
+
+} // namespace
+
+StackAllocator::StackAllocator(size_t stack_size, size_t cache_limit)
+    : stack_size_(round_size(stack_size)), cache_limit_(cache_limit),
+      free_stacks_() {}
+
+StackAllocator::~StackAllocator() {
+    free_stacks_.clear(
+        [this](void *node) { unmap_stack(stack_of(node), stack_size_); });
+}
+
+char *StackAllocator::allocate(size_t stack_size) {
+    const size_t rounded = round_size(stack_size);
+    if (rounded != stack_size_) {
+        return map_stack(rounded);
+    }
+
+    if (void *node = free_stacks_.pop()) {
+        return stack_of(node);
+    }
+    return map_stack(rounded);
+}
+
+void StackAllocator::deallocate(char *stack, size_t stack_size) {
+    if (!stack) {
+        return;
+    }
+
+    const size_t rounded = round_size(stack_size);
+    if (rounded != stack_size_ || !free_stacks_.reserve(cache_limit_)) {
+        unmap_stack(stack, rounded);
+        return;
+    }
+
+    trim_stack(stack, rounded);
+    free_stacks_.push(node_of(stack));
+}
+
+size_t StackAllocator::cached_count() const { return free_stacks_.size(); }
+
+size_t StackAllocator::round_size(size_t stack_size) {
+    const size_t page = page_size();
+    if (stack_size == 0) {
+        return page;
+    }
+    return (stack_size + page - 1) / page * page;
+}
+
+size_t StackAllocator::page_size() {
+    static const size_t page_size = detect_page_size();
+    return page_size;
+}
+
+char *StackAllocator::map_stack(size_t stack_size) {
+    const size_t guard = page_size();
+    void *base = mmap(nullptr, guard + stack_size, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_STACK,
+                      -1, 0);
+    if (base == MAP_FAILED) {
+        // 大量协程时更常见的是 vm.max_map_count 耗尽：每个栈占两个 VMA。
+        ZCO_LOG_ERROR("mmap fiber stack failed, stack_size={}, errno={}",
+                      stack_size, errno);
+        throw std::bad_alloc();
+    }
+
+    if (mprotect(base, guard, PROT_NONE) != 0) {
+        ZCO_LOG_ERROR("mprotect stack guard failed, errno={}", errno);
+        munmap(base, guard + stack_size);
+        throw std::bad_alloc();
+    }
+    return static_cast<char *>(base) + guard;
+}
+
+void StackAllocator::unmap_stack(char *stack, size_t stack_size) {
+    const size_t guard = page_size();
+    if (munmap(stack - guard, guard + stack_size) != 0) {
+        ZCO_LOG_WARN("munmap fiber stack failed, stack_size={}, errno={}",
+                     stack_size, errno);
+    }
+}
+
+void StackAllocator::trim_stack(char *stack, size_t stack_size) {
+    // 顶页放空闲节点，复用后入口栈帧也落在这里，保留不做回收。
+    const size_t length = stack_size - page_size();
+    if (length == 0) {
+        return;
+    }
+
+#ifdef MADV_FREE
+    if (g_madv_free_supported.load(std::memory_order_relaxed)) {
+        if (madvise(stack, length, MADV_FREE) == 0) {
+            return;
+        }
+        if (errno != EINVAL) {
+            ZCO_LOG_DEBUG("madvise MADV_FREE failed, errno={}", errno);
+            return;
+        }
+        g_madv_free_supported.store(false, std::memory_order_relaxed);
+    }
+#endif
+
+    if (madvise(stack, length, MADV_DONTNEED) != 0) {
+        ZCO_LOG_DEBUG("madvise MADV_DONTNEED failed, errno={}", errno);
+    }
+}
+
+char *StackAllocator::node_of(char *stack) const {
+    return stack + stack_size_ - sizeof(void *);
+}
+
+char *StackAllocator::stack_of(void *node) const {
+    return static_cast<char *>(node) + sizeof(void *) - stack_size_;
+}
+
+} // namespace zco
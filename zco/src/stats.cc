@@ -0,0 +1,310 @@
+#include "zco/stats.h"
+
+#include <cmath>
+#include <cstdio>
+
+#include "zco/internal/latency_histogram.h"
+#include "zco/internal/runtime_manager.h"
+
+namespace zco {
+
+namespace {
+
+enum class MetricType { kCounter, kGauge };
+
+// 一个指标的描述：名字、说明、类型和从快照取值的方式。纳秒类的累计值
+// 以 scale 换算为秒，保持 Prometheus 的基本单位约定。
+struct MetricDesc {
+    const char *name;
+    const char *help;
+    MetricType type;
+    uint64_t (*value)(const ProcessorStats &);
+    double scale;
+};
+
+const MetricDesc kMetrics[] = {
+    {"ready_fibers", "Fibers waiting in the ready queue.", MetricType::kGauge,
+     [](const ProcessorStats &s) -> uint64_t { return s.ready_fibers; }, 1.0},
+    {"pending_tasks", "Submitted tasks not yet turned into fibers.",
+     MetricType::kGauge,
+     [](const ProcessorStats &s) -> uint64_t { return s.pending_tasks; }, 1.0},
+    {"live_fibers", "Fibers created and not yet finished.",
+     MetricType::kGauge,
+     [](const ProcessorStats &s) -> uint64_t { return s.live_fibers; }, 1.0},
+    {"pending_timers", "Timers not yet due.", MetricType::kGauge,
+     [](const ProcessorStats &s) -> uint64_t { return s.pending_timers; },
+     1.0},
+    {"active", "Whether the scheduler accepts new tasks.", MetricType::kGauge,
+     [](const ProcessorStats &s) -> uint64_t { return s.active ? 1 : 0; },
+     1.0},
+    {"idle", "Whether the scheduler is blocked in its poller.",
+     MetricType::kGauge,
+     [](const ProcessorStats &s) -> uint64_t { return s.idle ? 1 : 0; }, 1.0},
+    {"cpu_seconds_total", "Time spent in the scheduler loop.",
+     MetricType::kCounter,
+     [](const ProcessorStats &s) { return s.cpu_time_ns; }, 1e-9},
+    {"loop_seconds", "Moving average of one scheduler loop iteration.",
+     MetricType::kGauge, [](const ProcessorStats &s) { return s.ema_loop_ns; },
+     1e-9},
+    {"context_switches_total", "Switches into a fiber.", MetricType::kCounter,
+     [](const ProcessorStats &s) { return s.context_switches; }, 1.0},
+    {"yields_total", "Fibers that yielded voluntarily.", MetricType::kCounter,
+     [](const ProcessorStats &s) { return s.yields; }, 1.0},
+    {"parks_total", "Fibers that parked waiting for an event.",
+     MetricType::kCounter, [](const ProcessorStats &s) { return s.parks; },
+     1.0},
+    {"wakeups_total", "Parked fibers put back on the ready queue.",
+     MetricType::kCounter, [](const ProcessorStats &s) { return s.wakeups; },
+     1.0},
+    {"remote_wakeups_total", "Wakeups issued from another thread.",
+     MetricType::kCounter,
+     [](const ProcessorStats &s) { return s.remote_wakeups; }, 1.0},
+    {"steals_in_total", "Tasks stolen from other schedulers.",
+     MetricType::kCounter, [](const ProcessorStats &s) { return s.steals_in; },
+     1.0},
+    {"steals_out_total", "Tasks stolen by other schedulers.",
+     MetricType::kCounter, [](const ProcessorStats &s) { return s.steals_out; },
+     1.0},
+    {"io_waits_total", "Fd waits registered with the poller.",
+     MetricType::kCounter, [](const ProcessorStats &s) { return s.io_waits; },
+     1.0},
+    {"io_wakeups_total", "Fibers resumed by fd readiness.",
+     MetricType::kCounter,
+     [](const ProcessorStats &s) { return s.io_wakeups; }, 1.0},
+    {"idle_waits_total", "Times the scheduler blocked in its poller.",
+     MetricType::kCounter,
+     [](const ProcessorStats &s) { return s.idle_waits; }, 1.0},
+    {"idle_wait_seconds_total", "Time spent blocked in the poller.",
+     MetricType::kCounter,
+     [](const ProcessorStats &s) { return s.idle_wait_ns; }, 1e-9},
+    {"idle_spins_total", "Times the scheduler spun before blocking.",
+     MetricType::kCounter,
+     [](const ProcessorStats &s) { return s.idle_spins; }, 1.0},
+    {"idle_spin_hits_total", "Idle spins that found work before blocking.",
+     MetricType::kCounter,
+     [](const ProcessorStats &s) { return s.idle_spin_hits; }, 1.0},
+    {"wakes_avoided_total",
+     "Wake fd writes skipped because the scheduler was not blocked.",
+     MetricType::kCounter,
+     [](const ProcessorStats &s) { return s.wakes_avoided; }, 1.0},
+    {"poller_syscalls_total", "System calls issued by the poller.",
+     MetricType::kCounter,
+     [](const ProcessorStats &s) { return s.poller_syscalls; }, 1.0},
+    {"timer_fires_total", "Timer callbacks executed.", MetricType::kCounter,
+     [](const ProcessorStats &s) { return s.timer_fires; }, 1.0},
+    {"fiber_pool_hits_total", "Fibers created from the reuse pool.",
+     MetricType::kCounter,
+     [](const ProcessorStats &s) { return s.fiber_pool_hits; }, 1.0},
+    {"fiber_pool_misses_total", "Fibers created by a fresh allocation.",
+     MetricType::kCounter,
+     [](const ProcessorStats &s) { return s.fiber_pool_misses; }, 1.0},
+    {"long_slices_total", "Fiber run slices over the watchdog threshold.",
+     MetricType::kCounter,
+     [](const ProcessorStats &s) { return s.long_slices; }, 1.0},
+    {"stack_saves_total", "Shared stack snapshots saved.",
+     MetricType::kCounter,
+     [](const ProcessorStats &s) { return s.stack_copy.save_count; }, 1.0},
+    {"stack_saved_bytes_total", "Bytes copied out of shared stacks.",
+     MetricType::kCounter,
+     [](const ProcessorStats &s) { return s.stack_copy.saved_bytes; }, 1.0},
+    {"stack_restores_total", "Shared stack snapshots restored.",
+     MetricType::kCounter,
+     [](const ProcessorStats &s) { return s.stack_copy.restore_count; }, 1.0},
+    {"stack_restored_bytes_total", "Bytes copied back into shared stacks.",
+     MetricType::kCounter,
+     [](const ProcessorStats &s) { return s.stack_copy.restored_bytes; },
+     1.0},
+};
+
+// 阻塞线程池只有一份，样本不带 sched 标签。
+struct BlockingMetricDesc {
+    const char *name;
+    const char *help;
+    MetricType type;
+    uint64_t (*value)(const BlockingPoolStats &);
+    double scale;
+};
+
+const BlockingMetricDesc kBlockingMetrics[] = {
+    {"blocking_max_threads", "Concurrency cap of the blocking pool.",
+     MetricType::kGauge,
+     [](const BlockingPoolStats &s) -> uint64_t { return s.max_threads; },
+     1.0},
+    {"blocking_threads", "Threads in the blocking pool.", MetricType::kGauge,
+     [](const BlockingPoolStats &s) -> uint64_t { return s.threads; }, 1.0},
+    {"blocking_busy_threads", "Blocking threads running a call.",
+     MetricType::kGauge,
+     [](const BlockingPoolStats &s) -> uint64_t { return s.busy_threads; },
+     1.0},
+    {"blocking_queued", "Blocking calls waiting for a thread.",
+     MetricType::kGauge,
+     [](const BlockingPoolStats &s) -> uint64_t { return s.queued; }, 1.0},
+    {"blocking_queued_peak", "Largest blocking queue depth seen.",
+     MetricType::kGauge,
+     [](const BlockingPoolStats &s) -> uint64_t { return s.peak_queued; },
+     1.0},
+    {"blocking_submitted_total", "Blocking calls submitted.",
+     MetricType::kCounter,
+     [](const BlockingPoolStats &s) { return s.submitted; }, 1.0},
+    {"blocking_completed_total", "Blocking calls finished.",
+     MetricType::kCounter,
+     [](const BlockingPoolStats &s) { return s.completed; }, 1.0},
+    {"blocking_queue_wait_seconds_total",
+     "Time blocking calls waited for a thread.", MetricType::kCounter,
+     [](const BlockingPoolStats &s) { return s.queue_wait_ns; }, 1e-9},
+    {"blocking_run_seconds_total", "Time spent running blocking calls.",
+     MetricType::kCounter,
+     [](const BlockingPoolStats &s) { return s.run_ns; }, 1e-9},
+};
+
+// 延迟分布以 summary 输出，分位点固定。
+struct SummaryDesc {
+    const char *name;
+    const char *help;
+    const LatencyHistogramStats &(*value)(const ProcessorStats &);
+};
+
+const SummaryDesc kSummaries[] = {
+    {"ready_latency_seconds", "Time from becoming ready to running.",
+     [](const ProcessorStats &s) -> const LatencyHistogramStats & {
+         return s.ready_latency;
+     }},
+    {"run_slice_seconds", "Time a fiber runs before switching out.",
+     [](const ProcessorStats &s) -> const LatencyHistogramStats & {
+         return s.run_slice;
+     }},
+};
+
+const double kQuantiles[] = {0.5, 0.9, 0.99, 0.999};
+
+void append_value(std::string *out, uint64_t value, double scale) {
+    char buffer[32];
+    int length = 0;
+    if (scale == 1.0) {
+        length = std::snprintf(buffer, sizeof(buffer), "%llu",
+                               static_cast<unsigned long long>(value));
+    } else {
+        length = std::snprintf(buffer, sizeof(buffer), "%.9g",
+                               static_cast<double>(value) * scale);
+    }
+    out->append(buffer, static_cast<size_t>(length));
+}
+
+} // namespace
+
+uint64_t LatencyHistogramStats::percentile_ns(double quantile) const {
+    if (count == 0 || buckets.empty()) {
+        return 0;
+    }
+
+    const double clamped = quantile < 0 ? 0 : (quantile > 1 ? 1 : quantile);
+    uint64_t rank = static_cast<uint64_t>(
+        std::ceil(clamped * static_cast<double>(count)));
+    if (rank == 0) {
+        rank = 1;
+    }
+
+    // 取第 rank 个样本所在桶的上界，不超过实际最大值。
+    uint64_t seen = 0;
+    for (size_t i = 0; i < buckets.size(); ++i) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            const uint64_t upper = LatencyHistogram::bucket_upper_bound(i);
+            return upper < max_ns ? upper : max_ns;
+        }
+    }
+    return max_ns;
+}
+
+void LatencyHistogramStats::merge(const LatencyHistogramStats &other) {
+    if (other.buckets.empty()) {
+        return;
+    }
+    if (buckets.empty()) {
+        buckets.assign(other.buckets.size(), 0);
+    }
+    for (size_t i = 0; i < buckets.size() && i < other.buckets.size(); ++i) {
+        buckets[i] += other.buckets[i];
+    }
+    count += other.count;
+    sum_ns += other.sum_ns;
+    if (other.max_ns > max_ns) {
+        max_ns = other.max_ns;
+    }
+}
+
+void co_sched_trace(const SchedTraceOptions &options) {
+    Runtime::instance().set_sched_trace(options);
+}
+
+RuntimeStats stats() { return Runtime::instance().stats(); }
+
+std::string render_prometheus(const RuntimeStats &snapshot,
+                              const std::string &prefix) {
+    std::string out;
+    if (snapshot.processors.empty()) {
+        return out;
+    }
+
+    // 按指标分组输出：同名样本必须连续出现在同一组 HELP/TYPE 之后。
+    out.reserve(sizeof(kMetrics) / sizeof(kMetrics[0]) *
+                (128 + snapshot.processors.size() * 48));
+    for (const MetricDesc &metric : kMetrics) {
+        const std::string name = prefix + "_" + metric.name;
+        out += "# HELP " + name + " " + metric.help + "\n";
+        out += "# TYPE " + name +
+               (metric.type == MetricType::kCounter ? " counter\n"
+                                                    : " gauge\n");
+        for (const ProcessorStats &processor : snapshot.processors) {
+            out += name + "{sched=\"" + std::to_string(processor.id) + "\"} ";
+            append_value(&out, metric.value(processor), metric.scale);
+            out += "\n";
+        }
+    }
+
+    for (const BlockingMetricDesc &metric : kBlockingMetrics) {
+        const std::string name = prefix + "_" + metric.name;
+        out += "# HELP " + name + " " + metric.help + "\n";
+        out += "# TYPE " + name +
+               (metric.type == MetricType::kCounter ? " counter\n"
+                                                    : " gauge\n");
+        out += name + " ";
+        append_value(&out, metric.value(snapshot.blocking), metric.scale);
+        out += "\n";
+    }
+
+    // 未开启延迟直方图时各调度器的分布都为空，不输出对应的 summary。
+    for (const SummaryDesc &summary : kSummaries) {
+        bool recorded = false;
+        for (const ProcessorStats &processor : snapshot.processors) {
+            recorded = recorded || !summary.value(processor).buckets.empty();
+        }
+        if (!recorded) {
+            continue;
+        }
+
+        const std::string name = prefix + "_" + summary.name;
+        out += "# HELP " + name + " " + summary.help + "\n";
+        out += "# TYPE " + name + " summary\n";
+        for (const ProcessorStats &processor : snapshot.processors) {
+            const LatencyHistogramStats &latency = summary.value(processor);
+            const std::string sched = std::to_string(processor.id);
+            for (double quantile : kQuantiles) {
+                char label[16];
+                std::snprintf(label, sizeof(label), "%g", quantile);
+                out += name + "{sched=\"" + sched + "\",quantile=\"" + label +
+                       "\"} ";
+                append_value(&out, latency.percentile_ns(quantile), 1e-9);
+                out += "\n";
+            }
+            out += name + "_sum{sched=\"" + sched + "\"} ";
+            append_value(&out, latency.sum_ns, 1e-9);
+            out += "\n" + name + "_count{sched=\"" + sched + "\"} ";
+            append_value(&out, latency.count, 1.0);
+            out += "\n";
+        }
+    }
+    return out;
+}
+
+} // namespace zco
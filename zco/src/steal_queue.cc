@@ -1,32 +1,320 @@
 #include "zco/internal/steal_queue.h"
 
 #include <algorithm>
-#include <iterator>
 #include <utility>
 
 namespace zco {
 
 // StealQueue 是任务投递的工作窃取缓冲：
-// - push() 在队尾追加，保持生产者本地写入简单。
-// - steal() 从队尾批量拿走任务，尽量保留队首较早进入的任务，减少局部性破坏。
-// - drain_some() 只在调度线程自消费路径使用，用于把外部任务批量转为 Fiber。
+// - push_local() 由 owner 写入 Chase-Lev 环形缓冲的 bottom 端，无需任何锁。
+// - push() 供其他线程投递，只做一次注入栈 CAS；owner 消费时批量搬进环形缓冲。
+//   push_batch() 先在本地串好整条链，同样只做一次 CAS。
+// - drain_some() 与 steal() 都从 top 端按 FIFO 批量 CAS 取出，保证提交顺序与
+//   调度顺序尽量一致；窃取者在环形缓冲为空时继续尝试溢出队列与注入栈。
+// - 环形缓冲写满时落入溢出队列，锁只在突发积压时出现。
+// - 节点在每线程缓存里复用：取出任务的线程把节点留给自己下一次投递，
+//   缓存满了才真正释放；跨线程投递时生产方缓存用完仍会退回分配器。
 
-StealQueue::StealQueue() : mutex_(), size_(0), tasks_() {}
+namespace {
+
+// 单次 CAS 批量取出的上限，决定栈上临时数组大小。
+constexpr size_t kGrabBatchLimit = 128;
+
+// 每线程最多缓存的空闲节点数。
+constexpr size_t kNodeCacheLimit = 512;
+
+// 缓存随线程退出析构，此后同一线程上的释放（如更晚析构的对象）直接 delete。
+enum class NodeCacheState : uint8_t { kUnused, kAlive, kDestroyed };
+thread_local NodeCacheState tls_node_cache_state = NodeCacheState::kUnused;
+
+size_t round_up_power_of_two(size_t value) {
+    size_t result = 2;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+} // namespace
+
+constexpr size_t StealQueue::kDefaultCapacity;
+
+struct StealQueue::NodeCache {
+    NodeCache() : head(nullptr), size(0) {
+        tls_node_cache_state = NodeCacheState::kAlive;
+    }
+
+    ~NodeCache() {
+        tls_node_cache_state = NodeCacheState::kDestroyed;
+        while (head) {
+            TaskNode *next = head->next;
+            delete head;
+            head = next;
+        }
+    }
+
+    static NodeCache *local() {
+        if (tls_node_cache_state == NodeCacheState::kDestroyed) {
+            return nullptr;
+        }
+        static thread_local NodeCache cache;
+        return &cache;
+    }
+
+    TaskNode *head;
+    size_t size;
+};
+
+StealQueue::TaskNode *StealQueue::acquire_node(Task task) {
+    NodeCache *cache = NodeCache::local();
+    if (!cache || !cache->head) {
+        return new TaskNode{std::move(task), nullptr};
+    }
+
+    TaskNode *node = cache->head;
+    cache->head = node->next;
+    --cache->size;
+    node->task = std::move(task);
+    node->next = nullptr;
+    return node;
+}
+
+void StealQueue::release_node(TaskNode *node) {
+    // 任务已被移走，节点里只剩空 Task。
+    NodeCache *cache = NodeCache::local();
+    if (!cache || cache->size >= kNodeCacheLimit) {
+        delete node;
+        return;
+    }
+
+    node->next = cache->head;
+    cache->head = node;
+    ++cache->size;
+}
+
+StealQueue::StealQueue(size_t capacity)
+    : capacity_(round_up_power_of_two(capacity)), mask_(capacity_ - 1),
+      buffer_(new std::atomic<TaskNode *>[capacity_]), top_(0), bottom_(0),
+      inject_head_(nullptr), overflow_mutex_(), overflow_(), overflow_size_(0),
+      size_(0) {
+    for (size_t i = 0; i < capacity_; ++i) {
+        buffer_[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+StealQueue::~StealQueue() {
+    const uint64_t top = top_.load(std::memory_order_relaxed);
+    const uint64_t bottom = bottom_.load(std::memory_order_relaxed);
+    for (uint64_t i = top; i < bottom; ++i) {
+        delete buffer_[i & mask_].load(std::memory_order_relaxed);
+    }
+
+    TaskNode *node = inject_head_.load(std::memory_order_relaxed);
+    while (node) {
+        TaskNode *next = node->next;
+        delete node;
+        node = next;
+    }
+
+    for (TaskNode *overflow_node : overflow_) {
+        delete overflow_node;
+    }
+}
 
 void StealQueue::push(Task task) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    tasks_.push_back(std::move(task));
-    size_.store(tasks_.size(), std::memory_order_relaxed);
+    TaskNode *node = acquire_node(std::move(task));
+    size_.fetch_add(1, std::memory_order_relaxed);
+
+    TaskNode *head = inject_head_.load(std::memory_order_relaxed);
+    do {
+        node->next = head;
+    } while (!inject_head_.compare_exchange_weak(head, node,
+                                                 std::memory_order_release,
+                                                 std::memory_order_relaxed));
+}
+
+void StealQueue::push_local(Task task) {
+    TaskNode *node = acquire_node(std::move(task));
+    size_.fetch_add(1, std::memory_order_relaxed);
+    push_node_local(node);
+}
+
+void StealQueue::push_batch(Task *tasks, size_t count) {
+    if (count == 0) {
+        return;
+    }
+
+    // 注入栈是 LIFO：后提交的节点在前，tail 是第一个任务，接到原栈顶上。
+    TaskNode *tail = acquire_node(std::move(tasks[0]));
+    TaskNode *chain = tail;
+    for (size_t i = 1; i < count; ++i) {
+        TaskNode *node = acquire_node(std::move(tasks[i]));
+        node->next = chain;
+        chain = node;
+    }
+    size_.fetch_add(count, std::memory_order_relaxed);
+
+    TaskNode *head = inject_head_.load(std::memory_order_relaxed);
+    do {
+        tail->next = head;
+    } while (!inject_head_.compare_exchange_weak(head, chain,
+                                                 std::memory_order_release,
+                                                 std::memory_order_relaxed));
+}
+
+void StealQueue::push_local_batch(Task *tasks, size_t count) {
+    size_.fetch_add(count, std::memory_order_relaxed);
+    for (size_t i = 0; i < count; ++i) {
+        push_node_local(acquire_node(std::move(tasks[i])));
+    }
+}
+
+void StealQueue::push_node_local(TaskNode *node) {
+    const uint64_t bottom = bottom_.load(std::memory_order_relaxed);
+    const uint64_t top = top_.load(std::memory_order_acquire);
+    if (bottom - top < capacity_) {
+        // 槽位写入先于 bottom 发布，窃取者 acquire bottom 后即可看到节点。
+        buffer_[bottom & mask_].store(node, std::memory_order_relaxed);
+        bottom_.store(bottom + 1, std::memory_order_release);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(overflow_mutex_);
+    overflow_.push_back(node);
+    overflow_size_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void StealQueue::transfer_injected() {
+    if (!inject_head_.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    TaskNode *node = inject_head_.exchange(nullptr, std::memory_order_acquire);
+
+    // 注入栈是 LIFO，先反转成提交顺序再写入环形缓冲。
+    TaskNode *ordered = nullptr;
+    while (node) {
+        TaskNode *next = node->next;
+        node->next = ordered;
+        ordered = node;
+        node = next;
+    }
+
+    while (ordered) {
+        TaskNode *next = ordered->next;
+        ordered->next = nullptr;
+        push_node_local(ordered);
+        ordered = next;
+    }
+}
+
+size_t StealQueue::grab_ring(std::vector<Task> *tasks, size_t max_count) {
+    TaskNode *batch[kGrabBatchLimit];
+    size_t grabbed = 0;
+
+    uint64_t top = top_.load(std::memory_order_acquire);
+    while (grabbed < max_count) {
+        const uint64_t bottom = bottom_.load(std::memory_order_acquire);
+        if (bottom <= top) {
+            break;
+        }
+
+        // top 可能已经过期，读到的槽位若被 owner 覆盖，下面的 CAS 必然失败。
+        const size_t available = static_cast<size_t>(
+            std::min<uint64_t>(bottom - top, capacity_));
+        const size_t count =
+            std::min(std::min(available, max_count - grabbed), kGrabBatchLimit);
+        for (size_t i = 0; i < count; ++i) {
+            batch[i] =
+                buffer_[(top + i) & mask_].load(std::memory_order_relaxed);
+        }
+
+        if (!top_.compare_exchange_weak(top, top + count,
+                                        std::memory_order_acq_rel,
+                                        std::memory_order_acquire)) {
+            continue;
+        }
+
+        for (size_t i = 0; i < count; ++i) {
+            tasks->push_back(std::move(batch[i]->task));
+            release_node(batch[i]);
+        }
+        grabbed += count;
+        top += count;
+    }
+
+    return grabbed;
 }
 
-size_t StealQueue::steal(std::deque<Task> *tasks, size_t max_steal,
+size_t StealQueue::grab_overflow(std::vector<Task> *tasks, size_t max_count) {
+    if (overflow_size_.load(std::memory_order_relaxed) == 0) {
+        return 0;
+    }
+
+    std::lock_guard<std::mutex> lock(overflow_mutex_);
+    const size_t count = std::min(max_count, overflow_.size());
+    for (size_t i = 0; i < count; ++i) {
+        TaskNode *node = overflow_.front();
+        overflow_.pop_front();
+        tasks->push_back(std::move(node->task));
+        release_node(node);
+    }
+    overflow_size_.fetch_sub(count, std::memory_order_relaxed);
+    return count;
+}
+
+size_t StealQueue::grab_injected(std::vector<Task> *tasks, size_t max_count) {
+    if (!inject_head_.load(std::memory_order_relaxed)) {
+        return 0;
+    }
+
+    TaskNode *node = inject_head_.exchange(nullptr, std::memory_order_acquire);
+    TaskNode *ordered = nullptr;
+    while (node) {
+        TaskNode *next = node->next;
+        node->next = ordered;
+        ordered = node;
+        node = next;
+    }
+
+    // 窃取者只拿最早提交的一段，剩余部分反转回 LIFO 链后整体挂回注入栈。
+    size_t grabbed = 0;
+    while (ordered && grabbed < max_count) {
+        TaskNode *next = ordered->next;
+        tasks->push_back(std::move(ordered->task));
+        release_node(ordered);
+        ordered = next;
+        ++grabbed;
+    }
+
+    if (ordered) {
+        TaskNode *rest_head = nullptr;
+        TaskNode *rest_tail = ordered;
+        while (ordered) {
+            TaskNode *next = ordered->next;
+            ordered->next = rest_head;
+            rest_head = ordered;
+            ordered = next;
+        }
+
+        TaskNode *head = inject_head_.load(std::memory_order_relaxed);
+        do {
+            rest_tail->next = head;
+        } while (!inject_head_.compare_exchange_weak(
+            head, rest_head, std::memory_order_release,
+            std::memory_order_relaxed));
+    }
+
+    return grabbed;
+}
+
+size_t StealQueue::steal(std::vector<Task> *tasks, size_t max_steal,
                          size_t min_reserve) {
     if (!tasks || max_steal == 0) {
         return 0;
     }
 
-    std::lock_guard<std::mutex> lock(mutex_);
-    const size_t total = tasks_.size();
+    const size_t total = size_.load(std::memory_order_relaxed);
     if (total <= min_reserve) {
         return 0;
     }
@@ -46,54 +334,55 @@ size_t StealQueue::steal(std::deque<Task> *tasks, size_t max_steal,
 
     const size_t stealable = total - min_reserve;
     const size_t count = std::min(max_steal, std::min(target, stealable));
-    for (size_t i = 0; i < count; ++i) {
-        // 从队尾窃取，优先拿走最新任务，降低原队列前端等待时间。
-        tasks->push_back(std::move(tasks_.back()));
-        tasks_.pop_back();
-    }
-    size_.store(tasks_.size(), std::memory_order_relaxed);
-    return count;
-}
 
-void StealQueue::drain_all(std::deque<Task> *tasks) {
-    if (!tasks) {
-        return;
+    // 优先从环形缓冲 top 端窃取最早的任务，其次是溢出队列，最后是尚未被
+    // owner 搬运的注入栈（owner 长时间运行单个 Fiber 时任务会停留在这里）。
+    size_t stolen = grab_ring(tasks, count);
+    if (stolen < count) {
+        stolen += grab_overflow(tasks, count - stolen);
+    }
+    if (stolen < count) {
+        stolen += grab_injected(tasks, count - stolen);
     }
 
-    std::lock_guard<std::mutex> lock(mutex_);
-    tasks->swap(tasks_);
-    size_.store(tasks_.size(), std::memory_order_relaxed);
+    size_.fetch_sub(stolen, std::memory_order_relaxed);
+    return stolen;
 }
 
-void StealQueue::drain_some(std::deque<Task> *tasks, size_t max_count) {
+void StealQueue::drain_all(std::vector<Task> *tasks) {
+    drain_some(tasks, static_cast<size_t>(-1));
+}
+
+void StealQueue::drain_some(std::vector<Task> *tasks, size_t max_count) {
     if (!tasks || max_count == 0) {
         return;
     }
 
-    std::lock_guard<std::mutex> lock(mutex_);
-    const size_t count = std::min(max_count, tasks_.size());
-    for (size_t i = 0; i < count; ++i) {
-        // 自消费路径按 FIFO 取出，保证提交顺序与调度顺序尽量一致。
-        tasks->push_back(std::move(tasks_.front()));
-        tasks_.pop_front();
+    transfer_injected();
+
+    size_t drained = grab_ring(tasks, max_count);
+    if (drained < max_count) {
+        drained += grab_overflow(tasks, max_count - drained);
     }
-    size_.store(tasks_.size(), std::memory_order_relaxed);
+    size_.fetch_sub(drained, std::memory_order_relaxed);
 }
 
-void StealQueue::append(std::deque<Task> *tasks) {
+void StealQueue::append(std::vector<Task> *tasks) {
     if (!tasks || tasks->empty()) {
         return;
     }
 
-    std::lock_guard<std::mutex> lock(mutex_);
-    tasks_.insert(tasks_.end(), std::make_move_iterator(tasks->begin()),
-                  std::make_move_iterator(tasks->end()));
+    size_.fetch_add(tasks->size(), std::memory_order_relaxed);
+    for (Task &task : *tasks) {
+        push_node_local(acquire_node(std::move(task)));
+    }
     tasks->clear();
-    size_.store(tasks_.size(), std::memory_order_relaxed);
 }
 
 size_t StealQueue::size() const {
     return size_.load(std::memory_order_relaxed);
 }
 
+size_t StealQueue::capacity() const { return capacity_; }
+
 } // namespace zco
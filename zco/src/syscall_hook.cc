@@ -0,0 +1,681 @@
+// 接管层定义了与 libc 同名的函数，不能再引入 fortify 的内联包装。
+#ifdef _FORTIFY_SOURCE
+#undef _FORTIFY_SOURCE
+#endif
+
+#include "zco/internal/syscall_hook.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#if defined(ZCO_ENABLE_SYSCALL_HOOK)
+#include <dlfcn.h>
+#endif
+
+#include <atomic>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+
+#include "zco/hook.h"
+#include "zco/internal/runtime_manager.h"
+
+namespace zco {
+
+// syscall_hook.cc 接管第三方库直接调用的阻塞 libc 函数：
+// - 接管开启时在协程里经 socket/socketpair/accept 创建的 fd 被登记：内核侧
+//   改成非阻塞并 attach 到运行时，fcntl/ioctl 对调用方仍报告它自己设置的标志。
+// - 登记过且调用方没有要求非阻塞的 fd，在协程里的读写、connect、accept 转给
+//   co_* 包装，走 run_io_loop 的等待；在普通线程里用真实 poll 补出阻塞语义。
+// - 其余 fd 直接透传；poll/select/epoll_wait 超时为 0 时也透传，运行时自身的
+//   零超时探测依赖这一点。
+// - 协程里的 poll/select/epoll_wait 转给 co_poll/co_select/co_epoll_wait，
+//   sleep/usleep/nanosleep 转给 sleep_for，都只挂起当前协程。
+
+namespace {
+
+enum HookedFdFlag : uint8_t {
+    kHookedFd = 0x1,
+    kUserNonblock = 0x2,
+};
+
+constexpr size_t kMaxHookedFds = 1 << 20;
+
+#if defined(ZCO_ENABLE_SYSCALL_HOOK)
+bool hook_enabled_from_env() {
+    // ZCO_SYSCALL_HOOK=1 在启动时打开接管，便于不改代码接入第三方库。
+    const char *value = std::getenv("ZCO_SYSCALL_HOOK");
+    return value && std::strcmp(value, "1") == 0;
+}
+
+std::atomic<bool> g_hook_enabled(hook_enabled_from_env());
+#endif
+
+size_t hooked_fd_capacity() {
+    rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) != 0 ||
+        limit.rlim_cur == RLIM_INFINITY || limit.rlim_cur > kMaxHookedFds) {
+        return kMaxHookedFds;
+    }
+    return static_cast<size_t>(limit.rlim_cur);
+}
+
+// 按 fd 下标的标志表，首次登记时才分配；读路径只有一次原子加载。
+// 表随进程存在不释放，退出阶段的 close 仍可安全查询。
+class HookedFdTable {
+  public:
+    HookedFdTable() : flags_(nullptr), capacity_(0), mutex_() {}
+
+    uint8_t get(int fd) const {
+        std::atomic<uint8_t> *flags = flags_.load(std::memory_order_acquire);
+        if (!flags || fd < 0 || static_cast<size_t>(fd) >= capacity_) {
+            return 0;
+        }
+        return flags[fd].load(std::memory_order_acquire);
+    }
+
+    bool set(int fd, uint8_t value) {
+        std::atomic<uint8_t> *flags = flags_.load(std::memory_order_acquire);
+        if (!flags) {
+            if (value == 0) {
+                return true;
+            }
+            flags = allocate();
+        }
+        if (fd < 0 || static_cast<size_t>(fd) >= capacity_) {
+            return value == 0;
+        }
+        flags[fd].store(value, std::memory_order_release);
+        return true;
+    }
+
+  private:
+    std::atomic<uint8_t> *allocate() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::atomic<uint8_t> *flags = flags_.load(std::memory_order_acquire);
+        if (!flags) {
+            const size_t capacity = hooked_fd_capacity();
+            flags = new std::atomic<uint8_t>[capacity]();
+            capacity_ = capacity;
+            flags_.store(flags, std::memory_order_release);
+        }
+        return flags;
+    }
+
+    std::atomic<std::atomic<uint8_t> *> flags_;
+    size_t capacity_;
+    std::mutex mutex_;
+};
+
+HookedFdTable g_hooked_fds;
+
+#if defined(ZCO_ENABLE_SYSCALL_HOOK)
+
+template <typename Fn> void resolve_next(Fn *&slot, const char *name) {
+    slot = reinterpret_cast<Fn *>(::dlsym(RTLD_NEXT, name));
+    if (!slot) {
+        // 静态链接 libc 时找不到下一个定义。此时日志本身也会走 write
+        // 接管，不能再打日志。
+        std::abort();
+    }
+}
+
+SysCalls load_sys_calls() {
+    SysCalls calls;
+    resolve_next(calls.socket, "socket");
+    resolve_next(calls.socketpair, "socketpair");
+    resolve_next(calls.connect, "connect");
+    resolve_next(calls.accept, "accept");
+    resolve_next(calls.accept4, "accept4");
+    resolve_next(calls.read, "read");
+    resolve_next(calls.readv, "readv");
+    resolve_next(calls.recv, "recv");
+    resolve_next(calls.recvfrom, "recvfrom");
+    resolve_next(calls.recvmsg, "recvmsg");
+    resolve_next(calls.write, "write");
+    resolve_next(calls.writev, "writev");
+    resolve_next(calls.send, "send");
+    resolve_next(calls.sendto, "sendto");
+    resolve_next(calls.sendmsg, "sendmsg");
+    resolve_next(calls.poll, "poll");
+    resolve_next(calls.select, "select");
+    resolve_next(calls.epoll_wait, "epoll_wait");
+    resolve_next(calls.close, "close");
+    resolve_next(calls.fcntl, "fcntl");
+    resolve_next(calls.ioctl, "ioctl");
+    resolve_next(calls.setsockopt, "setsockopt");
+    resolve_next(calls.dup, "dup");
+    resolve_next(calls.dup2, "dup2");
+    resolve_next(calls.dup3, "dup3");
+    resolve_next(calls.sleep, "sleep");
+    resolve_next(calls.usleep, "usleep");
+    resolve_next(calls.nanosleep, "nanosleep");
+    return calls;
+}
+
+#else
+
+SysCalls load_sys_calls() {
+    SysCalls calls;
+    calls.socket = &::socket;
+    calls.socketpair = &::socketpair;
+    calls.connect = &::connect;
+    calls.accept = &::accept;
+    calls.accept4 = &::accept4;
+    calls.read = &::read;
+    calls.readv = &::readv;
+    calls.recv = &::recv;
+    calls.recvfrom = &::recvfrom;
+    calls.recvmsg = &::recvmsg;
+    calls.write = &::write;
+    calls.writev = &::writev;
+    calls.send = &::send;
+    calls.sendto = &::sendto;
+    calls.sendmsg = &::sendmsg;
+    calls.poll = &::poll;
+    calls.select = &::select;
+    calls.epoll_wait = &::epoll_wait;
+    calls.close = &::close;
+    calls.fcntl = &::fcntl;
+    calls.ioctl = &::ioctl;
+    calls.setsockopt = &::setsockopt;
+    calls.dup = &::dup;
+    calls.dup2 = &::dup2;
+    calls.dup3 = &::dup3;
+    calls.sleep = &::sleep;
+    calls.usleep = &::usleep;
+    calls.nanosleep = &::nanosleep;
+    return calls;
+}
+
+#endif
+
+} // namespace
+
+const SysCalls &sys_calls() {
+    static const SysCalls calls = load_sys_calls();
+    return calls;
+}
+
+bool is_hooked_fd(int fd) { return (g_hooked_fds.get(fd) & kHookedFd) != 0; }
+
+void sync_hooked_fd_on_dup(int from_fd, int to_fd) {
+    if (to_fd < 0 || from_fd == to_fd) {
+        return;
+    }
+    // dup 出的 fd 与源共享文件状态，内核侧同样是非阻塞。
+    (void)g_hooked_fds.set(to_fd, g_hooked_fds.get(from_fd));
+}
+
+void clear_hooked_fd(int fd) { (void)g_hooked_fds.set(fd, 0); }
+
+#if defined(ZCO_ENABLE_SYSCALL_HOOK)
+
+bool co_hook_enable(bool enable) {
+    (void)sys_calls();
+    g_hook_enabled.store(enable, std::memory_order_release);
+    return true;
+}
+
+bool co_hook_enabled() {
+    return g_hook_enabled.load(std::memory_order_acquire);
+}
+
+namespace {
+
+const SysCalls &sys() { return sys_calls(); }
+
+// 接管开启且处于协程上下文。
+bool hook_active() {
+    return g_hook_enabled.load(std::memory_order_relaxed) && in_coroutine();
+}
+
+// 调用方按阻塞方式使用的已登记 fd。
+bool blocking_hooked_fd(int fd) { return g_hooked_fds.get(fd) == kHookedFd; }
+
+bool set_fd_nonblock(int fd, bool nonblock) {
+    const int flags = sys().fcntl(fd, F_GETFL, 0);
+    if (flags < 0) {
+        return false;
+    }
+    const int wanted = nonblock ? (flags | O_NONBLOCK) : (flags & ~O_NONBLOCK);
+    return wanted == flags || sys().fcntl(fd, F_SETFL, wanted) == 0;
+}
+
+// 登记接管 fd：内核侧改成非阻塞并允许常驻注册。表容量不足时保持原样。
+void adopt_fd(int fd, bool user_nonblock) {
+    const uint8_t flags = kHookedFd | (user_nonblock ? kUserNonblock : 0);
+    if (!g_hooked_fds.set(fd, flags)) {
+        return;
+    }
+    if (!set_fd_nonblock(fd, true)) {
+        clear_hooked_fd(fd);
+        return;
+    }
+    attach_fd(fd);
+}
+
+// accept 出的 fd 已被 co_accept 改成非阻塞并 attach，只补登记和 CLOEXEC。
+int adopt_accepted_fd(int fd, int flags) {
+    if (fd < 0) {
+        return fd;
+    }
+    if ((flags & SOCK_CLOEXEC) == 0) {
+        const int fd_flags = sys().fcntl(fd, F_GETFD, 0);
+        if (fd_flags >= 0) {
+            (void)sys().fcntl(fd, F_SETFD, fd_flags & ~FD_CLOEXEC);
+        }
+    }
+    const uint8_t hooked =
+        kHookedFd | ((flags & SOCK_NONBLOCK) != 0 ? kUserNonblock : 0);
+    if (!g_hooked_fds.set(fd, hooked) && (flags & SOCK_NONBLOCK) == 0) {
+        (void)set_fd_nonblock(fd, false);
+    }
+    return fd;
+}
+
+// 普通线程访问已登记 fd：内核侧已是非阻塞，用真实 poll 等到就绪再重试。
+template <typename Func>
+ssize_t block_thread_until_ready(int fd, short events, Func &&func) {
+    while (true) {
+        const ssize_t rc = func();
+        if (rc >= 0 || (errno != EAGAIN && errno != EWOULDBLOCK)) {
+            return rc;
+        }
+
+        pollfd pfd;
+        pfd.fd = fd;
+        pfd.events = events;
+        pfd.revents = 0;
+        if (sys().poll(&pfd, 1, -1) < 0 && errno != EINTR) {
+            return -1;
+        }
+    }
+}
+
+template <typename CoFunc, typename SysFunc>
+ssize_t hooked_io(int fd, short events, CoFunc &&co_func, SysFunc &&sys_func) {
+    if (!blocking_hooked_fd(fd)) {
+        return sys_func();
+    }
+    if (in_coroutine()) {
+        return co_func();
+    }
+    return block_thread_until_ready(fd, events, sys_func);
+}
+
+int thread_connect(int fd, const struct sockaddr *address,
+                   socklen_t address_len) {
+    const int rc = sys().connect(fd, address, address_len);
+    if (rc == 0 || errno != EINPROGRESS) {
+        return rc;
+    }
+
+    pollfd pfd;
+    pfd.fd = fd;
+    pfd.events = POLLOUT;
+    pfd.revents = 0;
+    while (sys().poll(&pfd, 1, -1) < 0) {
+        if (errno != EINTR) {
+            return -1;
+        }
+    }
+
+    int socket_error = 0;
+    socklen_t socket_error_len = static_cast<socklen_t>(sizeof(socket_error));
+    if (co_getsockopt(fd, SOL_SOCKET, SO_ERROR, &socket_error,
+                      &socket_error_len) != 0) {
+        return -1;
+    }
+    if (socket_error != 0) {
+        errno = socket_error;
+        return -1;
+    }
+    return 0;
+}
+
+uint32_t clamp_sleep_ms(uint64_t milliseconds) {
+    return milliseconds >= kInfiniteTimeoutMs
+               ? kInfiniteTimeoutMs - 1
+               : static_cast<uint32_t>(milliseconds);
+}
+
+} // namespace
+
+#else
+
+bool co_hook_enable(bool enable) {
+    (void)enable;
+    return false;
+}
+
+bool co_hook_enabled() { return false; }
+
+#endif
+
+} // namespace zco
+
+#if defined(ZCO_ENABLE_SYSCALL_HOOK)
+
+// 以下为导出的 libc 同名符号，签名与 glibc 声明保持一致。
+extern "C" {
+
+using zco::sys_calls;
+
+int socket(int domain, int type, int protocol) noexcept {
+    const int fd = sys_calls().socket(domain, type, protocol);
+    if (fd >= 0 && zco::hook_active()) {
+        zco::adopt_fd(fd, (type & SOCK_NONBLOCK) != 0);
+    }
+    return fd;
+}
+
+int socketpair(int domain, int type, int protocol, int sv[2]) noexcept {
+    const int rc = sys_calls().socketpair(domain, type, protocol, sv);
+    if (rc == 0 && zco::hook_active()) {
+        zco::adopt_fd(sv[0], (type & SOCK_NONBLOCK) != 0);
+        zco::adopt_fd(sv[1], (type & SOCK_NONBLOCK) != 0);
+    }
+    return rc;
+}
+
+int connect(int fd, const struct sockaddr *address, socklen_t address_len) {
+    if (!zco::blocking_hooked_fd(fd)) {
+        return sys_calls().connect(fd, address, address_len);
+    }
+    if (zco::in_coroutine()) {
+        return zco::co_connect(fd, address, address_len);
+    }
+    return zco::thread_connect(fd, address, address_len);
+}
+
+int accept(int fd, struct sockaddr *address, socklen_t *address_len) {
+    if (!zco::blocking_hooked_fd(fd)) {
+        return sys_calls().accept(fd, address, address_len);
+    }
+    if (zco::in_coroutine()) {
+        return zco::adopt_accepted_fd(
+            zco::co_accept(fd, address, address_len), 0);
+    }
+    return static_cast<int>(
+        zco::block_thread_until_ready(fd, POLLIN, [&]() -> ssize_t {
+            return sys_calls().accept(fd, address, address_len);
+        }));
+}
+
+int accept4(int fd, struct sockaddr *address, socklen_t *address_len,
+            int flags) {
+    if (!zco::blocking_hooked_fd(fd)) {
+        return sys_calls().accept4(fd, address, address_len, flags);
+    }
+    if (zco::in_coroutine()) {
+        return zco::adopt_accepted_fd(
+            zco::co_accept(fd, address, address_len), flags);
+    }
+    return static_cast<int>(
+        zco::block_thread_until_ready(fd, POLLIN, [&]() -> ssize_t {
+            return sys_calls().accept4(fd, address, address_len, flags);
+        }));
+}
+
+ssize_t read(int fd, void *buffer, size_t count) {
+    return zco::hooked_io(
+        fd, POLLIN, [&]() { return zco::co_read(fd, buffer, count); },
+        [&]() { return sys_calls().read(fd, buffer, count); });
+}
+
+ssize_t readv(int fd, const struct iovec *iov, int iovcnt) {
+    return zco::hooked_io(
+        fd, POLLIN, [&]() { return zco::co_readv(fd, iov, iovcnt); },
+        [&]() { return sys_calls().readv(fd, iov, iovcnt); });
+}
+
+ssize_t recv(int fd, void *buffer, size_t count, int flags) {
+    if (flags & MSG_DONTWAIT) {
+        return sys_calls().recv(fd, buffer, count, flags);
+    }
+    return zco::hooked_io(
+        fd, POLLIN, [&]() { return zco::co_recv(fd, buffer, count, flags); },
+        [&]() { return sys_calls().recv(fd, buffer, count, flags); });
+}
+
+ssize_t recvfrom(int fd, void *buffer, size_t count, int flags,
+                 struct sockaddr *address, socklen_t *address_len) {
+    if (flags & MSG_DONTWAIT) {
+        return sys_calls().recvfrom(fd, buffer, count, flags, address,
+                                    address_len);
+    }
+    return zco::hooked_io(
+        fd, POLLIN,
+        [&]() {
+            return zco::co_recvfrom(fd, buffer, count, flags, address,
+                                    address_len);
+        },
+        [&]() {
+            return sys_calls().recvfrom(fd, buffer, count, flags, address,
+                                        address_len);
+        });
+}
+
+ssize_t recvmsg(int fd, struct msghdr *message, int flags) {
+    if (flags & MSG_DONTWAIT) {
+        return sys_calls().recvmsg(fd, message, flags);
+    }
+    return zco::hooked_io(
+        fd, POLLIN, [&]() { return zco::co_recvmsg(fd, message, flags); },
+        [&]() { return sys_calls().recvmsg(fd, message, flags); });
+}
+
+ssize_t write(int fd, const void *buffer, size_t count) {
+    return zco::hooked_io(
+        fd, POLLOUT, [&]() { return zco::co_write(fd, buffer, count); },
+        [&]() { return sys_calls().write(fd, buffer, count); });
+}
+
+ssize_t writev(int fd, const struct iovec *iov, int iovcnt) {
+    return zco::hooked_io(
+        fd, POLLOUT, [&]() { return zco::co_writev(fd, iov, iovcnt); },
+        [&]() { return sys_calls().writev(fd, iov, iovcnt); });
+}
+
+ssize_t send(int fd, const void *buffer, size_t count, int flags) {
+    if (flags & MSG_DONTWAIT) {
+        return sys_calls().send(fd, buffer, count, flags);
+    }
+    return zco::hooked_io(
+        fd, POLLOUT, [&]() { return zco::co_send(fd, buffer, count, flags); },
+        [&]() { return sys_calls().send(fd, buffer, count, flags); });
+}
+
+ssize_t sendto(int fd, const void *buffer, size_t count, int flags,
+               const struct sockaddr *address, socklen_t address_len) {
+    if (flags & MSG_DONTWAIT) {
+        return sys_calls().sendto(fd, buffer, count, flags, address,
+                                  address_len);
+    }
+    return zco::hooked_io(
+        fd, POLLOUT,
+        [&]() {
+            return zco::co_sendto(fd, buffer, count, flags, address,
+                                  address_len);
+        },
+        [&]() {
+            return sys_calls().sendto(fd, buffer, count, flags, address,
+                                      address_len);
+        });
+}
+
+ssize_t sendmsg(int fd, const struct msghdr *message, int flags) {
+    if (flags & MSG_DONTWAIT) {
+        return sys_calls().sendmsg(fd, message, flags);
+    }
+    return zco::hooked_io(
+        fd, POLLOUT, [&]() { return zco::co_sendmsg(fd, message, flags); },
+        [&]() { return sys_calls().sendmsg(fd, message, flags); });
+}
+
+int poll(struct pollfd *fds, nfds_t nfds, int timeout) {
+    if (timeout == 0 || !zco::hook_active()) {
+        return sys_calls().poll(fds, nfds, timeout);
+    }
+    return zco::co_poll(fds, nfds, timeout);
+}
+
+int select(int nfds, fd_set *readfds, fd_set *writefds, fd_set *exceptfds,
+           struct timeval *timeout) {
+    const bool zero_timeout =
+        timeout && timeout->tv_sec == 0 && timeout->tv_usec == 0;
+    if (zero_timeout || !zco::hook_active()) {
+        return sys_calls().select(nfds, readfds, writefds, exceptfds,
+                                  timeout);
+    }
+    return zco::co_select(nfds, readfds, writefds, exceptfds, timeout);
+}
+
+int epoll_wait(int epfd, struct epoll_event *events, int maxevents,
+               int timeout) {
+    if (timeout == 0 || !zco::hook_active()) {
+        return sys_calls().epoll_wait(epfd, events, maxevents, timeout);
+    }
+    return zco::co_epoll_wait(epfd, events, maxevents, timeout);
+}
+
+int close(int fd) {
+    if (zco::is_hooked_fd(fd)) {
+        return zco::co_close(fd);
+    }
+    return sys_calls().close(fd);
+}
+
+int fcntl(int fd, int cmd, ...) {
+    // 与 glibc 相同，第三个参数统一按指针宽度取出，再原样转发。
+    va_list args;
+    va_start(args, cmd);
+    void *arg = va_arg(args, void *);
+    va_end(args);
+
+    const uint8_t flags = zco::g_hooked_fds.get(fd);
+    if ((flags & zco::kHookedFd) == 0) {
+        return sys_calls().fcntl(fd, cmd, arg);
+    }
+
+    if (cmd == F_GETFL) {
+        const int rc = sys_calls().fcntl(fd, F_GETFL);
+        if (rc < 0 || (flags & zco::kUserNonblock) != 0) {
+            return rc;
+        }
+        return rc & ~O_NONBLOCK;
+    }
+
+    if (cmd == F_SETFL) {
+        const int wanted = static_cast<int>(reinterpret_cast<intptr_t>(arg));
+        const int rc = sys_calls().fcntl(fd, F_SETFL, wanted | O_NONBLOCK);
+        if (rc == 0) {
+            const bool user_nonblock = (wanted & O_NONBLOCK) != 0;
+            (void)zco::g_hooked_fds.set(
+                fd, zco::kHookedFd | (user_nonblock ? zco::kUserNonblock : 0));
+        }
+        return rc;
+    }
+
+    const int rc = sys_calls().fcntl(fd, cmd, arg);
+    if (rc >= 0 && (cmd == F_DUPFD || cmd == F_DUPFD_CLOEXEC)) {
+        zco::sync_fd_metadata_on_dup(fd, rc);
+        zco::sync_hooked_fd_on_dup(fd, rc);
+    }
+    return rc;
+}
+
+int ioctl(int fd, unsigned long request, ...) noexcept {
+    va_list args;
+    va_start(args, request);
+    void *arg = va_arg(args, void *);
+    va_end(args);
+
+    if (request == FIONBIO && zco::is_hooked_fd(fd) && arg != nullptr) {
+        // 内核侧保持非阻塞，只记录调用方看到的标志。
+        const bool user_nonblock = *static_cast<int *>(arg) != 0;
+        (void)zco::g_hooked_fds.set(
+            fd, zco::kHookedFd | (user_nonblock ? zco::kUserNonblock : 0));
+        return 0;
+    }
+    return sys_calls().ioctl(fd, request, arg);
+}
+
+int setsockopt(int fd, int level, int option, const void *option_value,
+               socklen_t option_len) noexcept {
+    // 经 co_setsockopt 转发，SO_RCVTIMEO/SO_SNDTIMEO 会同步到超时缓存。
+    return zco::co_setsockopt(fd, level, option, option_value, option_len);
+}
+
+int dup(int oldfd) noexcept {
+    if (!zco::is_hooked_fd(oldfd)) {
+        return sys_calls().dup(oldfd);
+    }
+    return zco::co_dup(oldfd);
+}
+
+int dup2(int oldfd, int newfd) noexcept {
+    if (!zco::is_hooked_fd(oldfd) && !zco::is_hooked_fd(newfd)) {
+        return sys_calls().dup2(oldfd, newfd);
+    }
+    return zco::co_dup2(oldfd, newfd);
+}
+
+int dup3(int oldfd, int newfd, int flags) noexcept {
+    if (!zco::is_hooked_fd(oldfd) && !zco::is_hooked_fd(newfd)) {
+        return sys_calls().dup3(oldfd, newfd, flags);
+    }
+    return zco::co_dup3(oldfd, newfd, flags);
+}
+
+unsigned int sleep(unsigned int seconds) {
+    if (!zco::hook_active()) {
+        return sys_calls().sleep(seconds);
+    }
+    zco::sleep_for(zco::clamp_sleep_ms(static_cast<uint64_t>(seconds) * 1000));
+    return 0;
+}
+
+int usleep(useconds_t microseconds) {
+    if (!zco::hook_active()) {
+        return sys_calls().usleep(microseconds);
+    }
+    const uint64_t ms = (static_cast<uint64_t>(microseconds) + 999) / 1000;
+    zco::sleep_for(zco::clamp_sleep_ms(ms));
+    return 0;
+}
+
+int nanosleep(const struct timespec *request, struct timespec *remain) {
+    if (!zco::hook_active()) {
+        return sys_calls().nanosleep(request, remain);
+    }
+    if (!request) {
+        errno = EFAULT;
+        return -1;
+    }
+    if (request->tv_sec < 0 || request->tv_nsec < 0 ||
+        request->tv_nsec >= 1000000000L) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    const uint64_t milliseconds =
+        static_cast<uint64_t>(request->tv_sec) * 1000 +
+        (static_cast<uint64_t>(request->tv_nsec) + 999999) / 1000000;
+    zco::sleep_for(zco::clamp_sleep_ms(milliseconds));
+    if (remain) {
+        remain->tv_sec = 0;
+        remain->tv_nsec = 0;
+    }
+    return 0;
+}
+
+} // extern "C"
+
+#endif
@@ -0,0 +1,175 @@
+#include "zco/task_group.h"
+
+#include <errno.h>
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include "zco/event.h"
+#include "zco/internal/fiber.h"
+#include "zco/internal/processor.h"
+#include "zco/internal/runtime_manager.h"
+#include "zco/internal/timer.h"
+#include "zco/zco_log.h"
+
+namespace zco {
+
+// task_group.cc 维护子任务的登记与取消：
+// - 子协程开始执行时把自己登记到 running，结束时撤销并计数。
+// - 取消在组锁内对每个登记中的协程调用 request_cancel()，子协程撤销登记
+//   也要拿组锁，所以被取消的 Fiber 不会在此期间结束并被复用。
+// - 截止时间是挂在处理器时间轮上的一个定时器，只持有组状态的弱引用。
+
+struct TaskGroup::State {
+    State()
+        : cancelled(false), spawned(0), finished(0), first_done(-1),
+          idle(true, true), any_done(true, false) {}
+
+    std::atomic<bool> cancelled;
+    std::mutex mutex;
+    std::vector<Fiber::ptr> running; // 下标为子任务序号，未运行时为空
+    size_t spawned;
+    size_t finished;
+    int first_done;
+    Event idle;     // 全部子任务结束时置位
+    Event any_done; // 第一个子任务结束时置位
+    std::shared_ptr<TimerToken> deadline;
+};
+
+namespace {
+
+int wait_errno() { return cancelled() ? ECANCELED : ETIMEDOUT; }
+
+} // namespace
+
+TaskGroup::TaskGroup() : state_(std::make_shared<State>()) {}
+
+TaskGroup::TaskGroup(uint32_t deadline_ms) : TaskGroup() {
+    if (deadline_ms == kInfiniteTimeoutMs) {
+        return;
+    }
+
+    Processor *processor = current_processor();
+    if (!processor) {
+        Runtime &runtime = Runtime::instance();
+        runtime.ensure_started();
+        processor = runtime.processors()[runtime.pick_processor_index()].get();
+    }
+
+    std::weak_ptr<State> weak = state_;
+    state_->deadline = processor->add_timer(deadline_ms, [weak]() {
+        if (std::shared_ptr<State> state = weak.lock()) {
+            ZCO_LOG_DEBUG("task group deadline reached, cancel children");
+            cancel_state(state.get());
+        }
+    });
+}
+
+TaskGroup::~TaskGroup() {
+    while (!state_->idle.wait(kInfiniteTimeoutMs)) {
+    }
+    if (state_->deadline) {
+        state_->deadline->cancel();
+    }
+}
+
+bool TaskGroup::wait_all(uint32_t timeout_ms) const {
+    if (state_->idle.wait(timeout_ms)) {
+        return true;
+    }
+    errno = wait_errno();
+    return false;
+}
+
+int TaskGroup::wait_any(uint32_t timeout_ms) const {
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        if (state_->first_done >= 0) {
+            return state_->first_done;
+        }
+        if (state_->spawned == 0) {
+            errno = EINVAL;
+            return -1;
+        }
+    }
+
+    if (!state_->any_done.wait(timeout_ms)) {
+        errno = wait_errno();
+        return -1;
+    }
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return state_->first_done;
+}
+
+void TaskGroup::cancel() const { cancel_state(state_.get()); }
+
+bool TaskGroup::cancelled() const {
+    return state_->cancelled.load(std::memory_order_acquire);
+}
+
+size_t TaskGroup::size() const {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    return state_->spawned;
+}
+
+size_t TaskGroup::add_child() const {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    if (state_->spawned == state_->finished) {
+        state_->idle.reset();
+    }
+    state_->running.emplace_back();
+    return state_->spawned++;
+}
+
+bool TaskGroup::enter_child(const std::shared_ptr<State> &state,
+                            size_t index) {
+    Fiber::ptr self = current_fiber_shared();
+    std::lock_guard<std::mutex> lock(state->mutex);
+    // 取消方先置位再拿锁，这里持锁读到 false 时登记一定能被它看到。
+    if (state->cancelled.load(std::memory_order_acquire)) {
+        return false;
+    }
+    state->running[index] = std::move(self);
+    return true;
+}
+
+void TaskGroup::leave_child(const std::shared_ptr<State> &state, size_t index,
+                            bool failed) {
+    if (failed) {
+        ZCO_LOG_DEBUG("task group child failed, cancel siblings, index={}",
+                      index);
+        cancel_state(state.get());
+    }
+
+    std::lock_guard<std::mutex> lock(state->mutex);
+    state->running[index].reset();
+    ++state->finished;
+    if (state->first_done < 0) {
+        state->first_done = static_cast<int>(index);
+        state->any_done.signal();
+    }
+    if (state->finished == state->spawned) {
+        state->idle.signal();
+    }
+}
+
+void TaskGroup::cancel_state(State *state) {
+    if (state->cancelled.exchange(true, std::memory_order_acq_rel)) {
+        return;
+    }
+
+    size_t woken = 0;
+    std::lock_guard<std::mutex> lock(state->mutex);
+    for (size_t i = 0; i < state->running.size(); ++i) {
+        const Fiber::ptr &fiber = state->running[i];
+        if (fiber && fiber->request_cancel()) {
+            fiber->owner()->enqueue_ready(fiber);
+            ++woken;
+        }
+    }
+    ZCO_LOG_DEBUG("task group cancelled, children={}, woken={}",
+                  state->running.size(), woken);
+}
+
+} // namespace zco
@@ -1,6 +1,5 @@
 #include "zco/internal/timer.h"
 
-#include <algorithm>
 #include <chrono>
 
 #include "zco/zco_log.h"
@@ -8,78 +7,375 @@
 namespace zco {
 
 // TimerQueue 提供“按截止时间触发回调”的最小能力：
-// - add_timer: 录入 deadline + callback。
-// - process_due: 执行到期回调。
-// - next_timeout_ms: 告诉 epoll_wait 下一次最多可阻塞多久。
+// - add_timer: 按 deadline 与当前轮转时间的差值挂到对应层级槽位。
+// - process_due: 逐毫秒推进时间轮，高层槽位到点后逐级下沉，
+//   第 0 层槽位到点即到期。
+// - next_timeout_ms: 借助槽位占用位图找到最近的非空槽位，告诉 epoll_wait
+//   下一次最多可阻塞多久。
 
-TimerQueue::TimerQueue() : mutex_(), timers_(), sequence_(0) {}
+namespace {
+
+constexpr uint64_t kLowBitsMask = (1ull << 38) - 1;
+
+uint32_t level_offset(uint32_t level) {
+    return level == 0 ? 0 : 256 + 64 * (level - 1);
+}
+
+uint32_t level_shift(uint32_t level) {
+    return level == 0 ? 0 : 8 + 6 * (level - 1);
+}
+
+uint32_t level_size(uint32_t level) { return level == 0 ? 256 : 64; }
+
+} // namespace
+
+constexpr uint32_t TimerQueue::kLevelCount;
+constexpr uint32_t TimerQueue::kFirstLevelBits;
+constexpr uint32_t TimerQueue::kLevelBits;
+constexpr uint32_t TimerQueue::kSlotCount;
+constexpr uint32_t TimerQueue::kReadySlot;
+constexpr uint32_t TimerQueue::kFarSlot;
+constexpr uint32_t TimerQueue::kListCount;
+
+void TimerToken::cancel() {
+    cancelled.store(true, std::memory_order_release);
+    TimerQueue *owner = queue.load(std::memory_order_acquire);
+    if (owner) {
+        owner->cancel(this);
+    }
+}
+
+TimerQueue::TimerQueue()
+    : mutex_(), lists_(), occupied_(), current_ms_(now_ms()), size_(0) {
+    static_assert(kFirstLevelBits + (kLevelCount - 1) * kLevelBits == 38,
+                  "kLowBitsMask must match the total wheel span");
+}
+
+TimerQueue::~TimerQueue() {
+    for (uint32_t i = 0; i < kListCount; ++i) {
+        TimerToken *node = lists_[i].head;
+        while (node) {
+            TimerToken *next = node->next;
+            node->prev = nullptr;
+            node->next = nullptr;
+            node->queue.store(nullptr, std::memory_order_release);
+            node->callback = nullptr;
+            node->self.reset();
+            node = next;
+        }
+        lists_[i].head = nullptr;
+        lists_[i].tail = nullptr;
+    }
+}
 
 std::shared_ptr<TimerToken>
 TimerQueue::add_timer(uint32_t milliseconds, std::function<void()> callback) {
     std::shared_ptr<TimerToken> token = std::make_shared<TimerToken>();
-    const uint64_t deadline_ms = now_ms() + milliseconds;
-    const uint64_t seq = sequence_.fetch_add(1, std::memory_order_relaxed);
-    // seq 用于在相同 deadline 下提供稳定顺序，避免无序抖动。
+    token->deadline_ms = now_ms() + milliseconds;
+    token->callback = std::move(callback);
+    token->self = token;
 
     {
         std::lock_guard<std::mutex> lock(mutex_);
-        timers_.push(TimerEntry{deadline_ms, seq, token, std::move(callback)});
+        token->queue.store(this, std::memory_order_release);
+        link(token.get());
         ZCO_LOG_DEBUG("timer queued, delay_ms={}, queue_size={}", milliseconds,
-                      timers_.size());
+                      size_);
     }
 
     return token;
 }
 
-void TimerQueue::process_due() {
-    // 到期定时器在调度线程串行执行，避免跨线程回调竞态。
+size_t TimerQueue::process_due() {
+    // 到期定时器在调度线程串行执行，避免跨线程回调竞态；
+    // 回调里新增的到期定时器会在下一轮循环中继续执行。
+    size_t fired = 0;
     while (true) {
-        TimerEntry entry;
+        TimerList due;
         {
             std::lock_guard<std::mutex> lock(mutex_);
-            if (timers_.empty()) {
-                return;
-            }
-            if (timers_.top().deadline_ms > now_ms()) {
-                return;
-            }
-            entry = timers_.top();
-            timers_.pop();
+            advance_to(now_ms(), &due);
         }
 
-        if (entry.token &&
-            entry.token->cancelled.load(std::memory_order_acquire)) {
-            continue;
+        if (!due.head) {
+            return fired;
         }
 
-        if (entry.callback) {
-            ZCO_LOG_DEBUG("timer fired, deadline_ms={}", entry.deadline_ms);
-            entry.callback();
+        TimerToken *node = due.head;
+        while (node) {
+            TimerToken *next = node->next;
+            node->next = nullptr;
+
+            // 先接管时间轮的引用和回调，回调执行完毕后节点即可释放。
+            std::shared_ptr<TimerToken> holder = std::move(node->self);
+            std::function<void()> callback = std::move(node->callback);
+            node->callback = nullptr;
+
+            if (!node->cancelled.load(std::memory_order_acquire) && callback) {
+                ZCO_LOG_DEBUG("timer fired, deadline_ms={}", node->deadline_ms);
+                callback();
+                ++fired;
+            }
+            node = next;
         }
     }
 }
 
 int TimerQueue::next_timeout_ms() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    if (timers_.empty()) {
-        // 空队列给一个保守上限，避免 epoll 长时间无限阻塞。
-        return 1000;
+    uint64_t earliest = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (size_ == 0) {
+            // 空队列给一个保守上限，避免 epoll 长时间无限阻塞。
+            return 1000;
+        }
+        if (lists_[kReadySlot].head) {
+            return 0;
+        }
+
+        // 低层非空槽位的起点一定早于任何高层槽位，找到第一个即可。
+        bool found = false;
+        for (uint32_t level = 0; level < kLevelCount && !found; ++level) {
+            const uint32_t shift = level_shift(level);
+            const uint32_t span_shift = kFirstLevelBits + kLevelBits * level;
+            const uint32_t index = static_cast<uint32_t>(
+                (current_ms_ >> shift) & (level_size(level) - 1));
+            const int slot = find_next_slot(level, index + 1);
+            if (slot < 0) {
+                continue;
+            }
+
+            // 高层槽位的起点可能远早于其中定时器的 deadline，
+            // 取链表记录的最早 deadline 收紧等待时长。
+            earliest = ((current_ms_ >> span_shift) << span_shift) +
+                       (static_cast<uint64_t>(slot) << shift);
+            const uint64_t slot_min =
+                lists_[level_offset(level) + static_cast<uint32_t>(slot)]
+                    .min_deadline;
+            if (slot_min != UINT64_MAX && slot_min > earliest) {
+                earliest = slot_min;
+            }
+            found = true;
+        }
+
+        if (!found) {
+            // 只剩超出全部层级跨度的定时器。
+            return 1000;
+        }
     }
 
     const uint64_t now = now_ms();
-    const uint64_t deadline = timers_.top().deadline_ms;
-    if (deadline <= now) {
+    if (earliest <= now) {
         return 0;
     }
 
-    const uint64_t delta = deadline - now;
+    const uint64_t delta = earliest - now;
     return delta > 1000 ? 1000 : static_cast<int>(delta);
 }
 
+size_t TimerQueue::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return size_;
+}
+
+void TimerQueue::cancel(TimerToken *token) {
+    std::shared_ptr<TimerToken> holder;
+    std::function<void()> callback;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (token->queue.load(std::memory_order_relaxed) != this) {
+            // 已经触发或被取消。
+            return;
+        }
+
+        unlink(token);
+        token->queue.store(nullptr, std::memory_order_release);
+        holder = std::move(token->self);
+        callback = std::move(token->callback);
+        token->callback = nullptr;
+    }
+    // holder 与 callback 在锁外析构，
+    // 回调捕获的对象析构时可以安全地再次访问队列。
+}
+
+void TimerQueue::link(TimerToken *token) {
+    const uint64_t deadline = token->deadline_ms;
+    if (deadline <= current_ms_) {
+        link_to(token, kReadySlot);
+        return;
+    }
+
+    // 选择 deadline 与当前时间高位一致的最低层级，槽位下标取该层对应的位段。
+    for (uint32_t level = 0; level < kLevelCount; ++level) {
+        const uint32_t span_shift = kFirstLevelBits + kLevelBits * level;
+        if ((deadline >> span_shift) != (current_ms_ >> span_shift)) {
+            continue;
+        }
+
+        const uint32_t index = static_cast<uint32_t>(
+            (deadline >> level_shift(level)) & (level_size(level) - 1));
+        link_to(token, level_offset(level) + index);
+        return;
+    }
+
+    link_to(token, kFarSlot);
+}
+
+void TimerQueue::link_to(TimerToken *token, uint32_t slot) {
+    TimerList &list = lists_[slot];
+    token->slot = slot;
+    token->prev = list.tail;
+    token->next = nullptr;
+    if (list.tail) {
+        list.tail->next = token;
+    } else {
+        list.head = token;
+    }
+    list.tail = token;
+    if (token->deadline_ms < list.min_deadline) {
+        list.min_deadline = token->deadline_ms;
+    }
+
+    if (slot < kSlotCount) {
+        occupied_[slot / 64] |= (1ull << (slot % 64));
+    }
+    ++size_;
+}
+
+void TimerQueue::unlink(TimerToken *token) {
+    TimerList &list = lists_[token->slot];
+    if (token->prev) {
+        token->prev->next = token->next;
+    } else {
+        list.head = token->next;
+    }
+    if (token->next) {
+        token->next->prev = token->prev;
+    } else {
+        list.tail = token->prev;
+    }
+    token->prev = nullptr;
+    token->next = nullptr;
+
+    if (!list.head) {
+        list.min_deadline = UINT64_MAX;
+        if (token->slot < kSlotCount) {
+            occupied_[token->slot / 64] &= ~(1ull << (token->slot % 64));
+        }
+    }
+    --size_;
+}
+
+void TimerQueue::cascade(uint32_t slot) {
+    TimerToken *node = lists_[slot].head;
+    if (!node) {
+        return;
+    }
+
+    // 整条链摘下后按原顺序重新挂载，同 deadline 的先后关系保持不变。
+    size_t count = 0;
+    for (TimerToken *it = node; it; it = it->next) {
+        ++count;
+    }
+    lists_[slot].head = nullptr;
+    lists_[slot].tail = nullptr;
+    lists_[slot].min_deadline = UINT64_MAX;
+    if (slot < kSlotCount) {
+        occupied_[slot / 64] &= ~(1ull << (slot % 64));
+    }
+    size_ -= count;
+
+    while (node) {
+        TimerToken *next = node->next;
+        link(node);
+        node = next;
+    }
+}
+
+void TimerQueue::move_all(uint32_t slot, TimerList *due) {
+    TimerList &list = lists_[slot];
+    if (!list.head) {
+        return;
+    }
+
+    for (TimerToken *it = list.head; it; it = it->next) {
+        it->queue.store(nullptr, std::memory_order_release);
+        it->prev = nullptr;
+        --size_;
+    }
+
+    if (due->tail) {
+        due->tail->next = list.head;
+    } else {
+        due->head = list.head;
+    }
+    due->tail = list.tail;
+
+    list.head = nullptr;
+    list.tail = nullptr;
+    list.min_deadline = UINT64_MAX;
+    if (slot < kSlotCount) {
+        occupied_[slot / 64] &= ~(1ull << (slot % 64));
+    }
+}
+
+void TimerQueue::advance_to(uint64_t now, TimerList *due) {
+    move_all(kReadySlot, due);
+
+    while (current_ms_ < now) {
+        if (size_ == 0) {
+            // 时间轮为空时无需逐格推进，直接对齐到当前时间。
+            current_ms_ = now;
+            break;
+        }
+
+        ++current_ms_;
+        if ((current_ms_ & kLowBitsMask) == 0) {
+            cascade(kFarSlot);
+        }
+
+        // 高层先下沉，保证下沉到同一时刻低层槽位的定时器也能继续下沉。
+        for (uint32_t level = kLevelCount - 1; level > 0; --level) {
+            const uint32_t shift = level_shift(level);
+            if ((current_ms_ & ((1ull << shift) - 1)) != 0) {
+                continue;
+            }
+            const uint32_t index = static_cast<uint32_t>(
+                (current_ms_ >> shift) & (level_size(level) - 1));
+            cascade(level_offset(level) + index);
+        }
+
+        move_all(static_cast<uint32_t>(current_ms_ & 255), due);
+        move_all(kReadySlot, due);
+    }
+}
+
+int TimerQueue::find_next_slot(uint32_t level, uint32_t from) const {
+    const uint32_t size = level_size(level);
+    const uint32_t offset = level_offset(level);
+    for (uint32_t index = from; index < size;) {
+        const uint32_t global = offset + index;
+        const uint64_t word = occupied_[global / 64] >> (global % 64);
+        if (word != 0) {
+            const uint32_t found =
+                index + static_cast<uint32_t>(__builtin_ctzll(word));
+            return found < size ? static_cast<int>(found) : -1;
+        }
+        index += 64 - (global % 64);
+    }
+    return -1;
+}
+
 uint64_t now_ms() {
     const auto now = std::chrono::steady_clock::now().time_since_epoch();
     return static_cast<uint64_t>(
         std::chrono::duration_cast<std::chrono::milliseconds>(now).count());
 }
 
+uint64_t now_ns() {
+    const auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+}
+
 } // namespace zco
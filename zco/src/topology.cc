@@ -0,0 +1,273 @@
+#include "zco/internal/topology.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <utility>
+
+#include "zco/zco_log.h"
+
+namespace zco {
+
+// topology.cc 只依赖 sysfs 与原始系统调用，不引入 libnuma：
+// - CPU 绑定使用 pthread_setaffinity_np。
+// - 线程内存策略与区间内存策略分别使用 set_mempolicy/mbind。
+
+namespace {
+
+constexpr int kMpolPreferred = 1;
+constexpr unsigned kMpolMfMove = 1u << 1;
+constexpr size_t kMaxNumaNodes = 1024;
+constexpr const char *kNodeSysfsDir = "/sys/devices/system/node";
+
+using NodeMask = unsigned long[kMaxNumaNodes / (8 * sizeof(unsigned long))];
+
+bool make_node_mask(int numa_node, NodeMask *mask) {
+    if (numa_node < 0 || static_cast<size_t>(numa_node) >= kMaxNumaNodes) {
+        return false;
+    }
+
+    std::memset(*mask, 0, sizeof(NodeMask));
+    const size_t bits = 8 * sizeof(unsigned long);
+    (*mask)[numa_node / bits] |= 1UL << (numa_node % bits);
+    return true;
+}
+
+bool read_first_line(const std::string &path, std::string *line) {
+    std::ifstream in(path.c_str());
+    if (!in) {
+        return false;
+    }
+    std::getline(in, *line);
+    return true;
+}
+
+bool parse_int(const std::string &text, int *value) {
+    if (text.empty()) {
+        return false;
+    }
+
+    char *end = nullptr;
+    errno = 0;
+    const long parsed = std::strtol(text.c_str(), &end, 10);
+    if (errno != 0 || end == text.c_str() || *end != '\0' || parsed < 0 ||
+        parsed > 1 << 20) {
+        return false;
+    }
+    *value = static_cast<int>(parsed);
+    return true;
+}
+
+} // namespace
+
+CpuTopology::CpuTopology(std::vector<int> cpus, std::vector<int> cpu_nodes)
+    : cpus_(std::move(cpus)), cpu_nodes_(std::move(cpu_nodes)), nodes_() {
+    if (cpu_nodes_.size() != cpus_.size()) {
+        cpu_nodes_.assign(cpus_.size(), 0);
+    }
+
+    // 按 (节点, CPU) 排序，plan() 依赖同节点 CPU 相邻。
+    std::vector<std::pair<int, int>> entries;
+    entries.reserve(cpus_.size());
+    for (size_t i = 0; i < cpus_.size(); ++i) {
+        entries.emplace_back(cpu_nodes_[i], cpus_[i]);
+    }
+    std::sort(entries.begin(), entries.end());
+    entries.erase(std::unique(entries.begin(), entries.end()), entries.end());
+
+    cpus_.clear();
+    cpu_nodes_.clear();
+    for (size_t i = 0; i < entries.size(); ++i) {
+        cpu_nodes_.push_back(entries[i].first);
+        cpus_.push_back(entries[i].second);
+        if (nodes_.empty() || nodes_.back() != entries[i].first) {
+            nodes_.push_back(entries[i].first);
+        }
+    }
+}
+
+CpuTopology CpuTopology::detect() {
+    std::vector<int> cpus;
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+        ZCO_LOG_WARN("topology detect failed, sched_getaffinity errno={}",
+                     errno);
+        return CpuTopology(std::vector<int>(), std::vector<int>());
+    }
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (CPU_ISSET(cpu, &allowed)) {
+            cpus.push_back(cpu);
+        }
+    }
+
+    // 默认全部归入节点 0，再用 sysfs 中的 nodeN/cpulist 修正。
+    std::vector<int> cpu_nodes(cpus.size(), 0);
+    DIR *dir = opendir(kNodeSysfsDir);
+    if (dir) {
+        while (dirent *entry = readdir(dir)) {
+            const std::string name(entry->d_name);
+            int node = -1;
+            if (name.compare(0, 4, "node") != 0 ||
+                !parse_int(name.substr(4), &node)) {
+                continue;
+            }
+
+            const std::string path =
+                std::string(kNodeSysfsDir) + "/" + name + "/cpulist";
+            std::string line;
+            std::vector<int> node_cpus;
+            if (!read_first_line(path, &line) ||
+                !parse_cpu_list(line, &node_cpus)) {
+                continue;
+            }
+
+            for (size_t i = 0; i < cpus.size(); ++i) {
+                if (std::find(node_cpus.begin(), node_cpus.end(), cpus[i]) !=
+                    node_cpus.end()) {
+                    cpu_nodes[i] = node;
+                }
+            }
+        }
+        closedir(dir);
+    }
+
+    return CpuTopology(std::move(cpus), std::move(cpu_nodes));
+}
+
+size_t CpuTopology::cpu_count() const { return cpus_.size(); }
+
+size_t CpuTopology::node_count() const { return nodes_.size(); }
+
+int CpuTopology::node_of(int cpu) const {
+    for (size_t i = 0; i < cpus_.size(); ++i) {
+        if (cpus_[i] == cpu) {
+            return cpu_nodes_[i];
+        }
+    }
+    return -1;
+}
+
+std::vector<CpuPlacement> CpuTopology::plan(size_t processor_count) const {
+    std::vector<CpuPlacement> placements(processor_count);
+    if (cpus_.empty()) {
+        return placements;
+    }
+
+    // 在按节点排好序的 CPU 上等距取点：各节点分到的处理器数与其 CPU
+    // 数成比例，且同节点的处理器编号连续；处理器多于 CPU 时相邻的共享核。
+    const size_t cpu_count = cpus_.size();
+    for (size_t i = 0; i < processor_count; ++i) {
+        const size_t index = i * cpu_count / processor_count;
+        placements[i] = CpuPlacement(cpus_[index], cpu_nodes_[index]);
+    }
+    return placements;
+}
+
+bool parse_cpu_list(const std::string &text, std::vector<int> *cpus) {
+    if (!cpus) {
+        return false;
+    }
+
+    std::vector<int> parsed;
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t end = text.find(',', pos);
+        if (end == std::string::npos) {
+            end = text.size();
+        }
+
+        std::string item = text.substr(pos, end - pos);
+        while (!item.empty() && (item.back() == '\n' || item.back() == ' ')) {
+            item.pop_back();
+        }
+        pos = end + 1;
+        if (item.empty()) {
+            continue;
+        }
+
+        const size_t dash = item.find('-');
+        int first = 0;
+        int last = 0;
+        if (dash == std::string::npos) {
+            if (!parse_int(item, &first)) {
+                return false;
+            }
+            last = first;
+        } else if (!parse_int(item.substr(0, dash), &first) ||
+                   !parse_int(item.substr(dash + 1), &last) || last < first) {
+            return false;
+        }
+
+        for (int cpu = first; cpu <= last; ++cpu) {
+            parsed.push_back(cpu);
+        }
+    }
+
+    cpus->insert(cpus->end(), parsed.begin(), parsed.end());
+    return true;
+}
+
+bool bind_current_thread(const CpuPlacement &placement) {
+    if (placement.cpu < 0 || placement.cpu >= CPU_SETSIZE) {
+        return false;
+    }
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(placement.cpu, &set);
+    const int rc = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (rc != 0) {
+        ZCO_LOG_WARN("bind thread to cpu failed, cpu={}, error={}",
+                     placement.cpu, rc);
+        return false;
+    }
+
+    NodeMask mask;
+    if (make_node_mask(placement.numa_node, &mask) &&
+        syscall(SYS_set_mempolicy, kMpolPreferred, mask,
+                static_cast<unsigned long>(kMaxNumaNodes)) != 0) {
+        // 未开启 CONFIG_NUMA 的内核返回 ENOSYS，此时首次触碰已足够本地化。
+        ZCO_LOG_DEBUG("set_mempolicy failed, node={}, errno={}",
+                      placement.numa_node, errno);
+    }
+    return true;
+}
+
+bool bind_memory_to_node(void *addr, size_t length, int numa_node) {
+    NodeMask mask;
+    if (!addr || !make_node_mask(numa_node, &mask)) {
+        return false;
+    }
+
+    const long page_size = sysconf(_SC_PAGESIZE);
+    const uintptr_t page = page_size > 0 ? static_cast<uintptr_t>(page_size)
+                                         : static_cast<uintptr_t>(4096);
+    const uintptr_t begin =
+        (reinterpret_cast<uintptr_t>(addr) + page - 1) & ~(page - 1);
+    const uintptr_t end =
+        (reinterpret_cast<uintptr_t>(addr) + length) & ~(page - 1);
+    if (end <= begin) {
+        return true;
+    }
+
+    if (syscall(SYS_mbind, reinterpret_cast<void *>(begin), end - begin,
+                kMpolPreferred, mask, static_cast<unsigned long>(kMaxNumaNodes),
+                kMpolMfMove) != 0) {
+        ZCO_LOG_DEBUG("mbind failed, node={}, length={}, errno={}", numa_node,
+                      end - begin, errno);
+        return false;
+    }
+    return true;
+}
+
+} // namespace zco
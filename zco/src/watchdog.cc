@@ -0,0 +1,218 @@
+#include "zco/internal/watchdog.h"
+
+#include <execinfo.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <utility>
+
+#include "zco/internal/processor.h"
+#include "zco/internal/timer.h"
+#include "zco/zco_log.h"
+
+namespace zco {
+
+// watchdog.cc 负责发现“长时间不让出”的协程：
+// - 调度线程在切入、切回时登记片段起点，看门狗线程只读这两个原子量。
+// - 看门狗线程不读 Fiber，它可能已经回收；开启 capture_spawn_site 时调度
+//   线程在切入时把创建位置复制到处理器上，看门狗按片段起点校验后输出，
+//   永不切回的协程也能定位到创建位置。
+
+namespace {
+
+// 跳过 capture_spawn_site 与 attach_spawn_site 自身的帧。
+constexpr int kSkippedSpawnFrames = 2;
+constexpr size_t kMigrateBatchSize = 256;
+constexpr size_t kMigrateLimit = 4096; // 单轮检查最多迁移的任务数
+constexpr uint64_t kMinCheckIntervalNs = 1000 * 1000;
+
+// 携带创建位置的任务：运行期间把调用栈挂到当前协程上。
+struct SpawnSiteTask {
+    std::unique_ptr<SpawnSite> site;
+    Task task;
+
+    void operator()() {
+        Processor *processor = current_processor();
+        Fiber *fiber = processor ? processor->current_fiber() : nullptr;
+        if (fiber) {
+            fiber->set_spawn_site(site.get());
+            processor->publish_spawn_site(site.get());
+        }
+        task();
+        if (fiber) {
+            fiber->set_spawn_site(nullptr);
+        }
+    }
+};
+
+} // namespace
+
+constexpr int SpawnSite::kMaxFrames;
+
+std::unique_ptr<SpawnSite> capture_spawn_site() {
+    std::unique_ptr<SpawnSite> site(new SpawnSite());
+    void *frames[SpawnSite::kMaxFrames + kSkippedSpawnFrames];
+    const int depth = ::backtrace(frames, SpawnSite::kMaxFrames +
+                                              kSkippedSpawnFrames);
+    for (int i = kSkippedSpawnFrames; i < depth; ++i) {
+        site->frames[site->depth++] = frames[i];
+    }
+    return site;
+}
+
+std::string format_spawn_site(const SpawnSite &site) {
+    std::string text;
+    if (site.depth <= 0) {
+        return text;
+    }
+
+    char **symbols = ::backtrace_symbols(site.frames, site.depth);
+    for (int i = 0; i < site.depth; ++i) {
+        text += "\n  #";
+        text += std::to_string(i);
+        text += ' ';
+        if (symbols) {
+            text += symbols[i];
+        } else {
+            char address[32];
+            std::snprintf(address, sizeof(address), "%p", site.frames[i]);
+            text += address;
+        }
+    }
+    std::free(symbols);
+    return text;
+}
+
+Task attach_spawn_site(Task task) {
+    if (!task) {
+        return task;
+    }
+    return Task(SpawnSiteTask{capture_spawn_site(), std::move(task)});
+}
+
+Watchdog::Watchdog()
+    : processors_(nullptr), threshold_ns_(0), migrate_(false), reported_(),
+      mutex_(), cv_(), stopping_(false), thread_() {}
+
+Watchdog::~Watchdog() { stop(); }
+
+void Watchdog::start(const std::vector<std::unique_ptr<Processor>> *processors,
+                     uint64_t threshold_ns, bool migrate) {
+    if (thread_.joinable() || !processors || threshold_ns == 0) {
+        return;
+    }
+
+    processors_ = processors;
+    threshold_ns_ = threshold_ns;
+    migrate_ = migrate;
+    reported_.assign(processors_->size(), 0);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = false;
+    }
+    thread_ = std::thread(&Watchdog::run, this);
+}
+
+void Watchdog::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void Watchdog::run() {
+    // 以阈值的四分之一为周期，检出延迟不超过阈值的 1.25 倍。
+    const uint64_t interval_ns =
+        std::max(threshold_ns_ / 4, kMinCheckIntervalNs);
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_) {
+        cv_.wait_for(lock, std::chrono::nanoseconds(interval_ns));
+        if (stopping_) {
+            break;
+        }
+        lock.unlock();
+        check(now_ns());
+        lock.lock();
+    }
+}
+
+size_t Watchdog::check(uint64_t now_ns) {
+    if (!processors_) {
+        return 0;
+    }
+
+    size_t stalled = 0;
+    for (size_t i = 0; i < processors_->size(); ++i) {
+        Processor *processor = (*processors_)[i].get();
+        uint64_t begin_ns = 0;
+        int fiber_id = 0;
+        if (!processor || !processor->running_slice(&begin_ns, &fiber_id) ||
+            now_ns < begin_ns || now_ns - begin_ns < threshold_ns_) {
+            continue;
+        }
+
+        ++stalled;
+        if (reported_[i] != begin_ns) {
+            reported_[i] = begin_ns;
+            SpawnSite site;
+            const bool has_site =
+                processor->running_spawn_site(begin_ns, &site);
+            ZCO_LOG_WARN("fiber is not yielding, sched_id={}, fiber_id={}, "
+                         "running_ms={}, pending_tasks={}{}",
+                         processor->id(), fiber_id,
+                         (now_ns - begin_ns) / 1000000,
+                         processor->pending_task_count(),
+                         has_site ? "\n spawned at:" + format_spawn_site(site)
+                                  : std::string());
+        }
+        if (migrate_) {
+            const size_t moved = migrate_pending_tasks(processor);
+            if (moved > 0) {
+                ZCO_LOG_WARN("pending tasks migrated off stalled scheduler, "
+                             "sched_id={}, fiber_id={}, migrated={}",
+                             processor->id(), fiber_id, moved);
+            }
+        }
+    }
+    return stalled;
+}
+
+size_t Watchdog::migrate_pending_tasks(Processor *stalled) {
+    // 目标挑负载最低、且自己没有卡住的调度器；都卡住时不迁移。
+    Processor *target = nullptr;
+    for (size_t i = 0; i < processors_->size(); ++i) {
+        Processor *candidate = (*processors_)[i].get();
+        uint64_t begin_ns = 0;
+        int fiber_id = 0;
+        if (!candidate || candidate == stalled || candidate->draining() ||
+            (candidate->running_slice(&begin_ns, &fiber_id) &&
+             now_ns() - begin_ns >= threshold_ns_)) {
+            continue;
+        }
+        if (!target || candidate->load_score() < target->load_score()) {
+            target = candidate;
+        }
+    }
+    if (!target) {
+        return 0;
+    }
+
+    // 已实体化为协程的任务绑定了原调度器的栈，只能搬走尚未开始的任务。
+    std::vector<Task> tasks;
+    size_t moved = 0;
+    while (moved < kMigrateLimit &&
+           stalled->steal_tasks(&tasks, kMigrateBatchSize, 0) > 0) {
+        moved += tasks.size();
+        target->enqueue_task_batch(tasks.data(), tasks.size());
+        tasks.clear();
+    }
+    return moved;
+}
+
+} // namespace zco
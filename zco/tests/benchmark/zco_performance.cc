@@ -7,20 +7,48 @@
 #include <fcntl.h>
 #include <iomanip>
 #include <iostream>
+#include <memory>
 #include <sstream>
 #include <stdexcept>
 #include <string>
 #include <sys/socket.h>
 #include <thread>
+#include <ucontext.h>
 #include <unistd.h>
 #include <vector>
 
 #include "zco/channel.h"
 #include "zco/hook.h"
+#include "zco/internal/context.h"
+#include "zco/internal/steal_queue.h"
+#include "zco/mutex.h"
 #include "zco/sched.h"
 #include "zco/wait_group.h"
 #include "zco/zco_log.h"
 
+#if defined(ZCO_PERF_COUNT_MALLOC)
+// 链接时用 --wrap 把运行时与本文件对 malloc/operator new 的调用转到这里计数，
+// 与实际链接的分配器无关。
+namespace {
+std::atomic<uint64_t> g_malloc_calls(0);
+} // namespace
+
+extern "C" {
+void *__real_malloc(size_t size);
+void *__real__Znwm(size_t size);
+
+void *__wrap_malloc(size_t size) {
+    g_malloc_calls.fetch_add(1, std::memory_order_relaxed);
+    return __real_malloc(size);
+}
+
+void *__wrap__Znwm(size_t size) {
+    g_malloc_calls.fetch_add(1, std::memory_order_relaxed);
+    return __real__Znwm(size);
+}
+}
+#endif
+
 namespace zco {
 namespace {
 
@@ -31,8 +59,17 @@ constexpr int kDefaultYieldInterval = 8;
 constexpr size_t kDefaultStackSize = 64 * 1024;
 constexpr size_t kDefaultSharedStackNum = 64;
 constexpr int kDefaultChannelMessages = 80000;
+constexpr int kDefaultPingPongRounds = 200000;
+constexpr int kPingPongBackgroundFibers = 16;
+constexpr int kChannelBatchSize = 16;
+constexpr int kMutexFibersPerWorker = 4;
+constexpr int kSharedMutexWriteInterval = 16;
+constexpr int kSpawnWaveSize = 64;
 constexpr int kDefaultTimerTasks = 60000;
 constexpr int kDefaultHookRounds = 40000;
+constexpr int kDefaultContextSwitches = 2000000;
+constexpr int kDefaultStealQueueTasks = 400000;
+constexpr size_t kContextSwitchStackSize = 64 * 1024;
 
 struct WorkloadConfig {
     int scheduler_count;
@@ -42,8 +79,11 @@ struct WorkloadConfig {
     size_t stack_size;
     size_t shared_stack_num;
     int channel_messages;
+    int pingpong_rounds;
     int timer_tasks;
     int hook_rounds;
+    int context_switches;
+    int steal_queue_tasks;
 };
 
 struct ScenarioResult {
@@ -53,6 +93,8 @@ struct ScenarioResult {
     int operations;
     double seconds;
     double throughput_ops_per_second;
+    double stack_copy_bytes_per_second = 0;
+    double mallocs_per_operation = -1; // 未开启计数时为负
 };
 
 class RuntimeScenarioGuard {
@@ -196,12 +238,24 @@ WorkloadConfig load_workload_config() {
         scaled_workload(read_env_int("ZCO_PERF_CHANNEL_MESSAGES",
                                      kDefaultChannelMessages, 1, INT_MAX),
                         scale_pct);
+    config.pingpong_rounds =
+        scaled_workload(read_env_int("ZCO_PERF_PINGPONG_ROUNDS",
+                                     kDefaultPingPongRounds, 1, INT_MAX),
+                        scale_pct);
     config.timer_tasks = scaled_workload(
         read_env_int("ZCO_PERF_TIMER_TASKS", kDefaultTimerTasks, 1, INT_MAX),
         scale_pct);
     config.hook_rounds = scaled_workload(
         read_env_int("ZCO_PERF_HOOK_ROUNDS", kDefaultHookRounds, 1, INT_MAX),
         scale_pct);
+    config.context_switches =
+        scaled_workload(read_env_int("ZCO_PERF_CONTEXT_SWITCHES",
+                                     kDefaultContextSwitches, 1, INT_MAX),
+                        scale_pct);
+    config.steal_queue_tasks =
+        scaled_workload(read_env_int("ZCO_PERF_STEAL_TASKS",
+                                     kDefaultStealQueueTasks, 1, INT_MAX),
+                        scale_pct);
     return config;
 }
 
@@ -211,8 +265,11 @@ void print_workload_config(const WorkloadConfig &config) {
               << " producer_threads=" << config.producer_threads
               << " scheduler_tasks=" << config.scheduler_tasks
               << " channel_messages=" << config.channel_messages
+              << " pingpong_rounds=" << config.pingpong_rounds
               << " timer_tasks=" << config.timer_tasks
               << " hook_rounds=" << config.hook_rounds
+              << " context_switches=" << config.context_switches
+              << " steal_queue_tasks=" << config.steal_queue_tasks
               << " yield_interval=" << config.yield_interval
               << " stack_size=" << config.stack_size
               << " shared_stack_num=" << config.shared_stack_num << std::endl;
@@ -220,6 +277,32 @@ void print_workload_config(const WorkloadConfig &config) {
 
 void disable_benchmark_logging() { init_logger(zlog::LogLevel::value::OFF); }
 
+// 共享栈场景附带快照拷贝速率，用于评估 co_stack_num 是否够用。
+ScenarioResult with_stack_copy_rate(ScenarioResult result) {
+    const StackCopyStats stats = co_stack_copy_stats();
+    result.stack_copy_bytes_per_second =
+        static_cast<double>(stats.saved_bytes + stats.restored_bytes) /
+        result.seconds;
+    return result;
+}
+
+// 返回至今的分配调用次数；未开启计数时返回 -1。
+double malloc_calls() {
+#if defined(ZCO_PERF_COUNT_MALLOC)
+    return static_cast<double>(g_malloc_calls.load(std::memory_order_relaxed));
+#else
+    return -1;
+#endif
+}
+
+ScenarioResult with_malloc_rate(ScenarioResult result, double begin_calls) {
+    if (begin_calls >= 0) {
+        result.mallocs_per_operation =
+            (malloc_calls() - begin_calls) / result.operations;
+    }
+    return result;
+}
+
 void prepare_runtime(StackModel model, const WorkloadConfig &config) {
     shutdown();
     co_stack_model(model);
@@ -236,6 +319,7 @@ ScenarioResult run_scheduler_throughput(StackModel model,
     WaitGroup done(static_cast<uint32_t>(config.scheduler_tasks));
     std::atomic<int> executed(0);
 
+    const double malloc_begin = malloc_calls();
     auto start = std::chrono::steady_clock::now();
 
     std::vector<std::thread> producers;
@@ -274,13 +358,123 @@ ScenarioResult run_scheduler_throughput(StackModel model,
             .count();
     require_positive(seconds, "scheduler_submit elapsed must be positive");
 
-    return ScenarioResult{"scheduler_submit",
-                          model,
-                          config.producer_threads,
-                          config.scheduler_tasks,
-                          seconds,
-                          static_cast<double>(config.scheduler_tasks) /
-                              seconds};
+    return with_malloc_rate(
+        with_stack_copy_rate(ScenarioResult{
+            "scheduler_submit", model, config.producer_threads,
+            config.scheduler_tasks, seconds,
+            static_cast<double>(config.scheduler_tasks) / seconds}),
+        malloc_begin);
+}
+
+ScenarioResult run_spawn_throughput(const WorkloadConfig &config) {
+    // 单调度器上由一个协程按 kSpawnWaveSize 一批派生子协程，等一批跑完再派生
+    // 下一批。稳态下 Fiber、栈和队列节点都来自复用池，分配次数主要取决于
+    // 任务对象本身；任务数沿用 scheduler_tasks。
+    WorkloadConfig scaled = config;
+    scaled.scheduler_count = 1;
+    prepare_runtime(StackModel::kShared, scaled);
+    RuntimeScenarioGuard guard;
+
+    const int waves =
+        (config.scheduler_tasks + kSpawnWaveSize - 1) / kSpawnWaveSize;
+    const int total = waves * kSpawnWaveSize;
+    std::atomic<long long> checksum(0);
+    WaitGroup wave;
+    WaitGroup finished(1);
+
+    const double malloc_begin = malloc_calls();
+    const auto start = std::chrono::steady_clock::now();
+    go([&checksum, &wave, &finished, waves]() {
+        for (int w = 0; w < waves; ++w) {
+            wave.add(kSpawnWaveSize);
+            for (int i = 0; i < kSpawnWaveSize; ++i) {
+                // 捕获 24 字节，超出 std::function 的内联容量。
+                go([&checksum, &wave, w, i]() {
+                    checksum.fetch_add(w + i, std::memory_order_relaxed);
+                    wave.done();
+                });
+            }
+            wave.wait();
+        }
+        finished.done();
+    });
+    finished.wait();
+    const auto end = std::chrono::steady_clock::now();
+
+    long long expected = 0;
+    for (int w = 0; w < waves; ++w) {
+        for (int i = 0; i < kSpawnWaveSize; ++i) {
+            expected += w + i;
+        }
+    }
+    require_eq(checksum.load(), expected, "spawn checksum mismatch");
+
+    const double seconds =
+        std::chrono::duration_cast<std::chrono::duration<double>>(end - start)
+            .count();
+    require_positive(seconds, "spawn elapsed must be positive");
+
+    return with_malloc_rate(
+        ScenarioResult{"spawn_local", StackModel::kShared, 1, total, seconds,
+                       static_cast<double>(total) / seconds},
+        malloc_begin);
+}
+
+ScenarioResult run_remote_spawn_throughput(const WorkloadConfig &config,
+                                           bool batched) {
+    // 主线程按 kSpawnWaveSize 一批向全部调度器派生任务，等一批跑完再派生
+    // 下一批；对比逐个 go() 与 go_batch() 的跨线程投递和唤醒开销。
+    prepare_runtime(StackModel::kShared, config);
+    RuntimeScenarioGuard guard;
+
+    const int waves =
+        (config.scheduler_tasks + kSpawnWaveSize - 1) / kSpawnWaveSize;
+    const int total = waves * kSpawnWaveSize;
+    std::atomic<long long> checksum(0);
+    WaitGroup wave;
+    std::vector<Task> tasks;
+    tasks.reserve(kSpawnWaveSize);
+
+    const double malloc_begin = malloc_calls();
+    const auto start = std::chrono::steady_clock::now();
+    for (int w = 0; w < waves; ++w) {
+        wave.add(kSpawnWaveSize);
+        tasks.clear();
+        for (int i = 0; i < kSpawnWaveSize; ++i) {
+            tasks.emplace_back([&checksum, &wave, w, i]() {
+                checksum.fetch_add(w + i, std::memory_order_relaxed);
+                wave.done();
+            });
+        }
+        if (batched) {
+            go_batch(tasks.data(), tasks.size());
+        } else {
+            for (Task &task : tasks) {
+                go(std::move(task));
+            }
+        }
+        wave.wait();
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    long long expected = 0;
+    for (int w = 0; w < waves; ++w) {
+        for (int i = 0; i < kSpawnWaveSize; ++i) {
+            expected += w + i;
+        }
+    }
+    require_eq(checksum.load(), expected, "remote spawn checksum mismatch");
+
+    const double seconds =
+        std::chrono::duration_cast<std::chrono::duration<double>>(end - start)
+            .count();
+    require_positive(seconds, "remote spawn elapsed must be positive");
+
+    return with_malloc_rate(
+        ScenarioResult{batched ? "spawn_batch" : "spawn_remote",
+                       StackModel::kShared, 1, total, seconds,
+                       static_cast<double>(total) / seconds},
+        malloc_begin);
 }
 
 ScenarioResult run_channel_throughput(StackModel model,
@@ -356,13 +550,227 @@ ScenarioResult run_channel_throughput(StackModel model,
             .count();
     require_positive(seconds, "channel throughput elapsed must be positive");
 
-    return ScenarioResult{"channel_spsc",
-                          model,
-                          kProducerCoroutines + kConsumerCoroutines,
-                          config.channel_messages,
-                          seconds,
-                          static_cast<double>(config.channel_messages) /
-                              seconds};
+    return with_stack_copy_rate(
+        ScenarioResult{"channel_spsc", model,
+                       kProducerCoroutines + kConsumerCoroutines,
+                       config.channel_messages, seconds,
+                       static_cast<double>(config.channel_messages) / seconds});
+}
+
+ScenarioResult run_channel_pingpong(StackModel model,
+                                    const WorkloadConfig &config,
+                                    int background_fibers) {
+    // 单调度器上两个协程经两条容量为 1 的通道来回传值，
+    // 每轮耗时即一次“唤醒对端并切换过去”的往返延迟；
+    // background_fibers 个不断 yield 的协程模拟就绪队列中的其他负载。
+    WorkloadConfig single = config;
+    single.scheduler_count = 1;
+    prepare_runtime(model, single);
+    RuntimeScenarioGuard guard;
+
+    Channel<int> ping(1);
+    Channel<int> pong(1);
+    WaitGroup done(2);
+    WaitGroup background_done(static_cast<uint32_t>(background_fibers));
+    std::atomic<bool> ok(true);
+    std::atomic<bool> stop(false);
+    const int rounds = config.pingpong_rounds;
+
+    for (int i = 0; i < background_fibers; ++i) {
+        go([&stop, &background_done]() {
+            while (!stop.load(std::memory_order_acquire)) {
+                yield();
+            }
+            background_done.done();
+        });
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+
+    go([&ping, &pong, &done, &ok, rounds]() {
+        int value = 0;
+        for (int i = 0; i < rounds; ++i) {
+            if (!ping.write(i) || !pong.read(value) || value != i) {
+                ok.store(false, std::memory_order_release);
+                break;
+            }
+        }
+        ping.close();
+        done.done();
+    });
+
+    go([&ping, &pong, &done, &ok, rounds]() {
+        int value = 0;
+        for (int i = 0; i < rounds; ++i) {
+            if (!ping.read(value) || !pong.write(value)) {
+                ok.store(false, std::memory_order_release);
+                break;
+            }
+        }
+        pong.close();
+        done.done();
+    });
+
+    done.wait();
+    const auto end = std::chrono::steady_clock::now();
+    stop.store(true, std::memory_order_release);
+    background_done.wait();
+
+    require_true(ok.load(std::memory_order_acquire),
+                 "channel pingpong exchange failed");
+
+    const double seconds =
+        std::chrono::duration_cast<std::chrono::duration<double>>(end - start)
+            .count();
+    require_positive(seconds, "channel pingpong elapsed must be positive");
+
+    return with_stack_copy_rate(
+        ScenarioResult{background_fibers > 0 ? "channel_pingpong_loaded"
+                                             : "channel_pingpong",
+                       model, 2 + background_fibers, rounds, seconds,
+                       static_cast<double>(rounds) / seconds});
+}
+
+ScenarioResult run_channel_mpmc(const WorkloadConfig &config, int workers,
+                                int batch) {
+    // workers 个调度器上各跑一个生产者和一个消费者协程，共用一条通道；
+    // batch > 1 时改用 write_n/read_n，每批只做一次唤醒检查。
+    WorkloadConfig scaled = config;
+    scaled.scheduler_count = workers;
+    prepare_runtime(StackModel::kShared, scaled);
+    RuntimeScenarioGuard guard;
+
+    const int per_producer = config.channel_messages / workers > batch
+                                 ? config.channel_messages / workers / batch *
+                                       batch
+                                 : batch;
+    const int total = per_producer * workers;
+
+    Channel<int> channel(1024);
+    WaitGroup producers(static_cast<uint32_t>(workers));
+    WaitGroup consumers(static_cast<uint32_t>(workers));
+    std::atomic<int> consumed(0);
+    std::atomic<bool> ok(true);
+
+    const auto start = std::chrono::steady_clock::now();
+
+    for (int c = 0; c < workers; ++c) {
+        go([&channel, &consumers, &consumed, batch]() {
+            std::vector<int> values(static_cast<size_t>(batch));
+            while (true) {
+                const size_t count =
+                    batch > 1 ? channel.read_n(values.data(), values.size())
+                              : (channel.read(values[0]) ? 1 : 0);
+                if (count == 0) {
+                    break;
+                }
+                consumed.fetch_add(static_cast<int>(count),
+                                   std::memory_order_relaxed);
+            }
+            consumers.done();
+        });
+    }
+
+    for (int p = 0; p < workers; ++p) {
+        go([&channel, &producers, &ok, per_producer, batch]() {
+            std::vector<int> values(static_cast<size_t>(batch));
+            for (int i = 0; i < per_producer; i += batch) {
+                for (int k = 0; k < batch; ++k) {
+                    values[static_cast<size_t>(k)] = i + k;
+                }
+                const bool written =
+                    batch > 1 ? channel.write_n(values.data(), values.size()) ==
+                                    values.size()
+                              : channel.write(values[0]);
+                if (!written) {
+                    ok.store(false, std::memory_order_release);
+                    break;
+                }
+            }
+            producers.done();
+        });
+    }
+
+    producers.wait();
+    channel.close();
+    consumers.wait();
+    const auto end = std::chrono::steady_clock::now();
+
+    require_true(ok.load(std::memory_order_acquire),
+                 "channel mpmc producer failed");
+    require_eq(consumed.load(std::memory_order_relaxed), total,
+               "channel mpmc consumed count mismatch");
+
+    const double seconds =
+        std::chrono::duration_cast<std::chrono::duration<double>>(end - start)
+            .count();
+    require_positive(seconds, "channel mpmc elapsed must be positive");
+
+    return with_stack_copy_rate(ScenarioResult{
+        batch > 1 ? "channel_mpmc_batch" : "channel_mpmc", StackModel::kShared,
+        workers, total, seconds, static_cast<double>(total) / seconds});
+}
+
+ScenarioResult run_mutex_contention(const WorkloadConfig &config, int workers,
+                                    bool read_mostly) {
+    // workers 个调度器上各跑 kMutexFibersPerWorker 个协程争同一把锁，
+    // 操作总数沿用 channel_messages；read_mostly 时改用 SharedMutex，
+    // 每 kSharedMutexWriteInterval 次操作中只有一次写。
+    WorkloadConfig scaled = config;
+    scaled.scheduler_count = workers;
+    prepare_runtime(StackModel::kShared, scaled);
+    RuntimeScenarioGuard guard;
+
+    const int fibers = workers * kMutexFibersPerWorker;
+    const int per_fiber =
+        config.channel_messages / fibers > 0 ? config.channel_messages / fibers
+                                             : 1;
+    const int total = per_fiber * fibers;
+
+    Mutex mutex;
+    SharedMutex shared_mutex;
+    long long counter = 0;
+    std::atomic<long long> observed(0);
+    WaitGroup done(static_cast<uint32_t>(fibers));
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int f = 0; f < fibers; ++f) {
+        go([&mutex, &shared_mutex, &counter, &observed, &done, per_fiber,
+            read_mostly]() {
+            for (int i = 0; i < per_fiber; ++i) {
+                if (!read_mostly) {
+                    MutexGuard lock(mutex);
+                    ++counter;
+                } else if (i % kSharedMutexWriteInterval == 0) {
+                    WriteGuard lock(shared_mutex);
+                    ++counter;
+                } else {
+                    ReadGuard lock(shared_mutex);
+                    observed.fetch_add(counter, std::memory_order_relaxed);
+                }
+            }
+            done.done();
+        });
+    }
+    done.wait();
+    const auto end = std::chrono::steady_clock::now();
+
+    const int writes_per_fiber =
+        read_mostly ? (per_fiber + kSharedMutexWriteInterval - 1) /
+                          kSharedMutexWriteInterval
+                    : per_fiber;
+    require_eq(counter, static_cast<long long>(writes_per_fiber) * fibers,
+               "mutex protected counter mismatch");
+
+    const double seconds =
+        std::chrono::duration_cast<std::chrono::duration<double>>(end - start)
+            .count();
+    require_positive(seconds, "mutex contention elapsed must be positive");
+
+    return with_stack_copy_rate(ScenarioResult{
+        read_mostly ? "shared_mutex_read_mostly" : "mutex_contended",
+        StackModel::kShared, workers, total, seconds,
+        static_cast<double>(total) / seconds});
 }
 
 ScenarioResult run_timer_throughput(StackModel model,
@@ -397,12 +805,10 @@ ScenarioResult run_timer_throughput(StackModel model,
             .count();
     require_positive(seconds, "timer throughput elapsed must be positive");
 
-    return ScenarioResult{"timer_sleep",
-                          model,
-                          config.scheduler_count,
-                          config.timer_tasks,
-                          seconds,
-                          static_cast<double>(config.timer_tasks) / seconds};
+    return with_stack_copy_rate(
+        ScenarioResult{"timer_sleep", model, config.scheduler_count,
+                       config.timer_tasks, seconds,
+                       static_cast<double>(config.timer_tasks) / seconds});
 }
 
 ScenarioResult run_hook_io_throughput(StackModel model,
@@ -482,12 +888,188 @@ ScenarioResult run_hook_io_throughput(StackModel model,
             .count();
     require_positive(seconds, "hook throughput elapsed must be positive");
 
-    return ScenarioResult{"hook_socketpair",
-                          model,
-                          2,
-                          config.hook_rounds,
+    return with_stack_copy_rate(
+        ScenarioResult{"hook_socketpair", model, 2, config.hook_rounds, seconds,
+                       static_cast<double>(config.hook_rounds) / seconds});
+}
+
+// 上下文切换场景不经过调度器，直接在主线程和一个独立栈之间往返切换，
+// 每次往返计两次切换。入口函数只能是 void(*)()，因此状态放在文件级变量中。
+Context g_bench_main_context;
+Context g_bench_peer_context;
+ucontext_t g_bench_main_ucontext;
+ucontext_t g_bench_peer_ucontext;
+int g_bench_round_trips = 0;
+
+void context_switch_peer() {
+    for (;;) {
+        Context::swap_context(&g_bench_peer_context, &g_bench_main_context);
+    }
+}
+
+void ucontext_switch_peer() {
+    for (;;) {
+        swapcontext(&g_bench_peer_ucontext, &g_bench_main_ucontext);
+    }
+}
+
+ScenarioResult make_context_switch_result(const char *scenario,
+                                          int round_trips, double seconds) {
+    require_positive(seconds, "context switch elapsed must be positive");
+
+    const int switches = round_trips * 2;
+    return ScenarioResult{scenario,
+                          StackModel::kIndependent,
+                          1,
+                          switches,
                           seconds,
-                          static_cast<double>(config.hook_rounds) / seconds};
+                          static_cast<double>(switches) / seconds};
+}
+
+ScenarioResult run_context_switch(const WorkloadConfig &config) {
+    std::vector<char> stack(kContextSwitchStackSize);
+    g_bench_round_trips =
+        config.context_switches > 1 ? config.context_switches / 2 : 1;
+
+    g_bench_peer_context.make_context(stack.data(), stack.size(),
+                                      &context_switch_peer,
+                                      &g_bench_main_context);
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < g_bench_round_trips; ++i) {
+        Context::swap_context(&g_bench_main_context, &g_bench_peer_context);
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    const bool asm_backend =
+        std::string(Context::backend_name()) == std::string("asm");
+    return make_context_switch_result(
+        asm_backend ? "context_switch_asm" : "context_switch_ucontext",
+        g_bench_round_trips,
+        std::chrono::duration_cast<std::chrono::duration<double>>(end - start)
+            .count());
+}
+
+ScenarioResult run_swapcontext_switch(const WorkloadConfig &config) {
+    std::vector<char> stack(kContextSwitchStackSize);
+    g_bench_round_trips =
+        config.context_switches > 1 ? config.context_switches / 2 : 1;
+
+    require_true(getcontext(&g_bench_peer_ucontext) == 0,
+                 "getcontext failed for swapcontext perf scenario");
+    g_bench_peer_ucontext.uc_stack.ss_sp = stack.data();
+    g_bench_peer_ucontext.uc_stack.ss_size = stack.size();
+    g_bench_peer_ucontext.uc_link = &g_bench_main_ucontext;
+    makecontext(&g_bench_peer_ucontext, &ucontext_switch_peer, 0);
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < g_bench_round_trips; ++i) {
+        swapcontext(&g_bench_main_ucontext, &g_bench_peer_ucontext);
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    return make_context_switch_result(
+        "context_switch_swapcontext", g_bench_round_trips,
+        std::chrono::duration_cast<std::chrono::duration<double>>(end - start)
+            .count());
+}
+
+// 每个线程扮演一个 Processor：大部分任务写入自己的队列，每 4 个任务向其他
+// 队列做一次跨线程投递；自身队列空了就轮询窃取，直到全部任务执行完毕。
+ScenarioResult run_steal_queue_scaling(int workers,
+                                       const WorkloadConfig &config) {
+    const int per_worker = config.steal_queue_tasks / workers > 0
+                               ? config.steal_queue_tasks / workers
+                               : 1;
+    const int total = per_worker * workers;
+
+    std::vector<std::unique_ptr<StealQueue>> queues;
+    for (int i = 0; i < workers; ++i) {
+        queues.emplace_back(new StealQueue());
+    }
+
+    std::atomic<int> executed(0);
+    std::atomic<bool> started(false);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < workers; ++t) {
+        threads.emplace_back([&queues, &executed, &started, workers, t,
+                              per_worker, total]() {
+            StealQueue *own = queues[static_cast<size_t>(t)].get();
+            std::vector<Task> batch;
+            auto run_batch = [&batch]() {
+                for (Task &task : batch) {
+                    task();
+                }
+                batch.clear();
+            };
+
+            while (!started.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+
+            for (int i = 0; i < per_worker; ++i) {
+                Task task = [&executed]() {
+                    executed.fetch_add(1, std::memory_order_relaxed);
+                };
+                if (workers > 1 && (i & 3) == 3) {
+                    const int peer = (t + 1 + (i >> 2)) % workers;
+                    queues[static_cast<size_t>(peer)]->push(std::move(task));
+                } else {
+                    own->push_local(std::move(task));
+                }
+                if ((i & 63) == 63) {
+                    own->drain_some(&batch, 32);
+                    run_batch();
+                }
+            }
+
+            while (executed.load(std::memory_order_relaxed) < total) {
+                own->drain_some(&batch, 64);
+                for (int step = 1; batch.empty() && step < workers; ++step) {
+                    const int victim = (t + step) % workers;
+                    queues[static_cast<size_t>(victim)]->steal(&batch, 64, 0);
+                }
+                run_batch();
+            }
+        });
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    started.store(true, std::memory_order_release);
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    require_eq(executed.load(std::memory_order_relaxed), total,
+               "steal queue executed count mismatch");
+
+    const double seconds =
+        std::chrono::duration_cast<std::chrono::duration<double>>(end - start)
+            .count();
+    require_positive(seconds, "steal queue elapsed must be positive");
+
+    return ScenarioResult{"steal_queue_mp_steal",
+                          StackModel::kShared,
+                          workers,
+                          total,
+                          seconds,
+                          static_cast<double>(total) / seconds};
+}
+
+std::vector<int> scaling_worker_steps(const WorkloadConfig &config) {
+    const unsigned hardware = std::thread::hardware_concurrency();
+    int max_workers = hardware > 0 ? static_cast<int>(hardware) : 1;
+    if (max_workers > config.scheduler_count) {
+        max_workers = config.scheduler_count;
+    }
+
+    std::vector<int> steps;
+    for (int workers = 1; workers < max_workers; workers <<= 1) {
+        steps.push_back(workers);
+    }
+    steps.push_back(max_workers);
+    return steps;
 }
 
 const char *model_name(StackModel model) {
@@ -502,7 +1084,18 @@ void print_result(const ScenarioResult &result) {
               << " elapsed_s=" << std::fixed << std::setprecision(6)
               << result.seconds
               << " throughput_ops_per_s=" << std::setprecision(2)
-              << result.throughput_ops_per_second << std::endl;
+              << result.throughput_ops_per_second
+              << " avg_latency_ns=" << std::setprecision(1)
+              << result.seconds * 1e9 / result.operations;
+    if (result.model == StackModel::kShared) {
+        std::cout << " stack_copy_mb_per_s=" << std::setprecision(2)
+                  << result.stack_copy_bytes_per_second / (1024.0 * 1024.0);
+    }
+    if (result.mallocs_per_operation >= 0) {
+        std::cout << " mallocs_per_op=" << std::setprecision(3)
+                  << result.mallocs_per_operation;
+    }
+    std::cout << std::endl;
 }
 
 int run_benchmark() {
@@ -515,9 +1108,32 @@ int run_benchmark() {
     results.push_back(run_scheduler_throughput(StackModel::kShared, config));
     results.push_back(
         run_scheduler_throughput(StackModel::kIndependent, config));
+    results.push_back(run_spawn_throughput(config));
+    results.push_back(run_remote_spawn_throughput(config, false));
+    results.push_back(run_remote_spawn_throughput(config, true));
     results.push_back(run_channel_throughput(StackModel::kShared, config));
+    results.push_back(run_channel_pingpong(StackModel::kShared, config, 0));
+    results.push_back(
+        run_channel_pingpong(StackModel::kIndependent, config, 0));
+    results.push_back(run_channel_pingpong(StackModel::kShared, config,
+                                           kPingPongBackgroundFibers));
+    const std::vector<int> worker_steps = scaling_worker_steps(config);
+    for (size_t i = 0; i < worker_steps.size(); ++i) {
+        results.push_back(run_channel_mpmc(config, worker_steps[i], 1));
+        results.push_back(
+            run_channel_mpmc(config, worker_steps[i], kChannelBatchSize));
+    }
+    for (size_t i = 0; i < worker_steps.size(); ++i) {
+        results.push_back(run_mutex_contention(config, worker_steps[i], false));
+        results.push_back(run_mutex_contention(config, worker_steps[i], true));
+    }
     results.push_back(run_timer_throughput(StackModel::kShared, config));
     results.push_back(run_hook_io_throughput(StackModel::kShared, config));
+    results.push_back(run_context_switch(config));
+    results.push_back(run_swapcontext_switch(config));
+    for (size_t i = 0; i < worker_steps.size(); ++i) {
+        results.push_back(run_steal_queue_scaling(worker_steps[i], config));
+    }
 
     for (size_t i = 0; i < results.size(); ++i) {
         require_positive(results[i].throughput_ops_per_second,
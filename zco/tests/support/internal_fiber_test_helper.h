@@ -21,9 +21,9 @@ inline Fiber::ptr MakeFiberForTest(Processor *owner, int id, size_t stack_slot,
     const size_t effective_stack_size =
         use_shared_stack ? owner->shared_stack_size(stack_slot) : stack_size;
 
-    return std::make_shared<Fiber>(id, owner, std::move(task),
-                                   effective_stack_size, stack_slot,
-                                   use_shared_stack);
+    return make_intrusive<Fiber>(id, owner, std::move(task),
+                                 effective_stack_size, stack_slot,
+                                 use_shared_stack);
 }
 
 } // namespace test
@@ -0,0 +1,219 @@
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "support/test_fixture.h"
+#include "zco/blocking.h"
+#include "zco/event.h"
+#include "zco/stats.h"
+#include "zco/wait_group.h"
+
+namespace zco {
+namespace {
+
+// 统计大小恰好为 bytes 的可写映射数，用来观察独立栈是否被释放。
+int CountMappings(size_t bytes) {
+    std::ifstream maps("/proc/self/maps");
+    std::string line;
+    int count = 0;
+    while (std::getline(maps, line)) {
+        unsigned long begin = 0;
+        unsigned long end = 0;
+        char perms[5] = {0};
+        if (std::sscanf(line.c_str(), "%lx-%lx %4s", &begin, &end, perms) ==
+                3 &&
+            perms[1] == 'w' && end - begin == bytes) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+class BlockingUnitTest : public test::RuntimeTestBase {
+  protected:
+    void TearDown() override {
+        test::RuntimeTestBase::TearDown();
+        co_blocking_threads(64);
+    }
+};
+
+TEST_F(BlockingUnitTest, ReturnsValueAndRethrowsInFiber) {
+    init(1);
+
+    std::atomic<int> value(0);
+    std::atomic<bool> rethrown(false);
+    std::string moved;
+    Event done;
+    go([&]() {
+        value.store(blocking([]() { return 41 + 1; }));
+        moved = blocking([]() {
+            return std::unique_ptr<std::string>(new std::string("body"));
+        })->c_str();
+        try {
+            blocking([]() { throw std::runtime_error("fsync failed"); });
+        } catch (const std::runtime_error &) {
+            rethrown.store(true);
+        }
+        done.signal();
+    });
+    ASSERT_TRUE(done.wait(2000));
+    EXPECT_EQ(value.load(), 42);
+    EXPECT_EQ(moved, "body");
+    EXPECT_TRUE(rethrown.load());
+}
+
+TEST_F(BlockingUnitTest, RunsInlineOutsideFibers) {
+    const std::thread::id caller = std::this_thread::get_id();
+    std::thread::id runner;
+    blocking([&]() { runner = std::this_thread::get_id(); });
+    EXPECT_EQ(runner, caller);
+}
+
+TEST_F(BlockingUnitTest, SchedulerKeepsRunningWhileCallBlocks) {
+    init(1);
+
+    Event release;
+    std::atomic<bool> other_ran(false);
+    std::atomic<bool> saw_other_first(false);
+    std::atomic<int> origin(-2);
+    std::atomic<int> resumed_on(-3);
+    Event done;
+    go([&]() {
+        origin.store(sched_id());
+        blocking([&]() { release.wait(2000); });
+        saw_other_first.store(other_ran.load());
+        resumed_on.store(sched_id());
+        done.signal();
+    });
+    // 只有一个调度器：blocking 占住它的话这个协程永远跑不起来。
+    go([&]() {
+        other_ran.store(true);
+        release.signal();
+    });
+    ASSERT_TRUE(done.wait(2000));
+    EXPECT_TRUE(saw_other_first.load());
+    EXPECT_EQ(resumed_on.load(), origin.load());
+}
+
+TEST_F(BlockingUnitTest, ResumesOnOriginScheduler) {
+    init(4);
+
+    const int kFibers = 32;
+    std::atomic<int> moved(0);
+    WaitGroup done(kFibers);
+    for (int i = 0; i < kFibers; ++i) {
+        go([&]() {
+            const int before = sched_id();
+            blocking([]() {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            });
+            if (sched_id() != before) {
+                moved.fetch_add(1);
+            }
+            done.done();
+        });
+    }
+    done.wait();
+    EXPECT_EQ(moved.load(), 0);
+}
+
+TEST_F(BlockingUnitTest, CapsConcurrencyAndReportsQueueDepth) {
+    co_blocking_threads(2);
+    init(2);
+
+    const BlockingPoolStats before = stats().blocking;
+    const int kFibers = 8;
+    std::atomic<int> running(0);
+    std::atomic<int> peak(0);
+    WaitGroup done(kFibers);
+    for (int i = 0; i < kFibers; ++i) {
+        go([&]() {
+            blocking([&]() {
+                const int now = running.fetch_add(1) + 1;
+                int seen = peak.load();
+                while (now > seen && !peak.compare_exchange_weak(seen, now)) {
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                running.fetch_sub(1);
+            });
+            done.done();
+        });
+    }
+    done.wait();
+
+    // 协程恢复后阻塞线程才记账，轮询等计数追上。
+    BlockingPoolStats after = stats().blocking;
+    for (int i = 0; i < 1000 && after.completed - before.completed < kFibers;
+         ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        after = stats().blocking;
+    }
+    EXPECT_LE(peak.load(), 2);
+    EXPECT_EQ(after.max_threads, 2u);
+    EXPECT_LE(after.threads, 2u);
+    EXPECT_EQ(after.submitted - before.submitted, uint64_t(kFibers));
+    EXPECT_EQ(after.completed - before.completed, uint64_t(kFibers));
+    EXPECT_GE(after.peak_queued, 3u);
+    EXPECT_GT(after.queue_wait_ns, before.queue_wait_ns);
+    EXPECT_EQ(after.busy_threads, 0u);
+}
+
+TEST_F(BlockingUnitTest, ShutdownWaitsForCallsInFlight) {
+    init(1);
+
+    std::atomic<bool> finished(false);
+    Event started;
+    go([&]() {
+        blocking([&]() {
+            started.signal();
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            finished.store(true);
+        });
+    });
+    ASSERT_TRUE(started.wait(2000));
+    shutdown();
+    EXPECT_TRUE(finished.load());
+}
+
+TEST_F(BlockingUnitTest, ShutdownReleasesStacksOfFibersResumedAfterStop) {
+    // 取一个不常见的栈大小，便于在 /proc/self/maps 里认出这些栈。
+    const size_t kStackSize = 128 * 1024 + 3 * ::getpagesize();
+    co_stack_model(StackModel::kIndependent);
+    co_stack_size(kStackSize);
+    const int before = CountMappings(kStackSize);
+    init(1);
+
+    // 调度器停止后阻塞调用才结束，协程被投回已经停止的处理器。
+    const int kFibers = 8;
+    WaitGroup started(kFibers);
+    for (int i = 0; i < kFibers; ++i) {
+        go([&started]() {
+            started.done();
+            blocking([]() {
+                std::this_thread::sleep_for(std::chrono::milliseconds(30));
+            });
+        });
+    }
+    started.wait();
+    EXPECT_GE(CountMappings(kStackSize), before + kFibers);
+    shutdown();
+    EXPECT_EQ(CountMappings(kStackSize), before);
+}
+
+} // namespace
+} // namespace zco
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    zco::init_logger();
+    return RUN_ALL_TESTS();
+}
@@ -1,4 +1,8 @@
 #include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -119,6 +123,224 @@ TEST_F(ChannelUnitByHeaderTest, CoroutineProducerConsumerWorks) {
     EXPECT_EQ(sum.load(std::memory_order_relaxed), 1275);
 }
 
+TEST_F(ChannelUnitByHeaderTest, ParkedCoroutineReaderReceivesHandedValue) {
+    init(1);
+
+    Channel<int> channel(1, 1000);
+    Event parked;
+    Event done;
+    std::atomic<int> received(0);
+
+    go([&]() {
+        parked.signal();
+        int value = 0;
+        if (channel.read(value)) {
+            received.store(value, std::memory_order_release);
+        }
+        done.signal();
+    });
+
+    ASSERT_TRUE(parked.wait(1000));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    ASSERT_TRUE(channel.write(42));
+    ASSERT_TRUE(done.wait(1000));
+    EXPECT_EQ(received.load(std::memory_order_acquire), 42);
+
+    // 交接不占缓冲区，容量 1 的通道仍可立即写入。
+    EXPECT_TRUE(channel.try_write(43));
+    int out = 0;
+    EXPECT_TRUE(channel.try_read(out));
+    EXPECT_EQ(out, 43);
+}
+
+TEST_F(ChannelUnitByHeaderTest, TimedOutReadersDoNotSwallowLaterWrites) {
+    init(1);
+
+    Channel<int> channel(1);
+    Event done;
+    std::atomic<bool> timed_out(false);
+
+    go([&]() {
+        int value = 0;
+        timed_out.store(!channel.read(value, 20), std::memory_order_release);
+        done.signal();
+    });
+    ASSERT_TRUE(done.wait(1000));
+    EXPECT_TRUE(timed_out.load(std::memory_order_acquire));
+
+    int value = 0;
+    EXPECT_FALSE(channel.read(value, 20));
+
+    EXPECT_TRUE(channel.write(7, 0));
+    EXPECT_TRUE(channel.try_read(value));
+    EXPECT_EQ(value, 7);
+}
+
+TEST_F(ChannelUnitByHeaderTest, ThreadWriterBlocksUntilCoroutineReads) {
+    init(1);
+
+    Channel<int> channel(1, 1000);
+    ASSERT_TRUE(channel.write(1));
+
+    std::atomic<bool> written(false);
+    std::thread writer([&]() {
+        written.store(channel.write(2), std::memory_order_release);
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_FALSE(written.load(std::memory_order_acquire));
+
+    Event done;
+    std::atomic<int> sum(0);
+    go([&]() {
+        int value = 0;
+        for (int i = 0; i < 2 && channel.read(value); ++i) {
+            sum.fetch_add(value, std::memory_order_relaxed);
+        }
+        done.signal();
+    });
+
+    ASSERT_TRUE(done.wait(1000));
+    writer.join();
+    EXPECT_TRUE(written.load(std::memory_order_acquire));
+    EXPECT_EQ(sum.load(std::memory_order_relaxed), 3);
+}
+
+TEST_F(ChannelUnitByHeaderTest, CloseWakesParkedReadersAndWriters) {
+    init(2);
+
+    Channel<int> empty(1);
+    Channel<int> full(1);
+    ASSERT_TRUE(full.write(1));
+    WaitGroup done(2);
+    std::atomic<int> failures(0);
+
+    go([&]() {
+        int value = 0;
+        if (!empty.read(value)) {
+            failures.fetch_add(1, std::memory_order_relaxed);
+        }
+        done.done();
+    });
+    go([&]() {
+        if (!full.write(2)) {
+            failures.fetch_add(1, std::memory_order_relaxed);
+        }
+        done.done();
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    empty.close();
+    full.close();
+    done.wait();
+    EXPECT_EQ(failures.load(std::memory_order_relaxed), 2);
+}
+
+TEST_F(ChannelUnitByHeaderTest, BatchReadWriteMovesElementsInOrder) {
+    Channel<int> channel(4, 100);
+
+    int values[] = {1, 2, 3, 4, 5, 6};
+    EXPECT_EQ(channel.write_n(values, 6, 0), 4u);
+    EXPECT_FALSE(channel.done());
+
+    int out[8] = {0};
+    EXPECT_EQ(channel.read_n(out, 8), 4u);
+    EXPECT_TRUE(channel.done());
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_EQ(out[i], i + 1);
+    }
+
+    EXPECT_EQ(channel.write_n(values + 4, 2), 2u);
+    EXPECT_TRUE(channel.done());
+    EXPECT_EQ(channel.read_n(out, 1), 1u);
+    EXPECT_EQ(out[0], 5);
+    EXPECT_EQ(channel.read_n(out, 8), 1u);
+    EXPECT_EQ(out[0], 6);
+
+    EXPECT_EQ(channel.read_n(out, 8, 0), 0u);
+    EXPECT_EQ(channel.read_n(nullptr, 8, 0), 0u);
+    channel.close();
+    EXPECT_EQ(channel.write_n(values, 1), 0u);
+}
+
+TEST_F(ChannelUnitByHeaderTest, MoveOnlyElementsAreReleasedWithChannel) {
+    std::shared_ptr<int> tracker = std::make_shared<int>(0);
+    {
+        Channel<std::shared_ptr<int>> channel(4);
+        EXPECT_TRUE(channel.write(tracker));
+        EXPECT_TRUE(channel.write(tracker));
+        EXPECT_EQ(tracker.use_count(), 3);
+
+        std::shared_ptr<int> out;
+        EXPECT_TRUE(channel.read(out));
+        EXPECT_EQ(tracker.use_count(), 3);
+        out.reset();
+        EXPECT_EQ(tracker.use_count(), 2);
+    }
+    EXPECT_EQ(tracker.use_count(), 1);
+
+    Channel<std::unique_ptr<int>> owned(2);
+    EXPECT_TRUE(owned.write(std::unique_ptr<int>(new int(5))));
+    std::unique_ptr<int> out;
+    EXPECT_TRUE(owned.read(out));
+    ASSERT_TRUE(out);
+    EXPECT_EQ(*out, 5);
+}
+
+TEST_F(ChannelUnitByHeaderTest, MultiProducerMultiConsumerDeliversEachOnce) {
+    init(4);
+
+    constexpr int kProducers = 4;
+    constexpr int kConsumers = 4;
+    constexpr int kPerProducer = 5000;
+    Channel<int> channel(16);
+    WaitGroup producers(kProducers);
+    WaitGroup consumers(kConsumers + 1);
+    std::vector<std::atomic<int>> seen(kProducers * kPerProducer);
+    for (size_t i = 0; i < seen.size(); ++i) {
+        seen[i].store(0, std::memory_order_relaxed);
+    }
+
+    auto consume = [&]() {
+        int batch[8];
+        size_t count = 0;
+        while ((count = channel.read_n(batch, 8)) > 0) {
+            for (size_t i = 0; i < count; ++i) {
+                seen[static_cast<size_t>(batch[i])].fetch_add(
+                    1, std::memory_order_relaxed);
+            }
+        }
+        consumers.done();
+    };
+    for (int c = 0; c < kConsumers; ++c) {
+        go(consume);
+    }
+    // 线程读端与协程读端混用。
+    std::thread thread_consumer(consume);
+
+    for (int p = 0; p < kProducers; ++p) {
+        go([&, p]() {
+            for (int i = 0; i < kPerProducer; i += 4) {
+                int values[4];
+                for (int k = 0; k < 4; ++k) {
+                    values[k] = p * kPerProducer + i + k;
+                }
+                EXPECT_EQ(channel.write_n(values, 4), 4u);
+            }
+            producers.done();
+        });
+    }
+
+    producers.wait();
+    channel.close();
+    consumers.wait();
+    thread_consumer.join();
+
+    for (size_t i = 0; i < seen.size(); ++i) {
+        ASSERT_EQ(seen[i].load(std::memory_order_relaxed), 1) << i;
+    }
+}
+
 } // namespace
 } // namespace zco
 
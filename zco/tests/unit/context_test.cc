@@ -1,5 +1,8 @@
 #include <gtest/gtest.h>
 
+#include <cstdint>
+#include <vector>
+
 #include "support/test_fixture.h"
 #include "zco/internal/context.h"
 
@@ -8,6 +11,16 @@ namespace {
 
 class ContextUnitTest : public test::RuntimeTestBase {};
 
+Context g_main_context;
+Context g_entry_context;
+int g_entry_steps = 0;
+
+void ping_pong_entry() {
+    ++g_entry_steps;
+    Context::swap_context(&g_entry_context, &g_main_context);
+    ++g_entry_steps;
+}
+
 TEST_F(ContextUnitTest, SwapContextRejectsNullInputs) {
     Context context;
     EXPECT_EQ(Context::swap_context(nullptr, &context), -1);
@@ -19,6 +32,27 @@ TEST_F(ContextUnitTest, GetContextReturnsSuccessOnCurrentThread) {
     EXPECT_EQ(context.get_context(), 0);
 }
 
+TEST_F(ContextUnitTest, MakeContextRunsEntryAndReturnsToLink) {
+    std::vector<char> stack(64 * 1024);
+    g_entry_steps = 0;
+
+    g_entry_context.make_context(stack.data(), stack.size(), &ping_pong_entry,
+                                 &g_main_context);
+    ASSERT_EQ(Context::swap_context(&g_main_context, &g_entry_context), 0);
+    EXPECT_EQ(g_entry_steps, 1);
+
+    // 切出时保存的栈指针必须落在协程栈内。
+    const uintptr_t sp =
+        reinterpret_cast<uintptr_t>(g_entry_context.get_stack_pointer());
+    const uintptr_t low = reinterpret_cast<uintptr_t>(stack.data());
+    EXPECT_GT(sp, low);
+    EXPECT_LT(sp, low + stack.size());
+
+    // 入口函数自然返回后应经由 link 回到主上下文。
+    ASSERT_EQ(Context::swap_context(&g_main_context, &g_entry_context), 0);
+    EXPECT_EQ(g_entry_steps, 2);
+}
+
 } // namespace
 } // namespace zco
 
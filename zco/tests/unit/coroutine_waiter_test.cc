@@ -31,7 +31,10 @@ TEST_F(CoroutineWaiterUnitTest, ValidityChecksHandleDifferentEntryStates) {
     valid.active = std::make_shared<std::atomic<bool>>(true);
     EXPECT_TRUE(is_waiter_entry_valid(valid));
 
+    // 条目持有引用：外部释放不影响有效性，被 claim 移走后才失效。
     fiber.reset();
+    EXPECT_TRUE(is_waiter_entry_valid(valid));
+    valid.coroutine.reset();
     EXPECT_FALSE(is_waiter_entry_valid(valid));
 }
 
@@ -70,9 +73,13 @@ TEST_F(CoroutineWaiterUnitTest, ClaimWaiterReturnsFiberOnlyOnce) {
     waiter.coroutine = fiber;
     waiter.active = std::make_shared<std::atomic<bool>>(true);
 
+    const uint32_t refs = fiber->ref_count();
     Fiber::ptr first = claim_waiter(&waiter);
     ASSERT_NE(first, nullptr);
     EXPECT_EQ(first.get(), fiber.get());
+    // claim 把条目里的引用移交给调用方，不额外增减计数。
+    EXPECT_EQ(fiber->ref_count(), refs);
+    EXPECT_EQ(waiter.coroutine, nullptr);
 
     EXPECT_EQ(claim_waiter(&waiter), nullptr);
     waiter.active.reset();
@@ -192,6 +192,132 @@ TEST_F(EpollerUnitTest, CancelFdRemovesWaitersAndAllowsFdReuse) {
     epoller.stop();
 }
 
+TEST_F(EpollerUnitTest, AttachedFdWaitsWithoutEpollCtl) {
+    Epoller epoller;
+    ASSERT_TRUE(epoller.start());
+
+    int pair[2] = {-1, -1};
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, pair), 0);
+    ASSERT_TRUE(epoller.attach_fd(pair[1]));
+    EXPECT_TRUE(epoller.attach_fd(pair[1]));
+
+    // 首次收割只记录初始可写边沿。
+    epoller.wait_events(0, nullptr);
+
+    const uint64_t syscalls_before = epoller.syscall_count();
+    for (int round = 0; round < 3; ++round) {
+        std::shared_ptr<IoWaiter> waiter = std::make_shared<IoWaiter>();
+        waiter->fd = pair[1];
+        waiter->events = EPOLLIN;
+        waiter->active.store(true, std::memory_order_release);
+        ASSERT_TRUE(epoller.register_waiter(waiter));
+
+        const char marker = 'a';
+        ASSERT_EQ(::write(pair[0], &marker, 1), 1);
+
+        int callback_count = 0;
+        epoller.wait_events(
+            100, [&callback_count, waiter](
+                     const std::shared_ptr<IoWaiter> &ready, uint32_t events) {
+                ++callback_count;
+                EXPECT_EQ(ready.get(), waiter.get());
+                EXPECT_NE(events & EPOLLIN, 0u);
+            });
+        EXPECT_EQ(callback_count, 1);
+
+        char buffer = 0;
+        ASSERT_EQ(::read(pair[1], &buffer, 1), 1);
+        epoller.unregister_waiter(waiter);
+    }
+    // 每轮只有一次 epoll_wait，没有 epoll_ctl。
+    EXPECT_EQ(epoller.syscall_count() - syscalls_before, 3u);
+
+    ::close(pair[0]);
+    ::close(pair[1]);
+    epoller.stop();
+}
+
+TEST_F(EpollerUnitTest, AttachedFdRecordedEdgeDispatchesLaterWaiter) {
+    Epoller epoller;
+    ASSERT_TRUE(epoller.start());
+
+    int pair[2] = {-1, -1};
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, pair), 0);
+    ASSERT_TRUE(epoller.attach_fd(pair[1]));
+
+    const char marker = 'b';
+    ASSERT_EQ(::write(pair[0], &marker, 1), 1);
+    epoller.wait_events(0, nullptr);
+    ASSERT_TRUE(epoller.fd_wait_states_[pair[1]].read_ready);
+
+    std::shared_ptr<IoWaiter> waiter = std::make_shared<IoWaiter>();
+    waiter->fd = pair[1];
+    waiter->events = EPOLLIN;
+    waiter->active.store(true, std::memory_order_release);
+    ASSERT_TRUE(epoller.register_waiter(waiter));
+    EXPECT_FALSE(epoller.fd_wait_states_[pair[1]].read_ready);
+    EXPECT_FALSE(epoller.fd_wait_states_[pair[1]].read_waiter);
+
+    int callback_count = 0;
+    epoller.wait_events(
+        1000, [&callback_count, waiter](const std::shared_ptr<IoWaiter> &ready,
+                                        uint32_t events) {
+            ++callback_count;
+            EXPECT_EQ(ready.get(), waiter.get());
+            EXPECT_NE(events & EPOLLIN, 0u);
+        });
+    EXPECT_EQ(callback_count, 1);
+
+    ::close(pair[0]);
+    ::close(pair[1]);
+    epoller.stop();
+}
+
+TEST_F(EpollerUnitTest, CancelAttachedFdDropsPersistentRegistration) {
+    Epoller epoller;
+    ASSERT_TRUE(epoller.start());
+
+    int pair[2] = {-1, -1};
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, pair), 0);
+    ASSERT_TRUE(epoller.attach_fd(pair[1]));
+
+    const char marker = 'c';
+    ASSERT_EQ(::write(pair[0], &marker, 1), 1);
+    epoller.wait_events(0, nullptr);
+
+    std::shared_ptr<IoWaiter> waiter = std::make_shared<IoWaiter>();
+    waiter->fd = pair[1];
+    waiter->events = EPOLLIN;
+    waiter->active.store(true, std::memory_order_release);
+    waiter->error.store(0, std::memory_order_release);
+    ASSERT_TRUE(epoller.register_waiter(waiter));
+
+    std::vector<std::shared_ptr<IoWaiter>> cancelled =
+        epoller.cancel_fd(pair[1], EBADF);
+    ASSERT_EQ(cancelled.size(), 1u);
+    EXPECT_EQ(cancelled[0].get(), waiter.get());
+    EXPECT_FALSE(epoller.fd_wait_states_[pair[1]].persistent);
+    EXPECT_FALSE(epoller.fd_wait_states_[pair[1]].registered);
+    EXPECT_TRUE(epoller.pending_ready_.empty());
+
+    ::close(pair[0]);
+    ::close(pair[1]);
+    epoller.stop();
+}
+
+TEST_F(EpollerUnitTest, AttachDisabledFallsBackToOnDemandRegistration) {
+    Epoller epoller(false);
+    ASSERT_TRUE(epoller.start());
+
+    int pair[2] = {-1, -1};
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, pair), 0);
+    EXPECT_FALSE(epoller.attach_fd(pair[1]));
+
+    ::close(pair[0]);
+    ::close(pair[1]);
+    epoller.stop();
+}
+
 TEST_F(EpollerUnitTest, RegisterBeforeStartFailsWithEinval) {
     Epoller epoller;
     std::shared_ptr<IoWaiter> waiter = std::make_shared<IoWaiter>();
@@ -0,0 +1,194 @@
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "support/test_fixture.h"
+#include "zco/event.h"
+#include "zco/fiber_local.h"
+#include "zco/wait_group.h"
+
+namespace zco {
+namespace {
+
+class FiberLocalUnitTest : public test::RuntimeTestBase {};
+
+std::atomic<int> constructed(0);
+std::atomic<int> destroyed(0);
+
+struct Tracked {
+    Tracked() { constructed.fetch_add(1); }
+    ~Tracked() { destroyed.fetch_add(1); }
+    int value = 0;
+};
+
+void ResetCounters() {
+    constructed.store(0);
+    destroyed.store(0);
+}
+
+TEST_F(FiberLocalUnitTest, EachFiberSeesItsOwnValue) {
+    init(2);
+
+    FiberLocal<int> local;
+    const int kFibers = 16;
+    std::atomic<int> mismatches(0);
+    WaitGroup done(kFibers);
+    for (int i = 0; i < kFibers; ++i) {
+        go([&, i]() {
+            EXPECT_EQ(local.get(), 0);
+            local.set(i);
+            for (int round = 0; round < 8; ++round) {
+                yield();
+                if (*local != i) {
+                    mismatches.fetch_add(1);
+                }
+            }
+            done.done();
+        });
+    }
+    done.wait();
+    EXPECT_EQ(mismatches.load(), 0);
+}
+
+TEST_F(FiberLocalUnitTest, ConstructsLazilyAndDestroysWhenFiberEnds) {
+    init(1);
+    ResetCounters();
+
+    FiberLocal<Tracked> local;
+    Event untouched;
+    go([&]() { untouched.signal(); });
+    ASSERT_TRUE(untouched.wait(1000));
+    EXPECT_EQ(constructed.load(), 0);
+
+    std::atomic<int> destroyed_while_running(-1);
+    go([&]() {
+        local->value = 7;
+        EXPECT_EQ(local.get().value, 7);
+        EXPECT_TRUE(local.has_value());
+        destroyed_while_running.store(destroyed.load());
+    });
+    // 析构发生在任务返回之后，没有可等的信号，轮询计数。
+    for (int i = 0; i < 1000 && destroyed.load() == 0; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(constructed.load(), 1);
+    EXPECT_EQ(destroyed.load(), 1);
+    EXPECT_EQ(destroyed_while_running.load(), 0);
+}
+
+TEST_F(FiberLocalUnitTest, ResetDestroysAndNextAccessReconstructs) {
+    init(1);
+    ResetCounters();
+
+    FiberLocal<Tracked> local;
+    Event done;
+    go([&]() {
+        local->value = 3;
+        local.reset();
+        EXPECT_EQ(destroyed.load(), 1);
+        EXPECT_FALSE(local.has_value());
+        EXPECT_EQ(local->value, 0);
+        done.signal();
+    });
+    ASSERT_TRUE(done.wait(1000));
+    for (int i = 0; i < 1000 && destroyed.load() < 2; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(constructed.load(), 2);
+    EXPECT_EQ(destroyed.load(), 2);
+}
+
+TEST_F(FiberLocalUnitTest, RecycledFiberStartsEmpty) {
+    init(1);
+
+    FiberLocal<std::string> local;
+    for (int i = 0; i < 4; ++i) {
+        std::atomic<bool> had_value(true);
+        Event done;
+        go([&]() {
+            had_value.store(local.has_value());
+            local.set("request-" + std::to_string(i));
+            done.signal();
+        });
+        ASSERT_TRUE(done.wait(1000));
+        EXPECT_FALSE(had_value.load());
+    }
+}
+
+TEST_F(FiberLocalUnitTest, ManyLocalsSpillPastInlineSlots) {
+    init(1);
+
+    const int kLocals = 3 * kInlineFiberLocalSlots + 1;
+    std::vector<std::unique_ptr<FiberLocal<int>>> locals;
+    for (int i = 0; i < kLocals; ++i) {
+        locals.emplace_back(new FiberLocal<int>());
+    }
+
+    std::atomic<int> mismatches(0);
+    Event done;
+    go([&]() {
+        for (int i = 0; i < kLocals; ++i) {
+            locals[i]->set(i * 10);
+        }
+        yield();
+        for (int i = 0; i < kLocals; ++i) {
+            if (locals[i]->get() != i * 10) {
+                mismatches.fetch_add(1);
+            }
+        }
+        done.signal();
+    });
+    ASSERT_TRUE(done.wait(1000));
+    EXPECT_EQ(mismatches.load(), 0);
+}
+
+TEST_F(FiberLocalUnitTest, ThreadsOutsideFibersHaveTheirOwnValue) {
+    init(1);
+
+    FiberLocal<int> local;
+    local.set(5);
+
+    std::atomic<int> in_fiber(-1);
+    Event done;
+    go([&]() {
+        in_fiber.store(local.get());
+        done.signal();
+    });
+    ASSERT_TRUE(done.wait(1000));
+
+    int in_thread = -1;
+    std::thread([&]() { in_thread = local.get(); }).join();
+
+    EXPECT_EQ(in_fiber.load(), 0);
+    EXPECT_EQ(in_thread, 0);
+    EXPECT_EQ(local.get(), 5);
+}
+
+TEST_F(FiberLocalUnitTest, ReusedIndexDropsTheStaleValue) {
+    ResetCounters();
+
+    std::unique_ptr<FiberLocal<Tracked>> first(new FiberLocal<Tracked>());
+    (*first)->value = 9;
+    first.reset();
+    EXPECT_EQ(destroyed.load(), 0);
+
+    // 新的 FiberLocal 复用同一下标，旧值不会被当成自己的值。
+    FiberLocal<Tracked> second;
+    EXPECT_FALSE(second.has_value());
+    EXPECT_EQ(second->value, 0);
+    EXPECT_EQ(destroyed.load(), 1);
+    second.reset();
+}
+
+} // namespace
+} // namespace zco
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    zco::init_logger();
+    return RUN_ALL_TESTS();
+}
@@ -129,7 +129,7 @@ TEST_F(FiberUnitTest, IndependentStackRequiresPositiveStackSize) {
 
     EXPECT_THROW(
         {
-            Fiber::ptr fiber = std::make_shared<Fiber>(
+            Fiber::ptr fiber = make_intrusive<Fiber>(
                 11, &processor, Task([]() {}), 0, 0, false);
             (void)fiber;
         },
@@ -141,7 +141,7 @@ TEST_F(FiberUnitTest, SharedStackRejectsOutOfRangeSlot) {
 
     EXPECT_THROW(
         {
-            Fiber::ptr fiber = std::make_shared<Fiber>(
+            Fiber::ptr fiber = make_intrusive<Fiber>(
                 13, &processor, Task([]() {}), 64 * 1024, 7, true);
             (void)fiber;
         },
@@ -195,7 +195,7 @@ TEST_F(FiberUnitTest, IndependentStackAllowsOutOfRangeStackSlot) {
 TEST_F(FiberUnitTest, NullOwnerIsRejected) {
     EXPECT_THROW(
         {
-            Fiber::ptr fiber = std::make_shared<Fiber>(
+            Fiber::ptr fiber = make_intrusive<Fiber>(
                 21, nullptr, Task([]() {}), 64 * 1024, 0, true);
             (void)fiber;
         },
@@ -0,0 +1,178 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "support/test_fixture.h"
+#include "zco/event.h"
+#include "zco/file.h"
+#include "zco/internal/io_uring_poller.h"
+#include "zco/stats.h"
+#include "zco/wait_group.h"
+
+namespace zco {
+namespace {
+
+class FileUnitTest : public test::RuntimeTestBase {
+  protected:
+    void SetUp() override {
+        test::RuntimeTestBase::SetUp();
+        char path[] = "/tmp/zco_file_test_XXXXXX";
+        const int fd = ::mkstemp(path);
+        ASSERT_GE(fd, 0);
+        ::close(fd);
+        path_ = path;
+    }
+
+    void TearDown() override {
+        test::RuntimeTestBase::TearDown();
+        ::unsetenv("ZCO_POLLER");
+        ::unlink(path_.c_str());
+    }
+
+    // 在协程里写入、刷盘再读回，返回读到的内容。
+    std::string RoundTrip(const std::string &payload) {
+        std::string read_back;
+        std::atomic<int> failures(0);
+        Event done;
+        go([&]() {
+            const int fd = file::open(path_.c_str(), O_RDWR | O_TRUNC);
+            if (fd < 0) {
+                failures.fetch_add(1);
+                done.signal();
+                return;
+            }
+            std::vector<char> out(payload.begin(), payload.end());
+            if (file::pwrite(fd, out.data(), out.size(), 0) !=
+                    static_cast<ssize_t>(out.size()) ||
+                file::fsync(fd) != 0 || file::fdatasync(fd) != 0) {
+                failures.fetch_add(1);
+            }
+            std::vector<char> in(payload.size() + 16);
+            const ssize_t n = file::pread(fd, in.data(), in.size(), 0);
+            if (n >= 0) {
+                read_back.assign(in.data(), static_cast<size_t>(n));
+            } else {
+                failures.fetch_add(1);
+            }
+            ::close(fd);
+            done.signal();
+        });
+        EXPECT_TRUE(done.wait(5000));
+        EXPECT_EQ(failures.load(), 0);
+        return read_back;
+    }
+
+    std::string path_;
+};
+
+TEST_F(FileUnitTest, WritesFlushesAndReadsBackInFiber) {
+    init(1);
+
+    const uint64_t before = stats().blocking.submitted;
+    const std::string payload(64 * 1024 + 7, 'z');
+    EXPECT_EQ(RoundTrip(payload), payload);
+    if (IoUringPoller::supported()) {
+        // io_uring 直接执行文件操作，不经过阻塞线程池。
+        EXPECT_EQ(stats().blocking.submitted, before);
+    }
+}
+
+TEST_F(FileUnitTest, BlockingPoolFallbackWithoutIoUring) {
+    ASSERT_EQ(::setenv("ZCO_POLLER", "epoll", 1), 0);
+    init(1);
+
+    const uint64_t before = stats().blocking.submitted;
+    EXPECT_EQ(RoundTrip("fallback"), "fallback");
+    // open、pwrite、fsync、fdatasync、pread 各经过一次线程池。
+    EXPECT_EQ(stats().blocking.submitted - before, 5u);
+}
+
+TEST_F(FileUnitTest, SharedStackBuffersSurviveOtherFibers) {
+    co_stack_num(1);
+    init(1);
+
+    const int fd = ::open(path_.c_str(), O_RDWR);
+    ASSERT_GE(fd, 0);
+
+    // 所有协程共用一块共享栈，各自用栈上的缓冲区读写不同区段。
+    const int kFibers = 16;
+    const size_t kChunk = 512;
+    std::atomic<int> mismatches(0);
+    WaitGroup done(kFibers);
+    for (int i = 0; i < kFibers; ++i) {
+        go([&, i]() {
+            char out[kChunk];
+            std::memset(out, 'a' + i, sizeof(out));
+            const off_t offset = static_cast<off_t>(i * kChunk);
+            if (file::pwrite(fd, out, sizeof(out), offset) !=
+                static_cast<ssize_t>(sizeof(out))) {
+                mismatches.fetch_add(1);
+            }
+            char in[kChunk];
+            std::memset(in, 0, sizeof(in));
+            if (file::pread(fd, in, sizeof(in), offset) !=
+                    static_cast<ssize_t>(sizeof(in)) ||
+                std::memcmp(in, out, sizeof(in)) != 0) {
+                mismatches.fetch_add(1);
+            }
+            done.done();
+        });
+    }
+    done.wait();
+    ::close(fd);
+    EXPECT_EQ(mismatches.load(), 0);
+}
+
+TEST_F(FileUnitTest, ReportsErrnoLikeLibc) {
+    init(1);
+
+    std::atomic<int> open_errno(0);
+    std::atomic<int> read_errno(0);
+    std::atomic<int> offset_errno(0);
+    Event done;
+    go([&]() {
+        if (file::open("/nonexistent/zco_file_test", O_RDONLY) < 0) {
+            open_errno.store(errno);
+        }
+        char buffer[8];
+        if (file::pread(-1, buffer, sizeof(buffer), 0) < 0) {
+            read_errno.store(errno);
+        }
+        if (file::pread(0, buffer, sizeof(buffer), -1) < 0) {
+            offset_errno.store(errno);
+        }
+        done.signal();
+    });
+    ASSERT_TRUE(done.wait(2000));
+    EXPECT_EQ(open_errno.load(), ENOENT);
+    EXPECT_EQ(read_errno.load(), EBADF);
+    EXPECT_EQ(offset_errno.load(), EINVAL);
+}
+
+TEST_F(FileUnitTest, WorksOutsideFibers) {
+    const int fd = file::open(path_.c_str(), O_RDWR | O_TRUNC);
+    ASSERT_GE(fd, 0);
+    EXPECT_EQ(file::pwrite(fd, "thread", 6, 0), 6);
+    EXPECT_EQ(file::fsync(fd), 0);
+    char buffer[8] = {0};
+    EXPECT_EQ(file::pread(fd, buffer, sizeof(buffer), 0), 6);
+    EXPECT_STREQ(buffer, "thread");
+    ::close(fd);
+}
+
+} // namespace
+} // namespace zco
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    zco::init_logger();
+    return RUN_ALL_TESTS();
+}
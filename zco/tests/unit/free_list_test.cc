@@ -0,0 +1,97 @@
+#include <atomic>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "support/test_fixture.h"
+#include "zco/internal/free_list.h"
+
+namespace zco {
+namespace {
+
+class FreeListUnitTest : public test::RuntimeTestBase {};
+
+// 每个块只需容纳一个指针。
+struct Block {
+    void *storage[2];
+};
+
+TEST_F(FreeListUnitTest, PopsInLifoOrderAndTracksSize) {
+    FreeList list;
+    Block blocks[3];
+    EXPECT_EQ(list.pop(), nullptr);
+
+    for (Block &block : blocks) {
+        ASSERT_TRUE(list.reserve(8));
+        list.push(&block);
+    }
+    EXPECT_EQ(list.size(), 3u);
+    EXPECT_EQ(list.pop(), &blocks[2]);
+    EXPECT_EQ(list.pop(), &blocks[1]);
+    EXPECT_EQ(list.pop(), &blocks[0]);
+    EXPECT_EQ(list.pop(), nullptr);
+    EXPECT_EQ(list.size(), 0u);
+}
+
+TEST_F(FreeListUnitTest, ReserveRespectsLimit) {
+    FreeList list;
+    Block blocks[2];
+    ASSERT_TRUE(list.reserve(2));
+    list.push(&blocks[0]);
+    ASSERT_TRUE(list.reserve(2));
+    list.push(&blocks[1]);
+    EXPECT_FALSE(list.reserve(2));
+    EXPECT_EQ(list.size(), 2u);
+
+    std::vector<void *> released;
+    list.clear([&](void *node) { released.push_back(node); });
+    EXPECT_EQ(released.size(), 2u);
+    EXPECT_EQ(list.size(), 0u);
+    EXPECT_EQ(list.pop(), nullptr);
+}
+
+TEST_F(FreeListUnitTest, ConcurrentPushersWithSinglePopper) {
+    constexpr int kThreads = 4;
+    constexpr int kPerThread = 2000;
+    FreeList list;
+    std::vector<Block> blocks(kThreads * kPerThread);
+
+    std::atomic<int> rejected(0);
+    std::vector<std::thread> pushers;
+    for (int t = 0; t < kThreads; ++t) {
+        pushers.emplace_back([&, t]() {
+            for (int i = 0; i < kPerThread; ++i) {
+                if (!list.reserve(blocks.size())) {
+                    rejected.fetch_add(1);
+                    continue;
+                }
+                list.push(&blocks[t * kPerThread + i]);
+            }
+        });
+    }
+
+    // 唯一的弹出方与归还方并发运行，每个块恰好被取出一次。
+    std::set<void *> popped;
+    while (popped.size() < blocks.size() && rejected.load() == 0) {
+        if (void *node = list.pop()) {
+            EXPECT_TRUE(popped.insert(node).second);
+        }
+    }
+    for (std::thread &pusher : pushers) {
+        pusher.join();
+    }
+    EXPECT_EQ(rejected.load(), 0);
+    EXPECT_EQ(popped.size(), blocks.size());
+    EXPECT_EQ(list.pop(), nullptr);
+}
+
+} // namespace
+} // namespace zco
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    zco::init_logger();
+    return RUN_ALL_TESTS();
+}
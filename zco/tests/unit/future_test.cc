@@ -0,0 +1,127 @@
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "support/test_fixture.h"
+#include "zco/event.h"
+#include "zco/future.h"
+
+namespace zco {
+namespace {
+
+class FutureUnitTest : public test::RuntimeTestBase {};
+
+TEST_F(FutureUnitTest, DefaultFutureIsInvalid) {
+    Future<int> future;
+    EXPECT_FALSE(future.valid());
+    EXPECT_FALSE(future.ready());
+    EXPECT_FALSE(future.wait(0));
+    EXPECT_THROW(future.get(), std::future_error);
+}
+
+TEST_F(FutureUnitTest, ValueIsSetOnceAndSharedByCopies) {
+    Promise<std::string> promise;
+    Future<std::string> future = promise.get_future();
+    Future<std::string> copy = future;
+
+    EXPECT_FALSE(future.ready());
+    EXPECT_FALSE(future.wait(0));
+    EXPECT_TRUE(promise.set_value("zco"));
+    EXPECT_FALSE(promise.set_value("again"));
+    EXPECT_FALSE(promise.set_exception(
+        std::make_exception_ptr(std::runtime_error("late"))));
+
+    EXPECT_TRUE(future.ready());
+    EXPECT_EQ(future.get(), "zco");
+    EXPECT_EQ(copy.get(), "zco");
+    EXPECT_EQ(future.get(), "zco");
+}
+
+TEST_F(FutureUnitTest, ExceptionIsRethrownByGet) {
+    Promise<int> promise;
+    Future<int> future = promise.get_future();
+    promise.set_exception(std::make_exception_ptr(std::runtime_error("boom")));
+
+    EXPECT_TRUE(future.ready());
+    EXPECT_THROW(future.get(), std::runtime_error);
+}
+
+TEST_F(FutureUnitTest, DroppedPromiseBreaksFuture) {
+    Future<void> future;
+    {
+        Promise<void> promise;
+        future = promise.get_future();
+    }
+
+    ASSERT_TRUE(future.ready());
+    try {
+        future.get();
+        FAIL() << "expected broken_promise";
+    } catch (const std::future_error &error) {
+        EXPECT_EQ(error.code(), std::future_errc::broken_promise);
+    }
+}
+
+TEST_F(FutureUnitTest, MovedFromPromiseDoesNotBreakFuture) {
+    Promise<int> promise;
+    Future<int> future = promise.get_future();
+    {
+        Promise<int> moved(std::move(promise));
+        EXPECT_FALSE(promise.set_value(1));
+        EXPECT_TRUE(moved.set_value(2));
+    }
+    EXPECT_EQ(future.get(), 2);
+}
+
+TEST_F(FutureUnitTest, CoroutineWaitsForValueFromThread) {
+    init(1);
+
+    Promise<int> promise;
+    Future<int> future = promise.get_future();
+    Event waiting;
+    Event done;
+    std::atomic<int> value(0);
+    std::atomic<bool> early(true);
+
+    go([&]() {
+        early.store(future.wait(10));
+        waiting.signal();
+        value.store(future.get());
+        done.signal();
+    });
+
+    ASSERT_TRUE(waiting.wait(1000));
+    EXPECT_FALSE(early.load());
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    promise.set_value(42);
+    ASSERT_TRUE(done.wait(1000));
+    EXPECT_EQ(value.load(), 42);
+}
+
+TEST_F(FutureUnitTest, ThreadWaitsForVoidFromCoroutine) {
+    init(1);
+
+    Promise<void> promise;
+    Future<void> future = promise.get_future();
+    go([&promise]() {
+        sleep_for(10);
+        promise.set_value();
+    });
+
+    EXPECT_TRUE(future.wait(1000));
+    EXPECT_NO_THROW(future.get());
+}
+
+} // namespace
+} // namespace zco
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    zco::init_logger();
+    return RUN_ALL_TESTS();
+}
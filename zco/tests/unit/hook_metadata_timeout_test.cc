@@ -1175,7 +1175,10 @@ TEST_F(HookMetadataTimeoutUnitTest,
               0);
 
     WaitGroup done(2);
-    go([&done, listen_fd]() {
+    // 两个协程可能落在不同调度器上，先让 accept 超时再发起连接，
+    // 否则已完成握手的连接会让零超时 accept 直接成功。
+    Event accept_tried;
+    go([&done, &accept_tried, listen_fd]() {
         sockaddr_storage peer;
         std::memset(&peer, 0, sizeof(peer));
         socklen_t peer_len = sizeof(peer);
@@ -1184,10 +1187,12 @@ TEST_F(HookMetadataTimeoutUnitTest,
                             &peer_len, 0),
                   -1);
         EXPECT_EQ(errno, ETIMEDOUT);
+        accept_tried.signal();
         done.done();
     });
 
-    go([&done, listen_addr]() {
+    go([&done, &accept_tried, listen_addr]() {
+        accept_tried.wait();
         const int client_fd = co_tcp_socket(AF_INET);
         ASSERT_GE(client_fd, 0);
         errno = 0;
@@ -1,8 +1,14 @@
 #include <errno.h>
 #include <fcntl.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/select.h>
 #include <sys/socket.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <atomic>
+
 #include <gtest/gtest.h>
 
 #include "support/test_fixture.h"
@@ -259,6 +265,202 @@ TEST_F(HookUnitByHeaderTest, OutsideCoroutineIoHooksFailWithEperm) {
     EXPECT_EQ(co_close(pair[1]), 0);
 }
 
+TEST_F(HookUnitByHeaderTest, CoPollZeroTimeoutNeverParks) {
+    int pair[2] = {-1, -1};
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, pair), 0);
+
+    // 零超时只做一次真实 poll，不要求协程上下文。
+    pollfd pfd;
+    pfd.fd = pair[0];
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    EXPECT_EQ(co_poll(&pfd, 1, 0), 0);
+
+    ASSERT_EQ(::write(pair[1], "x", 1), 1);
+    EXPECT_EQ(co_poll(&pfd, 1, 0), 1);
+    EXPECT_TRUE(pfd.revents & POLLIN);
+
+    errno = 0;
+    pfd.revents = 0;
+    char byte = 0;
+    ASSERT_EQ(::read(pair[0], &byte, 1), 1);
+    EXPECT_EQ(co_poll(&pfd, 1, 10), -1);
+    EXPECT_EQ(errno, EPERM);
+
+    EXPECT_EQ(co_close(pair[0]), 0);
+    EXPECT_EQ(co_close(pair[1]), 0);
+}
+
+TEST_F(HookUnitByHeaderTest, CoPollWaitsOnSeveralFdsAndTimesOut) {
+    init(1);
+
+    int first[2] = {-1, -1};
+    int second[2] = {-1, -1};
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, first), 0);
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, second), 0);
+
+    int timed_out = -1;
+    int ready = -1;
+    short revents[2] = {0, 0};
+    WaitGroup done(2);
+    go([&]() {
+        pollfd fds[2];
+        fds[0].fd = first[0];
+        fds[0].events = POLLIN;
+        fds[1].fd = second[0];
+        fds[1].events = POLLIN;
+        timed_out = co_poll(fds, 2, 20);
+
+        ready = co_poll(fds, 2, 1000);
+        revents[0] = fds[0].revents;
+        revents[1] = fds[1].revents;
+        done.done();
+    });
+    go([&]() {
+        co_sleep_for(40);
+        EXPECT_EQ(::write(second[1], "p", 1), 1);
+        done.done();
+    });
+    done.wait();
+
+    EXPECT_EQ(timed_out, 0);
+    EXPECT_EQ(ready, 1);
+    EXPECT_EQ(revents[0], 0);
+    EXPECT_TRUE(revents[1] & POLLIN);
+
+    for (int fd : {first[0], first[1], second[0], second[1]}) {
+        EXPECT_EQ(co_close(fd), 0);
+    }
+}
+
+TEST_F(HookUnitByHeaderTest, CoPollSharesFdWithAnotherWaiter) {
+    init(1);
+
+    int pair[2] = {-1, -1};
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, pair), 0);
+
+    // 两个协程同时等同一 fd 的读事件，后登记的一方退化为定时重查。
+    std::atomic<int> woke(0);
+    WaitGroup done(3);
+    for (int i = 0; i < 2; ++i) {
+        go([&]() {
+            pollfd pfd;
+            pfd.fd = pair[0];
+            pfd.events = POLLIN;
+            pfd.revents = 0;
+            if (co_poll(&pfd, 1, 1000) == 1 && (pfd.revents & POLLIN)) {
+                woke.fetch_add(1);
+            }
+            done.done();
+        });
+    }
+    go([&]() {
+        co_sleep_for(20);
+        EXPECT_EQ(::write(pair[1], "s", 1), 1);
+        done.done();
+    });
+    done.wait();
+
+    EXPECT_EQ(woke.load(), 2);
+    EXPECT_EQ(co_close(pair[0]), 0);
+    EXPECT_EQ(co_close(pair[1]), 0);
+}
+
+TEST_F(HookUnitByHeaderTest, CoSelectFillsReadyFdSets) {
+    init(1);
+
+    int first[2] = {-1, -1};
+    int second[2] = {-1, -1};
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, first), 0);
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, second), 0);
+    const int max_fd = std::max(std::max(first[0], first[1]),
+                                std::max(second[0], second[1]));
+
+    int immediate = -1;
+    bool writable = false;
+    int waited = -1;
+    bool first_readable = true;
+    bool second_readable = false;
+    WaitGroup done(2);
+    go([&]() {
+        fd_set reads;
+        fd_set writes;
+        FD_ZERO(&reads);
+        FD_ZERO(&writes);
+        FD_SET(first[0], &reads);
+        FD_SET(first[1], &writes);
+        timeval zero = {0, 0};
+        immediate = co_select(max_fd + 1, &reads, &writes, nullptr, &zero);
+        writable = FD_ISSET(first[1], &writes);
+
+        FD_ZERO(&reads);
+        FD_SET(first[0], &reads);
+        FD_SET(second[0], &reads);
+        timeval limit = {1, 0};
+        waited = co_select(max_fd + 1, &reads, nullptr, nullptr, &limit);
+        first_readable = FD_ISSET(first[0], &reads);
+        second_readable = FD_ISSET(second[0], &reads);
+        done.done();
+    });
+    go([&]() {
+        co_sleep_for(20);
+        EXPECT_EQ(::write(second[1], "s", 1), 1);
+        done.done();
+    });
+    done.wait();
+
+    EXPECT_EQ(immediate, 1);
+    EXPECT_TRUE(writable);
+    EXPECT_EQ(waited, 1);
+    EXPECT_FALSE(first_readable);
+    EXPECT_TRUE(second_readable);
+
+    for (int fd : {first[0], first[1], second[0], second[1]}) {
+        EXPECT_EQ(co_close(fd), 0);
+    }
+}
+
+TEST_F(HookUnitByHeaderTest, CoEpollWaitParksOnEpollFd) {
+    init(1);
+
+    int pair[2] = {-1, -1};
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, pair), 0);
+    const int epfd = ::epoll_create1(EPOLL_CLOEXEC);
+    ASSERT_GE(epfd, 0);
+    epoll_event interest;
+    interest.events = EPOLLIN;
+    interest.data.fd = pair[0];
+    ASSERT_EQ(::epoll_ctl(epfd, EPOLL_CTL_ADD, pair[0], &interest), 0);
+
+    int timed_out = -1;
+    int ready = -1;
+    int ready_fd = -1;
+    WaitGroup done(2);
+    go([&]() {
+        epoll_event events[4];
+        timed_out = co_epoll_wait(epfd, events, 4, 10);
+        ready = co_epoll_wait(epfd, events, 4, 1000);
+        if (ready > 0) {
+            ready_fd = events[0].data.fd;
+        }
+        done.done();
+    });
+    go([&]() {
+        co_sleep_for(30);
+        EXPECT_EQ(::write(pair[1], "e", 1), 1);
+        done.done();
+    });
+    done.wait();
+
+    EXPECT_EQ(timed_out, 0);
+    EXPECT_EQ(ready, 1);
+    EXPECT_EQ(ready_fd, pair[0]);
+
+    EXPECT_EQ(co_close(epfd), 0);
+    EXPECT_EQ(co_close(pair[0]), 0);
+    EXPECT_EQ(co_close(pair[1]), 0);
+}
+
 } // namespace
 } // namespace zco
 
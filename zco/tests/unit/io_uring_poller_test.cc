@@ -0,0 +1,202 @@
+#include <errno.h>
+#include <stdlib.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+
+#include <gtest/gtest.h>
+
+#include "support/test_fixture.h"
+#include "zco/internal/io_uring_poller.h"
+
+namespace zco {
+namespace {
+
+class IoUringPollerUnitTest : public test::RuntimeTestBase {
+  protected:
+    void SetUp() override {
+        test::RuntimeTestBase::SetUp();
+        if (!IoUringPoller::supported()) {
+            GTEST_SKIP() << "io_uring is not supported by this kernel";
+        }
+    }
+};
+
+std::shared_ptr<IoWaiter> make_waiter(int fd, uint32_t events) {
+    std::shared_ptr<IoWaiter> waiter = std::make_shared<IoWaiter>();
+    waiter->fd = fd;
+    waiter->events = events;
+    waiter->active.store(true, std::memory_order_release);
+    waiter->error.store(0, std::memory_order_release);
+    return waiter;
+}
+
+TEST_F(IoUringPollerUnitTest, StartWakeStopFlowWorks) {
+    IoUringPoller poller;
+    ASSERT_TRUE(poller.start());
+    EXPECT_STREQ(poller.name(), "io_uring");
+
+    poller.wake();
+    int callback_count = 0;
+    poller.wait_events(5, [&callback_count](
+                              const std::shared_ptr<IoWaiter> &waiter,
+                              uint32_t events) {
+        (void)waiter;
+        (void)events;
+        ++callback_count;
+    });
+
+    EXPECT_EQ(callback_count, 0);
+    EXPECT_GT(poller.syscall_count(), 0u);
+    poller.stop();
+    poller.stop();
+}
+
+TEST_F(IoUringPollerUnitTest, WaitEventsDispatchesReadyWaiter) {
+    IoUringPoller poller;
+    ASSERT_TRUE(poller.start());
+
+    int pair[2] = {-1, -1};
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, pair), 0);
+
+    std::shared_ptr<IoWaiter> waiter = make_waiter(pair[1], EPOLLIN);
+    ASSERT_TRUE(poller.register_waiter(waiter));
+
+    const char marker = 'a';
+    ASSERT_EQ(::write(pair[0], &marker, 1), 1);
+
+    // 注册只排队 SQE，提交与等待合并为同一次 io_uring_enter。
+    const uint64_t before = poller.syscall_count();
+    int callback_count = 0;
+    poller.wait_events(
+        100, [&callback_count, waiter](const std::shared_ptr<IoWaiter> &ready,
+                                       uint32_t events) {
+            ++callback_count;
+            EXPECT_EQ(ready.get(), waiter.get());
+            EXPECT_NE(events & EPOLLIN, 0u);
+        });
+
+    EXPECT_EQ(callback_count, 1);
+    EXPECT_EQ(poller.syscall_count() - before, 1u);
+
+    ::close(pair[0]);
+    ::close(pair[1]);
+    poller.stop();
+}
+
+TEST_F(IoUringPollerUnitTest, UnregisteredWaiterIsNotDispatched) {
+    IoUringPoller poller;
+    ASSERT_TRUE(poller.start());
+
+    int pair[2] = {-1, -1};
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, pair), 0);
+
+    std::shared_ptr<IoWaiter> stale = make_waiter(pair[1], EPOLLIN);
+    ASSERT_TRUE(poller.register_waiter(stale));
+    poller.wait_events(0, nullptr);
+    poller.unregister_waiter(stale);
+
+    // 旧 poll 被撤销后重新注册，迟到的完成事件只能交给新的 waiter。
+    std::shared_ptr<IoWaiter> fresh = make_waiter(pair[1], EPOLLIN);
+    ASSERT_TRUE(poller.register_waiter(fresh));
+
+    const char marker = 'b';
+    ASSERT_EQ(::write(pair[0], &marker, 1), 1);
+
+    int callback_count = 0;
+    for (int i = 0; i < 3 && callback_count == 0; ++i) {
+        poller.wait_events(50, [&callback_count, fresh](
+                                   const std::shared_ptr<IoWaiter> &ready,
+                                   uint32_t events) {
+            (void)events;
+            ++callback_count;
+            EXPECT_EQ(ready.get(), fresh.get());
+        });
+    }
+    EXPECT_EQ(callback_count, 1);
+
+    ::close(pair[0]);
+    ::close(pair[1]);
+    poller.stop();
+}
+
+TEST_F(IoUringPollerUnitTest, CancelFdReturnsWaitersWithError) {
+    IoUringPoller poller;
+    ASSERT_TRUE(poller.start());
+
+    int pair[2] = {-1, -1};
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, pair), 0);
+
+    std::shared_ptr<IoWaiter> waiter = make_waiter(pair[1], EPOLLIN);
+    ASSERT_TRUE(poller.register_waiter(waiter));
+    poller.wait_events(0, nullptr);
+
+    std::vector<std::shared_ptr<IoWaiter>> cancelled =
+        poller.cancel_fd(pair[1], EBADF);
+    ASSERT_EQ(cancelled.size(), 1u);
+    EXPECT_EQ(cancelled[0].get(), waiter.get());
+    EXPECT_EQ(waiter->error.load(std::memory_order_acquire), EBADF);
+    EXPECT_TRUE(poller.cancel_fd(pair[1], EBADF).empty());
+
+    const char marker = 'c';
+    ASSERT_EQ(::write(pair[0], &marker, 1), 1);
+    int callback_count = 0;
+    poller.wait_events(
+        10, [&callback_count](const std::shared_ptr<IoWaiter> &ready,
+                              uint32_t events) {
+            (void)ready;
+            (void)events;
+            ++callback_count;
+        });
+    EXPECT_EQ(callback_count, 0);
+
+    ::close(pair[0]);
+    ::close(pair[1]);
+    poller.stop();
+}
+
+TEST_F(IoUringPollerUnitTest, InvalidFdSurfacesErrorOnCompletion) {
+    IoUringPoller poller;
+    ASSERT_TRUE(poller.start());
+
+    std::shared_ptr<IoWaiter> waiter = make_waiter(1 << 20, EPOLLIN);
+    ASSERT_TRUE(poller.register_waiter(waiter));
+
+    int callback_count = 0;
+    poller.wait_events(
+        100, [&callback_count, waiter](const std::shared_ptr<IoWaiter> &ready,
+                                       uint32_t events) {
+            ++callback_count;
+            EXPECT_EQ(ready.get(), waiter.get());
+            EXPECT_NE(events & EPOLLERR, 0u);
+        });
+
+    EXPECT_EQ(callback_count, 1);
+    EXPECT_EQ(waiter->error.load(std::memory_order_acquire), EBADF);
+    poller.stop();
+}
+
+TEST_F(IoUringPollerUnitTest, DefaultPollerHonorsEnvironmentOverride) {
+    ASSERT_EQ(::setenv("ZCO_POLLER", "epoll", 1), 0);
+    std::unique_ptr<Poller> epoll_poller = create_default_poller();
+    ASSERT_NE(epoll_poller, nullptr);
+    EXPECT_STREQ(epoll_poller->name(), "epoll");
+
+    ASSERT_EQ(::setenv("ZCO_POLLER", "io_uring", 1), 0);
+    std::unique_ptr<Poller> uring_poller = create_default_poller();
+    ASSERT_NE(uring_poller, nullptr);
+    EXPECT_STREQ(uring_poller->name(), "io_uring");
+
+    ASSERT_EQ(::unsetenv("ZCO_POLLER"), 0);
+}
+
+} // namespace
+} // namespace zco
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    zco::init_logger();
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,88 @@
+#include <cstdint>
+
+#include <gtest/gtest.h>
+
+#include "zco/internal/latency_histogram.h"
+#include "zco/zco_log.h"
+
+namespace zco {
+namespace {
+
+TEST(LatencyHistogramUnitTest, BucketsAreContiguousAndBounded) {
+    // 每个桶的上界加一正好落进下一个桶，整个 uint64_t 范围没有空隙。
+    for (size_t i = 0; i + 1 < LatencyHistogram::kBucketCount; ++i) {
+        const uint64_t upper = LatencyHistogram::bucket_upper_bound(i);
+        EXPECT_EQ(LatencyHistogram::bucket_index(upper), i);
+        EXPECT_EQ(LatencyHistogram::bucket_index(upper + 1), i + 1);
+    }
+    EXPECT_EQ(LatencyHistogram::bucket_index(UINT64_MAX),
+              LatencyHistogram::kBucketCount - 1);
+    EXPECT_EQ(LatencyHistogram::bucket_upper_bound(
+                  LatencyHistogram::kBucketCount - 1),
+              UINT64_MAX);
+}
+
+TEST(LatencyHistogramUnitTest, RelativeErrorStaysWithinOneSubBucket) {
+    for (uint64_t value : {9ULL, 100ULL, 1000ULL, 123456ULL, 987654321ULL}) {
+        const uint64_t upper = LatencyHistogram::bucket_upper_bound(
+            LatencyHistogram::bucket_index(value));
+        EXPECT_GE(upper, value);
+        EXPECT_LE(upper - value, value / 8);
+    }
+}
+
+TEST(LatencyHistogramUnitTest, PercentilesFollowRecordedSamples) {
+    LatencyHistogram histogram;
+    for (uint64_t value = 1; value <= 1000; ++value) {
+        histogram.record(value * 1000);
+    }
+
+    LatencyHistogramStats stats;
+    histogram.snapshot(&stats);
+    EXPECT_EQ(stats.count, 1000u);
+    EXPECT_EQ(stats.sum_ns, 500500u * 1000);
+    EXPECT_EQ(stats.max_ns, 1000000u);
+    ASSERT_EQ(stats.buckets.size(), LatencyHistogram::kBucketCount);
+
+    const uint64_t p50 = stats.percentile_ns(0.5);
+    const uint64_t p99 = stats.percentile_ns(0.99);
+    EXPECT_GE(p50, 500000u);
+    EXPECT_LE(p50, 500000u + 500000u / 8);
+    EXPECT_GE(p99, 990000u);
+    EXPECT_LE(p99, 1000000u);
+    EXPECT_EQ(stats.percentile_ns(1.0), 1000000u);
+}
+
+TEST(LatencyHistogramUnitTest, MergeAddsDistributions) {
+    LatencyHistogram fast;
+    LatencyHistogram slow;
+    for (int i = 0; i < 90; ++i) {
+        fast.record(100);
+    }
+    for (int i = 0; i < 10; ++i) {
+        slow.record(1000000);
+    }
+
+    LatencyHistogramStats total;
+    EXPECT_EQ(total.percentile_ns(0.5), 0u);
+
+    LatencyHistogramStats part;
+    fast.snapshot(&part);
+    total.merge(part);
+    slow.snapshot(&part);
+    total.merge(part);
+
+    EXPECT_EQ(total.count, 100u);
+    EXPECT_EQ(total.max_ns, 1000000u);
+    EXPECT_LE(total.percentile_ns(0.9), 100u + 100u / 8);
+    EXPECT_GE(total.percentile_ns(0.95), 1000000u - 1000000u / 8);
+}
+
+} // namespace
+} // namespace zco
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    zco::init_logger();
+    return RUN_ALL_TESTS();
+}
@@ -1,19 +1,37 @@
+#include <sys/syscall.h>
+#include <unistd.h>
+
 #include <atomic>
 #include <chrono>
+#include <fstream>
 #include <mutex>
+#include <shared_mutex>
+#include <string>
 #include <thread>
 #include <vector>
 
 #include <gtest/gtest.h>
 
 #include "support/test_fixture.h"
+#include "zco/event.h"
 #include "zco/mutex.h"
+#include "zco/stats.h"
 
 namespace zco {
 namespace {
 
 class MutexUnitByHeaderTest : public test::RuntimeTestBase {};
 
+// 线程阻塞在锁的条件变量上时内核状态为 S，比固定 sleep 更可靠。
+bool ThreadIsSleeping(pid_t tid) {
+    std::ifstream stat("/proc/self/task/" + std::to_string(tid) + "/stat");
+    std::string content;
+    std::getline(stat, content);
+    const std::string::size_type paren = content.rfind(')');
+    return paren != std::string::npos && paren + 2 < content.size() &&
+           content[paren + 2] == 'S';
+}
+
 TEST_F(MutexUnitByHeaderTest, LockUnlockAndTryLockFlow) {
     Mutex mutex;
 
@@ -125,31 +143,37 @@ TEST_F(MutexUnitByHeaderTest, CoroutineWaiterGetsLockBeforeThreadWaiter) {
     Mutex mutex;
     mutex.lock();
 
-    WaitGroup coroutine_started(1);
     WaitGroup done(2);
     std::vector<int> order;
     std::mutex order_mutex;
 
-    go([&]() {
-        coroutine_started.done();
-        MutexGuard guard(mutex);
+    // 线程先排队：按到达顺序转交的话它会先拿到锁。
+    std::atomic<pid_t> thread_tid(0);
+    std::thread thread_waiter([&]() {
+        thread_tid.store(static_cast<pid_t>(::syscall(SYS_gettid)));
         {
+            MutexGuard guard(mutex);
             std::lock_guard<std::mutex> lock(order_mutex);
-            order.push_back(1);
+            order.push_back(2);
         }
         done.done();
     });
+    while (thread_tid.load() == 0 || !ThreadIsSleeping(thread_tid.load())) {
+        std::this_thread::yield();
+    }
 
-    coroutine_started.wait();
-
-    std::thread thread_waiter([&]() {
-        MutexGuard guard(mutex);
+    const uint64_t parks = stats().processors.at(0).parks;
+    go([&]() {
         {
+            MutexGuard guard(mutex);
             std::lock_guard<std::mutex> lock(order_mutex);
-            order.push_back(2);
+            order.push_back(1);
         }
         done.done();
     });
+    while (stats().processors.at(0).parks == parks) {
+        std::this_thread::yield();
+    }
 
     mutex.unlock();
     done.wait();
@@ -194,15 +218,19 @@ TEST_F(MutexUnitByHeaderTest,
 
     go([&]() {
         coroutine_started.done();
-        MutexGuard guard(mutex);
-        coroutine_done.store(true, std::memory_order_release);
+        {
+            MutexGuard guard(mutex);
+            coroutine_done.store(true, std::memory_order_release);
+        }
         done.done();
     });
 
     coroutine_started.wait();
     std::thread waiter([&]() {
-        MutexGuard guard(mutex);
-        thread_done.store(true, std::memory_order_release);
+        {
+            MutexGuard guard(mutex);
+            thread_done.store(true, std::memory_order_release);
+        }
         done.done();
     });
 
@@ -233,6 +261,239 @@ TEST_F(MutexUnitByHeaderTest, ThreadLockBlocksUntilOwnerUnlocks) {
     EXPECT_TRUE(thread_acquired.load(std::memory_order_acquire));
 }
 
+TEST_F(MutexUnitByHeaderTest, ContendedLockKeepsMutualExclusion) {
+    init(4);
+
+    Mutex mutex;
+    constexpr int kCoroutines = 16;
+    constexpr int kThreads = 4;
+    constexpr int kIterations = 2000;
+    int counter = 0;
+    WaitGroup done(kCoroutines);
+
+    for (int i = 0; i < kCoroutines; ++i) {
+        go([&]() {
+            for (int j = 0; j < kIterations; ++j) {
+                MutexGuard guard(mutex);
+                ++counter;
+            }
+            done.done();
+        });
+    }
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < kThreads; ++i) {
+        threads.emplace_back([&]() {
+            for (int j = 0; j < kIterations; ++j) {
+                MutexGuard guard(mutex);
+                ++counter;
+            }
+        });
+    }
+    for (size_t i = 0; i < threads.size(); ++i) {
+        threads[i].join();
+    }
+    done.wait();
+
+    EXPECT_EQ(counter, (kCoroutines + kThreads) * kIterations);
+    EXPECT_TRUE(mutex.try_lock());
+    mutex.unlock();
+}
+
+TEST_F(MutexUnitByHeaderTest, UnlockHandsLockToParkedWaiter) {
+    init(1);
+
+    Mutex mutex;
+    mutex.lock();
+
+    Event parked;
+    Event release;
+    Event done;
+    go([&]() {
+        parked.signal();
+        mutex.lock();
+        ASSERT_TRUE(release.wait(1000));
+        mutex.unlock();
+        done.signal();
+    });
+
+    ASSERT_TRUE(parked.wait(1000));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    mutex.unlock();
+
+    // 锁已转交给挂起的协程，解锁后立即尝试也拿不到。
+    EXPECT_FALSE(mutex.try_lock());
+    release.signal();
+    ASSERT_TRUE(done.wait(1000));
+    EXPECT_TRUE(mutex.try_lock());
+    mutex.unlock();
+}
+
+class SharedMutexUnitTest : public test::RuntimeTestBase {};
+
+TEST_F(SharedMutexUnitTest, ReadersShareAndWritersExclude) {
+    SharedMutex mutex;
+
+    mutex.lock_shared();
+    EXPECT_TRUE(mutex.try_lock_shared());
+    EXPECT_FALSE(mutex.try_lock());
+    mutex.unlock_shared();
+    mutex.unlock_shared();
+
+    {
+        WriteGuard guard(mutex);
+        EXPECT_FALSE(mutex.try_lock_shared());
+        EXPECT_FALSE(mutex.try_lock());
+    }
+    {
+        std::shared_lock<SharedMutex> lock(mutex);
+        EXPECT_FALSE(mutex.try_lock());
+    }
+    EXPECT_TRUE(mutex.try_lock());
+    mutex.unlock();
+
+    // 未持有时解锁被忽略。
+    mutex.unlock();
+    mutex.unlock_shared();
+    EXPECT_TRUE(mutex.try_lock());
+    mutex.unlock();
+}
+
+TEST_F(SharedMutexUnitTest, WaitingWriterBlocksNewReaders) {
+    init(1);
+
+    RWMutex mutex;
+    mutex.lock_shared();
+
+    Event parked;
+    Event done;
+    std::atomic<bool> writer_done(false);
+    go([&]() {
+        parked.signal();
+        {
+            WriteGuard guard(mutex);
+            writer_done.store(true, std::memory_order_release);
+        }
+        done.signal();
+    });
+
+    ASSERT_TRUE(parked.wait(1000));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    // 写者排队后新读者不能插队。
+    EXPECT_FALSE(mutex.try_lock_shared());
+    EXPECT_FALSE(writer_done.load(std::memory_order_acquire));
+
+    mutex.unlock_shared();
+    ASSERT_TRUE(done.wait(1000));
+    EXPECT_TRUE(writer_done.load(std::memory_order_acquire));
+    EXPECT_TRUE(mutex.try_lock_shared());
+    mutex.unlock_shared();
+}
+
+TEST_F(SharedMutexUnitTest, WriterReleaseHandsLockToAllParkedReaders) {
+    init(2);
+
+    SharedMutex mutex;
+    mutex.lock();
+
+    constexpr int kReaders = 4;
+    std::atomic<int> parked(0);
+    std::atomic<int> inside(0);
+    std::atomic<int> max_inside(0);
+    Event release(true);
+    WaitGroup done(kReaders);
+    for (int i = 0; i < kReaders; ++i) {
+        go([&]() {
+            parked.fetch_add(1);
+            {
+                ReadGuard guard(mutex);
+                const int now = inside.fetch_add(1) + 1;
+                int seen = max_inside.load();
+                while (now > seen &&
+                       !max_inside.compare_exchange_weak(seen, now)) {
+                }
+                EXPECT_TRUE(release.wait(1000));
+                inside.fetch_sub(1);
+            }
+            done.done();
+        });
+    }
+
+    while (parked.load() < kReaders) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    mutex.unlock();
+
+    const auto deadline =
+        std::chrono::steady_clock::now() + std::chrono::seconds(2);
+    while (max_inside.load() < kReaders &&
+           std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(max_inside.load(), kReaders);
+    release.signal();
+    done.wait();
+}
+
+TEST_F(SharedMutexUnitTest, MixedReadersAndWritersSeeConsistentState) {
+    init(4);
+
+    SharedMutex mutex;
+    constexpr int kWriters = 4;
+    constexpr int kReaders = 8;
+    constexpr int kIterations = 1000;
+    long long first = 0;
+    long long second = 0;
+    std::atomic<bool> torn(false);
+    WaitGroup done(kWriters + kReaders);
+
+    for (int i = 0; i < kWriters; ++i) {
+        go([&]() {
+            for (int j = 0; j < kIterations; ++j) {
+                WriteGuard guard(mutex);
+                ++first;
+                ++second;
+            }
+            done.done();
+        });
+    }
+    for (int i = 0; i < kReaders; ++i) {
+        go([&]() {
+            for (int j = 0; j < kIterations; ++j) {
+                ReadGuard guard(mutex);
+                if (first != second) {
+                    torn.store(true);
+                }
+            }
+            done.done();
+        });
+    }
+
+    std::thread writer([&]() {
+        for (int j = 0; j < kIterations; ++j) {
+            std::lock_guard<SharedMutex> guard(mutex);
+            ++first;
+            ++second;
+        }
+    });
+    std::thread reader([&]() {
+        for (int j = 0; j < kIterations; ++j) {
+            std::shared_lock<SharedMutex> guard(mutex);
+            if (first != second) {
+                torn.store(true);
+            }
+        }
+    });
+    writer.join();
+    reader.join();
+    done.wait();
+
+    EXPECT_FALSE(torn.load());
+    EXPECT_EQ(first, (kWriters + 1) * kIterations);
+    EXPECT_EQ(second, first);
+}
+
 } // namespace
 } // namespace zco
 
@@ -32,7 +32,7 @@ TEST_F(ProcessorInternalUnitTest,
     EXPECT_TRUE(ready_batch.empty());
 
     Fiber::ptr fiber =
-        std::make_shared<Fiber>(101, &processor, []() {}, 64 * 1024, 0, true);
+        make_intrusive<Fiber>(101, &processor, []() {}, 64 * 1024, 0, true);
     ready_batch.push_back(fiber);
     processor.enqueue_ready_batch(&ready_batch);
     EXPECT_TRUE(ready_batch.empty());
@@ -46,7 +46,7 @@ TEST_F(ProcessorInternalUnitTest, RecycleAndIoReadyGuardPathsAreExercised) {
     Processor processor(22, 64 * 1024);
 
     Fiber::ptr fiber =
-        std::make_shared<Fiber>(102, &processor, []() {}, 64 * 1024, 0, true);
+        make_intrusive<Fiber>(102, &processor, []() {}, 64 * 1024, 0, true);
     EXPECT_FALSE(processor.recycle_if_done_before_run(fiber));
 
     fiber->mark_done();
@@ -66,7 +66,7 @@ TEST_F(ProcessorInternalUnitTest, RecycleAndIoReadyGuardPathsAreExercised) {
     ready->timer = std::make_shared<TimerToken>();
     ready->active.store(true, std::memory_order_release);
     {
-        Fiber::ptr tmp = std::make_shared<Fiber>(
+        Fiber::ptr tmp = make_intrusive<Fiber>(
             103, &processor, []() {}, 64 * 1024, 0, true);
         ready->fiber = tmp;
     }
@@ -94,7 +94,7 @@ TEST_F(ProcessorInternalUnitTest,
        SaveRestoreEarlyReturnWhenSharedStackStorageUnavailable) {
     Processor processor(24, 64 * 1024, 1, StackModel::kIndependent);
     Fiber::ptr fiber =
-        std::make_shared<Fiber>(104, &processor, []() {}, 64 * 1024, 0, false);
+        make_intrusive<Fiber>(104, &processor, []() {}, 64 * 1024, 0, false);
 
     processor.save_fiber_stack(fiber);
 
@@ -109,7 +109,7 @@ TEST_F(ProcessorInternalUnitTest,
 TEST_F(ProcessorInternalUnitTest, SharedStackOwnerUsesFiberIdToAvoidStaleHit) {
     Processor processor(25, 64 * 1024, 1, StackModel::kShared);
     Fiber::ptr fiber =
-        std::make_shared<Fiber>(201, &processor, []() {}, 64 * 1024, 0, true);
+        make_intrusive<Fiber>(201, &processor, []() {}, 64 * 1024, 0, true);
 
     processor.shared_stacks_.set_occupy_fiber(0, fiber.get(), fiber->id());
     fiber->reset(202, []() {}, 0);
@@ -124,7 +124,7 @@ TEST_F(ProcessorInternalUnitTest, SharedStackOwnerUsesFiberIdToAvoidStaleHit) {
 TEST_F(ProcessorInternalUnitTest, DoneFiberClearsMatchingSharedStackOwner) {
     Processor processor(26, 64 * 1024, 1, StackModel::kShared);
     Fiber::ptr fiber =
-        std::make_shared<Fiber>(203, &processor, []() {}, 64 * 1024, 0, true);
+        make_intrusive<Fiber>(203, &processor, []() {}, 64 * 1024, 0, true);
 
     processor.shared_stacks_.set_occupy_fiber(0, fiber.get(), fiber->id());
     fiber->mark_done();
@@ -1,12 +1,13 @@
 #include <atomic>
 #include <chrono>
-#include <deque>
 #include <sys/epoll.h>
 #include <thread>
+#include <vector>
 
 #include <gtest/gtest.h>
 
 #include "support/test_fixture.h"
+#include "zco/event.h"
 #include "zco/internal/processor.h"
 #include "zco/internal/runtime_manager.h"
 
@@ -37,7 +38,7 @@ TEST_F(ProcessorUnitTest, PendingTaskCountAndStealFlow) {
     processor.enqueue_task([]() {});
     EXPECT_EQ(processor.pending_task_count(), 3u);
 
-    std::deque<Task> stolen;
+    std::vector<Task> stolen;
     const size_t count = processor.steal_tasks(&stolen, 2, 0);
     EXPECT_GE(count, 1u);
     EXPECT_LE(count, 2u);
@@ -108,7 +109,7 @@ TEST_F(ProcessorUnitTest, NullAndNoCurrentFiberPathsReturnSafely) {
     EXPECT_FALSE(processor.park_current_for(1));
     EXPECT_FALSE(processor.wait_fd(3, EPOLLIN, 1));
 
-    std::deque<Task> out;
+    std::vector<Task> out;
     EXPECT_EQ(processor.steal_tasks(nullptr, 8, 0), 0u);
     EXPECT_EQ(processor.steal_tasks(&out, 0, 0), 0u);
 }
@@ -160,6 +161,43 @@ TEST_F(ProcessorUnitTest, YieldingTaskIsRescheduledAndEventuallyCompletes) {
     processor.join();
 }
 
+TEST_F(ProcessorUnitTest, YieldAndEventWakeKeepFiberRefCountStable) {
+    Processor processor(15, 64 * 1024);
+    Event event;
+    std::atomic<uint32_t> before_yield(0);
+    std::atomic<uint32_t> after_yield(0);
+    std::atomic<uint32_t> after_wake(0);
+    std::atomic<bool> done(false);
+
+    processor.start();
+    processor.enqueue_task([&]() {
+        Fiber *self = current_processor()->current_fiber();
+        before_yield.store(self->ref_count(), std::memory_order_release);
+        yield();
+        after_yield.store(self->ref_count(), std::memory_order_release);
+        event.wait();
+        after_wake.store(self->ref_count(), std::memory_order_release);
+        done.store(true, std::memory_order_release);
+    });
+    processor.enqueue_task([&event]() { event.signal(); });
+
+    const auto deadline =
+        std::chrono::steady_clock::now() + std::chrono::milliseconds(800);
+    while (!done.load(std::memory_order_acquire) &&
+           std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    // 运行期间只有运行循环持有一份引用，让出与唤醒都以移动方式交接。
+    ASSERT_TRUE(done.load(std::memory_order_acquire));
+    EXPECT_EQ(before_yield.load(std::memory_order_acquire), 1u);
+    EXPECT_EQ(after_yield.load(std::memory_order_acquire), 1u);
+    EXPECT_EQ(after_wake.load(std::memory_order_acquire), 1u);
+
+    processor.stop();
+    processor.join();
+}
+
 TEST_F(ProcessorUnitTest, IdleProcessorStealsPendingTasksFromBusyVictim) {
     Runtime &runtime = Runtime::instance();
     runtime.init(2);
@@ -201,7 +239,13 @@ TEST_F(ProcessorUnitTest, IdleProcessorStealsPendingTasksFromBusyVictim) {
         });
     }
 
-    std::this_thread::sleep_for(std::chrono::milliseconds(80));
+    // 负载高时空闲处理器可能迟迟得不到 CPU，等到它偷到任务再放行。
+    const auto steal_deadline =
+        std::chrono::steady_clock::now() + std::chrono::seconds(3);
+    while (ran_on_other.load(std::memory_order_relaxed) == 0 &&
+           std::chrono::steady_clock::now() < steal_deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
     release_blocker.store(true, std::memory_order_release);
     done.wait();
 
@@ -0,0 +1,126 @@
+#include <atomic>
+#include <deque>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "support/test_fixture.h"
+#include "zco/internal/processor.h"
+#include "zco/internal/run_queue.h"
+
+namespace zco {
+namespace {
+
+class RunQueueUnitTest : public test::RuntimeTestBase {};
+
+Fiber::ptr MakeFiber(Processor *processor, int id) {
+    return make_intrusive<Fiber>(id, processor, []() {}, 64 * 1024, 0, true);
+}
+
+TEST_F(RunQueueUnitTest, PopReturnsLocalAndInjectedFibersInFifoOrder) {
+    Processor processor(31, 64 * 1024);
+    RunQueue queue;
+
+    EXPECT_TRUE(queue.empty());
+    EXPECT_FALSE(queue.push(Fiber::ptr()));
+    EXPECT_EQ(queue.pop(), nullptr);
+
+    ASSERT_TRUE(queue.push_local(MakeFiber(&processor, 1)));
+    ASSERT_TRUE(queue.push(MakeFiber(&processor, 2)));
+    ASSERT_TRUE(queue.push(MakeFiber(&processor, 3)));
+    EXPECT_EQ(queue.size(), 3u);
+
+    for (int expected = 1; expected <= 3; ++expected) {
+        Fiber::ptr fiber = queue.pop();
+        ASSERT_NE(fiber, nullptr);
+        EXPECT_EQ(fiber->id(), expected);
+    }
+    EXPECT_TRUE(queue.empty());
+}
+
+TEST_F(RunQueueUnitTest, NextSlotIsLifoAndDisplacedFiberMovesToTail) {
+    Processor processor(32, 64 * 1024);
+    RunQueue queue;
+
+    ASSERT_TRUE(queue.push_local(MakeFiber(&processor, 1)));
+    ASSERT_TRUE(queue.push_next(MakeFiber(&processor, 2)));
+    ASSERT_TRUE(queue.push_next(MakeFiber(&processor, 3)));
+
+    Fiber::ptr next = queue.take_next();
+    ASSERT_NE(next, nullptr);
+    EXPECT_EQ(next->id(), 3);
+    EXPECT_EQ(queue.take_next(), nullptr);
+
+    std::deque<Fiber::ptr> drained;
+    EXPECT_EQ(queue.drain(&drained, 8), 2u);
+    ASSERT_EQ(drained.size(), 2u);
+    EXPECT_EQ(drained[0]->id(), 1);
+    EXPECT_EQ(drained[1]->id(), 2);
+}
+
+TEST_F(RunQueueUnitTest, QueuedFiberIsNotEnqueuedTwice) {
+    Processor processor(33, 64 * 1024);
+    RunQueue queue;
+
+    Fiber::ptr fiber = MakeFiber(&processor, 1);
+    ASSERT_TRUE(queue.push(fiber));
+    EXPECT_FALSE(queue.push_local(fiber));
+    EXPECT_FALSE(queue.push_next(fiber));
+    EXPECT_EQ(queue.size(), 1u);
+
+    EXPECT_EQ(queue.pop(), fiber);
+    EXPECT_TRUE(queue.push_next(fiber));
+    EXPECT_EQ(queue.take_next(), fiber);
+}
+
+TEST_F(RunQueueUnitTest, ConcurrentProducersDeliverEveryFiberOnce) {
+    Processor processor(34, 64 * 1024);
+    RunQueue queue;
+
+    constexpr int kProducers = 4;
+    constexpr int kPerProducer = 500;
+    std::vector<Fiber::ptr> fibers;
+    for (int i = 0; i < kProducers * kPerProducer; ++i) {
+        fibers.push_back(MakeFiber(&processor, i));
+    }
+
+    std::vector<std::thread> producers;
+    for (int t = 0; t < kProducers; ++t) {
+        producers.emplace_back([&queue, &fibers, t]() {
+            for (int i = 0; i < kPerProducer; ++i) {
+                queue.push(fibers[t * kPerProducer + i]);
+            }
+        });
+    }
+
+    std::vector<int> seen(fibers.size(), 0);
+    size_t consumed = 0;
+    while (consumed < fibers.size()) {
+        Fiber::ptr fiber = queue.pop();
+        if (!fiber) {
+            std::this_thread::yield();
+            continue;
+        }
+        ++seen[fiber->id()];
+        ++consumed;
+    }
+
+    for (size_t i = 0; i < producers.size(); ++i) {
+        producers[i].join();
+    }
+
+    for (size_t i = 0; i < seen.size(); ++i) {
+        EXPECT_EQ(seen[i], 1);
+    }
+    EXPECT_TRUE(queue.empty());
+}
+
+} // namespace
+} // namespace zco
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    zco::init_logger();
+    return RUN_ALL_TESTS();
+}
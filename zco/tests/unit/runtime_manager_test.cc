@@ -1,4 +1,5 @@
 #include <atomic>
+#include <chrono>
 #include <cstdint>
 #include <errno.h>
 #include <memory>
@@ -202,7 +203,7 @@ TEST_F(RuntimeManagerUnitTest, RegisterFiberAndExternalHandleRoundTrip) {
 
     Processor owner(77, 64 * 1024);
     Fiber::ptr fiber =
-        std::make_shared<Fiber>(1001, &owner, []() {}, 64 * 1024, 0, true);
+        make_intrusive<Fiber>(1001, &owner, []() {}, 64 * 1024, 0, true);
     ASSERT_NE(fiber, nullptr);
     EXPECT_EQ(fiber->external_handle_id(), 0u);
 
@@ -620,6 +621,149 @@ TEST_F(RuntimeManagerUnitTest, WaitFdRejectsZeroEventsInsideCoroutine) {
     done.wait();
 }
 
+// 轮询等待后台状态变化，超时返回 false。
+template <typename Pred> bool WaitUntil(Pred pred, int timeout_ms) {
+    for (int waited = 0; waited < timeout_ms; ++waited) {
+        if (pred()) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return pred();
+}
+
+TEST_F(RuntimeManagerUnitTest, ResizeSchedsAddsSchedulersAtRuntime) {
+    init(1);
+    EXPECT_EQ(resize_scheds(3), 3u);
+    EXPECT_EQ(scheduler_count(), 3u);
+    EXPECT_EQ(stats().processors.size(), 3u);
+
+    std::atomic<int> seen(-1);
+    Event done;
+    Runtime::instance().submit_to(2, [&]() {
+        seen.store(sched_id());
+        done.signal();
+    });
+    ASSERT_TRUE(done.wait(1000));
+    EXPECT_EQ(seen.load(), 2);
+
+    EXPECT_EQ(resize_scheds(0), 3u);
+}
+
+TEST_F(RuntimeManagerUnitTest, DrainedSchedulerHandsOffPendingTasks) {
+    init(2);
+
+    // 让调度器 1 被一个不让出的协程占住，之后投给它的任务都还在积压中。
+    std::atomic<bool> spinning(false);
+    std::atomic<bool> release(false);
+    Runtime::instance().submit_to(1, [&]() {
+        spinning.store(true);
+        while (!release.load()) {
+        }
+    });
+    ASSERT_TRUE(WaitUntil([&]() { return spinning.load(); }, 1000));
+
+    constexpr int kTasks = 64;
+    std::atomic<int> ran(0);
+    std::atomic<int> ran_on_drained(0);
+    WaitGroup wait_group(kTasks);
+    for (int i = 0; i < kTasks; ++i) {
+        Runtime::instance().submit_to(1, [&]() {
+            if (sched_id() == 1) {
+                ran_on_drained.fetch_add(1);
+            }
+            ran.fetch_add(1);
+            wait_group.done();
+        });
+    }
+
+    EXPECT_EQ(resize_scheds(1), 1u);
+    EXPECT_EQ(scheduler_count(), 1u);
+    release.store(true);
+    wait_group.wait();
+    EXPECT_EQ(ran.load(), kTasks);
+    EXPECT_EQ(ran_on_drained.load(), 0);
+
+    // 被缩容的调度器不再活跃，自己的协程结束后没有存活协程。
+    EXPECT_TRUE(WaitUntil(
+        [&]() {
+            const ProcessorStats drained = stats().processors.at(1);
+            return !drained.active && drained.live_fibers == 0 &&
+                   drained.pending_tasks == 0;
+        },
+        1000));
+}
+
+TEST_F(RuntimeManagerUnitTest, StartedFiberFinishesOnDrainedScheduler) {
+    init(2);
+
+    Event parked;
+    Event wake;
+    std::atomic<int> resumed_on(-1);
+    WaitGroup finished(1);
+    Runtime::instance().submit_to(1, [&]() {
+        parked.signal();
+        wake.wait();
+        resumed_on.store(sched_id());
+        finished.done();
+    });
+    ASSERT_TRUE(parked.wait(1000));
+
+    EXPECT_EQ(resize_scheds(1), 1u);
+    // 挂起中的协程栈绑定在原调度器上，缩容期间它仍然存活。
+    ProcessorStats drained = stats().processors.at(1);
+    EXPECT_FALSE(drained.active);
+    EXPECT_EQ(drained.live_fibers, 1u);
+
+    // 新任务只投给仍活跃的调度器。
+    std::atomic<int> seen(-1);
+    Event done;
+    Runtime::instance().submit_to(1, [&]() {
+        seen.store(sched_id());
+        done.signal();
+    });
+    ASSERT_TRUE(done.wait(1000));
+    EXPECT_EQ(seen.load(), 0);
+
+    wake.signal();
+    finished.wait();
+    EXPECT_EQ(resumed_on.load(), 1);
+    EXPECT_TRUE(WaitUntil(
+        [&]() { return stats().processors.at(1).live_fibers == 0; }, 1000));
+
+    // 重新扩容沿用已退役的调度器，而不是再建一个。
+    EXPECT_EQ(resize_scheds(2), 2u);
+    EXPECT_EQ(stats().processors.size(), 2u);
+    EXPECT_TRUE(stats().processors.at(1).active);
+    Runtime::instance().submit_to(1, [&]() {
+        seen.store(sched_id());
+        done.signal();
+    });
+    ASSERT_TRUE(done.wait(1000));
+    EXPECT_EQ(seen.load(), 1);
+}
+
+TEST_F(RuntimeManagerUnitTest, ResizeUnderLoadRunsEveryTask) {
+    init(2);
+
+    constexpr int kRounds = 20;
+    constexpr int kTasksPerRound = 200;
+    std::atomic<int> ran(0);
+    WaitGroup wait_group(kRounds * kTasksPerRound);
+    for (int round = 0; round < kRounds; ++round) {
+        for (int i = 0; i < kTasksPerRound; ++i) {
+            go([&]() {
+                yield();
+                ran.fetch_add(1);
+                wait_group.done();
+            });
+        }
+        resize_scheds(round % 2 == 0 ? 4 : 1);
+    }
+    wait_group.wait();
+    EXPECT_EQ(ran.load(), kRounds * kTasksPerRound);
+}
+
 } // namespace
 } // namespace zco
 
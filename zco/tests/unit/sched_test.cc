@@ -1,5 +1,6 @@
 #include <array>
 #include <atomic>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -187,6 +188,41 @@ TEST_F(SchedUnitByHeaderTest, NullClosurePointersAreIgnored) {
     EXPECT_EQ(ran.load(std::memory_order_relaxed), 1);
 }
 
+TEST_F(SchedUnitByHeaderTest, GoBatchRunsAllTasksAndSkipsNulls) {
+    init(3);
+
+    constexpr int kTasks = 100;
+    WaitGroup done(kTasks + 2);
+    std::atomic<int> ran(0);
+    std::vector<Task> tasks;
+    for (int i = 0; i < kTasks; ++i) {
+        tasks.emplace_back([&done, &ran]() {
+            ran.fetch_add(1, std::memory_order_relaxed);
+            done.done();
+        });
+        if (i % 10 == 0) {
+            tasks.emplace_back(nullptr);
+        }
+    }
+    go_batch(tasks.data(), tasks.size());
+    go_batch(nullptr, 0);
+
+    // 批量提交到指定调度器，也可以在协程里提交给自己。
+    Scheduler *scheduler = main_sched();
+    ASSERT_NE(scheduler, nullptr);
+    scheduler->go([&done, &ran, scheduler]() {
+        Task inner[1] = {Task([&done, &ran]() {
+            ran.fetch_add(1, std::memory_order_relaxed);
+            done.done();
+        })};
+        scheduler->go_batch(inner, 1);
+        done.done();
+    });
+
+    done.wait();
+    EXPECT_EQ(ran.load(std::memory_order_relaxed), kTasks + 1);
+}
+
 TEST_F(SchedUnitByHeaderTest, SleepForZeroInCoroutineActsLikeYield) {
     init(1);
 
@@ -253,6 +289,48 @@ TEST_F(SchedUnitByHeaderTest,
     EXPECT_TRUE(valid.load(std::memory_order_acquire));
 }
 
+TEST_F(SchedUnitByHeaderTest, StackCopyStatsCountOnlySlotEvictions) {
+    EXPECT_EQ(co_stack_copy_stats().saved_bytes, 0u);
+
+    co_stack_model(StackModel::kShared);
+    co_stack_num(2);
+    init(1);
+
+    // 两个协程各占一个空闲槽位，来回 yield 不需要任何快照拷贝。
+    WaitGroup spread(2);
+    for (int i = 0; i < 2; ++i) {
+        go([&spread]() {
+            for (int round = 0; round < 8; ++round) {
+                yield();
+            }
+            spread.done();
+        });
+    }
+    spread.wait();
+    EXPECT_EQ(co_stack_copy_stats().save_count, 0u);
+
+    // 三个协程挤两个槽位，换出和换回都要拷贝。在调度线程上一次投递，
+    // 三个任务在同一轮实体化，空闲自旋的调度器不会逐个接走。
+    WaitGroup crowded(3);
+    go([&crowded]() {
+        for (int i = 0; i < 3; ++i) {
+            go([&crowded]() {
+                for (int round = 0; round < 8; ++round) {
+                    yield();
+                }
+                crowded.done();
+            });
+        }
+    });
+    crowded.wait();
+
+    const StackCopyStats stats = co_stack_copy_stats();
+    EXPECT_GT(stats.save_count, 0u);
+    EXPECT_GT(stats.saved_bytes, 0u);
+    EXPECT_GT(stats.restore_count, 0u);
+    EXPECT_GT(stats.restored_bytes, 0u);
+}
+
 TEST_F(SchedUnitByHeaderTest, StopSchedsIsIdempotent) {
     init(1);
     stop_scheds();
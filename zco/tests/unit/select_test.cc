@@ -0,0 +1,320 @@
+#include <atomic>
+#include <chrono>
+#include <errno.h>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include "support/test_fixture.h"
+#include "zco/channel.h"
+#include "zco/event.h"
+#include "zco/select.h"
+#include "zco/wait_group.h"
+
+namespace zco {
+namespace {
+
+class SelectUnitTest : public test::RuntimeTestBase {};
+
+TEST_F(SelectUnitTest, OutsideCoroutineFailsWithEperm) {
+    Channel<int> channel(1);
+    int out = 0;
+
+    errno = 0;
+    EXPECT_EQ(select({SelectCase::recv(channel, out)}, 0), -1);
+    EXPECT_EQ(errno, EPERM);
+}
+
+TEST_F(SelectUnitTest, ReadyCaseFiresWithoutParking) {
+    init(1);
+
+    Channel<int> a(1);
+    Channel<int> b(1);
+    ASSERT_TRUE(b.try_write(7));
+
+    Event done;
+    std::atomic<int> fired(-2);
+    std::atomic<int> value(0);
+    std::atomic<int> empty_result(0);
+    std::atomic<int> empty_errno(0);
+    go([&]() {
+        int from_a = 0;
+        int from_b = 0;
+        fired.store(select({SelectCase::recv(a, from_a),
+                            SelectCase::recv(b, from_b)}));
+        value.store(from_b);
+
+        // timeout 为 0 时只尝试一次。
+        empty_result.store(select({SelectCase::recv(a, from_a),
+                                   SelectCase::recv(b, from_b)},
+                                  0));
+        empty_errno.store(errno);
+        done.signal();
+    });
+
+    ASSERT_TRUE(done.wait(1000));
+    EXPECT_EQ(fired.load(), 1);
+    EXPECT_EQ(value.load(), 7);
+    EXPECT_EQ(empty_result.load(), -1);
+    EXPECT_EQ(empty_errno.load(), ETIMEDOUT);
+}
+
+TEST_F(SelectUnitTest, ParkedSelectTakesExactlyOneOfConcurrentWrites) {
+    init(1);
+
+    Channel<int> a(1);
+    Channel<int> b(1);
+    Event parked;
+    Event done;
+    std::atomic<int> fired(-2);
+    std::atomic<int> value(0);
+
+    go([&]() {
+        int from_a = 0;
+        int from_b = 0;
+        parked.signal();
+        const int index = select({SelectCase::recv(a, from_a),
+                                  SelectCase::recv(b, from_b)},
+                                 1000);
+        fired.store(index);
+        value.store(index == 0 ? from_a : from_b);
+        done.signal();
+    });
+
+    ASSERT_TRUE(parked.wait(1000));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    std::thread writer_a([&]() { EXPECT_TRUE(a.write(1, 1000)); });
+    std::thread writer_b([&]() { EXPECT_TRUE(b.write(2, 1000)); });
+    writer_a.join();
+    writer_b.join();
+    ASSERT_TRUE(done.wait(1000));
+
+    // 胜出分支拿走一个值，另一个值必须仍留在自己的通道里。
+    const int index = fired.load();
+    ASSERT_TRUE(index == 0 || index == 1);
+    EXPECT_EQ(value.load(), index + 1);
+    int left = 0;
+    Channel<int> &other = index == 0 ? b : a;
+    EXPECT_TRUE(other.try_read(left));
+    EXPECT_EQ(left, index == 0 ? 2 : 1);
+    EXPECT_FALSE(a.try_read(left));
+    EXPECT_FALSE(b.try_read(left));
+}
+
+TEST_F(SelectUnitTest, TimeoutLeavesNoStaleRegistration) {
+    init(1);
+
+    Channel<int> a(1);
+    Channel<int> b(1);
+    Event done;
+    std::atomic<int> fired(-2);
+    std::atomic<int> error(0);
+
+    go([&]() {
+        int out = 0;
+        const auto begin = std::chrono::steady_clock::now();
+        fired.store(select({SelectCase::recv(a, out),
+                            SelectCase::recv(b, out)},
+                           30));
+        error.store(errno);
+        EXPECT_GE(std::chrono::steady_clock::now() - begin,
+                  std::chrono::milliseconds(25));
+        done.signal();
+    });
+
+    ASSERT_TRUE(done.wait(1000));
+    EXPECT_EQ(fired.load(), -1);
+    EXPECT_EQ(error.load(), ETIMEDOUT);
+
+    // 超时后的写入不能交给已失效的节点。
+    EXPECT_TRUE(a.write(5, 0));
+    int out = 0;
+    EXPECT_TRUE(a.try_read(out));
+    EXPECT_EQ(out, 5);
+}
+
+TEST_F(SelectUnitTest, SendCaseFiresWhenReaderFreesSpace) {
+    init(1);
+
+    Channel<int> full(1);
+    Channel<int> idle(1);
+    ASSERT_TRUE(full.try_write(1));
+
+    Event parked;
+    Event done;
+    std::atomic<int> fired(-2);
+    std::atomic<bool> ok(false);
+
+    go([&]() {
+        int value = 2;
+        int unused = 0;
+        bool sent = false;
+        parked.signal();
+        fired.store(select({SelectCase::recv(idle, unused),
+                            SelectCase::send(full, value, &sent)},
+                           1000));
+        ok.store(sent);
+        done.signal();
+    });
+
+    ASSERT_TRUE(parked.wait(1000));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    int out = 0;
+    ASSERT_TRUE(full.read(out, 1000));
+    EXPECT_EQ(out, 1);
+    ASSERT_TRUE(done.wait(1000));
+
+    EXPECT_EQ(fired.load(), 1);
+    EXPECT_TRUE(ok.load());
+    EXPECT_TRUE(full.read(out, 1000));
+    EXPECT_EQ(out, 2);
+}
+
+TEST_F(SelectUnitTest, CloseFiresReceiveCaseWithOkFalse) {
+    init(1);
+
+    Channel<int> channel(1);
+    Event parked;
+    Event done;
+    std::atomic<int> fired(-2);
+    std::atomic<bool> ok(true);
+
+    go([&]() {
+        int out = 0;
+        bool received = true;
+        parked.signal();
+        fired.store(select({SelectCase::recv(channel, out, &received)}));
+        ok.store(received);
+        done.signal();
+    });
+
+    ASSERT_TRUE(parked.wait(1000));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    channel.close();
+    ASSERT_TRUE(done.wait(1000));
+    EXPECT_EQ(fired.load(), 0);
+    EXPECT_FALSE(ok.load());
+}
+
+TEST_F(SelectUnitTest, FdReadinessFiresAlongsideChannels) {
+    init(1);
+
+    int pair[2] = {-1, -1};
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, pair), 0);
+
+    Channel<int> channel(1);
+    Event parked;
+    Event done;
+    std::atomic<int> fired(-2);
+    std::atomic<char> byte(0);
+
+    go([&]() {
+        int out = 0;
+        parked.signal();
+        fired.store(select({SelectCase::recv(channel, out),
+                            SelectCase::fd(pair[1], IoEventType::kRead)},
+                           1000));
+        char c = 0;
+        if (::read(pair[1], &c, 1) == 1) {
+            byte.store(c);
+        }
+        done.signal();
+    });
+
+    ASSERT_TRUE(parked.wait(1000));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    const char marker = 'z';
+    ASSERT_EQ(::write(pair[0], &marker, 1), 1);
+    ASSERT_TRUE(done.wait(1000));
+    EXPECT_EQ(fired.load(), 1);
+    EXPECT_EQ(byte.load(), marker);
+
+    // fd 分支胜出后通道上没有残留登记，写入仍进入缓冲区。
+    EXPECT_TRUE(channel.write(3, 0));
+    int out = 0;
+    EXPECT_TRUE(channel.try_read(out));
+    EXPECT_EQ(out, 3);
+
+    ::close(pair[0]);
+    ::close(pair[1]);
+}
+
+TEST_F(SelectUnitTest, ConcurrentSelectsDeliverEachValueOnce) {
+    init(4);
+
+    constexpr int kPerProducer = 2000;
+    constexpr int kConsumers = 4;
+    Channel<int> a(4);
+    Channel<int> b(4);
+    std::atomic<int> received(0);
+    std::atomic<long long> sum(0);
+    WaitGroup consumers(kConsumers);
+
+    for (int i = 0; i < kConsumers; ++i) {
+        go([&]() {
+            bool a_open = true;
+            bool b_open = true;
+            while (a_open || b_open) {
+                int from_a = 0;
+                int from_b = 0;
+                bool ok_a = false;
+                bool ok_b = false;
+                int index = -1;
+                if (a_open && b_open) {
+                    index = select({SelectCase::recv(a, from_a, &ok_a),
+                                    SelectCase::recv(b, from_b, &ok_b)});
+                } else if (a_open) {
+                    index = select({SelectCase::recv(a, from_a, &ok_a)});
+                } else {
+                    index = select({SelectCase::recv(b, from_b, &ok_b)}) == 0
+                                ? 1
+                                : -1;
+                }
+                if (index == 0) {
+                    a_open = ok_a;
+                    if (ok_a) {
+                        received.fetch_add(1);
+                        sum.fetch_add(from_a);
+                    }
+                } else if (index == 1) {
+                    b_open = ok_b;
+                    if (ok_b) {
+                        received.fetch_add(1);
+                        sum.fetch_add(from_b);
+                    }
+                }
+            }
+            consumers.done();
+        });
+    }
+
+    std::thread producer_a([&]() {
+        for (int i = 1; i <= kPerProducer; ++i) {
+            ASSERT_TRUE(a.write(i, 3000));
+        }
+        a.close();
+    });
+    std::thread producer_b([&]() {
+        for (int i = 1; i <= kPerProducer; ++i) {
+            ASSERT_TRUE(b.write(-i, 3000));
+        }
+        b.close();
+    });
+    producer_a.join();
+    producer_b.join();
+    consumers.wait();
+
+    EXPECT_EQ(received.load(), 2 * kPerProducer);
+    EXPECT_EQ(sum.load(), 0);
+}
+
+} // namespace
+} // namespace zco
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    zco::init_logger();
+    return RUN_ALL_TESTS();
+}
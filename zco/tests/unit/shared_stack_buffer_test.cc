@@ -109,6 +109,23 @@ TEST_F(SharedStackBufferUnitTest, SharedStackPoolOwnerTracksFiberAndId) {
     EXPECT_EQ(owner.fiber_id, 0);
 }
 
+TEST_F(SharedStackBufferUnitTest, BindSlotPrefersFreeThenLeastBoundSlot) {
+    SharedStackPool pool(3, 1024);
+
+    EXPECT_EQ(pool.bind_slot(0), 0u);
+    EXPECT_EQ(pool.bind_slot(0), 1u);
+    EXPECT_EQ(pool.bind_slot(7), 2u);
+    EXPECT_EQ(pool.bind_slot(4), 1u);
+    EXPECT_EQ(pool.bound_count(1), 2u);
+
+    pool.unbind_slot(0);
+    EXPECT_EQ(pool.bound_count(0), 0u);
+    EXPECT_EQ(pool.bind_slot(2), 0u);
+
+    pool.unbind_slot(9);
+    EXPECT_EQ(pool.bound_count(9), 0u);
+}
+
 TEST_F(SharedStackBufferUnitTest, ConstAccessorsExposeSamePointers) {
     SharedStackBuffer buffer(128);
     const SharedStackBuffer &const_ref = buffer;
@@ -1,4 +1,6 @@
 #include <gtest/gtest.h>
+#include <set>
+#include <thread>
 #include <vector>
 
 #include "support/test_fixture.h"
@@ -107,6 +109,46 @@ TEST_F(SnapshotBufferPoolUnitTest, PerBucketLimitDropsOverflowBuffers) {
     }
 }
 
+TEST_F(SnapshotBufferPoolUnitTest, RemoteReleasesAreReusedByOwner) {
+    SnapshotBufferPool pool;
+
+    constexpr int kThreads = 4;
+    constexpr int kPerThread = 32;
+    std::vector<char *> buffers;
+    size_t capacity = 0;
+    uint8_t bucket = 0;
+    for (int i = 0; i < kThreads * kPerThread; ++i) {
+        buffers.push_back(pool.acquire(5000, &capacity, &bucket));
+    }
+
+    std::vector<std::thread> releasers;
+    for (int t = 0; t < kThreads; ++t) {
+        releasers.emplace_back([&pool, &buffers, bucket, capacity, t]() {
+            for (int i = 0; i < kPerThread; ++i) {
+                pool.release(buffers[t * kPerThread + i], bucket, capacity);
+            }
+        });
+    }
+
+    // 归还与取用并发进行，取到的缓冲区要么来自池，要么是新分配的。
+    std::vector<char *> reacquired;
+    for (int i = 0; i < kThreads * kPerThread; ++i) {
+        size_t cap = 0;
+        uint8_t b = 0;
+        reacquired.push_back(pool.acquire(5000, &cap, &b));
+        ASSERT_EQ(cap, capacity);
+    }
+    for (std::thread &thread : releasers) {
+        thread.join();
+    }
+
+    std::set<char *> unique(reacquired.begin(), reacquired.end());
+    EXPECT_EQ(unique.size(), reacquired.size());
+    for (char *buf : reacquired) {
+        pool.release(buf, bucket, capacity);
+    }
+}
+
 TEST_F(SnapshotBufferPoolUnitTest, ReleaseNullBufferIsNoop) {
     SnapshotBufferPool pool;
     pool.release(nullptr, SnapshotBufferPool::dynamic_bucket_index(), 0);
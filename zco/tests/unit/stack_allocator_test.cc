@@ -0,0 +1,173 @@
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "support/test_fixture.h"
+#include "zco/event.h"
+#include "zco/internal/stack_allocator.h"
+#include "zco/sched.h"
+
+namespace zco {
+namespace {
+
+class StackAllocatorUnitTest : public test::RuntimeTestBase {};
+
+size_t resident_pages(char *stack, size_t stack_size) {
+    std::vector<unsigned char> vec(stack_size / StackAllocator::page_size());
+    if (mincore(stack, stack_size, vec.data()) != 0) {
+        return static_cast<size_t>(-1);
+    }
+
+    size_t resident = 0;
+    for (size_t i = 0; i < vec.size(); ++i) {
+        resident += vec[i] & 1;
+    }
+    return resident;
+}
+
+TEST_F(StackAllocatorUnitTest, StackSizeIsRoundedToPages) {
+    const size_t page = StackAllocator::page_size();
+    EXPECT_EQ(StackAllocator::round_size(0), page);
+    EXPECT_EQ(StackAllocator::round_size(1), page);
+    EXPECT_EQ(StackAllocator::round_size(page), page);
+    EXPECT_EQ(StackAllocator::round_size(page + 1), 2 * page);
+}
+
+TEST_F(StackAllocatorUnitTest, PagesAreCommittedOnlyWhenTouched) {
+    const size_t stack_size = 64 * 1024;
+    StackAllocator allocator(stack_size, 4);
+
+    char *stack = allocator.allocate(stack_size);
+    ASSERT_NE(stack, nullptr);
+    EXPECT_EQ(resident_pages(stack, stack_size), 0u);
+
+    stack[stack_size - 1] = 1;
+    EXPECT_EQ(resident_pages(stack, stack_size), 1u);
+
+    allocator.deallocate(stack, stack_size);
+}
+
+TEST_F(StackAllocatorUnitTest, OverflowIntoGuardPageFaults) {
+    StackAllocator allocator(16 * 1024, 4);
+    char *stack = allocator.allocate(16 * 1024);
+    stack[0] = 1;
+
+    // 子进程里写栈底下方一字节，应被 guard 页拦下。
+    const pid_t pid = fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0) {
+        volatile char *below = stack - 1;
+        *below = 1;
+        _exit(0);
+    }
+
+    int status = 0;
+    ASSERT_EQ(waitpid(pid, &status, 0), pid);
+    ASSERT_TRUE(WIFSIGNALED(status));
+    EXPECT_EQ(WTERMSIG(status), SIGSEGV);
+
+    allocator.deallocate(stack, 16 * 1024);
+}
+
+TEST_F(StackAllocatorUnitTest, ReleasedStackIsReusedUpToCacheLimit) {
+    const size_t stack_size = 32 * 1024;
+    StackAllocator allocator(stack_size, 2);
+
+    char *a = allocator.allocate(stack_size);
+    char *b = allocator.allocate(stack_size);
+    char *c = allocator.allocate(stack_size);
+    allocator.deallocate(a, stack_size);
+    allocator.deallocate(b, stack_size);
+    allocator.deallocate(c, stack_size);
+    EXPECT_EQ(allocator.cached_count(), 2u);
+
+    // 后进先出：最近归还且未超限的是 b。
+    char *reused = allocator.allocate(stack_size);
+    EXPECT_EQ(reused, b);
+    EXPECT_EQ(allocator.cached_count(), 1u);
+
+    // 复用的栈整段可写，被回收的页重新按需提交。
+    reused[0] = 1;
+    reused[stack_size - 1] = 1;
+    allocator.deallocate(reused, stack_size);
+}
+
+TEST_F(StackAllocatorUnitTest, OtherSizesBypassCache) {
+    StackAllocator allocator(32 * 1024, 4);
+
+    char *stack = allocator.allocate(64 * 1024);
+    stack[64 * 1024 - 1] = 1;
+    allocator.deallocate(stack, 64 * 1024);
+    EXPECT_EQ(allocator.cached_count(), 0u);
+
+    allocator.deallocate(nullptr, 32 * 1024);
+    EXPECT_EQ(allocator.cached_count(), 0u);
+}
+
+TEST_F(StackAllocatorUnitTest, RemoteReleasesAreReusedByOwner) {
+    const size_t stack_size = 32 * 1024;
+    StackAllocator allocator(stack_size, 64);
+
+    std::vector<char *> stacks;
+    for (int i = 0; i < 16; ++i) {
+        stacks.push_back(allocator.allocate(stack_size));
+    }
+
+    std::thread releaser([&]() {
+        for (size_t i = 0; i < stacks.size(); ++i) {
+            allocator.deallocate(stacks[i], stack_size);
+        }
+    });
+    releaser.join();
+    EXPECT_EQ(allocator.cached_count(), stacks.size());
+
+    for (size_t i = 0; i < stacks.size(); ++i) {
+        char *stack = allocator.allocate(stack_size);
+        EXPECT_NE(std::find(stacks.begin(), stacks.end(), stack),
+                  stacks.end());
+    }
+    EXPECT_EQ(allocator.cached_count(), 0u);
+
+    for (size_t i = 0; i < stacks.size(); ++i) {
+        allocator.deallocate(stacks[i], stack_size);
+    }
+}
+
+TEST_F(StackAllocatorUnitTest, IndependentFibersRunOnGuardedStacks) {
+    co_stack_model(StackModel::kIndependent);
+    co_stack_size(64 * 1024);
+    init(1);
+
+    Event done;
+    std::atomic<int> sum(0);
+    go([&]() {
+        // 在栈上用掉大半空间，确认可用区间完整且不会碰到 guard 页。
+        volatile char frame[48 * 1024];
+        for (size_t i = 0; i < sizeof(frame); i += 512) {
+            frame[i] = static_cast<char>(i / 512 + 1);
+            sum.fetch_add(frame[i] ? 1 : 0);
+        }
+        done.signal();
+    });
+    ASSERT_TRUE(done.wait(3000));
+    EXPECT_GT(sum.load(), 0);
+
+    shutdown();
+}
+
+} // namespace
+} // namespace zco
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    zco::init_logger();
+    return RUN_ALL_TESTS();
+}
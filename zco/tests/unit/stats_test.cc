@@ -0,0 +1,254 @@
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "support/test_fixture.h"
+#include "zco/event.h"
+#include "zco/hook.h"
+#include "zco/stats.h"
+
+namespace zco {
+namespace {
+
+class StatsUnitTest : public test::RuntimeTestBase {};
+
+uint64_t Sum(const RuntimeStats &snapshot,
+             uint64_t (*field)(const ProcessorStats &)) {
+    uint64_t total = 0;
+    for (const ProcessorStats &processor : snapshot.processors) {
+        total += field(processor);
+    }
+    return total;
+}
+
+TEST_F(StatsUnitTest, EmptyBeforeInit) {
+    const RuntimeStats snapshot = stats();
+    EXPECT_TRUE(snapshot.processors.empty());
+    EXPECT_TRUE(render_prometheus(snapshot).empty());
+}
+
+TEST_F(StatsUnitTest, ReportsOneEntryPerProcessor) {
+    init(3);
+
+    const RuntimeStats snapshot = stats();
+    ASSERT_EQ(snapshot.processors.size(), 3u);
+    for (size_t i = 0; i < snapshot.processors.size(); ++i) {
+        EXPECT_EQ(snapshot.processors[i].id, static_cast<int>(i));
+    }
+}
+
+TEST_F(StatsUnitTest, CountsSwitchesYieldsParksAndTimers) {
+    init(1);
+
+    Event started;
+    Event release;
+    Event done;
+    go([&]() {
+        for (int i = 0; i < 3; ++i) {
+            yield();
+        }
+        sleep_for(2);
+        started.signal();
+        release.wait();
+        done.signal();
+    });
+
+    ASSERT_TRUE(started.wait(1000));
+    // 等协程挂起在 release 上之后再由普通线程唤醒，计入 remote_wakeups。
+    // 调度器空闲自旋时协程可能还没走到 wait。
+    for (int i = 0; i < 1000 && stats().processors.at(0).parks < 2; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    release.signal();
+    ASSERT_TRUE(done.wait(1000));
+
+    const ProcessorStats processor = stats().processors.at(0);
+    EXPECT_GE(processor.yields, 3u);
+    EXPECT_GE(processor.parks, 2u);
+    EXPECT_GE(processor.context_switches, 6u);
+    EXPECT_GE(processor.timer_fires, 1u);
+    EXPECT_GE(processor.remote_wakeups, 1u);
+    EXPECT_GE(processor.wakeups, processor.remote_wakeups + 1);
+    EXPECT_GT(processor.cpu_time_ns, 0u);
+}
+
+TEST_F(StatsUnitTest, CountsIoWaitsAndWakeups) {
+    init(1);
+
+    int pair[2] = {-1, -1};
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, pair), 0);
+    ::fcntl(pair[0], F_SETFL, ::fcntl(pair[0], F_GETFL) | O_NONBLOCK);
+
+    std::atomic<ssize_t> got(-1);
+    Event done;
+    go([&]() {
+        char byte = 0;
+        got.store(co_read(pair[0], &byte, 1, 1000));
+        done.signal();
+    });
+    go([&]() {
+        sleep_for(10);
+        EXPECT_EQ(::write(pair[1], "s", 1), 1);
+    });
+
+    ASSERT_TRUE(done.wait(2000));
+    EXPECT_EQ(got.load(), 1);
+
+    const ProcessorStats processor = stats().processors.at(0);
+    EXPECT_GE(processor.io_waits, 1u);
+    EXPECT_GE(processor.io_wakeups, 1u);
+    EXPECT_GE(processor.idle_waits, 1u);
+    EXPECT_GT(processor.poller_syscalls, 0u);
+
+    ::close(pair[0]);
+    ::close(pair[1]);
+}
+
+TEST_F(StatsUnitTest, FinishedFibersAreReusedFromThePool) {
+    init(1);
+
+    const int kRounds = 8;
+    for (int i = 0; i < kRounds; ++i) {
+        Event done;
+        go([&]() { done.signal(); });
+        ASSERT_TRUE(done.wait(1000));
+        // 等协程回收到池里再提交下一个。
+        WaitShortly();
+    }
+
+    const RuntimeStats snapshot = stats();
+    const uint64_t hits = Sum(snapshot, [](const ProcessorStats &processor) {
+        return processor.fiber_pool_hits;
+    });
+    const uint64_t misses = Sum(snapshot, [](const ProcessorStats &processor) {
+        return processor.fiber_pool_misses;
+    });
+    EXPECT_GE(hits + misses, static_cast<uint64_t>(kRounds));
+    EXPECT_GT(hits, 0u);
+}
+
+TEST_F(StatsUnitTest, StealsBalanceAcrossProcessors) {
+    init(4);
+
+    const int kTasks = 2000;
+    std::atomic<int> remaining(kTasks);
+    Event done;
+    go([&]() {
+        // 一次性在同一调度器上提交大量任务，其余调度器空闲时会来窃取。
+        for (int i = 0; i < kTasks; ++i) {
+            go([&]() {
+                if (remaining.fetch_sub(1) == 1) {
+                    done.signal();
+                }
+            });
+        }
+    });
+    ASSERT_TRUE(done.wait(5000));
+
+    const RuntimeStats snapshot = stats();
+    const uint64_t steals_in = Sum(snapshot, [](const ProcessorStats &p) {
+        return p.steals_in;
+    });
+    const uint64_t steals_out = Sum(snapshot, [](const ProcessorStats &p) {
+        return p.steals_out;
+    });
+    // 偷取方和被偷方的计数各自独立累加，汇总后应当一致。
+    EXPECT_EQ(steals_in, steals_out);
+}
+
+TEST_F(StatsUnitTest, SubmitsToBusySchedulerSkipTheWakeup) {
+    init(1);
+
+    const int kTasks = 16;
+    std::atomic<bool> release(false);
+    std::atomic<int> remaining(kTasks);
+    Event started;
+    Event done;
+    // 等调度器阻塞在 poller 上，这一次投递真正写唤醒 fd。
+    for (int i = 0; i < 1000 && !stats().processors.at(0).idle; ++i) {
+        WaitShortly();
+    }
+    ASSERT_TRUE(stats().processors.at(0).idle);
+    go([&]() {
+        started.signal();
+        // 不让出，调度器一直忙碌，期间的投递都不需要写唤醒 fd。
+        while (!release.load()) {
+        }
+    });
+    ASSERT_TRUE(started.wait(1000));
+
+    const uint64_t before = stats().processors.at(0).wakes_avoided;
+    for (int i = 0; i < kTasks; ++i) {
+        go([&]() {
+            if (remaining.fetch_sub(1) == 1) {
+                done.signal();
+            }
+        });
+    }
+    release.store(true);
+    ASSERT_TRUE(done.wait(1000));
+
+    // 旧实现在这段忙碌期间也只会写一次唤醒 fd，其余写入被 poller 合并。
+    EXPECT_EQ(stats().processors.at(0).wakes_avoided - before, 1u);
+}
+
+TEST_F(StatsUnitTest, IdleSchedulerSpinsBeforeBlocking) {
+    if (std::thread::hardware_concurrency() <= 1) {
+        GTEST_SKIP() << "idle spinning is disabled on a single cpu";
+    }
+    init(1);
+
+    for (int i = 0; i < 50; ++i) {
+        Event done;
+        go([&]() { done.signal(); });
+        ASSERT_TRUE(done.wait(1000));
+    }
+
+    const ProcessorStats processor = stats().processors.at(0);
+    EXPECT_GT(processor.idle_spins, 0u);
+    EXPECT_LE(processor.idle_spin_hits, processor.idle_spins);
+}
+
+TEST_F(StatsUnitTest, RendersPrometheusText) {
+    RuntimeStats snapshot;
+    snapshot.processors.resize(2);
+    snapshot.processors[0].id = 0;
+    snapshot.processors[0].context_switches = 42;
+    snapshot.processors[0].idle_wait_ns = 1500000000;
+    snapshot.processors[1].id = 1;
+    snapshot.processors[1].ready_fibers = 7;
+    snapshot.blocking.queued = 3;
+
+    const std::string text = render_prometheus(snapshot, "app");
+    EXPECT_NE(text.find("# HELP app_context_switches_total "),
+              std::string::npos);
+    EXPECT_NE(text.find("# TYPE app_context_switches_total counter\n"),
+              std::string::npos);
+    EXPECT_NE(text.find("app_context_switches_total{sched=\"0\"} 42\n"),
+              std::string::npos);
+    EXPECT_NE(text.find("# TYPE app_ready_fibers gauge\n"), std::string::npos);
+    EXPECT_NE(text.find("app_ready_fibers{sched=\"1\"} 7\n"),
+              std::string::npos);
+    EXPECT_NE(text.find("app_idle_wait_seconds_total{sched=\"0\"} 1.5\n"),
+              std::string::npos);
+    EXPECT_NE(
+        text.find("# TYPE app_blocking_queued gauge\napp_blocking_queued 3\n"),
+        std::string::npos);
+    EXPECT_EQ(text.find("zco_"), std::string::npos);
+}
+
+} // namespace
+} // namespace zco
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    zco::init_logger();
+    return RUN_ALL_TESTS();
+}
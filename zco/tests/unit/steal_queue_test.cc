@@ -1,5 +1,6 @@
 #include <atomic>
-#include <deque>
+#include <thread>
+#include <vector>
 
 #include <gtest/gtest.h>
 
@@ -23,7 +24,7 @@ TEST_F(StealQueueUnitTest, HandlesNullOutputOrZeroMaxSteal) {
 
     EXPECT_EQ(queue.steal(nullptr, 3, 0), 0u);
 
-    std::deque<Task> out;
+    std::vector<Task> out;
     EXPECT_EQ(queue.steal(&out, 0, 0), 0u);
     EXPECT_TRUE(out.empty());
 }
@@ -32,7 +33,7 @@ TEST_F(StealQueueUnitTest, ReturnsZeroWhenTotalNotAboveReserve) {
     StealQueue queue;
     PushNoopTasks(&queue, 5);
 
-    std::deque<Task> out;
+    std::vector<Task> out;
     EXPECT_EQ(queue.steal(&out, 8, 5), 0u);
     EXPECT_EQ(queue.steal(&out, 8, 6), 0u);
 }
@@ -41,21 +42,21 @@ TEST_F(StealQueueUnitTest, UsesPolicyRangesForSmallMediumLargeQueues) {
     {
         StealQueue queue;
         PushNoopTasks(&queue, 5);
-        std::deque<Task> out;
+        std::vector<Task> out;
         EXPECT_EQ(queue.steal(&out, 100, 0), 1u);
     }
 
     {
         StealQueue queue;
         PushNoopTasks(&queue, 30);
-        std::deque<Task> out;
+        std::vector<Task> out;
         EXPECT_EQ(queue.steal(&out, 100, 0), 10u);
     }
 
     {
         StealQueue queue;
         PushNoopTasks(&queue, 100);
-        std::deque<Task> out;
+        std::vector<Task> out;
         EXPECT_EQ(queue.steal(&out, 100, 0), 40u);
     }
 }
@@ -64,12 +65,12 @@ TEST_F(StealQueueUnitTest, AppliesMaxStealAndReserveBoundaries) {
     StealQueue queue;
     PushNoopTasks(&queue, 100);
 
-    std::deque<Task> out;
+    std::vector<Task> out;
     EXPECT_EQ(queue.steal(&out, 7, 0), 7u);
 
     StealQueue queue_with_reserve;
     PushNoopTasks(&queue_with_reserve, 20);
-    std::deque<Task> out2;
+    std::vector<Task> out2;
     EXPECT_EQ(queue_with_reserve.steal(&out2, 50, 19), 1u);
 }
 
@@ -77,7 +78,7 @@ TEST_F(StealQueueUnitTest, DrainAndAppendTransferTasksCorrectly) {
     StealQueue source;
     PushNoopTasks(&source, 4);
 
-    std::deque<Task> drained;
+    std::vector<Task> drained;
     source.drain_all(&drained);
     EXPECT_EQ(source.size(), 0u);
     EXPECT_EQ(drained.size(), 4u);
@@ -88,7 +89,7 @@ TEST_F(StealQueueUnitTest, DrainAndAppendTransferTasksCorrectly) {
     EXPECT_EQ(target.size(), 4u);
 
     target.append(nullptr);
-    std::deque<Task> empty;
+    std::vector<Task> empty;
     target.append(&empty);
     EXPECT_EQ(target.size(), 4u);
 }
@@ -98,7 +99,7 @@ TEST_F(StealQueueUnitTest,
     StealQueue queue;
     PushNoopTasks(&queue, 5);
 
-    std::deque<Task> drained;
+    std::vector<Task> drained;
     queue.drain_some(&drained, 2);
     EXPECT_EQ(drained.size(), 2u);
     EXPECT_EQ(queue.size(), 3u);
@@ -112,6 +113,169 @@ TEST_F(StealQueueUnitTest,
     EXPECT_EQ(drained.size(), 5u);
 }
 
+TEST_F(StealQueueUnitTest, InjectedTasksDrainInSubmitOrder) {
+    StealQueue queue;
+    std::vector<int> order;
+    for (int i = 0; i < 6; ++i) {
+        queue.push([&order, i]() { order.push_back(i); });
+    }
+
+    std::vector<Task> stolen;
+    EXPECT_EQ(queue.steal(&stolen, 1, 0), 1u);
+
+    std::vector<Task> drained;
+    queue.drain_some(&drained, 3);
+    queue.drain_some(&drained, 10);
+    ASSERT_EQ(drained.size(), 5u);
+
+    for (Task &task : stolen) {
+        task();
+    }
+    for (Task &task : drained) {
+        task();
+    }
+    EXPECT_EQ(order, (std::vector<int>{0, 1, 2, 3, 4, 5}));
+}
+
+TEST_F(StealQueueUnitTest, BatchPushesKeepSubmitOrderAndSize) {
+    StealQueue queue;
+    std::vector<int> order;
+    queue.push([&order]() { order.push_back(0); });
+
+    std::vector<Task> batch;
+    for (int i = 1; i <= 4; ++i) {
+        batch.emplace_back([&order, i]() { order.push_back(i); });
+    }
+    queue.push_batch(batch.data(), batch.size());
+    queue.push_batch(nullptr, 0);
+    EXPECT_EQ(queue.size(), 5u);
+    for (const Task &task : batch) {
+        EXPECT_FALSE(task);
+    }
+
+    batch.clear();
+    for (int i = 5; i <= 6; ++i) {
+        batch.emplace_back([&order, i]() { order.push_back(i); });
+    }
+    queue.push_local_batch(batch.data(), batch.size());
+    EXPECT_EQ(queue.size(), 7u);
+
+    std::vector<Task> drained;
+    queue.drain_all(&drained);
+    ASSERT_EQ(drained.size(), 7u);
+    EXPECT_EQ(queue.size(), 0u);
+    for (Task &task : drained) {
+        task();
+    }
+    // 本地批次直接进环形缓冲，注入栈里的任务在 drain 时才搬到它后面。
+    EXPECT_EQ(order, (std::vector<int>{5, 6, 0, 1, 2, 3, 4}));
+}
+
+TEST_F(StealQueueUnitTest, OverflowKeepsTasksWhenRingIsFull) {
+    StealQueue queue(4);
+    EXPECT_EQ(queue.capacity(), 4u);
+
+    std::vector<int> order;
+    for (int i = 0; i < 10; ++i) {
+        queue.push_local([&order, i]() { order.push_back(i); });
+    }
+    EXPECT_EQ(queue.size(), 10u);
+
+    std::vector<Task> stolen;
+    EXPECT_EQ(queue.steal(&stolen, 100, 0), 3u);
+    EXPECT_EQ(queue.size(), 7u);
+
+    std::vector<Task> drained;
+    queue.drain_all(&drained);
+    EXPECT_EQ(drained.size(), 7u);
+    EXPECT_EQ(queue.size(), 0u);
+
+    for (Task &task : stolen) {
+        task();
+    }
+    for (Task &task : drained) {
+        task();
+    }
+    EXPECT_EQ(order, (std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+}
+
+TEST_F(StealQueueUnitTest, ConcurrentProducersAndThievesRunEachTaskOnce) {
+    constexpr int kProducerThreads = 2;
+    constexpr int kThiefThreads = 3;
+    constexpr int kTasksPerProducer = 20000;
+    constexpr int kOwnerTasks = 20000;
+    constexpr int kTotalTasks =
+        kProducerThreads * kTasksPerProducer + kOwnerTasks;
+
+    StealQueue queue(64);
+    std::vector<std::atomic<int>> hits(kTotalTasks);
+    for (std::atomic<int> &hit : hits) {
+        hit.store(0);
+    }
+    std::atomic<int> executed(0);
+
+    auto make_task = [&hits, &executed](int index) {
+        return [&hits, &executed, index]() {
+            hits[index].fetch_add(1, std::memory_order_relaxed);
+            executed.fetch_add(1, std::memory_order_relaxed);
+        };
+    };
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < kProducerThreads; ++p) {
+        threads.emplace_back([&queue, &make_task, p]() {
+            for (int i = 0; i < kTasksPerProducer; ++i) {
+                queue.push(make_task(p * kTasksPerProducer + i));
+            }
+        });
+    }
+    for (int t = 0; t < kThiefThreads; ++t) {
+        threads.emplace_back([&queue, &executed]() {
+            std::vector<Task> stolen;
+            while (executed.load(std::memory_order_relaxed) < kTotalTasks) {
+                queue.steal(&stolen, 16, 0);
+                for (Task &task : stolen) {
+                    task();
+                }
+                stolen.clear();
+            }
+        });
+    }
+
+    // 当前线程扮演 owner：本地投递与批量消费交替进行。
+    std::vector<Task> drained;
+    const int owner_base = kProducerThreads * kTasksPerProducer;
+    for (int i = 0; i < kOwnerTasks; ++i) {
+        queue.push_local(make_task(owner_base + i));
+        if ((i & 31) == 0) {
+            queue.drain_some(&drained, 8);
+        }
+    }
+    while (executed.load(std::memory_order_relaxed) +
+               static_cast<int>(drained.size()) <
+           kTotalTasks) {
+        queue.drain_some(&drained, 64);
+        for (Task &task : drained) {
+            task();
+        }
+        drained.clear();
+    }
+    for (Task &task : drained) {
+        task();
+    }
+    drained.clear();
+
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(executed.load(), kTotalTasks);
+    EXPECT_EQ(queue.size(), 0u);
+    for (int i = 0; i < kTotalTasks; ++i) {
+        ASSERT_EQ(hits[i].load(), 1) << "task index " << i;
+    }
+}
+
 } // namespace
 } // namespace zco
 
@@ -0,0 +1,339 @@
+#include <arpa/inet.h>
+#include <atomic>
+#include <cstring>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/ioctl.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include "support/test_fixture.h"
+#include "zco/event.h"
+#include "zco/hook.h"
+
+namespace zco {
+namespace {
+
+class SyscallHookUnitTest : public test::RuntimeTestBase {
+  protected:
+    void SetUp() override {
+        RuntimeTestBase::SetUp();
+        if (!co_hook_enable(true)) {
+            GTEST_SKIP() << "built without ZCO_ENABLE_SYSCALL_HOOK";
+        }
+    }
+
+    void TearDown() override {
+        co_hook_enable(false);
+        RuntimeTestBase::TearDown();
+    }
+};
+
+// 在协程里创建 socketpair，使两端都被接管。
+bool MakeHookedPair(int pair[2]) {
+    Event created;
+    std::atomic<bool> ok(false);
+    go([&]() {
+        ok.store(::socketpair(AF_UNIX, SOCK_STREAM, 0, pair) == 0);
+        created.signal();
+    });
+    return created.wait(1000) && ok.load();
+}
+
+TEST_F(SyscallHookUnitTest, BlockingReadParksOnlyTheCallingFiber) {
+    init(1);
+
+    int pair[2] = {-1, -1};
+    ASSERT_TRUE(MakeHookedPair(pair));
+
+    char seen = 0;
+    std::atomic<ssize_t> got(-2);
+    Event done;
+    go([&]() {
+        got.store(::read(pair[0], &seen, 1));
+        done.signal();
+    });
+
+    // 单调度器上读协程挂起后，写协程仍能运行。
+    std::atomic<bool> writer_ran(false);
+    go([&]() {
+        sleep_for(10);
+        writer_ran.store(true);
+        EXPECT_EQ(::write(pair[1], "z", 1), 1);
+    });
+
+    if (!done.wait(2000)) {
+        ADD_FAILURE() << "read blocked the scheduler";
+        ::shutdown(pair[1], SHUT_RDWR);
+        done.wait(1000);
+    }
+    EXPECT_TRUE(writer_ran.load());
+    EXPECT_EQ(got.load(), 1);
+    EXPECT_EQ(seen, 'z');
+
+    ::close(pair[0]);
+    ::close(pair[1]);
+}
+
+TEST_F(SyscallHookUnitTest, FcntlReportsCallerNonblockFlag) {
+    init(1);
+
+    std::atomic<int> initial(-1);
+    std::atomic<int> after_set(-1);
+    std::atomic<int> read_errno(0);
+    std::atomic<int> after_clear(-1);
+    Event done;
+    go([&]() {
+        const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        initial.store(::fcntl(fd, F_GETFL) & O_NONBLOCK);
+
+        int pair[2] = {-1, -1};
+        ::socketpair(AF_UNIX, SOCK_STREAM, 0, pair);
+        ::fcntl(pair[0], F_SETFL, ::fcntl(pair[0], F_GETFL) | O_NONBLOCK);
+        after_set.store(::fcntl(pair[0], F_GETFL) & O_NONBLOCK);
+        char byte = 0;
+        errno = 0;
+        // 调用方自己要求非阻塞时直接返回 EAGAIN，不挂起。
+        if (::read(pair[0], &byte, 1) < 0) {
+            read_errno.store(errno);
+        }
+
+        int off = 0;
+        ::ioctl(pair[0], FIONBIO, &off);
+        after_clear.store(::fcntl(pair[0], F_GETFL) & O_NONBLOCK);
+
+        ::close(fd);
+        ::close(pair[0]);
+        ::close(pair[1]);
+        done.signal();
+    });
+
+    ASSERT_TRUE(done.wait(1000));
+    EXPECT_EQ(initial.load(), 0);
+    EXPECT_EQ(after_set.load(), O_NONBLOCK);
+    EXPECT_TRUE(read_errno.load() == EAGAIN ||
+                read_errno.load() == EWOULDBLOCK);
+    EXPECT_EQ(after_clear.load(), 0);
+}
+
+TEST_F(SyscallHookUnitTest, ThreadContextKeepsBlockingSemantics) {
+    init(1);
+
+    int pair[2] = {-1, -1};
+    ASSERT_TRUE(MakeHookedPair(pair));
+
+    go([&]() {
+        sleep_for(20);
+        ::write(pair[1], "t", 1);
+    });
+
+    // 内核侧已是非阻塞，普通线程上的 read 仍要等到数据而不是返回 EAGAIN。
+    char seen = 0;
+    EXPECT_EQ(::read(pair[0], &seen, 1), 1);
+    EXPECT_EQ(seen, 't');
+
+    ::close(pair[0]);
+    ::close(pair[1]);
+}
+
+TEST_F(SyscallHookUnitTest, ConnectAcceptAndRecvShareOneScheduler) {
+    init(1);
+
+    std::atomic<int> port(0);
+    std::atomic<ssize_t> received(-1);
+    char buffer[8] = {};
+    Event listening;
+    Event done;
+
+    go([&]() {
+        const int listener = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address;
+        std::memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t length = sizeof(address);
+        if (::bind(listener, reinterpret_cast<sockaddr *>(&address),
+                   sizeof(address)) != 0 ||
+            ::listen(listener, 4) != 0 ||
+            ::getsockname(listener, reinterpret_cast<sockaddr *>(&address),
+                          &length) != 0) {
+            listening.signal();
+            done.signal();
+            return;
+        }
+        port.store(ntohs(address.sin_port));
+        listening.signal();
+
+        const int conn = ::accept(listener, nullptr, nullptr);
+        if (conn >= 0) {
+            received.store(::recv(conn, buffer, 5, MSG_WAITALL));
+            ::close(conn);
+        }
+        ::close(listener);
+        done.signal();
+    });
+
+    ASSERT_TRUE(listening.wait(1000));
+    ASSERT_NE(port.load(), 0);
+
+    go([&]() {
+        const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address;
+        std::memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = htons(static_cast<uint16_t>(port.load()));
+        if (::connect(fd, reinterpret_cast<sockaddr *>(&address),
+                      sizeof(address)) == 0) {
+            sleep_for(5);
+            ::send(fd, "hello", 5, 0);
+        }
+        ::close(fd);
+    });
+
+    ASSERT_TRUE(done.wait(2000));
+    EXPECT_EQ(received.load(), 5);
+    EXPECT_STREQ(buffer, "hello");
+}
+
+TEST_F(SyscallHookUnitTest, SleepCallsYieldToOtherFibers) {
+    init(1);
+
+    std::atomic<bool> ran_during_sleep(false);
+    std::atomic<bool> other_ran(false);
+    Event done;
+    go([&]() {
+        ::usleep(30000);
+        timespec request = {0, 5 * 1000 * 1000};
+        ::nanosleep(&request, nullptr);
+        ran_during_sleep.store(other_ran.load());
+        done.signal();
+    });
+    go([&]() { other_ran.store(true); });
+
+    ASSERT_TRUE(done.wait(1000));
+    EXPECT_TRUE(ran_during_sleep.load());
+}
+
+TEST_F(SyscallHookUnitTest, PollWaitsOnSeveralFdsWithoutBlocking) {
+    init(1);
+
+    int first[2] = {-1, -1};
+    int second[2] = {-1, -1};
+    ASSERT_TRUE(MakeHookedPair(first));
+    ASSERT_TRUE(MakeHookedPair(second));
+
+    std::atomic<int> ready(-1);
+    std::atomic<int> timed_out(-1);
+    short revents[2] = {0, 0};
+    Event done;
+    go([&]() {
+        pollfd fds[2];
+        fds[0].fd = first[0];
+        fds[0].events = POLLIN;
+        fds[1].fd = second[0];
+        fds[1].events = POLLIN;
+        fds[0].revents = fds[1].revents = 0;
+        timed_out.store(::poll(fds, 2, 20));
+
+        ready.store(::poll(fds, 2, 1000));
+        revents[0] = fds[0].revents;
+        revents[1] = fds[1].revents;
+        done.signal();
+    });
+    go([&]() {
+        sleep_for(40);
+        ::write(second[1], "p", 1);
+    });
+
+    ASSERT_TRUE(done.wait(2000));
+    EXPECT_EQ(timed_out.load(), 0);
+    EXPECT_EQ(ready.load(), 1);
+    EXPECT_EQ(revents[0], 0);
+    EXPECT_TRUE(revents[1] & POLLIN);
+
+    for (int fd : {first[0], first[1], second[0], second[1]}) {
+        ::close(fd);
+    }
+}
+
+TEST_F(SyscallHookUnitTest, SelectAndEpollWaitYieldToOtherFibers) {
+    init(1);
+
+    int pair[2] = {-1, -1};
+    ASSERT_TRUE(MakeHookedPair(pair));
+    const int epfd = ::epoll_create1(EPOLL_CLOEXEC);
+    ASSERT_GE(epfd, 0);
+    epoll_event interest;
+    interest.events = EPOLLIN;
+    interest.data.fd = pair[0];
+    ASSERT_EQ(::epoll_ctl(epfd, EPOLL_CTL_ADD, pair[0], &interest), 0);
+
+    std::atomic<int> selected(-1);
+    std::atomic<int> polled(-1);
+    Event done;
+    go([&]() {
+        fd_set reads;
+        FD_ZERO(&reads);
+        FD_SET(pair[0], &reads);
+        selected.store(::select(pair[0] + 1, &reads, nullptr, nullptr,
+                                nullptr));
+
+        epoll_event events[2];
+        polled.store(::epoll_wait(epfd, events, 2, 1000));
+        done.signal();
+    });
+    // 单调度器上写协程能运行，说明 select/epoll_wait 只挂起了当前协程。
+    go([&]() {
+        sleep_for(10);
+        ::write(pair[1], "s", 1);
+    });
+
+    if (!done.wait(2000)) {
+        ADD_FAILURE() << "select blocked the scheduler";
+        ::shutdown(pair[1], SHUT_RDWR);
+        done.wait(1000);
+    }
+    EXPECT_EQ(selected.load(), 1);
+    EXPECT_EQ(polled.load(), 1);
+
+    ::close(epfd);
+    ::close(pair[0]);
+    ::close(pair[1]);
+}
+
+TEST_F(SyscallHookUnitTest, DisabledHookLeavesNewSocketsAlone) {
+    init(1);
+    ASSERT_TRUE(co_hook_enabled());
+    co_hook_enable(false);
+    EXPECT_FALSE(co_hook_enabled());
+
+    std::atomic<int> flags(-1);
+    Event done;
+    go([&]() {
+        const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+        flags.store(::fcntl(fd, F_GETFL));
+        ::close(fd);
+        done.signal();
+    });
+
+    ASSERT_TRUE(done.wait(1000));
+    ASSERT_GE(flags.load(), 0);
+    EXPECT_EQ(flags.load() & O_NONBLOCK, 0);
+}
+
+} // namespace
+} // namespace zco
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    zco::init_logger();
+    return RUN_ALL_TESTS();
+}
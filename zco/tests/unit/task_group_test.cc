@@ -0,0 +1,209 @@
+#include <atomic>
+#include <chrono>
+#include <errno.h>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <thread>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include "support/test_fixture.h"
+#include "zco/event.h"
+#include "zco/io_event.h"
+#include "zco/task_group.h"
+
+namespace zco {
+namespace {
+
+class TaskGroupUnitTest : public test::RuntimeTestBase {};
+
+TEST_F(TaskGroupUnitTest, CollectsResultsOfAllChildren) {
+    init(2);
+
+    TaskGroup group;
+    Future<int> a = group.go([]() { return 1; });
+    Future<int> b = group.go([]() {
+        sleep_for(5);
+        return 2;
+    });
+    std::atomic<int> side(0);
+    Future<void> c = group.go([&side]() { side.store(3); });
+
+    ASSERT_TRUE(group.wait_all(1000));
+    EXPECT_EQ(group.size(), 3u);
+    EXPECT_FALSE(group.cancelled());
+    EXPECT_EQ(a.get() + b.get(), 3);
+    EXPECT_NO_THROW(c.get());
+    EXPECT_EQ(side.load(), 3);
+}
+
+TEST_F(TaskGroupUnitTest, WaitAllTimesOutWhileChildRuns) {
+    init(1);
+
+    Event release;
+    TaskGroup group;
+    group.go([&release]() { release.wait(1000); });
+
+    errno = 0;
+    EXPECT_FALSE(group.wait_all(10));
+    EXPECT_EQ(errno, ETIMEDOUT);
+    release.signal();
+    EXPECT_TRUE(group.wait_all(1000));
+}
+
+TEST_F(TaskGroupUnitTest, WaitAnyReturnsFirstFinishedChild) {
+    init(2);
+
+    TaskGroup empty;
+    errno = 0;
+    EXPECT_EQ(empty.wait_any(0), -1);
+    EXPECT_EQ(errno, EINVAL);
+
+    Event release;
+    TaskGroup group;
+    group.go([&release]() { release.wait(1000); });
+    group.go([]() { sleep_for(5); });
+
+    EXPECT_EQ(group.wait_any(1000), 1);
+    EXPECT_EQ(group.wait_any(0), 1);
+    release.signal();
+}
+
+TEST_F(TaskGroupUnitTest, FailingChildCancelsSleepingSibling) {
+    init(2);
+
+    std::atomic<bool> sibling_cancelled(false);
+    std::chrono::steady_clock::duration elapsed{};
+    const auto begin = std::chrono::steady_clock::now();
+    Future<void> sibling;
+    Future<int> failing;
+    {
+        TaskGroup group;
+        sibling = group.go([&sibling_cancelled]() {
+            sleep_for(5000);
+            sibling_cancelled.store(cancelled());
+        });
+        failing = group.go([]() -> int {
+            sleep_for(10);
+            throw std::runtime_error("child failed");
+        });
+        EXPECT_TRUE(group.wait_all(3000));
+        EXPECT_TRUE(group.cancelled());
+    }
+    elapsed = std::chrono::steady_clock::now() - begin;
+
+    EXPECT_LT(elapsed, std::chrono::milliseconds(2000));
+    EXPECT_TRUE(sibling_cancelled.load());
+    EXPECT_NO_THROW(sibling.get());
+    EXPECT_THROW(failing.get(), std::runtime_error);
+}
+
+TEST_F(TaskGroupUnitTest, CancelInterruptsTimedEventWait) {
+    init(1);
+
+    Event never;
+    Event parked;
+    std::atomic<bool> woke(true);
+    TaskGroup group;
+    group.go([&]() {
+        parked.signal();
+        woke.store(never.wait(5000));
+    });
+
+    ASSERT_TRUE(parked.wait(1000));
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    group.cancel();
+    group.cancel();
+    ASSERT_TRUE(group.wait_all(1000));
+    EXPECT_FALSE(woke.load());
+}
+
+TEST_F(TaskGroupUnitTest, CancelFailsIoWaitWithEcanceled) {
+    init(1);
+
+    int pair[2] = {-1, -1};
+    ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, pair), 0);
+
+    Event parked;
+    std::atomic<bool> ready(true);
+    std::atomic<int> error(0);
+    TaskGroup group;
+    group.go([&]() {
+        IoEvent readable(pair[1], IoEventType::kRead);
+        parked.signal();
+        ready.store(readable.wait(5000));
+        error.store(errno);
+    });
+
+    ASSERT_TRUE(parked.wait(1000));
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    group.cancel();
+    ASSERT_TRUE(group.wait_all(1000));
+    EXPECT_FALSE(ready.load());
+    EXPECT_EQ(error.load(), ECANCELED);
+
+    ::close(pair[0]);
+    ::close(pair[1]);
+}
+
+TEST_F(TaskGroupUnitTest, ChildrenStartedAfterCancelDoNotRun) {
+    init(1);
+
+    std::atomic<int> ran(0);
+    TaskGroup group;
+    group.cancel();
+    Future<int> future = group.go([&ran]() { return ran.fetch_add(1); });
+
+    ASSERT_TRUE(group.wait_all(1000));
+    EXPECT_EQ(ran.load(), 0);
+    EXPECT_THROW(future.get(), TaskCancelled);
+}
+
+TEST_F(TaskGroupUnitTest, DeadlineCancelsRunningChildren) {
+    init(1);
+
+    std::atomic<bool> saw_cancel(false);
+    const auto begin = std::chrono::steady_clock::now();
+    {
+        TaskGroup group(20);
+        group.go([&saw_cancel]() {
+            sleep_for(5000);
+            saw_cancel.store(cancelled());
+        });
+    }
+
+    EXPECT_LT(std::chrono::steady_clock::now() - begin,
+              std::chrono::milliseconds(2000));
+    EXPECT_TRUE(saw_cancel.load());
+}
+
+TEST_F(TaskGroupUnitTest, CancelledFlagIsClearedForReusedFibers) {
+    init(1);
+
+    {
+        TaskGroup group;
+        group.go([]() { sleep_for(5000); });
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        group.cancel();
+    }
+
+    // 被取消的协程回收后再复用，新任务不能看到旧的取消标记。
+    std::atomic<bool> flag(true);
+    Event done;
+    go([&]() {
+        flag.store(cancelled());
+        done.signal();
+    });
+    ASSERT_TRUE(done.wait(1000));
+    EXPECT_FALSE(flag.load());
+}
+
+} // namespace
+} // namespace zco
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    zco::init_logger();
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,147 @@
+#include <array>
+#include <functional>
+#include <memory>
+#include <utility>
+
+#include <gtest/gtest.h>
+
+#include "support/test_fixture.h"
+#include "zco/task.h"
+#include "zco/wait_group.h"
+
+namespace zco {
+namespace {
+
+class TaskUnitTest : public test::RuntimeTestBase {};
+
+// 记录存活实例数，用来检查 Task 移动与析构时不泄漏也不重复析构。
+struct Tracked {
+    explicit Tracked(int *alive) : alive(alive) { ++*alive; }
+    Tracked(const Tracked &other) : alive(other.alive) { ++*alive; }
+    Tracked(Tracked &&other) noexcept : alive(other.alive) { ++*alive; }
+    ~Tracked() { --*alive; }
+
+    int *alive;
+};
+
+int g_plain_calls = 0;
+
+void plain_function() { ++g_plain_calls; }
+
+TEST_F(TaskUnitTest, EmptyTaskIsFalseAndThrowsOnCall) {
+    Task task;
+    EXPECT_FALSE(task);
+    EXPECT_FALSE(task.is_inline());
+    EXPECT_THROW(task(), std::bad_function_call);
+
+    Task from_null = nullptr;
+    EXPECT_FALSE(from_null);
+}
+
+TEST_F(TaskUnitTest, NullFunctionPointerAndEmptyFunctionGiveEmptyTask) {
+    void (*null_fn)() = nullptr;
+    EXPECT_FALSE(Task(null_fn));
+    EXPECT_FALSE(Task(std::function<void()>()));
+
+    g_plain_calls = 0;
+    Task from_pointer(&plain_function);
+    ASSERT_TRUE(from_pointer);
+    from_pointer();
+    EXPECT_EQ(g_plain_calls, 1);
+}
+
+TEST_F(TaskUnitTest, SmallCaptureIsStoredInline) {
+    int calls = 0;
+    void *a = nullptr;
+    void *b = nullptr;
+    void *c = nullptr;
+    Task task([&calls, a, b, c]() {
+        (void)a;
+        (void)b;
+        (void)c;
+        ++calls;
+    });
+
+    EXPECT_TRUE(task.is_inline());
+    task();
+    task();
+    EXPECT_EQ(calls, 2);
+}
+
+TEST_F(TaskUnitTest, LargeCaptureFallsBackToHeap) {
+    std::array<char, 128> payload{};
+    payload[0] = 'z';
+    char seen = 0;
+    Task task([payload, &seen]() { seen = payload[0]; });
+
+    EXPECT_FALSE(task.is_inline());
+    Task moved(std::move(task));
+    EXPECT_FALSE(task);
+    moved();
+    EXPECT_EQ(seen, 'z');
+}
+
+TEST_F(TaskUnitTest, MoveOnlyCaptureIsAccepted) {
+    std::unique_ptr<int> value(new int(7));
+    int seen = 0;
+    Task task([value = std::move(value), &seen]() { seen = *value; });
+
+    EXPECT_TRUE(task.is_inline());
+    Task other;
+    other = std::move(task);
+    other();
+    EXPECT_EQ(seen, 7);
+}
+
+TEST_F(TaskUnitTest, MoveAndResetDestroyCapturesExactlyOnce) {
+    int alive = 0;
+    {
+        Task inline_task([tracked = Tracked(&alive)]() {});
+        std::array<char, 96> padding{};
+        Task heap_task([tracked = Tracked(&alive), padding]() {});
+        EXPECT_EQ(alive, 2);
+
+        Task moved_inline(std::move(inline_task));
+        Task moved_heap(std::move(heap_task));
+        EXPECT_EQ(alive, 2);
+
+        moved_inline = std::move(moved_heap);
+        EXPECT_EQ(alive, 1);
+
+        moved_inline = nullptr;
+        EXPECT_EQ(alive, 0);
+    }
+    EXPECT_EQ(alive, 0);
+}
+
+TEST_F(TaskUnitTest, GoRunsMoveOnlyTasksAndReleasesCaptures) {
+    init(1);
+
+    std::shared_ptr<int> shared = std::make_shared<int>(0);
+    std::weak_ptr<int> watch = shared;
+    WaitGroup done(2);
+    go([owned = std::unique_ptr<int>(new int(1)), shared, &done]() {
+        *shared += *owned;
+        done.done();
+    });
+    go([shared = std::move(shared), &done]() {
+        *shared += 1;
+        done.done();
+    });
+    done.wait();
+
+    // 任务执行完即释放捕获，不等 Fiber 被复用。
+    for (int i = 0; i < 100 && !watch.expired(); ++i) {
+        WaitShortly();
+    }
+    EXPECT_TRUE(watch.expired());
+}
+
+} // namespace
+} // namespace zco
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    zco::init_logger();
+    return RUN_ALL_TESTS();
+}
@@ -144,6 +144,78 @@ TEST_F(TimerQueueUnitTest, ConcurrentAddThenProcessExecutesAllCallbacks) {
     EXPECT_EQ(called.load(std::memory_order_relaxed), kTotal);
 }
 
+TEST_F(TimerQueueUnitTest, CancelUnlinksTimerImmediately) {
+    TimerQueue queue;
+    std::atomic<int> called(0);
+
+    std::vector<std::shared_ptr<TimerToken>> tokens;
+    for (int i = 0; i < 100; ++i) {
+        tokens.push_back(queue.add_timer(
+            static_cast<uint32_t>(i * 50),
+            [&called]() { called.fetch_add(1, std::memory_order_relaxed); }));
+    }
+    EXPECT_EQ(queue.size(), 100u);
+
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        tokens[i]->cancel();
+    }
+    EXPECT_EQ(queue.size(), 0u);
+    EXPECT_EQ(queue.next_timeout_ms(), 1000);
+
+    // 重复取消与触发后取消都应是无害的空操作。
+    tokens[0]->cancel();
+    queue.process_due();
+    EXPECT_EQ(called.load(std::memory_order_relaxed), 0);
+}
+
+TEST_F(TimerQueueUnitTest, CancelReleasesCallbackCaptures) {
+    TimerQueue queue;
+    std::shared_ptr<int> captured = std::make_shared<int>(7);
+    std::weak_ptr<int> observer = captured;
+
+    std::shared_ptr<TimerToken> token =
+        queue.add_timer(500, [captured]() { (void)captured; });
+    captured.reset();
+    EXPECT_FALSE(observer.expired());
+
+    token->cancel();
+    EXPECT_TRUE(observer.expired());
+}
+
+TEST_F(TimerQueueUnitTest, TimerBeyondFirstLevelCascadesAndFires) {
+    TimerQueue queue;
+    std::vector<int> order;
+
+    queue.add_timer(300, [&order]() { order.push_back(2); });
+    queue.add_timer(20, [&order]() { order.push_back(1); });
+
+    const int timeout_ms = queue.next_timeout_ms();
+    EXPECT_GT(timeout_ms, 0);
+    EXPECT_LE(timeout_ms, 20);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(25));
+    queue.process_due();
+    ASSERT_EQ(order.size(), 1u);
+
+    // 第 0 层只覆盖 256ms，300ms 的定时器需要从上层槽位下沉后才会到期。
+    EXPECT_LE(queue.next_timeout_ms(), 300);
+    std::this_thread::sleep_for(std::chrono::milliseconds(290));
+    queue.process_due();
+    ASSERT_EQ(order.size(), 2u);
+    EXPECT_EQ(order[1], 2);
+    EXPECT_EQ(queue.size(), 0u);
+}
+
+TEST_F(TimerQueueUnitTest, TokenOutlivingQueueCanStillBeCancelled) {
+    std::shared_ptr<TimerToken> token;
+    {
+        TimerQueue queue;
+        token = queue.add_timer(1000, []() {});
+    }
+    token->cancel();
+    EXPECT_TRUE(token->cancelled.load(std::memory_order_acquire));
+}
+
 } // namespace
 } // namespace zco
 
@@ -0,0 +1,122 @@
+#include <sched.h>
+
+#include <atomic>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "support/test_fixture.h"
+#include "zco/event.h"
+#include "zco/internal/processor.h"
+#include "zco/internal/runtime_manager.h"
+#include "zco/internal/topology.h"
+#include "zco/sched.h"
+
+namespace zco {
+namespace {
+
+class TopologyUnitTest : public test::RuntimeTestBase {};
+
+TEST_F(TopologyUnitTest, ParseCpuListExpandsRangesAndIgnoresNewline) {
+    std::vector<int> cpus;
+    ASSERT_TRUE(parse_cpu_list("0-3,8,10-11\n", &cpus));
+    EXPECT_EQ(cpus, (std::vector<int>{0, 1, 2, 3, 8, 10, 11}));
+
+    std::vector<int> empty;
+    EXPECT_TRUE(parse_cpu_list("\n", &empty));
+    EXPECT_TRUE(empty.empty());
+}
+
+TEST_F(TopologyUnitTest, ParseCpuListRejectsMalformedInput) {
+    std::vector<int> cpus;
+    EXPECT_FALSE(parse_cpu_list("3-1", &cpus));
+    EXPECT_FALSE(parse_cpu_list("a,b", &cpus));
+    EXPECT_FALSE(parse_cpu_list("1-", &cpus));
+    EXPECT_FALSE(parse_cpu_list("0-1", nullptr));
+    EXPECT_TRUE(cpus.empty());
+}
+
+TEST_F(TopologyUnitTest, PlanGroupsProcessorsByNodeProportionally) {
+    // 节点 1 放在前面、CPU 乱序，构造函数负责排序去重。
+    CpuTopology topology({4, 5, 6, 7, 0, 1, 2, 3, 3},
+                         {1, 1, 1, 1, 0, 0, 0, 0, 0});
+    EXPECT_EQ(topology.cpu_count(), 8u);
+    EXPECT_EQ(topology.node_count(), 2u);
+    EXPECT_EQ(topology.node_of(5), 1);
+    EXPECT_EQ(topology.node_of(42), -1);
+
+    std::vector<CpuPlacement> plan = topology.plan(4);
+    ASSERT_EQ(plan.size(), 4u);
+    EXPECT_EQ(plan[0].cpu, 0);
+    EXPECT_EQ(plan[1].cpu, 2);
+    EXPECT_EQ(plan[2].cpu, 4);
+    EXPECT_EQ(plan[3].cpu, 6);
+    EXPECT_EQ(plan[0].numa_node, 0);
+    EXPECT_EQ(plan[1].numa_node, 0);
+    EXPECT_EQ(plan[2].numa_node, 1);
+    EXPECT_EQ(plan[3].numa_node, 1);
+}
+
+TEST_F(TopologyUnitTest, PlanSharesCoresWhenProcessorsExceedCpus) {
+    CpuTopology topology({0, 1}, {0, 0});
+
+    std::vector<CpuPlacement> plan = topology.plan(4);
+    ASSERT_EQ(plan.size(), 4u);
+    EXPECT_EQ(plan[0].cpu, 0);
+    EXPECT_EQ(plan[1].cpu, 0);
+    EXPECT_EQ(plan[2].cpu, 1);
+    EXPECT_EQ(plan[3].cpu, 1);
+}
+
+TEST_F(TopologyUnitTest, EmptyTopologyLeavesProcessorsUnbound) {
+    CpuTopology topology({}, {});
+    EXPECT_EQ(topology.node_count(), 0u);
+
+    std::vector<CpuPlacement> plan = topology.plan(2);
+    ASSERT_EQ(plan.size(), 2u);
+    EXPECT_EQ(plan[0].cpu, -1);
+    EXPECT_EQ(plan[1].numa_node, -1);
+
+    EXPECT_FALSE(bind_current_thread(plan[0]));
+    EXPECT_FALSE(bind_memory_to_node(nullptr, 4096, 0));
+}
+
+TEST_F(TopologyUnitTest, DetectReportsAllowedCpus) {
+    CpuTopology topology = CpuTopology::detect();
+    EXPECT_GE(topology.cpu_count(), 1u);
+    EXPECT_GE(topology.node_count(), 1u);
+}
+
+TEST_F(TopologyUnitTest, NumaAwareRuntimePinsProcessorThreads) {
+    co_numa_aware(true);
+    EXPECT_TRUE(Runtime::instance().numa_aware());
+    init(2);
+    EXPECT_FALSE(Runtime::instance().set_numa_aware(false));
+
+    std::atomic<int> cpu(-2);
+    std::atomic<int> node(-2);
+    Event done;
+    go([&]() {
+        Processor *processor = current_processor();
+        node.store(processor ? processor->numa_node() : -1);
+        cpu.store(sched_getcpu());
+        done.signal();
+    });
+    ASSERT_TRUE(done.wait(3000));
+
+    EXPECT_GE(node.load(), 0);
+    CpuTopology topology = CpuTopology::detect();
+    EXPECT_EQ(topology.node_of(cpu.load()), node.load());
+
+    shutdown();
+    EXPECT_FALSE(Runtime::instance().numa_aware());
+}
+
+} // namespace
+} // namespace zco
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    zco::init_logger();
+    return RUN_ALL_TESTS();
+}
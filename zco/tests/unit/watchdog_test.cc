@@ -0,0 +1,195 @@
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+
+#include <gtest/gtest.h>
+
+#include "support/test_fixture.h"
+#include "zco/event.h"
+#include "zco/internal/processor.h"
+#include "zco/internal/watchdog.h"
+#include "zco/stats.h"
+
+namespace zco {
+namespace {
+
+class WatchdogUnitTest : public test::RuntimeTestBase {};
+
+// 不让出调度器地占住当前线程。
+void BlockThread(int milliseconds) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(milliseconds));
+}
+
+// done.signal() 之后协程还要切回调度器才结束本次片段，等片段计入统计。
+template <typename Pred> ProcessorStats WaitForStats(Pred pred) {
+    ProcessorStats processor = stats().processors.at(0);
+    for (int i = 0; i < 500 && !pred(processor); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        processor = stats().processors.at(0);
+    }
+    return processor;
+}
+
+TEST_F(WatchdogUnitTest, TracingIsOffByDefault) {
+    init(1);
+
+    Event done;
+    go([&]() { done.signal(); });
+    ASSERT_TRUE(done.wait(1000));
+
+    const ProcessorStats processor = stats().processors.at(0);
+    EXPECT_TRUE(processor.ready_latency.buckets.empty());
+    EXPECT_TRUE(processor.run_slice.buckets.empty());
+    EXPECT_EQ(processor.long_slices, 0u);
+}
+
+TEST_F(WatchdogUnitTest, RecordsReadyLatencyAndRunSlices) {
+    SchedTraceOptions options;
+    options.latency_histograms = true;
+    co_sched_trace(options);
+    init(1);
+
+    Event done;
+    go([&]() {
+        for (int i = 0; i < 4; ++i) {
+            yield();
+        }
+        BlockThread(5);
+        done.signal();
+    });
+    ASSERT_TRUE(done.wait(1000));
+
+    const ProcessorStats processor = WaitForStats(
+        [](const ProcessorStats &p) { return p.run_slice.count >= 5; });
+    EXPECT_GE(processor.run_slice.count, 5u);
+    EXPECT_GE(processor.run_slice.max_ns, 5u * 1000 * 1000);
+    EXPECT_GE(processor.ready_latency.count, 5u);
+    EXPECT_EQ(processor.long_slices, 0u);
+    EXPECT_NE(render_prometheus(stats()).find(
+                  "zco_run_slice_seconds{sched=\"0\",quantile=\"0.99\"}"),
+              std::string::npos);
+}
+
+TEST_F(WatchdogUnitTest, ReportsFiberThatDoesNotYield) {
+    SchedTraceOptions options;
+    options.long_slice_ms = 20;
+    options.capture_spawn_site = true;
+    co_sched_trace(options);
+    init(1);
+
+    std::atomic<bool> has_site(false);
+    Event done;
+    go([&]() {
+        const Fiber *fiber = current_processor()->current_fiber();
+        has_site.store(fiber && fiber->spawn_site() != nullptr);
+        BlockThread(60);
+        done.signal();
+    });
+    ASSERT_TRUE(done.wait(1000));
+
+    EXPECT_TRUE(has_site.load());
+    EXPECT_EQ(WaitForStats([](const ProcessorStats &p) {
+                  return p.long_slices >= 1;
+              }).long_slices,
+              1u);
+}
+
+TEST_F(WatchdogUnitTest, ExposesSpawnSiteOfFiberThatNeverSwitchesBack) {
+    SchedTraceOptions options;
+    options.long_slice_ms = 1000;
+    options.capture_spawn_site = true;
+    co_sched_trace(options);
+    init(1);
+
+    std::atomic<Processor *> processor(nullptr);
+    std::atomic<bool> release(false);
+    Event started;
+    Event done;
+    go([&]() {
+        processor.store(current_processor());
+        started.signal();
+        // 不让出调度器地等待，模拟卡死的处理函数。
+        while (!release.load()) {
+            BlockThread(1);
+        }
+        done.signal();
+    });
+    const bool has_started = started.wait(1000);
+
+    // 协程还没切回，看门狗只能从处理器上读到创建位置。
+    uint64_t begin_ns = 0;
+    int fiber_id = 0;
+    SpawnSite site;
+    SpawnSite stale;
+    const bool running =
+        has_started && processor.load()->running_slice(&begin_ns, &fiber_id);
+    const bool has_site =
+        running && processor.load()->running_spawn_site(begin_ns, &site);
+    const bool has_stale =
+        running && processor.load()->running_spawn_site(begin_ns + 1, &stale);
+    release.store(true);
+    ASSERT_TRUE(done.wait(1000));
+
+    EXPECT_TRUE(running);
+    EXPECT_TRUE(has_site);
+    EXPECT_GT(site.depth, 0);
+    EXPECT_FALSE(has_stale);
+}
+
+TEST_F(WatchdogUnitTest, MigratesPendingTasksOffStalledScheduler) {
+    SchedTraceOptions options;
+    options.long_slice_ms = 20;
+    options.migrate_on_long_slice = true;
+    co_sched_trace(options);
+    init(2);
+
+    Event blocking;
+    Event unblocked;
+    main_sched()->go([&]() {
+        blocking.signal();
+        BlockThread(400);
+        unblocked.signal();
+    });
+    ASSERT_TRUE(blocking.wait(1000));
+
+    // 这些任务排在卡住的调度器上，只能靠看门狗转交给另一个调度器。
+    const int kTasks = 8;
+    std::atomic<int> finished(0);
+    std::atomic<int> on_stalled(0);
+    Event all_done;
+    for (int i = 0; i < kTasks; ++i) {
+        main_sched()->go([&]() {
+            if (sched_id() == 0) {
+                on_stalled.fetch_add(1);
+            }
+            if (finished.fetch_add(1) + 1 == kTasks) {
+                all_done.signal();
+            }
+        });
+    }
+
+    EXPECT_TRUE(all_done.wait(300));
+    ASSERT_TRUE(unblocked.wait(1000));
+    while (finished.load() != kTasks) {
+        WaitShortly();
+    }
+    EXPECT_EQ(on_stalled.load(), 0);
+}
+
+TEST_F(WatchdogUnitTest, SpawnSiteFormatsFrames) {
+    std::unique_ptr<SpawnSite> site = capture_spawn_site();
+    ASSERT_NE(site, nullptr);
+    EXPECT_GT(site->depth, 0);
+    EXPECT_NE(format_spawn_site(*site).find("#0 "), std::string::npos);
+    EXPECT_TRUE(format_spawn_site(SpawnSite()).empty());
+}
+
+} // namespace
+} // namespace zco
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    zco::init_logger();
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,285 @@
+#include "zco/internal/processor.h"
+#include "zco/internal/runtime_manager.h"
+#include "zco/zco_log.h"
+#include "znet/address.h"
+#include "znet/buffer.h"
+#include "znet/tcp_connection.h"
+#include "znet/tcp_server.h"
+#include "znet/znet_logger.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 对比 epoll 与 io_uring 两种 poller 在 znet echo 路径上的系统调用开销：
+// 同一进程内依次切换 ZCO_POLLER 启动 TcpServer，阻塞客户端线程做固定次数
+// 的请求/应答往返，统计 poller 自身发起的系统调用次数并折算到每个请求。
+
+namespace {
+
+struct BenchConfig {
+    int port = 18090;
+    int server_threads = 2;
+    int clients = 8;
+    int requests_per_client = 2000;
+    int payload_bytes = 64;
+    int scale_pct = 100;
+};
+
+struct BackendResult {
+    std::string backend;
+    bool ok = false;
+    uint64_t requests = 0;
+    uint64_t syscalls = 0;
+    double seconds = 0.0;
+};
+
+int read_env_int(const char *name, int default_value, int min_value,
+                 int max_value) {
+    const char *raw = std::getenv(name);
+    if (!raw || raw[0] == '\0') {
+        return default_value;
+    }
+
+    char *end = nullptr;
+    errno = 0;
+    const long parsed = std::strtol(raw, &end, 10);
+    if (errno != 0 || end == raw || (end && *end != '\0') ||
+        parsed < min_value || parsed > max_value) {
+        return default_value;
+    }
+    return static_cast<int>(parsed);
+}
+
+int scaled_value(const int base, const int scale_pct, const int min_value) {
+    const long long scaled =
+        (static_cast<long long>(base) * static_cast<long long>(scale_pct)) /
+        100;
+    return scaled < min_value ? min_value : static_cast<int>(scaled);
+}
+
+BenchConfig load_config() {
+    BenchConfig cfg;
+    cfg.port = read_env_int("ZNET_ECHO_PORT", cfg.port, 1, 65535);
+    cfg.server_threads =
+        read_env_int("ZNET_ECHO_THREADS", cfg.server_threads, 1, 256);
+    cfg.clients = read_env_int("ZNET_ECHO_CLIENTS", cfg.clients, 1, 1024);
+    cfg.payload_bytes =
+        read_env_int("ZNET_ECHO_PAYLOAD", cfg.payload_bytes, 1, 65536);
+    cfg.scale_pct = read_env_int("ZNET_PERF_SCALE_PCT", cfg.scale_pct, 1, 1000);
+    cfg.requests_per_client =
+        scaled_value(read_env_int("ZNET_ECHO_REQUESTS",
+                                  cfg.requests_per_client, 1, 10000000),
+                     cfg.scale_pct, 1);
+    return cfg;
+}
+
+uint64_t poller_syscalls(std::string *backend) {
+    uint64_t total = 0;
+    const auto &processors = zco::Runtime::instance().processors();
+    for (size_t i = 0; i < processors.size(); ++i) {
+        const zco::Poller *poller =
+            processors[i] ? processors[i]->poller() : nullptr;
+        if (!poller) {
+            continue;
+        }
+        total += poller->syscall_count();
+        if (backend) {
+            *backend = poller->name();
+        }
+    }
+    return total;
+}
+
+bool write_all(int fd, const char *data, size_t length) {
+    while (length > 0) {
+        const ssize_t n = ::send(fd, data, length, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        data += n;
+        length -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool read_all(int fd, char *data, size_t length) {
+    while (length > 0) {
+        const ssize_t n = ::recv(fd, data, length, 0);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        data += n;
+        length -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+int connect_client(int port) {
+    const int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        return -1;
+    }
+
+    const int one = 1;
+    (void)::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (::connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) !=
+        0) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+BackendResult run_backend(const BenchConfig &cfg, const char *backend,
+                          int port) {
+    BackendResult result;
+    result.backend = backend;
+    ::setenv("ZCO_POLLER", backend, 1);
+
+    auto address = std::make_shared<znet::IPv4Address>(
+        "127.0.0.1", static_cast<uint16_t>(port));
+    auto server = std::make_shared<znet::TcpServer>(address, 1024);
+    server->set_thread_count(cfg.server_threads);
+    server->set_on_message(
+        [](const znet::TcpConnection::ptr &conn, znet::Buffer &buffer) {
+            if (!conn || buffer.readable_bytes() == 0) {
+                return;
+            }
+            if (conn->send(buffer.peek(), buffer.readable_bytes()) < 0) {
+                conn->close();
+                return;
+            }
+            buffer.retrieve_all();
+        });
+
+    if (!server->start()) {
+        std::cerr << "[znet-echo-syscalls] server start failed, backend="
+                  << backend << std::endl;
+        zco::shutdown();
+        return result;
+    }
+
+    // 先建好所有连接，让 accept 与连接初始化不计入请求路径。
+    std::vector<int> fds;
+    for (int i = 0; i < cfg.clients; ++i) {
+        const int fd = connect_client(port);
+        if (fd < 0) {
+            std::cerr << "[znet-echo-syscalls] connect failed, errno=" << errno
+                      << std::endl;
+            break;
+        }
+        fds.push_back(fd);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    std::atomic<uint64_t> completed(0);
+    std::atomic<bool> failed(fds.size() != static_cast<size_t>(cfg.clients));
+    const uint64_t syscalls_before = poller_syscalls(&result.backend);
+    const auto begin = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> clients;
+    for (size_t i = 0; i < fds.size(); ++i) {
+        clients.emplace_back([&cfg, &completed, &failed, fd = fds[i]]() {
+            std::string request(static_cast<size_t>(cfg.payload_bytes), 'z');
+            std::string response(request.size(), '\0');
+            for (int n = 0; n < cfg.requests_per_client; ++n) {
+                if (!write_all(fd, request.data(), request.size()) ||
+                    !read_all(fd, &response[0], response.size())) {
+                    failed.store(true);
+                    return;
+                }
+                completed.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+    for (size_t i = 0; i < clients.size(); ++i) {
+        clients[i].join();
+    }
+
+    const auto end = std::chrono::steady_clock::now();
+    result.syscalls = poller_syscalls(nullptr) - syscalls_before;
+    result.requests = completed.load();
+    result.seconds = std::chrono::duration<double>(end - begin).count();
+    result.ok = !failed.load() && result.requests > 0;
+
+    for (size_t i = 0; i < fds.size(); ++i) {
+        ::close(fds[i]);
+    }
+    server->stop();
+    zco::shutdown();
+    return result;
+}
+
+void print_result(const BackendResult &result) {
+    const double per_request =
+        result.requests > 0 ? static_cast<double>(result.syscalls) /
+                                  static_cast<double>(result.requests)
+                            : 0.0;
+    const double qps = result.seconds > 0.0
+                           ? static_cast<double>(result.requests) /
+                                 result.seconds
+                           : 0.0;
+    std::cout << "ZNET_ECHO_SYSCALLS backend=" << result.backend
+              << " ok=" << (result.ok ? 1 : 0)
+              << " requests=" << result.requests
+              << " poller_syscalls=" << result.syscalls << std::fixed
+              << std::setprecision(3)
+              << " syscalls_per_request=" << per_request
+              << std::setprecision(0) << " qps=" << qps << std::endl;
+}
+
+} // namespace
+
+int main() {
+    std::signal(SIGPIPE, SIG_IGN);
+    znet::init_logger(zlog::LogLevel::value::OFF);
+    zco::init_logger(zlog::LogLevel::value::OFF);
+
+    const BenchConfig cfg = load_config();
+    std::cout << "[znet-echo-syscalls] config"
+              << " port=" << cfg.port
+              << " server_threads=" << cfg.server_threads
+              << " clients=" << cfg.clients
+              << " requests_per_client=" << cfg.requests_per_client
+              << " payload_bytes=" << cfg.payload_bytes
+              << " scale_pct=" << cfg.scale_pct << std::endl;
+
+    bool ok = true;
+    const char *backends[] = {"epoll", "io_uring"};
+    for (size_t i = 0; i < sizeof(backends) / sizeof(backends[0]); ++i) {
+        // 每个后端换一个端口，避免上一轮监听 socket 的 TIME_WAIT 干扰。
+        const BackendResult result =
+            run_backend(cfg, backends[i], cfg.port + static_cast<int>(i));
+        print_result(result);
+        ok = ok && result.ok;
+    }
+    return ok ? 0 : 1;
+}